@@ -0,0 +1,196 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include "parallel.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace qengine {
+
+
+class JobCounter;
+
+
+// Work done by a job. begin and end are the range of the jobs ParallelFor
+// splits, other jobs can put anything there, or ignore them.
+typedef void (*JobFunction)(void *userData, size_t begin, size_t end);
+
+
+struct Job {
+  JobFunction function;
+  void *userData;
+  size_t begin;
+  size_t end;
+};
+
+
+// Counts the jobs run against it that are not done yet, for JobSystem::Wait,
+// and holds back the jobs depending on them until they are. Must outlive all
+// of those jobs, which waiting on it makes sure of. Can be used again once
+// done.
+class JobCounter {
+public:
+  JobCounter()
+    : pending(0)
+  {
+    lock.clear();
+  }
+
+  JobCounter(const JobCounter &) = delete;
+  JobCounter &operator=(const JobCounter &) = delete;
+
+  bool IsDone() const {
+    return pending.load(std::memory_order_acquire) == 0;
+  }
+
+private:
+  friend class JobSystem;
+
+  // A job, and the counter it was run against.
+  struct Task {
+    Job job;
+    JobCounter *counter;
+  };
+
+  void Lock();
+  void Unlock();
+
+  std::atomic<uint32_t> pending;
+  std::atomic_flag lock;
+  // Jobs run with this counter as their dependency.
+  std::vector<Task> waiting;
+};
+
+
+// Work stealing job system. Every thread taking part, the workers and the
+// thread that started it, has a Chase-Lev deque of its own: jobs it runs go
+// on its bottom and are taken back from there, last in first out, while
+// idle threads steal from the top of the others', oldest first. Threads
+// outside the system hand their jobs in through a shared queue.
+//
+// Waiting on a counter runs jobs meanwhile, so the thread that started the
+// system helps out instead of blocking, and jobs may wait on jobs of their
+// own. Workers with nothing to run or steal go to sleep until more jobs come.
+//
+// Typical use:
+//   JobCounter physics, frame;
+//   jobs.Run(physicsJobs, physicsCount, &physics);
+//   jobs.Run(animationJobs, animationCount, &frame, &physics);
+//   jobs.Wait(frame);
+class JobSystem {
+public:
+  // Start asks for one worker for every core besides the one of the caller.
+  static const uint32_t DefaultWorkerCount = ~0u;
+
+  // Jobs a deque holds. Jobs run past that are run right away instead.
+  static const uint32_t DequeCapacity = 4096;
+
+  JobSystem();
+  ~JobSystem();
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  // Start workerCount worker threads, and take in the calling thread as the
+  // main one. With no workers, the main thread runs every job as it waits.
+  // Start and Stop from the same thread.
+  void Start(uint32_t workerCount = DefaultWorkerCount);
+
+  // Stop the workers once their jobs are done, then run whatever is still
+  // queued on the caller. Jobs run afterwards are run right away.
+  void Stop();
+
+  bool IsRunning() const {
+    return running.load(std::memory_order_acquire);
+  }
+
+  // Worker threads, not counting the main one.
+  uint32_t WorkerCount() const {
+    return static_cast<uint32_t>(threads.size());
+  }
+
+  // Run count jobs, adding them to counter unless it is null. With
+  // dependency set, they start only once it is done. From any thread,
+  // including from jobs.
+  void Run(const Job *jobs, size_t count, JobCounter *counter, JobCounter *dependency = nullptr);
+
+  void Run(const Job &job, JobCounter *counter, JobCounter *dependency = nullptr) {
+    Run(&job, 1, counter, dependency);
+  }
+
+  // Run jobs until counter is done.
+  void Wait(JobCounter &counter);
+
+  // Run callback over [0, count) split into ranges of at least grain
+  // elements, and wait for them. Ranges start at one per thread, and are
+  // split in half again while the thread running them has nothing left for
+  // others to steal, so the grain adapts to how the work spreads out.
+  void ParallelFor(size_t count, size_t grain, math::RangeCallback callback, void *userData);
+
+  // Same, with func(begin, end).
+  template<typename Func>
+  void ParallelFor(size_t count, size_t grain, const Func &func) {
+    math::RangeCallback trampoline = [] (void *userData, size_t begin, size_t end) {
+      (*static_cast<const Func *>(userData))(begin, end);
+    };
+    ParallelFor(count, grain, trampoline, const_cast<Func *>(&func));
+  }
+
+  // math::ParallelForExecutor taking the job system as its context, for
+  // math::SetParallelExecutor.
+  static void Executor(void *context, size_t count, size_t grain, math::RangeCallback callback,
+    void *userData);
+
+private:
+  typedef JobCounter::Task Task;
+
+  class Deque;
+  struct Worker;
+  struct Range;
+
+  // Job of ParallelFor, over [begin, end) of the Range at userData.
+  static void RunRange(void *userData, size_t begin, size_t end);
+
+  // Worker of the calling thread, null if it is not one of ours.
+  Worker *Current() const;
+
+  void WorkerMain(uint32_t index);
+
+  // Queue task from the calling thread.
+  void Schedule(const Task &task);
+
+  // Take a task to run, from worker's deque, the shared queue, or others'.
+  bool FindTask(Worker *worker, Task &task);
+
+  void Execute(const Task &task);
+
+  // One job against counter is done.
+  void Finish(JobCounter *counter);
+
+  void Wake(size_t count);
+
+  std::atomic<bool> running;
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+
+  // Jobs from threads outside the system.
+  std::mutex sharedLock;
+  std::deque<Task> shared;
+  std::atomic<size_t> sharedCount;
+
+  // Sleeping workers wait for signal to change.
+  std::mutex sleepLock;
+  std::condition_variable sleepCondition;
+  std::atomic<uint64_t> signal;
+  std::atomic<uint32_t> sleeping;
+};
+} // qengine
@@ -0,0 +1,28 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include "memory/handle_pool.hpp"
+#include "vector.hpp"
+
+#include <cstdint>
+
+
+namespace qengine {
+
+
+// Surface parameters of a draw: the GL names of its shader program and
+// textures, 0 for none, and the factors they are scaled by.
+struct Material {
+  uint32_t program;
+  uint32_t albedoTexture;
+  uint32_t normalTexture;
+  uint32_t roughnessMetallicTexture;
+  math::Vec4 albedo;
+  float roughness;
+  float metallic;
+};
+
+
+typedef Handle<Material> MaterialHandle;
+typedef HandlePool<Material, MemoryTag::Material> MaterialPool;
+} // qengine
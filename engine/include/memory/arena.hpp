@@ -0,0 +1,163 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include "memory_tracker.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+
+namespace qengine {
+
+
+// Bump allocator for temporaries, not thread safe. Allocations are carved
+// one after the other out of a block, and only ever freed all together, by
+// rewinding to a mark taken earlier, or resetting.
+//
+// When the block runs out, more are chained on, and Reset then replaces them
+// with a single block as large as the most used at once, so that once the
+// arena has seen its largest load it stops allocating altogether.
+class LinearArena {
+public:
+  // Alignment of allocations that do not ask for one.
+  static const size_t DefaultAlignment = alignof(std::max_align_t);
+
+  // Blocks are counted under tag, see memory_tracker.hpp.
+  explicit LinearArena(size_t capacity = 0, MemoryTag tag = MemoryTag::Scratch);
+  ~LinearArena();
+
+  LinearArena(const LinearArena &) = delete;
+  LinearArena &operator=(const LinearArena &) = delete;
+
+  // size bytes aligned to alignment, a power of two. Never null.
+  void *Allocate(size_t size, size_t alignment = DefaultAlignment);
+
+  // Room for count T, left uninitialized.
+  template<typename T>
+  T *AllocateArray(size_t count) {
+    return static_cast<T *>(Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  // Position to Rewind back to, freeing everything allocated after.
+  size_t Mark() const { return used; }
+  void Rewind(size_t mark);
+
+  // Free everything, and replace the blocks with one of Peak bytes if that
+  // did not fit in the first.
+  void Reset();
+
+  // Bytes in use, counting padding.
+  size_t Used() const { return used; }
+
+  // Most bytes in use at once since the last ResetPeak.
+  size_t Peak() const { return peak; }
+  void ResetPeak() { peak = used; }
+
+  // Bytes held, in all blocks.
+  size_t Capacity() const;
+
+private:
+  struct Block {
+    char *data;
+    size_t size;
+    // Mark at the start of the block.
+    size_t base;
+  };
+
+  char *AllocateBlock(size_t size);
+  void FreeBlock(const Block &block);
+
+  std::vector<Block> blocks;
+  size_t used;
+  size_t peak;
+  MemoryTag tag;
+};
+
+
+// Arena of the calling thread, for temporaries that do not outlive the
+// function taking them. Take a ScratchScope before allocating from it, so
+// that callers further up keep their own.
+LinearArena &ScratchArena();
+
+
+// Rewinds an arena to where it was when the scope was taken.
+class ScratchScope {
+public:
+  explicit ScratchScope(LinearArena &arena = ScratchArena())
+    : arena(arena)
+    , mark(arena.Mark())
+  { }
+
+  ~ScratchScope() {
+    arena.Rewind(mark);
+  }
+
+  ScratchScope(const ScratchScope &) = delete;
+  ScratchScope &operator=(const ScratchScope &) = delete;
+
+  LinearArena &Arena() { return arena; }
+
+private:
+  LinearArena &arena;
+  size_t mark;
+};
+
+
+// Standard library allocator drawing from Arena, a LinearArena or a
+// FrameAllocator, see frame_allocator.hpp. Deallocation does nothing, the
+// memory goes back when the arena is rewound or reset, so containers using
+// it must not outlive that.
+//
+//   ScratchScope scope;
+//   ArenaVector<uint32_t> visible(ArenaAllocator<uint32_t>(scope.Arena()));
+template<typename T, typename Arena = LinearArena>
+class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  template<typename U>
+  struct rebind {
+    typedef ArenaAllocator<U, Arena> other;
+  };
+
+  explicit ArenaAllocator(Arena &arena)
+    : arena(&arena)
+  { }
+
+  template<typename U>
+  ArenaAllocator(const ArenaAllocator<U, Arena> &other)
+    : arena(&other.GetArena())
+  { }
+
+  T *allocate(size_t count) {
+    return arena->template AllocateArray<T>(count);
+  }
+
+  void deallocate(T *, size_t) { }
+
+  Arena &GetArena() const { return *arena; }
+
+private:
+  Arena *arena;
+};
+
+
+template<typename T, typename U, typename Arena>
+inline bool operator==(const ArenaAllocator<T, Arena> &a, const ArenaAllocator<U, Arena> &b)
+{
+  return &a.GetArena() == &b.GetArena();
+}
+
+
+template<typename T, typename U, typename Arena>
+inline bool operator!=(const ArenaAllocator<T, Arena> &a, const ArenaAllocator<U, Arena> &b)
+{
+  return !(a == b);
+}
+
+
+template<typename T, typename Arena = LinearArena>
+using ArenaVector = std::vector<T, ArenaAllocator<T, Arena>>;
+} // qengine
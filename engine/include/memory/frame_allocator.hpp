@@ -0,0 +1,104 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include "arena.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+
+namespace qengine {
+
+
+// Bump allocator for data living one frame, such as command lists and
+// culling results, which any thread may allocate from at once. There is a
+// buffer per frame in flight, two or three, and starting a frame frees the
+// buffer of the oldest, so what a frame allocated stays valid while the
+// frames after it are recorded.
+//
+// A frame outgrowing its buffer gets the rest from the heap, and buffers
+// grow to the most any frame used as they are taken up again, so that in the
+// steady state allocating is a single atomic add. All of it is counted under
+// MemoryTag::Frame.
+class FrameAllocator {
+public:
+  static const uint32_t MaxFrameCount = 3;
+  static const uint32_t DefaultFrameCount = 2;
+  static const size_t DefaultCapacity = 4 * 1024 * 1024;
+
+  FrameAllocator();
+  ~FrameAllocator();
+
+  FrameAllocator(const FrameAllocator &) = delete;
+  FrameAllocator &operator=(const FrameAllocator &) = delete;
+
+  // Set up frameCount buffers, from 1 to MaxFrameCount, of capacity bytes
+  // each, freeing any there were. Until then everything comes from the heap.
+  void Create(size_t capacity = DefaultCapacity, uint32_t frameCount = DefaultFrameCount);
+  void Destroy();
+
+  // size bytes aligned to alignment, a power of two, valid until the frame
+  // is frameCount frames behind. Thread safe. Never null.
+  void *Allocate(size_t size, size_t alignment = LinearArena::DefaultAlignment);
+
+  template<typename T>
+  T *AllocateArray(size_t count) {
+    return static_cast<T *>(Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  // Start the next frame, called by Engine::SwapBuffers. Nothing may be
+  // allocating meanwhile.
+  void NextFrame();
+
+  uint32_t FrameCount() const { return frameCount; }
+
+  // Frames started since Create.
+  uint64_t Frame() const { return frame; }
+
+  // Bytes of each buffer.
+  size_t Capacity() const { return capacity; }
+
+  // Bytes the current frame used so far, counting padding.
+  size_t Used() const;
+
+  // Bytes the last frame used in all.
+  size_t LastFrameUsed() const { return lastFrameUsed; }
+
+  // Most bytes any frame used.
+  size_t PeakUsed() const { return peakUsed; }
+
+  // Bytes the last frame had to get from the heap.
+  size_t LastFrameOverflow() const { return lastFrameOverflow; }
+
+private:
+  struct Overflow {
+    void *memory;
+    size_t size;
+  };
+
+  struct Buffer {
+    char *data;
+    size_t size;
+    std::atomic<size_t> offset;
+    // Heap allocations past the end of data, and the bytes they hold.
+    std::vector<Overflow> overflow;
+    std::atomic<size_t> overflowBytes;
+  };
+
+  // Free the overflow of buffer, and grow it to capacity.
+  void Recycle(Buffer &buffer);
+
+  Buffer buffers[MaxFrameCount];
+  uint32_t frameCount;
+  uint32_t current;
+  uint64_t frame;
+  size_t capacity;
+  size_t lastFrameUsed;
+  size_t peakUsed;
+  size_t lastFrameOverflow;
+  std::mutex overflowLock;
+};
+} // qengine
@@ -0,0 +1,273 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include "memory_tracker.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+
+namespace qengine {
+
+
+// 32 bit reference to an item of a HandlePool<T>: the index of its slot in
+// the low IndexBits, and the generation of the slot when the item was added
+// above them. Removing the item bumps the generation, so handles to it go
+// stale instead of pointing at whatever takes the slot next. The null handle
+// is 0, as generations start at 1.
+template<typename T>
+struct Handle {
+  static const uint32_t IndexBits = 20;
+  static const uint32_t GenerationBits = 32 - IndexBits;
+  static const uint32_t MaxIndex = (1u << IndexBits) - 1;
+  static const uint32_t MaxGeneration = (1u << GenerationBits) - 1;
+
+  Handle()
+    : value(0)
+  { }
+
+  Handle(uint32_t index, uint32_t generation)
+    : value(generation << IndexBits | index)
+  { }
+
+  uint32_t Index() const { return value & MaxIndex; }
+  uint32_t Generation() const { return value >> IndexBits; }
+  bool IsNull() const { return value == 0; }
+
+  bool operator==(const Handle &other) const { return value == other.value; }
+  bool operator!=(const Handle &other) const { return value != other.value; }
+
+  uint32_t value;
+};
+
+
+// Pool of T, kept densely packed in one array in no particular order, and
+// referenced by Handle<T>. Adding reuses the slots of removed items, and
+// removing moves the last item into the hole, so walking the pool is a walk
+// over a plain array, with no gaps to skip.
+//
+// Handles go through a slot table, one lookup to the item. Pointers into
+// the pool are only good until the next Add or Remove.
+//
+// A slot whose generation runs out is retired, and only comes back, at
+// generation 1, after Handle<T>::MaxGeneration more removals from the pool,
+// so a stale handle can only pass for a new item if it was held across that
+// many. Churn then never grows the slot table past the most items ever held
+// at once plus MaxGeneration.
+//
+// Everything the pool holds is allocated through TrackedAllocator, counted
+// under Tag, see memory_tracker.hpp.
+//
+//   MeshPool meshes;
+//   MeshHandle handle = meshes.Add(mesh);
+//   if (Mesh *found = meshes.Get(handle)) { ... }
+//   for (Mesh &mesh : meshes) { ... }
+template<typename T, MemoryTag Tag = MemoryTag::General>
+class HandlePool {
+public:
+  typedef Handle<T> HandleType;
+  typedef T *iterator;
+  typedef const T *const_iterator;
+
+  HandlePool()
+    : freeSlots(NoSlot)
+    , releases(0)
+  { }
+
+  // Add item, null if the pool already holds Handle<T>::MaxIndex + 1 items.
+  HandleType Add(const T &item);
+  HandleType Add(T &&item);
+
+  // Remove the item of handle. False if it is stale or null.
+  bool Remove(HandleType handle);
+
+  // Item of handle, null if it is stale or null.
+  T *Get(HandleType handle);
+  const T *Get(HandleType handle) const;
+
+  bool Contains(HandleType handle) const { return Get(handle) != nullptr; }
+
+  // Handle of the item at position i of the array.
+  HandleType HandleAt(size_t i) const {
+    uint32_t slot = owners[i];
+    return HandleType(slot, slots[slot].generation);
+  }
+
+  void Clear();
+  void Reserve(size_t count);
+
+  size_t Size() const { return items.size(); }
+  bool Empty() const { return items.empty(); }
+
+  T *Data() { return items.data(); }
+  const T *Data() const { return items.data(); }
+  T &operator[](size_t i) { return items[i]; }
+  const T &operator[](size_t i) const { return items[i]; }
+
+  iterator begin() { return items.data(); }
+  iterator end() { return items.data() + items.size(); }
+  const_iterator begin() const { return items.data(); }
+  const_iterator end() const { return items.data() + items.size(); }
+
+private:
+  static const uint32_t NoSlot = ~0u;
+
+  struct Slot {
+    // Position of the item in items, or the next free slot.
+    uint32_t dense;
+    uint32_t generation;
+  };
+
+  struct Retired {
+    uint32_t slot;
+    // Value of releases when the slot was retired.
+    uint64_t release;
+  };
+
+  // Slot for a new item at the end of items, NoSlot if there is none.
+  uint32_t Acquire();
+
+  // Stale the handles of slot, and put it on the free list.
+  void Release(uint32_t slot);
+
+  std::vector<T, TrackedAllocator<T, Tag>> items;
+  // Slot of each item.
+  std::vector<uint32_t, TrackedAllocator<uint32_t, Tag>> owners;
+  std::vector<Slot, TrackedAllocator<Slot, Tag>> slots;
+  uint32_t freeSlots;
+  // Retired slots, oldest first, and how many releases there have been.
+  std::deque<Retired, TrackedAllocator<Retired, Tag>> retired;
+  uint64_t releases;
+};
+
+
+template<typename T, MemoryTag Tag>
+uint32_t HandlePool<T, Tag>::Acquire()
+{
+  uint32_t slot = freeSlots;
+  if (slot != NoSlot) {
+    freeSlots = slots[slot].dense;
+  } else if (!retired.empty() &&
+    releases - retired.front().release >= HandleType::MaxGeneration) {
+    slot = retired.front().slot;
+    retired.pop_front();
+    slots[slot].generation = 1;
+  } else if (slots.size() <= HandleType::MaxIndex) {
+    slot = static_cast<uint32_t>(slots.size());
+    Slot fresh = { 0, 1 };
+    slots.push_back(fresh);
+  } else {
+    return NoSlot;
+  }
+  slots[slot].dense = static_cast<uint32_t>(items.size());
+  owners.push_back(slot);
+  return slot;
+}
+
+
+template<typename T, MemoryTag Tag>
+typename HandlePool<T, Tag>::HandleType HandlePool<T, Tag>::Add(const T &item)
+{
+  uint32_t slot = Acquire();
+  if (slot == NoSlot) {
+    return HandleType();
+  }
+  items.push_back(item);
+  return HandleType(slot, slots[slot].generation);
+}
+
+
+template<typename T, MemoryTag Tag>
+typename HandlePool<T, Tag>::HandleType HandlePool<T, Tag>::Add(T &&item)
+{
+  uint32_t slot = Acquire();
+  if (slot == NoSlot) {
+    return HandleType();
+  }
+  items.push_back(std::move(item));
+  return HandleType(slot, slots[slot].generation);
+}
+
+
+// A slot whose generation runs out is retired rather than wrapped around,
+// until Acquire sees a full epoch of releases go by, see HandlePool.
+template<typename T, MemoryTag Tag>
+void HandlePool<T, Tag>::Release(uint32_t slot)
+{
+  ++releases;
+  if (slots[slot].generation < HandleType::MaxGeneration) {
+    ++slots[slot].generation;
+    slots[slot].dense = freeSlots;
+    freeSlots = slot;
+  } else {
+    slots[slot].generation = 0;
+    Retired entry = { slot, releases };
+    retired.push_back(entry);
+  }
+}
+
+
+template<typename T, MemoryTag Tag>
+bool HandlePool<T, Tag>::Remove(HandleType handle)
+{
+  if (!Get(handle)) {
+    return false;
+  }
+  uint32_t slot = handle.Index();
+  uint32_t dense = slots[slot].dense;
+  uint32_t last = static_cast<uint32_t>(items.size() - 1);
+  if (dense != last) {
+    items[dense] = std::move(items[last]);
+    owners[dense] = owners[last];
+    slots[owners[dense]].dense = dense;
+  }
+  items.pop_back();
+  owners.pop_back();
+  Release(slot);
+  return true;
+}
+
+
+template<typename T, MemoryTag Tag>
+T *HandlePool<T, Tag>::Get(HandleType handle)
+{
+  uint32_t slot = handle.Index();
+  // Retired slots have generation 0, which no handle from Add has.
+  if (slot >= slots.size() || handle.Generation() == 0 ||
+    slots[slot].generation != handle.Generation()) {
+    return nullptr;
+  }
+  return &items[slots[slot].dense];
+}
+
+
+template<typename T, MemoryTag Tag>
+const T *HandlePool<T, Tag>::Get(HandleType handle) const
+{
+  return const_cast<HandlePool *>(this)->Get(handle);
+}
+
+
+// Every slot in use gets a new generation, which stales all handles given out.
+template<typename T, MemoryTag Tag>
+void HandlePool<T, Tag>::Clear()
+{
+  for (size_t i = 0; i < owners.size(); ++i) {
+    Release(owners[i]);
+  }
+  items.clear();
+  owners.clear();
+}
+
+
+template<typename T, MemoryTag Tag>
+void HandlePool<T, Tag>::Reserve(size_t count)
+{
+  items.reserve(count);
+  owners.reserve(count);
+  slots.reserve(count);
+}
+} // qengine
@@ -0,0 +1,155 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Memory tracking is on unless building with Q_RELEASE_MINIMAL, in which
+// case every function here is an empty inline, and the allocation functions
+// go straight to the heap.
+#if !defined(Q_RELEASE_MINIMAL)
+#define Q_MEMORY_TRACKING 1
+#endif
+
+
+namespace qengine {
+
+
+// What memory is for, to count it by.
+enum class MemoryTag : uint32_t {
+  General,
+  Math,
+  Mesh,
+  Material,
+  Renderer,
+  Texture,
+  Jobs,
+  Frame,
+  Scratch,
+  Count
+};
+
+static const uint32_t MemoryTagCount = static_cast<uint32_t>(MemoryTag::Count);
+
+
+struct MemoryTagStats {
+  // Bytes held now, and the most held at once since ResetMemoryPeaks.
+  size_t bytes;
+  size_t peakBytes;
+  // Allocations held now, and made in all.
+  size_t allocations;
+  size_t totalAllocations;
+  // 0 for none.
+  size_t budget;
+};
+
+
+struct MemorySnapshot {
+  MemoryTagStats tags[MemoryTagCount];
+  // Over all tags.
+  size_t bytes;
+  size_t peakBytes;
+};
+
+
+// Called by the allocation that takes tag over its budget, from the thread
+// making it. Not called again until it drops back under.
+typedef void (*OverBudgetCallback)(void *userData, MemoryTag tag, size_t bytes, size_t budget);
+
+
+const char *MemoryTagName(MemoryTag tag);
+
+
+#if defined(Q_MEMORY_TRACKING)
+
+// Count size bytes allocated, or freed, under tag, for memory allocated
+// elsewhere, such as on the gpu. Thread safe, a few relaxed atomic adds.
+void TrackAllocation(MemoryTag tag, size_t size);
+void TrackFree(MemoryTag tag, size_t size);
+
+// Set the budget of tag in bytes, 0 for none.
+void SetMemoryBudget(MemoryTag tag, size_t budget);
+
+// Set the function called when a tag goes over budget, null for none.
+void SetOverBudgetCallback(OverBudgetCallback callback, void *userData);
+
+// Counters of every tag. Taken while others allocate, the tags may be out
+// of step by the allocations in flight.
+MemorySnapshot TakeMemorySnapshot();
+
+// Start the peaks over from the bytes held now.
+void ResetMemoryPeaks();
+
+#else
+
+inline void TrackAllocation(MemoryTag, size_t) { }
+inline void TrackFree(MemoryTag, size_t) { }
+inline void SetMemoryBudget(MemoryTag, size_t) { }
+inline void SetOverBudgetCallback(OverBudgetCallback, void *) { }
+inline MemorySnapshot TakeMemorySnapshot() { return MemorySnapshot(); }
+inline void ResetMemoryPeaks() { }
+
+#endif
+
+
+// size bytes from the heap, counted under tag, to give back with TrackedFree
+// and the same size and tag.
+inline void *TrackedAllocate(size_t size, MemoryTag tag)
+{
+  void *memory = ::operator new(size);
+  TrackAllocation(tag, size);
+  return memory;
+}
+
+
+inline void TrackedFree(void *memory, size_t size, MemoryTag tag)
+{
+  if (memory) {
+    TrackFree(tag, size);
+    ::operator delete(memory);
+  }
+}
+
+
+// Standard library allocator counting under Tag.
+//
+//   std::vector<Vertex, TrackedAllocator<Vertex, MemoryTag::Mesh>> vertices;
+template<typename T, MemoryTag Tag>
+class TrackedAllocator {
+public:
+  typedef T value_type;
+
+  template<typename U>
+  struct rebind {
+    typedef TrackedAllocator<U, Tag> other;
+  };
+
+  TrackedAllocator() { }
+
+  template<typename U>
+  TrackedAllocator(const TrackedAllocator<U, Tag> &) { }
+
+  T *allocate(size_t count) {
+    return static_cast<T *>(TrackedAllocate(count * sizeof(T), Tag));
+  }
+
+  void deallocate(T *memory, size_t count) {
+    TrackedFree(memory, count * sizeof(T), Tag);
+  }
+};
+
+
+template<typename T, typename U, MemoryTag Tag>
+inline bool operator==(const TrackedAllocator<T, Tag> &, const TrackedAllocator<U, Tag> &)
+{
+  return true;
+}
+
+
+template<typename T, typename U, MemoryTag Tag>
+inline bool operator!=(const TrackedAllocator<T, Tag> &, const TrackedAllocator<U, Tag> &)
+{
+  return false;
+}
+} // qengine
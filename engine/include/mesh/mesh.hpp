@@ -0,0 +1,28 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include "memory/handle_pool.hpp"
+#include "bounding/bound_box.hpp"
+
+#include <cstdint>
+
+
+namespace qengine {
+
+
+// Mesh as the renderer draws it: the GL names of its vertex array and
+// buffers, 0 until uploaded, what to draw from them, and its bounds in
+// model space for culling.
+struct Mesh {
+  uint32_t vertexArray;
+  uint32_t vertexBuffer;
+  uint32_t indexBuffer;
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  math::AABB bounds;
+};
+
+
+typedef Handle<Mesh> MeshHandle;
+typedef HandlePool<Mesh, MemoryTag::Mesh> MeshPool;
+} // qengine
@@ -0,0 +1,84 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace qengine {
+
+
+// What a gpu buffer gets bound as when drawing.
+enum class BufferTarget {
+  Vertex,
+  Index,
+  Uniform,
+  Storage
+};
+
+
+// Hint for how often the contents of a gpu buffer are rewritten.
+enum class BufferUsage {
+  Static,
+  Dynamic,
+  Stream
+};
+
+
+// OpenGL buffer object. Contiguous arrays of trivially copyable data, such as
+// vertices or math::Mat4 palettes, are memcpy'd straight into mapped buffer
+// memory with Upload(), without going element by element.
+class GpuBuffer {
+public:
+  GpuBuffer();
+  ~GpuBuffer();
+
+  GpuBuffer(const GpuBuffer &) = delete;
+  GpuBuffer &operator=(const GpuBuffer &) = delete;
+
+  // Allocate size bytes of gpu storage, initialized from data if not null,
+  // counted under MemoryTag::Renderer. Requires a current GL context.
+  // Returns false if the buffer could not be created.
+  bool Create(BufferTarget target, size_t size, BufferUsage usage, const void *data = nullptr);
+
+  // Release the gpu storage. Safe to call on a buffer never created.
+  void Destroy();
+
+  // Map size bytes at offset for writing. Previous contents of the range are
+  // discarded. Returns null if the range is out of bounds, or the buffer is
+  // already mapped.
+  void *Map(size_t offset, size_t size);
+
+  // Unmap the buffer after Map(). Returns false if the contents were lost
+  // while mapped, and must be written again.
+  bool Unmap();
+
+  // Copy size bytes from data into the buffer at offset.
+  bool Write(const void *data, size_t size, size_t offset = 0);
+
+  // Copy count elements into the buffer, starting at element first.
+  template<typename T>
+  bool Upload(const T *data, size_t count, size_t first = 0) {
+    static_assert(std::is_trivially_copyable<T>::value,
+      "Only trivially copyable types can be copied into a gpu buffer.");
+    return Write(data, count * sizeof(T), first * sizeof(T));
+  }
+
+  // Bind to the target the buffer was created for.
+  void Bind() const;
+
+  // Bind to an indexed binding point, for Uniform and Storage buffers.
+  void BindBase(uint32_t index) const;
+
+  uint32_t Handle() const { return handle; }
+  size_t Size() const { return size; }
+  bool IsMapped() const { return mapped != nullptr; }
+
+private:
+  uint32_t handle;
+  BufferTarget target;
+  size_t size;
+  void *mapped;
+};
+} // qengine
@@ -0,0 +1,38 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include "memory/handle_pool.hpp"
+
+#include <cstdint>
+
+
+namespace qengine {
+
+
+// Framebuffer drawn into offscreen: the GL names of the framebuffer and its
+// attachments, 0 for none, and their size and sample count.
+struct RenderTarget {
+  uint32_t framebuffer;
+  uint32_t colorTexture;
+  uint32_t depthTexture;
+  uint32_t width;
+  uint32_t height;
+  uint32_t samples;
+};
+
+
+typedef Handle<RenderTarget> RenderTargetHandle;
+typedef HandlePool<RenderTarget, MemoryTag::Renderer> RenderTargetPool;
+
+
+// Fill target with a new framebuffer of width x height, with an RGBA8 color
+// texture and a depth stencil texture, both multisampled if samples is not
+// 0. Texture storage is counted under MemoryTag::Texture. Requires a current
+// GL context. False if the framebuffer is incomplete, leaving nothing
+// allocated and target as it was.
+bool CreateRenderTarget(RenderTarget &target, uint32_t width, uint32_t height, uint32_t samples);
+
+// Delete the framebuffer and textures of target, and zero it. Safe to call
+// on a target never created.
+void DestroyRenderTarget(RenderTarget &target);
+} // qengine
@@ -3,23 +3,132 @@
 
 #include "command_list.hpp"
 #include "render_target.hpp"
+#include "gpu_buffer.hpp"
 #include "mesh/mesh.hpp"
 #include "material/material.hpp"
+#include "jobs/job_system.hpp"
+#include "memory/frame_allocator.hpp"
 
 
 
 namespace qengine {
 
 
+// How the engine presents what it draws.
+enum class DisplayMode {
+  // A window on the desktop.
+  Windowed,
+  // A window never shown, which still needs a display server.
+  Hidden,
+  // An offscreen context through EGL, needing no display, as on build
+  // machines. Falls back to Null where there is no EGL.
+  Headless,
+  // No OpenGL at all. Everything on the CPU runs as usual, jobs, culling,
+  // frame memory, and nothing gets drawn, for timing the CPU side of frames.
+  Null
+};
+
+
+struct EngineConfig {
+  EngineConfig()
+    : width(1920)
+    , height(1080)
+    , vsync(true)
+    , samples(0)
+    , glMajor(4)
+    , glMinor(4)
+    , mode(DisplayMode::Windowed)
+    , title("Quick Engine")
+    , frameLimit(0)
+    , workerCount(JobSystem::DefaultWorkerCount)
+    , frameCount(FrameAllocator::DefaultFrameCount)
+  { }
+
+  // Size of the window, or of the offscreen surface.
+  uint32_t width;
+  uint32_t height;
+  bool vsync;
+  // MSAA samples of the default framebuffer, or of the engine's own one on
+  // surfaceless headless contexts, 0 for none.
+  uint32_t samples;
+  // OpenGL version of the core profile context.
+  uint32_t glMajor;
+  uint32_t glMinor;
+  DisplayMode mode;
+  const char *title;
+  // Frames after which WindowIsRunning turns false, 0 for no limit.
+  uint64_t frameLimit;
+  // Worker threads of the job system, see JobSystem::Start.
+  uint32_t workerCount;
+  // Frames in flight kept by FrameMemory, two or three.
+  uint32_t frameCount;
+};
+
+
 // Quick Graphics engine. For Practice.
 class Engine {
 public:
+  Engine();
+  ~Engine();
 
-  void Init();
+  // Start the job system, which also runs every math::ParallelFor from then
+  // on, and open the display config asks for. False if it could not be
+  // opened, or OpenGL could not be loaded.
+  bool Init(const EngineConfig &config = EngineConfig());
   bool WindowIsRunning();
   void Poll();
   void SwapBuffers();
+
+  // Make WindowIsRunning turn false.
+  void Close();
+
+  // The mode the engine runs in, Null when a headless context could not be
+  // had. Nothing may call OpenGL in Null mode.
+  DisplayMode Mode() const { return mode; }
+  bool HasGL() const { return mode != DisplayMode::Null; }
+
+  const EngineConfig &Config() const { return config; }
+
+  // Frames swapped since Init.
+  uint64_t FrameCount() const { return frames; }
+
+  // Framebuffer frames are drawn into: 0, the default one, unless headless
+  // on a surfaceless context, which has none, and the engine makes one of
+  // config's size and samples. Bound from Init on.
+  uint32_t Framebuffer() const { return offscreen.framebuffer; }
+
+  // Framebuffer to read the last swapped frame back from, the multisample
+  // resolve of Framebuffer if it has samples.
+  uint32_t ResolvedFramebuffer() const {
+    return resolved.framebuffer ? resolved.framebuffer : offscreen.framebuffer;
+  }
+
+  JobSystem &Jobs() { return jobs; }
+
+  // Memory for the current frame, see FrameAllocator.
+  FrameAllocator &FrameMemory() { return frameMemory; }
+
+  // Resources the engine owns, referenced by handle.
+  MeshPool &Meshes() { return meshes; }
+  MaterialPool &Materials() { return materials; }
+  RenderTargetPool &RenderTargets() { return renderTargets; }
   
 private:
+  bool OpenWindow();
+  bool OpenHeadless();
+  void CloseDisplay();
+
+  EngineConfig config;
+  DisplayMode mode;
+  bool closed;
+  uint64_t frames;
+  JobSystem jobs;
+  FrameAllocator frameMemory;
+  // Surfaceless headless only, see Framebuffer.
+  RenderTarget offscreen;
+  RenderTarget resolved;
+  MeshPool meshes;
+  MaterialPool materials;
+  RenderTargetPool renderTargets;
 };
 } // qengine
\ No newline at end of file
@@ -0,0 +1,476 @@
+// Copyright (c) Mario Garcia, MIT License.
+#include "jobs/job_system.hpp"
+#include "memory/memory_tracker.hpp"
+
+#include <algorithm>
+
+
+namespace qengine {
+
+
+// Rounds an idle worker looks for jobs before going to sleep.
+static const uint32_t SpinCount = 64;
+
+// Ranges ParallelFor aims for on every thread at least, so that the grain
+// grows with large counts rather than splitting them down to single elements.
+static const size_t RangesPerThread = 16;
+
+
+void JobCounter::Lock()
+{
+  while (lock.test_and_set(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+}
+
+
+void JobCounter::Unlock()
+{
+  lock.clear(std::memory_order_release);
+}
+
+
+// Chase-Lev deque of fixed capacity, after Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models". Only the owner pushes and pops, at
+// the bottom, anyone steals, at the top. The fields of a slot are atomics of
+// their own, as a thief may read a slot while it gets written again, in which
+// case it loses the race for top and throws what it read away.
+class JobSystem::Deque {
+public:
+  Deque()
+    : top(0)
+    , bottom(0)
+  { }
+
+  // False when full.
+  bool Push(const Task &task) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= static_cast<int64_t>(DequeCapacity)) {
+      return false;
+    }
+    slots[b & Mask].Store(task);
+    bottom.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Pop(Task &task) {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    task = slots[b & Mask].Load();
+    if (t < b) {
+      return true;
+    }
+    // Last one, race the thieves for it.
+    bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+      std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  bool Steal(Task &task) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return false;
+    }
+    task = slots[t & Mask].Load();
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+      std::memory_order_relaxed);
+  }
+
+  bool Empty() const {
+    return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+  }
+
+private:
+  static const int64_t Mask = DequeCapacity - 1;
+
+  struct Slot {
+    void Store(const Task &task) {
+      function.store(task.job.function, std::memory_order_relaxed);
+      userData.store(task.job.userData, std::memory_order_relaxed);
+      begin.store(task.job.begin, std::memory_order_relaxed);
+      end.store(task.job.end, std::memory_order_relaxed);
+      counter.store(task.counter, std::memory_order_relaxed);
+    }
+
+    Task Load() const {
+      Task task;
+      task.job.function = function.load(std::memory_order_relaxed);
+      task.job.userData = userData.load(std::memory_order_relaxed);
+      task.job.begin = begin.load(std::memory_order_relaxed);
+      task.job.end = end.load(std::memory_order_relaxed);
+      task.counter = counter.load(std::memory_order_relaxed);
+      return task;
+    }
+
+    std::atomic<JobFunction> function;
+    std::atomic<void *> userData;
+    std::atomic<size_t> begin;
+    std::atomic<size_t> end;
+    std::atomic<JobCounter *> counter;
+  };
+
+  // Kept on lines of their own, away from each other and the slots, as the
+  // owner and the thieves write them.
+  char padTop[64];
+  std::atomic<int64_t> top;
+  char padBottom[64];
+  std::atomic<int64_t> bottom;
+  char padSlots[64];
+  Slot slots[DequeCapacity];
+};
+
+
+struct JobSystem::Worker {
+  explicit Worker(uint32_t index)
+    : random(index * 2654435761u + 1)
+  { }
+
+  Deque deque;
+  // xorshift state, for picking whom to steal from.
+  uint32_t random;
+};
+
+
+// What ParallelFor splits, shared by all of its jobs.
+struct JobSystem::Range {
+  JobSystem *system;
+  math::RangeCallback callback;
+  void *userData;
+  size_t grain;
+  JobCounter counter;
+};
+
+
+// The system the calling thread takes part in, and its worker there.
+static thread_local const JobSystem *currentSystem = nullptr;
+static thread_local uint32_t currentIndex = 0;
+
+
+JobSystem::JobSystem()
+  : running(false)
+  , sharedCount(0)
+  , signal(0)
+  , sleeping(0)
+{
+}
+
+
+JobSystem::~JobSystem()
+{
+  Stop();
+}
+
+
+void JobSystem::Start(uint32_t workerCount)
+{
+  if (IsRunning()) {
+    return;
+  }
+  if (workerCount == DefaultWorkerCount) {
+    uint32_t cores = std::thread::hardware_concurrency();
+    workerCount = cores > 1 ? cores - 1 : 0;
+  }
+  for (uint32_t i = 0; i <= workerCount; ++i) {
+    workers.push_back(std::unique_ptr<Worker>(new Worker(i)));
+    TrackAllocation(MemoryTag::Jobs, sizeof(Worker));
+  }
+  currentSystem = this;
+  currentIndex = 0;
+  running.store(true, std::memory_order_release);
+  for (uint32_t i = 1; i <= workerCount; ++i) {
+    threads.push_back(std::thread(&JobSystem::WorkerMain, this, i));
+  }
+}
+
+
+void JobSystem::Stop()
+{
+  if (!IsRunning()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(sleepLock);
+    running.store(false, std::memory_order_release);
+    signal.fetch_add(1);
+  }
+  sleepCondition.notify_all();
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+  threads.clear();
+  // Whatever the workers left, and the jobs those release.
+  Task task;
+  while (FindTask(workers[0].get(), task)) {
+    Execute(task);
+  }
+  for (size_t i = 0; i < workers.size(); ++i) {
+    TrackFree(MemoryTag::Jobs, sizeof(Worker));
+  }
+  workers.clear();
+  currentSystem = nullptr;
+}
+
+
+JobSystem::Worker *JobSystem::Current() const
+{
+  if (currentSystem != this || currentIndex >= workers.size()) {
+    return nullptr;
+  }
+  return workers[currentIndex].get();
+}
+
+
+void JobSystem::WorkerMain(uint32_t index)
+{
+  currentSystem = this;
+  currentIndex = index;
+  Worker *worker = workers[index].get();
+  uint32_t idle = 0;
+  while (IsRunning()) {
+    uint64_t seen = signal.load();
+    Task task;
+    if (FindTask(worker, task)) {
+      Execute(task);
+      idle = 0;
+      continue;
+    }
+    if (++idle < SpinCount) {
+      std::this_thread::yield();
+      continue;
+    }
+    // Anything queued after seen was read changes signal, so either it is
+    // seen here, or Wake sees this worker sleeping and notifies it.
+    std::unique_lock<std::mutex> guard(sleepLock);
+    sleeping.fetch_add(1);
+    sleepCondition.wait(guard, [&] { return signal.load() != seen; });
+    sleeping.fetch_sub(1);
+    idle = 0;
+  }
+}
+
+
+void JobSystem::Schedule(const Task &task)
+{
+  Worker *worker = Current();
+  if (worker) {
+    if (!worker->deque.Push(task)) {
+      Execute(task);
+    }
+    return;
+  }
+  std::lock_guard<std::mutex> guard(sharedLock);
+  shared.push_back(task);
+  sharedCount.fetch_add(1, std::memory_order_release);
+}
+
+
+bool JobSystem::FindTask(Worker *worker, Task &task)
+{
+  if (worker && worker->deque.Pop(task)) {
+    return true;
+  }
+  if (sharedCount.load(std::memory_order_acquire) > 0) {
+    std::lock_guard<std::mutex> guard(sharedLock);
+    if (!shared.empty()) {
+      task = shared.front();
+      shared.pop_front();
+      sharedCount.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  uint32_t count = static_cast<uint32_t>(workers.size());
+  uint32_t start = 0;
+  if (worker) {
+    worker->random ^= worker->random << 13;
+    worker->random ^= worker->random >> 17;
+    worker->random ^= worker->random << 5;
+    start = worker->random % count;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    Worker *victim = workers[(start + i) % count].get();
+    if (victim != worker && victim->deque.Steal(task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+void JobSystem::Execute(const Task &task)
+{
+  task.job.function(task.job.userData, task.job.begin, task.job.end);
+  Finish(task.counter);
+}
+
+
+// The count only drops under the counter's lock, so that once a waiter sees
+// it done and takes the lock in turn, nothing touches the counter anymore.
+void JobSystem::Finish(JobCounter *counter)
+{
+  if (!counter) {
+    return;
+  }
+  std::vector<Task> released;
+  counter->Lock();
+  if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    released.swap(counter->waiting);
+  }
+  counter->Unlock();
+  if (released.empty()) {
+    return;
+  }
+  if (!IsRunning()) {
+    for (size_t i = 0; i < released.size(); ++i) {
+      Execute(released[i]);
+    }
+    return;
+  }
+  for (size_t i = 0; i < released.size(); ++i) {
+    Schedule(released[i]);
+  }
+  Wake(released.size());
+}
+
+
+void JobSystem::Wake(size_t count)
+{
+  signal.fetch_add(1);
+  if (sleeping.load() == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(sleepLock);
+  }
+  if (count > 1) {
+    sleepCondition.notify_all();
+  } else {
+    sleepCondition.notify_one();
+  }
+}
+
+
+void JobSystem::Run(const Job *jobs, size_t count, JobCounter *counter, JobCounter *dependency)
+{
+  if (count == 0) {
+    return;
+  }
+  if (counter) {
+    counter->pending.fetch_add(static_cast<uint32_t>(count), std::memory_order_relaxed);
+  }
+  if (dependency) {
+    dependency->Lock();
+    if (!dependency->IsDone()) {
+      for (size_t i = 0; i < count; ++i) {
+        Task task = { jobs[i], counter };
+        dependency->waiting.push_back(task);
+      }
+      dependency->Unlock();
+      return;
+    }
+    dependency->Unlock();
+  }
+  if (!IsRunning()) {
+    for (size_t i = 0; i < count; ++i) {
+      Task task = { jobs[i], counter };
+      Execute(task);
+    }
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    Task task = { jobs[i], counter };
+    Schedule(task);
+  }
+  Wake(count);
+}
+
+
+void JobSystem::Wait(JobCounter &counter)
+{
+  Worker *worker = Current();
+  while (!counter.IsDone()) {
+    Task task;
+    if (FindTask(worker, task)) {
+      Execute(task);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  // Let the last Finish let go of the counter.
+  counter.Lock();
+  counter.Unlock();
+}
+
+
+// Ranges split off go on the deque of the thread running them, only while
+// it is empty: if a thief takes the half, the other is split again, if not,
+// the thread comes back to it after working through its own half, a grain at
+// a time.
+void JobSystem::RunRange(void *userData, size_t begin, size_t end)
+{
+  Range &range = *static_cast<Range *>(userData);
+  JobSystem &system = *range.system;
+  Worker *worker = system.Current();
+  while (begin < end) {
+    size_t size = end - begin;
+    if (worker && size >= 2 * range.grain && worker->deque.Empty()) {
+      size_t middle = begin + size / 2;
+      Task task = { { &JobSystem::RunRange, userData, middle, end }, &range.counter };
+      range.counter.pending.fetch_add(1, std::memory_order_relaxed);
+      if (worker->deque.Push(task)) {
+        system.Wake(1);
+        end = middle;
+        continue;
+      }
+      range.counter.pending.fetch_sub(1, std::memory_order_relaxed);
+    }
+    size_t piece = size < 2 * range.grain ? size : range.grain;
+    range.callback(range.userData, begin, begin + piece);
+    begin += piece;
+  }
+}
+
+
+void JobSystem::ParallelFor(size_t count, size_t grain, math::RangeCallback callback,
+  void *userData)
+{
+  if (count == 0) {
+    return;
+  }
+  size_t threadCount = workers.size();
+  if (!IsRunning() || threadCount < 2 || count <= grain) {
+    callback(userData, 0, count);
+    return;
+  }
+  Range range;
+  range.system = this;
+  range.callback = callback;
+  range.userData = userData;
+  range.grain = std::max(std::max(grain, static_cast<size_t>(1)),
+    count / (threadCount * RangesPerThread));
+  size_t ranges = std::min(threadCount, count / range.grain);
+  std::vector<Job> jobs(ranges);
+  for (size_t i = 0; i < ranges; ++i) {
+    Job job = { &JobSystem::RunRange, &range, count * i / ranges, count * (i + 1) / ranges };
+    jobs[i] = job;
+  }
+  Run(jobs.data(), ranges, &range.counter);
+  Wait(range.counter);
+}
+
+
+void JobSystem::Executor(void *context, size_t count, size_t grain,
+  math::RangeCallback callback, void *userData)
+{
+  static_cast<JobSystem *>(context)->ParallelFor(count, grain, callback, userData);
+}
+} // qengine
@@ -0,0 +1,114 @@
+// Copyright (c) Mario Garcia, MIT License.
+#include "memory/arena.hpp"
+
+#include <algorithm>
+
+
+namespace qengine {
+
+
+// Bytes the scratch arena of a thread starts with.
+static const size_t ScratchCapacity = 256 * 1024;
+
+// Smallest block chained on when an arena runs out.
+static const size_t MinBlockSize = 64 * 1024;
+
+
+LinearArena::LinearArena(size_t capacity, MemoryTag tag)
+  : used(0)
+  , peak(0)
+  , tag(tag)
+{
+  if (capacity > 0) {
+    Block block = { AllocateBlock(capacity), capacity, 0 };
+    blocks.push_back(block);
+  }
+}
+
+
+LinearArena::~LinearArena()
+{
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    FreeBlock(blocks[i]);
+  }
+}
+
+
+char *LinearArena::AllocateBlock(size_t size)
+{
+  return static_cast<char *>(TrackedAllocate(size, tag));
+}
+
+
+void LinearArena::FreeBlock(const Block &block)
+{
+  TrackedFree(block.data, block.size, tag);
+}
+
+
+// Padding to align the start of a block counts as used, so marks stay plain
+// byte counts, and a new block starts at the current mark.
+void *LinearArena::Allocate(size_t size, size_t alignment)
+{
+  if (!blocks.empty()) {
+    Block &block = blocks.back();
+    uintptr_t start = reinterpret_cast<uintptr_t>(block.data) + (used - block.base);
+    uintptr_t aligned = (start + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    size_t end = (aligned - reinterpret_cast<uintptr_t>(block.data)) + size;
+    if (end <= block.size) {
+      used = block.base + end;
+      peak = std::max(peak, used);
+      return reinterpret_cast<void *>(aligned);
+    }
+  }
+  size_t last = blocks.empty() ? 0 : blocks.back().size;
+  size_t blockSize = std::max(size + alignment, std::max(last * 2, MinBlockSize));
+  Block block = { AllocateBlock(blockSize), blockSize, used };
+  blocks.push_back(block);
+  return Allocate(size, alignment);
+}
+
+
+void LinearArena::Rewind(size_t mark)
+{
+  if (mark >= used) {
+    return;
+  }
+  while (blocks.size() > 1 && blocks.back().base >= mark) {
+    FreeBlock(blocks.back());
+    blocks.pop_back();
+  }
+  used = mark;
+}
+
+
+void LinearArena::Reset()
+{
+  if (peak > 0 && (blocks.size() != 1 || blocks[0].size < peak)) {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+      FreeBlock(blocks[i]);
+    }
+    blocks.clear();
+    Block block = { AllocateBlock(peak), peak, 0 };
+    blocks.push_back(block);
+  }
+  used = 0;
+}
+
+
+size_t LinearArena::Capacity() const
+{
+  size_t capacity = 0;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    capacity += blocks[i].size;
+  }
+  return capacity;
+}
+
+
+LinearArena &ScratchArena()
+{
+  static thread_local LinearArena arena(ScratchCapacity);
+  return arena;
+}
+} // qengine
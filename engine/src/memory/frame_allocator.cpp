@@ -0,0 +1,132 @@
+// Copyright (c) Mario Garcia, MIT License.
+#include "memory/frame_allocator.hpp"
+
+#include <algorithm>
+
+
+namespace qengine {
+
+
+FrameAllocator::FrameAllocator()
+  : frameCount(0)
+  , current(0)
+  , frame(0)
+  , capacity(0)
+  , lastFrameUsed(0)
+  , peakUsed(0)
+  , lastFrameOverflow(0)
+{
+  for (uint32_t i = 0; i < MaxFrameCount; ++i) {
+    buffers[i].data = nullptr;
+    buffers[i].size = 0;
+    buffers[i].offset.store(0, std::memory_order_relaxed);
+    buffers[i].overflowBytes.store(0, std::memory_order_relaxed);
+  }
+}
+
+
+FrameAllocator::~FrameAllocator()
+{
+  Destroy();
+}
+
+
+void FrameAllocator::Create(size_t capacity, uint32_t frameCount)
+{
+  Destroy();
+  this->capacity = capacity;
+  uint32_t most = MaxFrameCount;
+  this->frameCount = std::max(1u, std::min(frameCount, most));
+  for (uint32_t i = 0; i < this->frameCount; ++i) {
+    Recycle(buffers[i]);
+  }
+}
+
+
+void FrameAllocator::Destroy()
+{
+  for (uint32_t i = 0; i < MaxFrameCount; ++i) {
+    Buffer &buffer = buffers[i];
+    for (size_t j = 0; j < buffer.overflow.size(); ++j) {
+      TrackedFree(buffer.overflow[j].memory, buffer.overflow[j].size, MemoryTag::Frame);
+    }
+    buffer.overflow.clear();
+    buffer.overflowBytes.store(0, std::memory_order_relaxed);
+    TrackedFree(buffer.data, buffer.size, MemoryTag::Frame);
+    buffer.data = nullptr;
+    buffer.size = 0;
+    buffer.offset.store(0, std::memory_order_relaxed);
+  }
+  frameCount = 0;
+  current = 0;
+  frame = 0;
+  capacity = 0;
+  lastFrameUsed = 0;
+  peakUsed = 0;
+  lastFrameOverflow = 0;
+}
+
+
+void *FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+  Buffer &buffer = buffers[current];
+  uintptr_t data = reinterpret_cast<uintptr_t>(buffer.data);
+  size_t offset = buffer.offset.load(std::memory_order_relaxed);
+  for (;;) {
+    uintptr_t aligned = (data + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    size_t end = (aligned - data) + size;
+    if (end > buffer.size) {
+      break;
+    }
+    if (buffer.offset.compare_exchange_weak(offset, end, std::memory_order_relaxed)) {
+      return reinterpret_cast<void *>(aligned);
+    }
+  }
+  size_t bytes = size + alignment;
+  Overflow block = { TrackedAllocate(bytes, MemoryTag::Frame), bytes };
+  buffer.overflowBytes.fetch_add(bytes, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> guard(overflowLock);
+  buffer.overflow.push_back(block);
+  uintptr_t start = reinterpret_cast<uintptr_t>(block.memory);
+  return reinterpret_cast<void *>((start + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+}
+
+
+size_t FrameAllocator::Used() const
+{
+  const Buffer &buffer = buffers[current];
+  return buffer.offset.load(std::memory_order_relaxed) +
+    buffer.overflowBytes.load(std::memory_order_relaxed);
+}
+
+
+void FrameAllocator::NextFrame()
+{
+  if (frameCount == 0) {
+    return;
+  }
+  lastFrameUsed = Used();
+  lastFrameOverflow = buffers[current].overflowBytes.load(std::memory_order_relaxed);
+  peakUsed = std::max(peakUsed, lastFrameUsed);
+  capacity = std::max(capacity, peakUsed);
+  current = (current + 1) % frameCount;
+  ++frame;
+  Recycle(buffers[current]);
+}
+
+
+void FrameAllocator::Recycle(Buffer &buffer)
+{
+  for (size_t i = 0; i < buffer.overflow.size(); ++i) {
+    TrackedFree(buffer.overflow[i].memory, buffer.overflow[i].size, MemoryTag::Frame);
+  }
+  buffer.overflow.clear();
+  buffer.overflowBytes.store(0, std::memory_order_relaxed);
+  if (buffer.size < capacity) {
+    TrackedFree(buffer.data, buffer.size, MemoryTag::Frame);
+    buffer.data = static_cast<char *>(TrackedAllocate(capacity, MemoryTag::Frame));
+    buffer.size = capacity;
+  }
+  buffer.offset.store(0, std::memory_order_relaxed);
+}
+} // qengine
@@ -0,0 +1,126 @@
+// Copyright (c) Mario Garcia, MIT License.
+#include "memory/memory_tracker.hpp"
+
+#include <atomic>
+
+
+namespace qengine {
+
+
+const char *MemoryTagName(MemoryTag tag)
+{
+  switch (tag) {
+    case MemoryTag::General:  return "General";
+    case MemoryTag::Math:     return "Math";
+    case MemoryTag::Mesh:     return "Mesh";
+    case MemoryTag::Material: return "Material";
+    case MemoryTag::Renderer: return "Renderer";
+    case MemoryTag::Texture:  return "Texture";
+    case MemoryTag::Jobs:     return "Jobs";
+    case MemoryTag::Frame:    return "Frame";
+    case MemoryTag::Scratch:  return "Scratch";
+    default:                  return "Unknown";
+  }
+}
+
+
+#if defined(Q_MEMORY_TRACKING)
+
+// Counters of a tag, on a cache line of their own so that threads busy with
+// different tags do not fight over it.
+struct alignas(64) TagCounters {
+  std::atomic<size_t> bytes;
+  std::atomic<size_t> peakBytes;
+  std::atomic<size_t> allocations;
+  std::atomic<size_t> totalAllocations;
+  std::atomic<size_t> budget;
+};
+
+
+static TagCounters tagCounters[MemoryTagCount];
+static TagCounters totalCounters;
+static std::atomic<OverBudgetCallback> overBudgetCallback(nullptr);
+static std::atomic<void *> overBudgetUserData(nullptr);
+
+
+static void RaisePeak(std::atomic<size_t> &peak, size_t bytes)
+{
+  size_t seen = peak.load(std::memory_order_relaxed);
+  while (bytes > seen && !peak.compare_exchange_weak(seen, bytes, std::memory_order_relaxed)) {
+  }
+}
+
+
+void TrackAllocation(MemoryTag tag, size_t size)
+{
+  TagCounters &counters = tagCounters[static_cast<uint32_t>(tag)];
+  size_t bytes = counters.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+  RaisePeak(counters.peakBytes, bytes);
+  RaisePeak(totalCounters.peakBytes,
+    totalCounters.bytes.fetch_add(size, std::memory_order_relaxed) + size);
+
+  size_t budget = counters.budget.load(std::memory_order_relaxed);
+  if (budget && bytes > budget && bytes - size <= budget) {
+    OverBudgetCallback callback = overBudgetCallback.load(std::memory_order_acquire);
+    if (callback) {
+      callback(overBudgetUserData.load(std::memory_order_relaxed), tag, bytes, budget);
+    }
+  }
+}
+
+
+void TrackFree(MemoryTag tag, size_t size)
+{
+  TagCounters &counters = tagCounters[static_cast<uint32_t>(tag)];
+  counters.bytes.fetch_sub(size, std::memory_order_relaxed);
+  counters.allocations.fetch_sub(1, std::memory_order_relaxed);
+  totalCounters.bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+
+void SetMemoryBudget(MemoryTag tag, size_t budget)
+{
+  tagCounters[static_cast<uint32_t>(tag)].budget.store(budget, std::memory_order_relaxed);
+}
+
+
+void SetOverBudgetCallback(OverBudgetCallback callback, void *userData)
+{
+  overBudgetUserData.store(userData, std::memory_order_relaxed);
+  overBudgetCallback.store(callback, std::memory_order_release);
+}
+
+
+MemorySnapshot TakeMemorySnapshot()
+{
+  MemorySnapshot snapshot;
+  for (uint32_t i = 0; i < MemoryTagCount; ++i) {
+    const TagCounters &counters = tagCounters[i];
+    MemoryTagStats &stats = snapshot.tags[i];
+    stats.bytes = counters.bytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+    stats.budget = counters.budget.load(std::memory_order_relaxed);
+  }
+  snapshot.bytes = totalCounters.bytes.load(std::memory_order_relaxed);
+  snapshot.peakBytes = totalCounters.peakBytes.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+
+void ResetMemoryPeaks()
+{
+  for (uint32_t i = 0; i < MemoryTagCount; ++i) {
+    TagCounters &counters = tagCounters[i];
+    counters.peakBytes.store(counters.bytes.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
+  }
+  totalCounters.peakBytes.store(totalCounters.bytes.load(std::memory_order_relaxed),
+    std::memory_order_relaxed);
+}
+
+#endif
+} // qengine
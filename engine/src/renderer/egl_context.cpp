@@ -0,0 +1,214 @@
+// Copyright (c) Mario Garcia, MIT License.
+#include "egl_context.hpp"
+
+#if defined(Q_HAS_EGL)
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+#endif
+
+
+namespace qengine {
+
+
+#if defined(Q_HAS_EGL)
+
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+static EGLSurface eglSurface = EGL_NO_SURFACE;
+static EGLContext eglContext = EGL_NO_CONTEXT;
+
+
+static bool HasExtension(const char *extensions, const char *name)
+{
+  size_t length = std::strlen(name);
+  for (const char *at = extensions; at && (at = std::strstr(at, name)); at += length) {
+    bool start = at == extensions || at[-1] == ' ';
+    bool end = at[length] == ' ' || at[length] == '\0';
+    if (start && end) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// The surfaceless platform of Mesa needs no display server nor gpu device,
+// and falls back to llvmpipe. Failing that, the default display.
+static EGLDisplay OpenDisplay()
+{
+  const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+  if (HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+      (PFNEGLGETPLATFORMDISPLAYEXTPROC )eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay) {
+      EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY,
+        nullptr);
+      if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) {
+        return display;
+      }
+    }
+  }
+  EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) {
+    return display;
+  }
+  return EGL_NO_DISPLAY;
+}
+
+
+// First config for surfaceType, 0 for none, with samples MSAA samples.
+static bool ChooseConfig(EGLint surfaceType, uint32_t samples, EGLConfig &config)
+{
+  const EGLint attributes[] = {
+    EGL_SURFACE_TYPE, surfaceType,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_DEPTH_SIZE, 24,
+    EGL_SAMPLES, static_cast<EGLint>(samples),
+    EGL_NONE
+  };
+  EGLint count = 0;
+  return eglChooseConfig(eglDisplay, attributes, &config, 1, &count) && count > 0;
+}
+
+
+// A pbuffer gives the context a default framebuffer of the right size and
+// samples, so it wins whenever some config has one. Surfaceless contexts
+// have no default framebuffer at all, the engine draws into one of its own.
+bool CreateEglContext(uint32_t width, uint32_t height, uint32_t glMajor, uint32_t glMinor,
+  uint32_t samples)
+{
+  DestroyEglContext();
+  eglDisplay = OpenDisplay();
+  if (eglDisplay == EGL_NO_DISPLAY || !eglBindAPI(EGL_OPENGL_API)) {
+    DestroyEglContext();
+    return false;
+  }
+  EGLConfig config;
+  bool surfaceless = false;
+  if (!ChooseConfig(EGL_PBUFFER_BIT, samples, config)) {
+    surfaceless = HasExtension(eglQueryString(eglDisplay, EGL_EXTENSIONS),
+      "EGL_KHR_surfaceless_context");
+    if (!surfaceless || !ChooseConfig(0, 0, config)) {
+      DestroyEglContext();
+      return false;
+    }
+  }
+
+  const EGLint contextAttributes[] = {
+    EGL_CONTEXT_MAJOR_VERSION, static_cast<EGLint>(glMajor),
+    EGL_CONTEXT_MINOR_VERSION, static_cast<EGLint>(glMinor),
+    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+    EGL_NONE
+  };
+  eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+  if (eglContext == EGL_NO_CONTEXT) {
+    DestroyEglContext();
+    return false;
+  }
+
+  if (!surfaceless) {
+    const EGLint surfaceAttributes[] = {
+      EGL_WIDTH, static_cast<EGLint>(width),
+      EGL_HEIGHT, static_cast<EGLint>(height),
+      EGL_NONE
+    };
+    eglSurface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttributes);
+    if (eglSurface == EGL_NO_SURFACE) {
+      DestroyEglContext();
+      return false;
+    }
+  }
+  if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+    DestroyEglContext();
+    return false;
+  }
+  return true;
+}
+
+
+bool EglHasSurface()
+{
+  return eglSurface != EGL_NO_SURFACE;
+}
+
+
+void DestroyEglContext()
+{
+  if (eglDisplay == EGL_NO_DISPLAY) {
+    return;
+  }
+  eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  if (eglSurface != EGL_NO_SURFACE) {
+    eglDestroySurface(eglDisplay, eglSurface);
+    eglSurface = EGL_NO_SURFACE;
+  }
+  if (eglContext != EGL_NO_CONTEXT) {
+    eglDestroyContext(eglDisplay, eglContext);
+    eglContext = EGL_NO_CONTEXT;
+  }
+  eglTerminate(eglDisplay);
+  eglDisplay = EGL_NO_DISPLAY;
+}
+
+
+void *EglProcAddress(const char *name)
+{
+  return reinterpret_cast<void *>(eglGetProcAddress(name));
+}
+
+
+void EglSwapBuffers()
+{
+  if (eglSurface != EGL_NO_SURFACE) {
+    eglSwapBuffers(eglDisplay, eglSurface);
+  }
+}
+
+
+void EglSwapInterval(int interval)
+{
+  if (eglDisplay != EGL_NO_DISPLAY) {
+    eglSwapInterval(eglDisplay, interval);
+  }
+}
+
+#else
+
+bool CreateEglContext(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t)
+{
+  return false;
+}
+
+
+void DestroyEglContext()
+{
+}
+
+
+bool EglHasSurface()
+{
+  return false;
+}
+
+
+void *EglProcAddress(const char *)
+{
+  return nullptr;
+}
+
+
+void EglSwapBuffers()
+{
+}
+
+
+void EglSwapInterval(int)
+{
+}
+
+#endif
+} // qengine
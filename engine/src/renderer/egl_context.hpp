@@ -0,0 +1,28 @@
+// Copyright(c) Mario Garcia, MIT License.
+#pragma once
+
+#include <cstdint>
+
+
+namespace qengine {
+
+
+// Offscreen OpenGL context through EGL, for machines without a display. On
+// a pbuffer of width x height with samples MSAA samples where a config has
+// them, else surfaceless where the driver allows, as Mesa does. Only built
+// with Q_HAS_EGL, without it creating fails.
+bool CreateEglContext(uint32_t width, uint32_t height, uint32_t glMajor, uint32_t glMinor,
+  uint32_t samples);
+void DestroyEglContext();
+
+// False when surfaceless, where framebuffer 0 has no storage, and drawing
+// needs a framebuffer of its own.
+bool EglHasSurface();
+
+// For gladLoadGLLoader.
+void *EglProcAddress(const char *name);
+
+// Present the frame on the pbuffer, nothing to do when surfaceless.
+void EglSwapBuffers();
+void EglSwapInterval(int interval);
+} // qengine
@@ -0,0 +1,133 @@
+// Copyright (c) Mario Garcia, MIT License.
+#include "renderer/gpu_buffer.hpp"
+
+#include "memory/memory_tracker.hpp"
+#include "../glad/glad.h"
+
+#include <cstring>
+
+
+namespace qengine {
+
+
+static GLenum ToGLTarget(BufferTarget target)
+{
+  switch (target) {
+    case BufferTarget::Index:   return GL_ELEMENT_ARRAY_BUFFER;
+    case BufferTarget::Uniform: return GL_UNIFORM_BUFFER;
+    case BufferTarget::Storage: return GL_SHADER_STORAGE_BUFFER;
+    default:                    return GL_ARRAY_BUFFER;
+  }
+}
+
+
+static GLenum ToGLUsage(BufferUsage usage)
+{
+  switch (usage) {
+    case BufferUsage::Dynamic: return GL_DYNAMIC_DRAW;
+    case BufferUsage::Stream:  return GL_STREAM_DRAW;
+    default:                   return GL_STATIC_DRAW;
+  }
+}
+
+
+GpuBuffer::GpuBuffer()
+  : handle(0)
+  , target(BufferTarget::Vertex)
+  , size(0)
+  , mapped(nullptr)
+{
+}
+
+
+GpuBuffer::~GpuBuffer()
+{
+  Destroy();
+}
+
+
+// All writes go through GL_COPY_WRITE_BUFFER, so that filling an index buffer
+// does not disturb whichever vertex array object happens to be bound.
+bool GpuBuffer::Create(BufferTarget target, size_t size, BufferUsage usage, const void *data)
+{
+  Destroy();
+  glGenBuffers(1, &handle);
+  if (!handle) {
+    return false;
+  }
+  glBindBuffer(GL_COPY_WRITE_BUFFER, handle);
+  glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), data, ToGLUsage(usage));
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  this->target = target;
+  this->size = size;
+  TrackAllocation(MemoryTag::Renderer, size);
+  return true;
+}
+
+
+void GpuBuffer::Destroy()
+{
+  if (!handle) {
+    return;
+  }
+  if (mapped) {
+    Unmap();
+  }
+  glDeleteBuffers(1, &handle);
+  TrackFree(MemoryTag::Renderer, size);
+  handle = 0;
+  size = 0;
+}
+
+
+void *GpuBuffer::Map(size_t offset, size_t size)
+{
+  if (!handle || mapped || size == 0 || offset + size > this->size) {
+    return nullptr;
+  }
+  glBindBuffer(GL_COPY_WRITE_BUFFER, handle);
+  mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), 
+    static_cast<GLsizeiptr>(size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  return mapped;
+}
+
+
+bool GpuBuffer::Unmap()
+{
+  if (!mapped) {
+    return false;
+  }
+  glBindBuffer(GL_COPY_WRITE_BUFFER, handle);
+  GLboolean intact = glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  mapped = nullptr;
+  return intact == GL_TRUE;
+}
+
+
+bool GpuBuffer::Write(const void *data, size_t size, size_t offset)
+{
+  if (size == 0) {
+    return true;
+  }
+  void *dst = Map(offset, size);
+  if (!dst) {
+    return false;
+  }
+  std::memcpy(dst, data, size);
+  return Unmap();
+}
+
+
+void GpuBuffer::Bind() const
+{
+  glBindBuffer(ToGLTarget(target), handle);
+}
+
+
+void GpuBuffer::BindBase(uint32_t index) const
+{
+  glBindBufferBase(ToGLTarget(target), index, handle);
+}
+} // qengine
@@ -0,0 +1,89 @@
+// Copyright (c) Mario Garcia, MIT License.
+#include "renderer/render_target.hpp"
+
+#include "memory/memory_tracker.hpp"
+#include "../glad/glad.h"
+
+#include <cstddef>
+
+
+namespace qengine {
+
+
+// Both formats take 4 bytes a sample.
+static size_t TextureBytes(const RenderTarget &target)
+{
+  size_t samples = target.samples ? target.samples : 1;
+  return static_cast<size_t>(target.width) * target.height * samples * 4;
+}
+
+
+static uint32_t CreateTexture(GLenum format, uint32_t width, uint32_t height, uint32_t samples)
+{
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+  if (samples) {
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, texture);
+    glTexStorage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, static_cast<GLsizei>(samples), format,
+      static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_TRUE);
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+  } else {
+    // One level only, so the default mipmapped filter would leave it
+    // incomplete for sampling.
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, format, static_cast<GLsizei>(width),
+      static_cast<GLsizei>(height));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+  return texture;
+}
+
+
+bool CreateRenderTarget(RenderTarget &target, uint32_t width, uint32_t height, uint32_t samples)
+{
+  RenderTarget created = { 0, 0, 0, width, height, samples };
+  GLenum textureTarget = samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+  created.colorTexture = CreateTexture(GL_RGBA8, width, height, samples);
+  if (created.colorTexture) {
+    TrackAllocation(MemoryTag::Texture, TextureBytes(created));
+  }
+  created.depthTexture = CreateTexture(GL_DEPTH24_STENCIL8, width, height, samples);
+  if (created.depthTexture) {
+    TrackAllocation(MemoryTag::Texture, TextureBytes(created));
+  }
+
+  glGenFramebuffers(1, &created.framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, created.framebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textureTarget,
+    created.colorTexture, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, textureTarget,
+    created.depthTexture, 0);
+  bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  if (!complete) {
+    DestroyRenderTarget(created);
+    return false;
+  }
+  target = created;
+  return true;
+}
+
+
+void DestroyRenderTarget(RenderTarget &target)
+{
+  if (target.colorTexture) {
+    glDeleteTextures(1, &target.colorTexture);
+    TrackFree(MemoryTag::Texture, TextureBytes(target));
+  }
+  if (target.depthTexture) {
+    glDeleteTextures(1, &target.depthTexture);
+    TrackFree(MemoryTag::Texture, TextureBytes(target));
+  }
+  if (target.framebuffer) {
+    glDeleteFramebuffers(1, &target.framebuffer);
+  }
+  target = RenderTarget();
+}
+} // qengine
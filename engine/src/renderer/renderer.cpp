@@ -3,6 +3,7 @@
 
 #include "../glad/glad.h"
 #include "GLFW/glfw3.h"
+#include "egl_context.hpp"
 
 #include <iostream>
 
@@ -13,37 +14,178 @@ namespace qengine {
 GLFWwindow *window = nullptr;
 
 
-void Engine::Init()
+Engine::Engine()
+  : mode(DisplayMode::Null)
+  , closed(true)
+  , frames(0)
+  , offscreen()
+  , resolved()
 {
-  glfwInit();
+}
+
+
+Engine::~Engine()
+{
+  CloseDisplay();
+  if (jobs.IsRunning()) {
+    math::SetParallelExecutor(nullptr, nullptr);
+    jobs.Stop();
+  }
+}
+
+
+bool Engine::Init(const EngineConfig &config)
+{
+  this->config = config;
+  frameMemory.Create(FrameAllocator::DefaultCapacity, config.frameCount);
+  if (!jobs.IsRunning()) {
+    jobs.Start(config.workerCount);
+    math::SetParallelExecutor(&JobSystem::Executor, &jobs);
+  }
+  CloseDisplay();
+  frames = 0;
+  mode = config.mode;
+
+  switch (mode) {
+    case DisplayMode::Windowed:
+    case DisplayMode::Hidden:
+      if (!OpenWindow()) {
+        std::cout << "Failed to create a window :c\n";
+        mode = DisplayMode::Null;
+        closed = true;
+        return false;
+      }
+      break;
+    case DisplayMode::Headless:
+      if (!OpenHeadless()) {
+        std::cout << "No headless OpenGL context, running without OpenGL\n";
+        mode = DisplayMode::Null;
+      }
+      break;
+    default:
+      break;
+  }
+  closed = false;
+  return true;
+}
+
+
+bool Engine::OpenWindow()
+{
+  if (!glfwInit()) {
+    return false;
+  }
+  glfwDefaultWindowHints();
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, static_cast<int>(config.glMajor));
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, static_cast<int>(config.glMinor));
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  glfwWindowHint(GLFW_SAMPLES, static_cast<int>(config.samples));
+  glfwWindowHint(GLFW_VISIBLE, mode == DisplayMode::Windowed ? GLFW_TRUE : GLFW_FALSE);
+  window = glfwCreateWindow(static_cast<int>(config.width), static_cast<int>(config.height),
+    config.title, nullptr, nullptr);
   if (!window) {
-    glfwWindowHint(GLFW_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_VERSION_MINOR, 4);
-    glfwWindowHint(GLFW_OPENGL_CORE_PROFILE, GLFW_TRUE);
-    window = glfwCreateWindow(1920, 1080, "Quick Engine", nullptr, nullptr);
-    glfwMakeContextCurrent(window);
-    glfwSetWindowUserPointer(window, this);
-  } 
+    glfwTerminate();
+    return false;
+  }
+  glfwMakeContextCurrent(window);
+  glfwSetWindowUserPointer(window, this);
   if (!gladLoadGLLoader((GLADloadproc )glfwGetProcAddress)) {
     std::cout << "Failed to load glad :c\n";
+    CloseDisplay();
+    return false;
+  }
+  glfwSwapInterval(config.vsync ? 1 : 0);
+  return true;
+}
+
+
+bool Engine::OpenHeadless()
+{
+  if (!CreateEglContext(config.width, config.height, config.glMajor, config.glMinor,
+    config.samples)) {
+    return false;
+  }
+  if (!gladLoadGLLoader((GLADloadproc )EglProcAddress)) {
+    std::cout << "Failed to load glad :c\n";
+    DestroyEglContext();
+    return false;
+  }
+  if (!EglHasSurface()) {
+    if (!CreateRenderTarget(offscreen, config.width, config.height, config.samples) ||
+      (config.samples && !CreateRenderTarget(resolved, config.width, config.height, 0))) {
+      std::cout << "Failed to create the offscreen framebuffer :c\n";
+      CloseDisplay();
+      return false;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, offscreen.framebuffer);
+    glViewport(0, 0, static_cast<GLsizei>(config.width), static_cast<GLsizei>(config.height));
   }
+  EglSwapInterval(config.vsync ? 1 : 0);
+  return true;
+}
+
+
+void Engine::CloseDisplay()
+{
+  if (window) {
+    glfwDestroyWindow(window);
+    window = nullptr;
+    glfwTerminate();
+  }
+  DestroyRenderTarget(resolved);
+  DestroyRenderTarget(offscreen);
+  DestroyEglContext();
 }
 
 
 bool Engine::WindowIsRunning()
 {
-  return !glfwWindowShouldClose(window);
+  if (closed || (config.frameLimit && frames >= config.frameLimit)) {
+    return false;
+  }
+  return !window || !glfwWindowShouldClose(window);
 }
 
 
 void Engine::Poll()
 {
-  glfwPollEvents();
+  if (window) {
+    glfwPollEvents();
+  }
 }
 
 
 void Engine::SwapBuffers()
 {
-  glfwSwapBuffers(window);
+  switch (mode) {
+    case DisplayMode::Windowed:
+    case DisplayMode::Hidden:
+      glfwSwapBuffers(window);
+      break;
+    case DisplayMode::Headless:
+      // Surfaceless contexts have nothing to swap, the resolve and the flush
+      // send the frame down all the same, so that timing it means something.
+      if (resolved.framebuffer) {
+        GLint width = static_cast<GLint>(config.width), height = static_cast<GLint>(config.height);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, offscreen.framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolved.framebuffer);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT,
+          GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, offscreen.framebuffer);
+      }
+      glFlush();
+      EglSwapBuffers();
+      break;
+    default:
+      break;
+  }
+  frameMemory.NextFrame();
+  ++frames;
+}
+
+
+void Engine::Close()
+{
+  closed = true;
 }
-} // qengine
\ No newline at end of file
+} // qengine
@@ -0,0 +1,45 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "vector.hpp"
+#include "matrix.hpp"
+
+#include <type_traits>
+
+
+namespace math {
+
+
+// 16 byte aligned variants of Vec4 and Mat4. Use these for storage that is
+// hammered by SIMD code, or mirrors std140 uniform blocks. They behave exactly
+// like the unaligned types, and convert to and from them freely.
+//
+// Over aligned types only get aligned heap storage from operator new as of
+// C++17, so keep that in mind when putting them in containers.
+struct alignas(16) Vec4A : public Vec4 {
+  using Vec4::Vector4;
+
+  Vec4A() : Vec4() { }
+
+  Vec4A(const Vec4 &v) : Vec4(v) { }
+};
+
+
+struct alignas(16) Mat4A : public Mat4 {
+  using Mat4::Matrix4x4;
+
+  Mat4A() : Mat4() { }
+
+  Mat4A(const Mat4 &m) : Mat4(m) { }
+};
+
+
+static_assert(std::is_trivially_copyable<Vec4A>::value && std::is_standard_layout<Vec4A>::value,
+  "Vec4A must be trivially copyable and standard layout.");
+static_assert(std::is_trivially_copyable<Mat4A>::value && std::is_standard_layout<Mat4A>::value,
+  "Mat4A must be trivially copyable and standard layout.");
+static_assert(alignof(Vec4A) == 16 && sizeof(Vec4A) == sizeof(Vec4), "Vec4A must be 16 byte aligned.");
+static_assert(alignof(Mat4A) == 16 && sizeof(Mat4A) == sizeof(Mat4), "Mat4A must be 16 byte aligned.");
+} // jkl
@@ -0,0 +1,196 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../matrix.hpp"
+#include "../vector.hpp"
+#include "../vector_math.hpp"
+#include "../span.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+
+namespace math {
+
+
+// Axis aligned bounding box, stored as its min and max corners. The default
+// box is empty, inverted so that merging anything into it gives that thing
+// back.
+template<typename T>
+struct BoundBox {
+  constexpr BoundBox()
+    : min(std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max())
+    , max(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest())
+  { }
+
+  constexpr BoundBox(const Vector3<T> &min, const Vector3<T> &max)
+    : min(min), max(max)
+  { }
+
+  // Box of half size extent around center.
+  static constexpr BoundBox FromCenterExtent(const Vector3<T> &center, const Vector3<T> &extent) {
+    return BoundBox(center - extent, center + extent);
+  }
+
+  // True if nothing has been merged into the box yet.
+  constexpr bool IsEmpty() const {
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+  }
+
+  constexpr Vector3<T> Center() const {
+    return (min + max) * static_cast<T>(0.5);
+  }
+
+  // Half the size of the box along each axis.
+  constexpr Vector3<T> Extent() const {
+    return (max - min) * static_cast<T>(0.5);
+  }
+
+  constexpr Vector3<T> Size() const {
+    return max - min;
+  }
+
+  // Surface area, the usual cost metric when building bounding volume
+  // hierarchies. Zero for an empty box.
+  constexpr T SurfaceArea() const {
+    return IsEmpty() ? static_cast<T>(0)
+      : static_cast<T>(2) * ((max.x - min.x) * (max.y - min.y)
+        + (max.y - min.y) * (max.z - min.z) + (max.z - min.z) * (max.x - min.x));
+  }
+
+  // Grow the box to hold point.
+  constexpr void Merge(const Vector3<T> &point) {
+    min = math::Min(min, point);
+    max = math::Max(max, point);
+  }
+
+  // Grow the box to hold box.
+  constexpr void Merge(const BoundBox &box) {
+    min = math::Min(min, box.min);
+    max = math::Max(max, box.max);
+  }
+
+  // Points on the surface count as inside.
+  constexpr bool Contains(const Vector3<T> &point) const {
+    return point.x >= min.x && point.x <= max.x
+      && point.y >= min.y && point.y <= max.y
+      && point.z >= min.z && point.z <= max.z;
+  }
+
+  constexpr bool Contains(const BoundBox &box) const {
+    return box.min.x >= min.x && box.max.x <= max.x
+      && box.min.y >= min.y && box.max.y <= max.y
+      && box.min.z >= min.z && box.max.z <= max.z;
+  }
+
+  // Touching boxes intersect.
+  constexpr bool Intersects(const BoundBox &box) const {
+    return min.x <= box.max.x && max.x >= box.min.x
+      && min.y <= box.max.y && max.y >= box.min.y
+      && min.z <= box.max.z && max.z >= box.min.z;
+  }
+
+  Vector3<T> min;
+  Vector3<T> max;
+};
+
+typedef BoundBox<real32> AABB;
+
+
+static_assert(std::is_trivially_copyable<AABB>::value && std::is_standard_layout<AABB>::value,
+  "AABB must be trivially copyable and standard layout.");
+
+
+// Smallest box holding both a and b.
+template<typename T> constexpr
+BoundBox<T> Merge(const BoundBox<T> &a, const BoundBox<T> &b);
+
+// Bounds of box after transforming it by m, an affine matrix for row vectors.
+// Rather than transforming the eight corners, the center is transformed as a
+// point and the extent by the absolute value of the upper 3x3 of m, which
+// gives the same box for a fraction of the work. Empty boxes stay empty.
+template<typename T> constexpr
+BoundBox<T> Transform(const BoundBox<T> &box, const Matrix4x4<T> &m);
+
+
+// Structure of arrays storage for many boxes, e.g. the bounds of every object
+// in a scene. Each corner component lives in its own array, so the batch
+// kernels below, and the culling code, work on FloatN::Width boxes at a time.
+struct AABBArray {
+  AABBArray() { }
+
+  explicit AABBArray(size_t count) {
+    Resize(count);
+  }
+
+  // New boxes are empty.
+  void Resize(size_t count) {
+    AABB empty;
+    minX.resize(count, empty.min.x); minY.resize(count, empty.min.y); minZ.resize(count, empty.min.z);
+    maxX.resize(count, empty.max.x); maxY.resize(count, empty.max.y); maxZ.resize(count, empty.max.z);
+  }
+
+  void Clear() {
+    Resize(0);
+  }
+
+  size_t Size() const {
+    return minX.size();
+  }
+
+  void PushBack(const AABB &box) {
+    minX.push_back(box.min.x); minY.push_back(box.min.y); minZ.push_back(box.min.z);
+    maxX.push_back(box.max.x); maxY.push_back(box.max.y); maxZ.push_back(box.max.z);
+  }
+
+  void Set(size_t i, const AABB &box) {
+    minX[i] = box.min.x; minY[i] = box.min.y; minZ[i] = box.min.z;
+    maxX[i] = box.max.x; maxY[i] = box.max.y; maxZ[i] = box.max.z;
+  }
+
+  AABB Get(size_t i) const {
+    return AABB(Vec3(minX[i], minY[i], minZ[i]), Vec3(maxX[i], maxY[i], maxZ[i]));
+  }
+
+  std::vector<real32> minX, minY, minZ;
+  std::vector<real32> maxX, maxY, maxZ;
+};
+
+
+// Batch kernels over AABBArrays and point arrays, FloatN::Width elements at a
+// time with a scalar tail. Element wise kernels resize out to the size of
+// their first input, and out may be the same array as any input. With
+// parallel set, large batches are split across cores with ParallelFor, see
+// parallel.hpp.
+
+// Bounds of every box in boxes. Empty if boxes is.
+inline AABB MergeBatch(const AABBArray &boxes, bool parallel = false);
+
+// out[i] = Merge(a[i], b[i]). b must be at least as long as a.
+inline void MergeBatch(const AABBArray &a, const AABBArray &b, AABBArray &out,
+  bool parallel = false);
+
+// box grown to hold every point, e.g. the vertices of a mesh. Any stride
+// works, packed arrays of Vec3 take a faster path.
+inline AABB ExpandByPoints(const AABB &box, StridedSpan<const Vec3> points,
+  bool parallel = false);
+
+// Bounds of points, empty if there are none.
+inline AABB FromPoints(StridedSpan<const Vec3> points, bool parallel = false);
+
+// out[i] = Transform(boxes[i], m), every box by the same matrix.
+inline void TransformBatch(const AABBArray &boxes, const Mat4 &m, AABBArray &out,
+  bool parallel = false);
+
+// out[i] = Transform(boxes[i], matrices[i]), e.g. local bounds by world
+// matrices. matrices must hold boxes.Size() matrices.
+inline void TransformBatch(const AABBArray &boxes, const Mat4 *matrices, AABBArray &out,
+  bool parallel = false);
+} // jkl
+
+#include "internal/bound_box.inl"
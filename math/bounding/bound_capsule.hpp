@@ -0,0 +1,114 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../vector.hpp"
+#include "../vector_math.hpp"
+#include "../span.hpp"
+#include "bound_box.hpp"
+#include "bound_sphere.hpp"
+#include "bound_oriented_box.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace math {
+
+
+// Capsule: every point within radius of the segment from start to end, a
+// cylinder with half spheres on its ends. Fits limbs, characters and other
+// long rounded things closely, and is about as cheap to test as a sphere. A
+// negative radius marks an empty capsule, which is what the default
+// constructor gives.
+template<typename T>
+struct BoundCapsule {
+  constexpr BoundCapsule()
+    : start(), end(), radius(-static_cast<T>(1))
+  { }
+
+  constexpr BoundCapsule(const Vector3<T> &start, const Vector3<T> &end, T radius)
+    : start(start), end(end), radius(radius)
+  { }
+
+  constexpr bool IsEmpty() const {
+    return radius < static_cast<T>(0);
+  }
+
+  // Points on the surface count as inside.
+  constexpr bool Contains(const Vector3<T> &point) const;
+
+  constexpr BoundBox<T> ToBoundBox() const;
+
+  // Sphere around the capsule, as loose as a sphere around anything long.
+  constexpr BoundSphere<T> ToBoundSphere() const;
+
+  Vector3<T> start;
+  Vector3<T> end;
+  T radius;
+};
+
+typedef BoundCapsule<real32> Capsule;
+
+
+// Capsule along the principal axis of points, see PrincipalAxes, holding
+// all of them, with its ends pulled in as far as the round caps allow. Empty
+// if there are no points.
+inline Capsule FitCapsule(StridedSpan<const Vec3> points);
+
+// Which side of plane the capsule is on: 1 in front, -1 behind, 0
+// straddling. See bound_sphere.hpp for how planes are stored.
+template<typename T> constexpr
+int32 Classify(const BoundCapsule<T> &capsule, const Vector4<T> &plane);
+
+
+// Structure of arrays storage for many capsules, see AABBArray.
+struct CapsuleArray {
+  CapsuleArray() { }
+
+  explicit CapsuleArray(size_t count) {
+    Resize(count);
+  }
+
+  // New capsules are empty.
+  void Resize(size_t count) {
+    startX.resize(count, 0.0f); startY.resize(count, 0.0f); startZ.resize(count, 0.0f);
+    endX.resize(count, 0.0f); endY.resize(count, 0.0f); endZ.resize(count, 0.0f);
+    radius.resize(count, -1.0f);
+  }
+
+  void Clear() {
+    Resize(0);
+  }
+
+  size_t Size() const {
+    return startX.size();
+  }
+
+  void PushBack(const Capsule &capsule) {
+    startX.push_back(capsule.start.x); startY.push_back(capsule.start.y);
+    startZ.push_back(capsule.start.z);
+    endX.push_back(capsule.end.x); endY.push_back(capsule.end.y); endZ.push_back(capsule.end.z);
+    radius.push_back(capsule.radius);
+  }
+
+  void Set(size_t i, const Capsule &capsule) {
+    startX[i] = capsule.start.x; startY[i] = capsule.start.y; startZ[i] = capsule.start.z;
+    endX[i] = capsule.end.x; endY[i] = capsule.end.y; endZ[i] = capsule.end.z;
+    radius[i] = capsule.radius;
+  }
+
+  Capsule Get(size_t i) const {
+    return Capsule(Vec3(startX[i], startY[i], startZ[i]), Vec3(endX[i], endY[i], endZ[i]),
+      radius[i]);
+  }
+
+  std::vector<real32> startX, startY, startZ;
+  std::vector<real32> endX, endY, endZ;
+  std::vector<real32> radius;
+};
+} // jkl
+
+#include "internal/bound_capsule.inl"
@@ -0,0 +1,112 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../vector.hpp"
+#include "../vector_math.hpp"
+#include "../span.hpp"
+#include "bound_box.hpp"
+#include "bound_sphere.hpp"
+#include "bound_oriented_box.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace math {
+
+
+// Cylinder with flat ends, around the segment from start to end. Fits pipes,
+// poles and columns closely. A negative radius marks an empty cylinder,
+// which is what the default constructor gives.
+template<typename T>
+struct BoundCylinder {
+  constexpr BoundCylinder()
+    : start(), end(), radius(-static_cast<T>(1))
+  { }
+
+  constexpr BoundCylinder(const Vector3<T> &start, const Vector3<T> &end, T radius)
+    : start(start), end(end), radius(radius)
+  { }
+
+  constexpr bool IsEmpty() const {
+    return radius < static_cast<T>(0);
+  }
+
+  // Points on the surface count as inside.
+  constexpr bool Contains(const Vector3<T> &point) const;
+
+  // Smallest AABB around the cylinder, tighter than one around its capsule:
+  // the end discs only reach radius * sqrt(1 - axis_i^2) along world axis i.
+  constexpr BoundBox<T> ToBoundBox() const;
+
+  constexpr BoundSphere<T> ToBoundSphere() const;
+
+  Vector3<T> start;
+  Vector3<T> end;
+  T radius;
+};
+
+typedef BoundCylinder<real32> Cylinder;
+
+
+// Cylinder along the principal axis of points, see PrincipalAxes, holding
+// all of them. Empty if there are no points.
+inline Cylinder FitCylinder(StridedSpan<const Vec3> points);
+
+// Which side of plane the cylinder is on: 1 in front, -1 behind, 0
+// straddling. See bound_sphere.hpp for how planes are stored.
+template<typename T> constexpr
+int32 Classify(const BoundCylinder<T> &cylinder, const Vector4<T> &plane);
+
+
+// Structure of arrays storage for many cylinders, see AABBArray.
+struct CylinderArray {
+  CylinderArray() { }
+
+  explicit CylinderArray(size_t count) {
+    Resize(count);
+  }
+
+  // New cylinders are empty.
+  void Resize(size_t count) {
+    startX.resize(count, 0.0f); startY.resize(count, 0.0f); startZ.resize(count, 0.0f);
+    endX.resize(count, 0.0f); endY.resize(count, 0.0f); endZ.resize(count, 0.0f);
+    radius.resize(count, -1.0f);
+  }
+
+  void Clear() {
+    Resize(0);
+  }
+
+  size_t Size() const {
+    return startX.size();
+  }
+
+  void PushBack(const Cylinder &cylinder) {
+    startX.push_back(cylinder.start.x); startY.push_back(cylinder.start.y);
+    startZ.push_back(cylinder.start.z);
+    endX.push_back(cylinder.end.x); endY.push_back(cylinder.end.y); endZ.push_back(cylinder.end.z);
+    radius.push_back(cylinder.radius);
+  }
+
+  void Set(size_t i, const Cylinder &cylinder) {
+    startX[i] = cylinder.start.x; startY[i] = cylinder.start.y; startZ[i] = cylinder.start.z;
+    endX[i] = cylinder.end.x; endY[i] = cylinder.end.y; endZ[i] = cylinder.end.z;
+    radius[i] = cylinder.radius;
+  }
+
+  Cylinder Get(size_t i) const {
+    return Cylinder(Vec3(startX[i], startY[i], startZ[i]), Vec3(endX[i], endY[i], endZ[i]),
+      radius[i]);
+  }
+
+  std::vector<real32> startX, startY, startZ;
+  std::vector<real32> endX, endY, endZ;
+  std::vector<real32> radius;
+};
+} // jkl
+
+#include "internal/bound_cylinder.inl"
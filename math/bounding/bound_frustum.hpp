@@ -0,0 +1,94 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../matrix.hpp"
+#include "../vector.hpp"
+#include "bound_box.hpp"
+#include "bound_sphere.hpp"
+#include "bound_oriented_box.hpp"
+#include "bound_capsule.hpp"
+#include "bound_cylinder.hpp"
+
+#include <cstddef>
+
+
+namespace math {
+
+
+// View frustum, as six planes facing inwards, stored like the planes of
+// bound_sphere.hpp: Vec4(n.x, n.y, n.z, d) with n of unit length, and the
+// inside in front of every plane.
+template<typename T>
+struct BoundFrustum {
+  enum PlaneIndex {
+    Left, Right, Bottom, Top, Near, Far,
+    PlaneCount
+  };
+
+  // Frustum with every plane zeroed, which holds everything.
+  constexpr BoundFrustum()
+    : planes()
+  { }
+
+  // Extract the planes of a view projection matrix, for row vectors with
+  // -w <= x, y, z <= w in clip space, as made by PerspectiveLH/RH and
+  // LookAtLH/RH, e.g. BoundFrustum(view * projection). The planes of a
+  // projection matrix alone are in view space, and those of world * view *
+  // projection in the object's local space.
+  explicit constexpr BoundFrustum(const Matrix4x4<T> &viewProjection);
+
+  // Points on a plane count as inside.
+  constexpr bool Contains(const Vector3<T> &point) const;
+
+  // True if any part of box may be inside. Conservative: boxes near the
+  // frustum's corners can be reported as intersecting while they are not.
+  constexpr bool Intersects(const BoundBox<T> &box) const;
+
+  // True if any part of sphere may be inside, with the same caveat, which
+  // holds for the volumes below too.
+  constexpr bool Intersects(const BoundSphere<T> &sphere) const;
+
+  constexpr bool Intersects(const BoundOrientedBox<T> &box) const;
+
+  constexpr bool Intersects(const BoundCapsule<T> &capsule) const;
+
+  constexpr bool Intersects(const BoundCylinder<T> &cylinder) const;
+
+  Vector4<T> planes[PlaneCount];
+};
+
+typedef BoundFrustum<real32> Frustum;
+
+
+// Batch frustum culling. Writes the index of every box, or sphere, that
+// intersects frustum to visible, in increasing order, and returns how many
+// there are. visible must have room for every element. Boxes must not be
+// empty, see bound_box.hpp.
+//
+// FloatN::Width elements are tested at once against all six planes, without
+// branches, and the survivors compacted with a move mask. With parallel set,
+// large arrays are split into chunks culled across cores with ParallelFor,
+// see parallel.hpp, then the chunks' lists are moved together.
+inline size_t CullBatch(const Frustum &frustum, const AABBArray &boxes, uint32 *visible,
+  bool parallel = false);
+
+inline size_t CullBatch(const Frustum &frustum, const SphereArray &spheres, uint32 *visible,
+  bool parallel = false);
+
+// The tighter volumes cost more per test, an oriented box most, but cull
+// long thin objects that a box or sphere around them would keep, see
+// bound_oriented_box.hpp, bound_capsule.hpp and bound_cylinder.hpp.
+inline size_t CullBatch(const Frustum &frustum, const OBBArray &boxes, uint32 *visible,
+  bool parallel = false);
+
+inline size_t CullBatch(const Frustum &frustum, const CapsuleArray &capsules, uint32 *visible,
+  bool parallel = false);
+
+inline size_t CullBatch(const Frustum &frustum, const CylinderArray &cylinders, uint32 *visible,
+  bool parallel = false);
+} // jkl
+
+#include "internal/bound_frustum.inl"
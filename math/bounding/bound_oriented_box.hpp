@@ -0,0 +1,142 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../matrix.hpp"
+#include "../vector.hpp"
+#include "../vector_math.hpp"
+#include "../span.hpp"
+#include "bound_box.hpp"
+#include "bound_sphere.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace math {
+
+
+// Oriented bounding box: a box of half size extent around center, along the
+// rows of axes, which are of unit length and perpendicular to each other.
+// Much tighter than an AABB around long thin objects that are not aligned
+// with the world axes. A negative extent marks an empty box, which is what
+// the default constructor gives.
+template<typename T>
+struct BoundOrientedBox {
+  constexpr BoundOrientedBox()
+    : center()
+    , extent(-static_cast<T>(1), -static_cast<T>(1), -static_cast<T>(1))
+    , axes()
+  { }
+
+  constexpr BoundOrientedBox(const Vector3<T> &center, const Vector3<T> &extent,
+    const Matrix3x3<T> &axes)
+    : center(center), extent(extent), axes(axes)
+  { }
+
+  // Same box as an AABB.
+  explicit constexpr BoundOrientedBox(const BoundBox<T> &box)
+    : center(box.Center()), extent(box.Extent()), axes()
+  { }
+
+  constexpr bool IsEmpty() const {
+    return extent.x < static_cast<T>(0);
+  }
+
+  // The box's axis i, 0 to 2.
+  constexpr Vector3<T> Axis(uint32 i) const {
+    return Vector3<T>(axes.data[i][0], axes.data[i][1], axes.data[i][2]);
+  }
+
+  // Points on the surface count as inside.
+  constexpr bool Contains(const Vector3<T> &point) const;
+
+  // Smallest AABB around the box.
+  constexpr BoundBox<T> ToBoundBox() const;
+
+  // Sphere through the box's corners.
+  constexpr BoundSphere<T> ToBoundSphere() const;
+
+  Vector3<T> center;
+  Vector3<T> extent;
+  Matrix3x3<T> axes;
+};
+
+typedef BoundOrientedBox<real32> OBB;
+
+
+// Principal axes of points, the eigenvectors of their covariance matrix, as
+// the rows of the result, from the direction they spread along most to the
+// one they spread along least. Always a rotation. The base of the fits of
+// oriented boxes, capsules and cylinders.
+inline Mat3 PrincipalAxes(StridedSpan<const Vec3> points);
+
+// Box along the principal axes of points, holding all of them. Not the
+// smallest oriented box, but close for the long or flat point sets where an
+// OBB pays off. Empty if there are no points.
+inline OBB FitOrientedBox(StridedSpan<const Vec3> points);
+
+// Which side of plane the box is on: 1 in front, -1 behind, 0 straddling.
+// See bound_sphere.hpp for how planes are stored.
+template<typename T> constexpr
+int32 Classify(const BoundOrientedBox<T> &box, const Vector4<T> &plane);
+
+
+// Structure of arrays storage for many oriented boxes, see AABBArray.
+// axes[r * 3 + c] holds axes.data[r][c] of every box.
+struct OBBArray {
+  OBBArray() { }
+
+  explicit OBBArray(size_t count) {
+    Resize(count);
+  }
+
+  // New boxes are empty.
+  void Resize(size_t count) {
+    OBB empty;
+    centerX.resize(count, 0.0f); centerY.resize(count, 0.0f); centerZ.resize(count, 0.0f);
+    extentX.resize(count, empty.extent.x); extentY.resize(count, empty.extent.y);
+    extentZ.resize(count, empty.extent.z);
+    for (uint32 k = 0; k < 9; ++k) {
+      axes[k].resize(count, empty.axes.data[k / 3][k % 3]);
+    }
+  }
+
+  void Clear() {
+    Resize(0);
+  }
+
+  size_t Size() const {
+    return centerX.size();
+  }
+
+  void PushBack(const OBB &box) {
+    Resize(Size() + 1);
+    Set(Size() - 1, box);
+  }
+
+  void Set(size_t i, const OBB &box) {
+    centerX[i] = box.center.x; centerY[i] = box.center.y; centerZ[i] = box.center.z;
+    extentX[i] = box.extent.x; extentY[i] = box.extent.y; extentZ[i] = box.extent.z;
+    for (uint32 k = 0; k < 9; ++k) {
+      axes[k][i] = box.axes.data[k / 3][k % 3];
+    }
+  }
+
+  OBB Get(size_t i) const {
+    Mat3 m;
+    for (uint32 k = 0; k < 9; ++k) {
+      m.data[k / 3][k % 3] = axes[k][i];
+    }
+    return OBB(Vec3(centerX[i], centerY[i], centerZ[i]), Vec3(extentX[i], extentY[i], extentZ[i]), m);
+  }
+
+  std::vector<real32> centerX, centerY, centerZ;
+  std::vector<real32> extentX, extentY, extentZ;
+  std::vector<real32> axes[9];
+};
+} // jkl
+
+#include "internal/bound_oriented_box.inl"
@@ -0,0 +1,182 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../matrix.hpp"
+#include "../vector.hpp"
+#include "../vector_math.hpp"
+#include "../span.hpp"
+#include "bound_box.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+
+namespace math {
+
+
+// Bounding sphere, 16 bytes for real32. Cheaper to test and to store than a
+// box, but looser around long thin objects. A negative radius marks an empty
+// sphere, which is what the default constructor gives.
+template<typename T>
+struct BoundSphere {
+  constexpr BoundSphere()
+    : center(), radius(-static_cast<T>(1))
+  { }
+
+  constexpr BoundSphere(const Vector3<T> &center, T radius)
+    : center(center), radius(radius)
+  { }
+
+  constexpr bool IsEmpty() const {
+    return radius < static_cast<T>(0);
+  }
+
+  // Points on the surface count as inside.
+  constexpr bool Contains(const Vector3<T> &point) const {
+    return (point - center).LengthSquared() <= radius * radius;
+  }
+
+  constexpr bool Contains(const BoundSphere &sphere) const;
+
+  // Touching spheres intersect, empty ones never do.
+  constexpr bool Intersects(const BoundSphere &sphere) const {
+    T r = radius + sphere.radius;
+    return !IsEmpty() && !sphere.IsEmpty() && (sphere.center - center).LengthSquared() <= r * r;
+  }
+
+  // Grow the sphere just enough to hold point, moving its center towards it.
+  // Not the smallest sphere holding both, but close, and this is the growing
+  // step of the fit below.
+  constexpr void Merge(const Vector3<T> &point);
+
+  // Grow to the smallest sphere holding both spheres.
+  constexpr void Merge(const BoundSphere &sphere);
+
+  // Box around the sphere.
+  constexpr BoundBox<T> ToBoundBox() const {
+    return IsEmpty() ? BoundBox<T>()
+      : BoundBox<T>::FromCenterExtent(center, Vector3<T>(radius, radius, radius));
+  }
+
+  Vector3<T> center;
+  T radius;
+};
+
+typedef BoundSphere<real32> Sphere;
+
+
+static_assert(std::is_trivially_copyable<Sphere>::value && std::is_standard_layout<Sphere>::value,
+  "Sphere must be trivially copyable and standard layout.");
+static_assert(sizeof(Sphere) == 4 * sizeof(real32), "Sphere must be tightly packed.");
+
+
+// Smallest sphere holding both a and b.
+template<typename T> constexpr
+BoundSphere<T> Merge(const BoundSphere<T> &a, const BoundSphere<T> &b);
+
+// Bounds of sphere after transforming it by m, an affine matrix for row
+// vectors. The radius is scaled by a bound on the largest scale of m, so the
+// result stays conservative under non uniform scale, and shears. For
+// rotations and scales the bound is the exact largest scale.
+template<typename T> constexpr
+BoundSphere<T> Transform(const BoundSphere<T> &sphere, const Matrix4x4<T> &m);
+
+// Fit a sphere around points with Ritter's method: start from the most
+// distant pair among the extreme points on each axis, then grow the sphere
+// over every point left outside. Usually within 5-20% of the optimal radius.
+// Each refinement pass shrinks the best sphere so far and grows it back over
+// the points, keeping it if it got smaller, for a few percent more. Empty if
+// there are no points.
+inline Sphere FitSphere(StridedSpan<const Vec3> points, uint32 refinePasses = 0);
+
+
+// Planes are stored as Vec4(n.x, n.y, n.z, d), holding the points p where
+// Dot(n, p) + d = 0, with n of unit length. The side n points to is the front.
+
+// Which side of plane the sphere is on: 1 in front, -1 behind, 0 straddling.
+template<typename T> constexpr
+int32 Classify(const BoundSphere<T> &sphere, const Vector4<T> &plane);
+
+
+// Structure of arrays storage for many spheres, the sphere counterpart of
+// AABBArray, see bound_box.hpp.
+struct SphereArray {
+  SphereArray() { }
+
+  explicit SphereArray(size_t count) {
+    Resize(count);
+  }
+
+  // New spheres are empty.
+  void Resize(size_t count) {
+    x.resize(count, 0.0f);
+    y.resize(count, 0.0f);
+    z.resize(count, 0.0f);
+    radius.resize(count, -1.0f);
+  }
+
+  void Clear() {
+    Resize(0);
+  }
+
+  size_t Size() const {
+    return x.size();
+  }
+
+  void PushBack(const Sphere &sphere) {
+    x.push_back(sphere.center.x);
+    y.push_back(sphere.center.y);
+    z.push_back(sphere.center.z);
+    radius.push_back(sphere.radius);
+  }
+
+  void Set(size_t i, const Sphere &sphere) {
+    x[i] = sphere.center.x; y[i] = sphere.center.y; z[i] = sphere.center.z;
+    radius[i] = sphere.radius;
+  }
+
+  Sphere Get(size_t i) const {
+    return Sphere(Vec3(x[i], y[i], z[i]), radius[i]);
+  }
+
+  std::vector<real32> x, y, z;
+  std::vector<real32> radius;
+};
+
+
+// Batch kernels over SphereArrays, FloatN::Width spheres at a time with a
+// scalar tail. With parallel set, large batches are split across cores with
+// ParallelFor, see parallel.hpp. The kernels writing compacted index lists
+// always run on the calling thread, so the indices come out in order.
+
+// Write the index of every sphere in spheres that intersects sphere to
+// indices, which must have room for spheres.Size() entries. Returns how many
+// were written.
+inline size_t IntersectBatch(const SphereArray &spheres, const Sphere &sphere,
+  uint32 *indices);
+
+// results[i] = a[i] intersects b[i], as 1 or 0. b must be at least as long
+// as a.
+inline void IntersectBatch(const SphereArray &a, const SphereArray &b, uint8 *results,
+  bool parallel = false);
+
+// sides[i] = Classify(spheres[i], plane).
+inline void ClassifyBatch(const SphereArray &spheres, const Vec4 &plane, int8 *sides,
+  bool parallel = false);
+
+// Write the index of every sphere not completely behind plane to indices,
+// which must have room for spheres.Size() entries. Returns how many were
+// written.
+inline size_t InFrontBatch(const SphereArray &spheres, const Vec4 &plane, uint32 *indices);
+
+// out[i] = Transform(spheres[i], matrices[i]). matrices must hold
+// spheres.Size() matrices. out may be spheres.
+inline void TransformBatch(const SphereArray &spheres, const Mat4 *matrices, SphereArray &out,
+  bool parallel = false);
+} // jkl
+
+#include "internal/bound_sphere.inl"
@@ -0,0 +1,122 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../vector.hpp"
+#include "../span.hpp"
+#include "../ray.hpp"
+#include "../wide.hpp"
+#include "bound_box.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+
+namespace math {
+
+
+// One node of a Bvh, 32 bytes so that two share a cache line. Nodes are laid
+// out depth first: the first child of an interior node directly follows it,
+// offset points at the second one.
+struct BvhNode {
+  bool IsLeaf() const {
+    return count != 0;
+  }
+
+  AABB bounds;
+  // First entry in Bvh::primitives for leaves, the second child for interior
+  // nodes.
+  uint32 offset;
+  // Primitives in a leaf, 0 for interior nodes.
+  uint16 count;
+  // Axis the children of an interior node were split along, 0 to 2.
+  uint8 axis;
+  uint8 pad;
+};
+
+static_assert(sizeof(BvhNode) == 32, "BvhNode should fill half a cache line");
+
+
+// Closest hit of a ray against a triangle Bvh. u and v are the barycentric
+// coordinates of the hit, see Intersect in ray.hpp.
+struct RayHit {
+  uint32 primitive;
+  real32 distance;
+  real32 u;
+  real32 v;
+};
+
+
+// Bounding volume hierarchy over primitives given by their boxes, or over
+// triangles. The tree only stores primitive indices, queries hand those back,
+// and the triangle queries take the same positions and indices the tree was
+// built from.
+//
+// Built top down with the surface area heuristic, evaluated over
+// BvhBinCount bins per axis rather than every split, see Build. Traversal
+// keeps a short fixed size stack, the tree is never deeper than MaxDepth.
+struct Bvh {
+  static const uint32 MaxDepth = 64;
+
+  bool Empty() const {
+    return nodes.empty();
+  }
+
+  void Clear() {
+    nodes.clear();
+    primitives.clear();
+  }
+
+  // Build over count primitives with the given boxes. Leaves hold up to
+  // maxLeafSize primitives, more only where no split helps. With parallel set
+  // the two halves of large nodes are built at the same time with
+  // ParallelFor, see parallel.hpp.
+  void Build(const AABB *bounds, size_t count, bool parallel = false, uint32 maxLeafSize = 4);
+
+  // Build over an indexed triangle list, three indices per triangle.
+  void Build(StridedSpan<const Vec3> positions, const uint32 *indices, size_t triangleCount,
+    bool parallel = false, uint32 maxLeafSize = 4);
+
+  // Update the node boxes for primitives that moved, keeping the tree as it
+  // is, in one pass over the nodes. Much cheaper than a rebuild, though the
+  // tree degrades as the primitives move away from where they were built.
+  // Fine for skinned or otherwise deforming meshes, rebuild for anything
+  // that gets rearranged.
+  void Refit(const AABB *bounds);
+
+  void Refit(StridedSpan<const Vec3> positions, const uint32 *indices);
+
+  // Walk every leaf whose box the ray enters within maxDistance, nearest
+  // child first, calling intersect(primitive, maxDistance) for each of its
+  // primitives. intersect returns true on a hit and then lowers maxDistance
+  // to that hit, which prunes the rest of the walk. Returns true if intersect
+  // did.
+  template<typename Intersect>
+  bool Raycast(const Ray3 &ray, real32 &maxDistance, const Intersect &intersect) const;
+
+  // Closest triangle hit within maxDistance.
+  bool Raycast(const Ray3 &ray, StridedSpan<const Vec3> positions, const uint32 *indices,
+    RayHit &hit, real32 maxDistance = std::numeric_limits<real32>::max()) const;
+
+  // Closest triangle hits of FloatN::Width rays at once, walking the tree
+  // once for the whole packet. Only worth it for rays that go the same way,
+  // like neighbouring pixels or texels. Writes hits[lane] for the lanes that
+  // hit and returns them as a mask, see MoveMask.
+  int32 Raycast(const WideRay<FloatN> &rays, StridedSpan<const Vec3> positions,
+    const uint32 *indices, RayHit *hits,
+    real32 maxDistance = std::numeric_limits<real32>::max()) const;
+
+  // Call func(primitive) for every primitive in a leaf that overlaps box.
+  template<typename Func>
+  void Query(const AABB &box, const Func &func) const;
+
+  std::vector<BvhNode> nodes;
+  // Primitive indices, grouped by leaf.
+  std::vector<uint32> primitives;
+};
+} // jkl
+
+#include "internal/bvh.inl"
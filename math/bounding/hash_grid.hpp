@@ -0,0 +1,100 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "spatial_index.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+
+namespace math {
+
+
+// Unbounded uniform grid of loose cells, of which only the occupied ones
+// exist, found through a hash of their coordinates. An object goes in the
+// cell holding its center, and may reach half a cell out of it, so moving an
+// object is O(1), and free while it stays in its cell. Objects larger than
+// that, or too far out for the cell coordinates, 2^20 cells either way of
+// the origin, are kept aside and tested by every query.
+//
+// Suits scenes of many objects of about the same size spread over a large
+// area, with the cell size a little above the size of the common object.
+// Small box queries look up the cells they cover, and rays walk the cells
+// along them. Large box queries and frustum queries go through the occupied
+// cells instead.
+class HashGrid : public SpatialIndex {
+public:
+  explicit HashGrid(real32 cellSize);
+
+  uint32 Insert(const AABB &box) override;
+  void Remove(uint32 handle) override;
+  void Move(uint32 handle, const AABB &box) override;
+  void Clear() override;
+
+  void QueryBox(const AABB &box, std::vector<uint32> &results) const override;
+  void QueryFrustum(const Frustum &frustum, std::vector<uint32> &results) const override;
+  void QueryRay(const Ray3 &ray, real32 maxDistance, std::vector<uint32> &results) const override;
+
+  real32 CellSize() const {
+    return cellSize;
+  }
+
+  // Number of occupied cells.
+  size_t CellCount() const {
+    return cellMap.size();
+  }
+
+private:
+  static const int32 CellRange = 1 << 20;
+  // Cell of the objects kept aside.
+  static const uint32 LargeCell = InvalidIndex - 1;
+
+  struct Cell {
+    int32 x, y, z;
+    uint32 first;
+    // Zero for cells in the free list.
+    uint32 count;
+  };
+
+  // Cell coordinate of v, clamped to the range of the keys.
+  int32 Coordinate(real32 v) const;
+
+  static uint64 Key(int32 x, int32 y, int32 z);
+
+  // True if box is to be kept aside.
+  bool IsLarge(const AABB &box) const;
+
+  // LargeCell if box is to be kept aside, else the cell holding it, created
+  // if needed.
+  uint32 FindCell(const AABB &box);
+
+  // True if box belongs in cell.
+  bool InCell(uint32 cell, const AABB &box) const;
+
+  // Link handle into the cell its box belongs in, or take it off its cell,
+  // giving the cell back once empty.
+  void Attach(uint32 handle);
+  void Detach(uint32 handle);
+
+  AABB LooseBounds(const Cell &cell) const;
+
+  // Call visit(cell) for every occupied cell whose loose bounds may
+  // intersect region.
+  template<typename Visit>
+  void ForCells(const AABB &region, const Visit &visit) const;
+
+  std::vector<Cell> cells;
+  uint32 freeCells;
+  std::unordered_map<uint64, uint32> cellMap;
+  // Loose bounds of every cell made since the last Clear. Cells given back
+  // stay in, so this only ever grows, but rays never walk past it.
+  AABB occupied;
+  uint32 large;
+  real32 cellSize;
+  real32 inverseCellSize;
+};
+} // jkl
+
+#include "internal/hash_grid.inl"
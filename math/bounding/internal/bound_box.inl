@@ -0,0 +1,310 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../bound_box.hpp"
+#include "../../wide.hpp"
+#include "../../wide_vector.hpp"
+#include "../../parallel.hpp"
+
+#include <mutex>
+
+
+namespace math {
+
+
+template<typename T> constexpr
+BoundBox<T> Merge(const BoundBox<T> &a, const BoundBox<T> &b)
+{
+  return BoundBox<T>(Min(a.min, b.min), Max(a.max, b.max));
+}
+
+
+// c' = c * M + t, e' = e * |M|, with M the upper 3x3 of m and t its last row.
+template<typename T> constexpr
+BoundBox<T> Transform(const BoundBox<T> &box, const Matrix4x4<T> &m)
+{
+  if (box.IsEmpty()) {
+    return box;
+  }
+  Vector3<T> c = box.Center();
+  Vector3<T> e = box.Extent();
+  Vector3<T> center(
+    c.x * m.data[0][0] + c.y * m.data[1][0] + c.z * m.data[2][0] + m.data[3][0],
+    c.x * m.data[0][1] + c.y * m.data[1][1] + c.z * m.data[2][1] + m.data[3][1],
+    c.x * m.data[0][2] + c.y * m.data[1][2] + c.z * m.data[2][2] + m.data[3][2]);
+  Vector3<T> extent(
+    e.x * Abs(m.data[0][0]) + e.y * Abs(m.data[1][0]) + e.z * Abs(m.data[2][0]),
+    e.x * Abs(m.data[0][1]) + e.y * Abs(m.data[1][1]) + e.z * Abs(m.data[2][1]),
+    e.x * Abs(m.data[0][2]) + e.y * Abs(m.data[1][2]) + e.z * Abs(m.data[2][2]));
+  return BoundBox<T>::FromCenterExtent(center, extent);
+}
+
+
+namespace detail {
+
+
+// Bounds work is a handful of min/max per element, so only big batches are
+// worth splitting.
+static const size_t BoundsParallelGrain = 16 * 1024;
+
+
+// Runs wide(i) for every full FloatN over [begin, end), and scalar(i) for the
+// leftovers.
+template<typename Wide, typename Scalar> inline
+void BoundsBatchRange(size_t begin, size_t end, const Wide &wide, const Scalar &scalar)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wideEnd = begin + (end - begin) / W * W;
+  size_t i = begin;
+  for (; i < wideEnd; i += W) {
+    wide(i);
+  }
+  for (; i < end; ++i) {
+    scalar(i);
+  }
+}
+
+
+template<typename Wide, typename Scalar> inline
+void BoundsBatch(size_t count, bool parallel, const Wide &wide, const Scalar &scalar)
+{
+  if (!parallel) {
+    BoundsBatchRange(0, count, wide, scalar);
+    return;
+  }
+  ParallelFor(count, BoundsParallelGrain, [&] (size_t begin, size_t end) {
+    BoundsBatchRange(begin, end, wide, scalar);
+  });
+}
+
+
+// Component axis of v, 0 to 2 for x to z.
+inline real32 Axis(const Vec3 &v, uint32 axis)
+{
+  return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+
+// Append base + lane for every lane set in bits. Every lane is written, and
+// the count only moves past the selected ones, which avoids a branch per lane.
+inline void AppendLanes(int32 bits, size_t base, uint32 *indices, size_t &count)
+{
+  for (uint32 l = 0; l < FloatN::Width; ++l) {
+    indices[count] = static_cast<uint32>(base + l);
+    count += static_cast<size_t>((bits >> l) & 1);
+  }
+}
+
+
+// Running min and max corners over FloatN::Width lanes, folded into one box
+// at the end.
+struct WideBoundsAccumulator {
+  WideBoundsAccumulator() {
+    AABB empty;
+    minX = FloatN(empty.min.x); minY = FloatN(empty.min.y); minZ = FloatN(empty.min.z);
+    maxX = FloatN(empty.max.x); maxY = FloatN(empty.max.y); maxZ = FloatN(empty.max.z);
+  }
+
+  void Merge(const FloatN &x0, const FloatN &y0, const FloatN &z0,
+    const FloatN &x1, const FloatN &y1, const FloatN &z1) {
+    minX = Min(minX, x0); minY = Min(minY, y0); minZ = Min(minZ, z0);
+    maxX = Max(maxX, x1); maxY = Max(maxY, y1); maxZ = Max(maxZ, z1);
+  }
+
+  AABB Reduce() const {
+    return AABB(Vec3(ReduceMin(minX), ReduceMin(minY), ReduceMin(minZ)),
+      Vec3(ReduceMax(maxX), ReduceMax(maxY), ReduceMax(maxZ)));
+  }
+
+  FloatN minX, minY, minZ;
+  FloatN maxX, maxY, maxZ;
+};
+
+
+// Reduce [0, count) into one box with range(begin, end), which returns the
+// box of its range. In parallel, every range is merged in under a lock,
+// ranges are large enough for that not to matter.
+template<typename Range> inline
+AABB ReduceBounds(size_t count, bool parallel, const Range &range)
+{
+  if (!parallel) {
+    return range(0, count);
+  }
+  AABB result;
+  std::mutex lock;
+  ParallelFor(count, BoundsParallelGrain, [&] (size_t begin, size_t end) {
+    AABB box = range(begin, end);
+    std::lock_guard<std::mutex> guard(lock);
+    result.Merge(box);
+  });
+  return result;
+}
+
+
+inline AABB MergeBoxesRange(const AABBArray &boxes, size_t begin, size_t end)
+{
+  WideBoundsAccumulator acc;
+  AABB tail;
+  BoundsBatchRange(begin, end,
+    [&] (size_t i) {
+      acc.Merge(FloatN::Load(&boxes.minX[i]), FloatN::Load(&boxes.minY[i]), FloatN::Load(&boxes.minZ[i]),
+        FloatN::Load(&boxes.maxX[i]), FloatN::Load(&boxes.maxY[i]), FloatN::Load(&boxes.maxZ[i]));
+    },
+    [&] (size_t i) {
+      tail.Merge(boxes.Get(i));
+    });
+  return Merge(acc.Reduce(), tail);
+}
+
+
+inline AABB ExpandByPointsRange(StridedSpan<const Vec3> points, size_t begin, size_t end)
+{
+  const uint32 W = FloatN::Width;
+  typedef WideVector3<FloatN> Vec3xN;
+  const bool packed = points.stride == sizeof(Vec3);
+  WideBoundsAccumulator acc;
+  AABB tail;
+  BoundsBatchRange(begin, end,
+    [&] (size_t i) {
+      Vec3xN v;
+      if (packed) {
+        v = Vec3xN::Load(&points[i]);
+      } else {
+        real32 xs[W], ys[W], zs[W];
+        for (uint32 l = 0; l < W; ++l) {
+          const Vec3 &p = points[i + l];
+          xs[l] = p.x; ys[l] = p.y; zs[l] = p.z;
+        }
+        v = Vec3xN::Load(xs, ys, zs);
+      }
+      acc.Merge(v.x, v.y, v.z, v.x, v.y, v.z);
+    },
+    [&] (size_t i) {
+      tail.Merge(points[i]);
+    });
+  return Merge(acc.Reduce(), tail);
+}
+
+
+// Center/extent transform of W boxes, see Transform. The matrix rows are
+// broadcast, or gathered lane by lane for per box matrices. Empty boxes are
+// passed through as they were.
+inline void TransformBoxesWide(const AABBArray &boxes, size_t i, const FloatN m[12],
+  AABBArray &out)
+{
+  FloatN minX = FloatN::Load(&boxes.minX[i]), minY = FloatN::Load(&boxes.minY[i]);
+  FloatN minZ = FloatN::Load(&boxes.minZ[i]), maxX = FloatN::Load(&boxes.maxX[i]);
+  FloatN maxY = FloatN::Load(&boxes.maxY[i]), maxZ = FloatN::Load(&boxes.maxZ[i]);
+  FloatN empty = (minX > maxX) | (minY > maxY) | (minZ > maxZ);
+
+  FloatN half(0.5f);
+  FloatN cx = (minX + maxX) * half, cy = (minY + maxY) * half, cz = (minZ + maxZ) * half;
+  FloatN ex = (maxX - minX) * half, ey = (maxY - minY) * half, ez = (maxZ - minZ) * half;
+
+  FloatN tx = cx * m[0] + cy * m[3] + cz * m[6] + m[9];
+  FloatN ty = cx * m[1] + cy * m[4] + cz * m[7] + m[10];
+  FloatN tz = cx * m[2] + cy * m[5] + cz * m[8] + m[11];
+  FloatN sx = ex * Abs(m[0]) + ey * Abs(m[3]) + ez * Abs(m[6]);
+  FloatN sy = ex * Abs(m[1]) + ey * Abs(m[4]) + ez * Abs(m[7]);
+  FloatN sz = ex * Abs(m[2]) + ey * Abs(m[5]) + ez * Abs(m[8]);
+
+  Select(empty, minX, tx - sx).Store(&out.minX[i]);
+  Select(empty, minY, ty - sy).Store(&out.minY[i]);
+  Select(empty, minZ, tz - sz).Store(&out.minZ[i]);
+  Select(empty, maxX, tx + sx).Store(&out.maxX[i]);
+  Select(empty, maxY, ty + sy).Store(&out.maxY[i]);
+  Select(empty, maxZ, tz + sz).Store(&out.maxZ[i]);
+}
+} // detail
+
+
+inline AABB MergeBatch(const AABBArray &boxes, bool parallel)
+{
+  return detail::ReduceBounds(boxes.Size(), parallel, [&] (size_t begin, size_t end) {
+    return detail::MergeBoxesRange(boxes, begin, end);
+  });
+}
+
+
+inline void MergeBatch(const AABBArray &a, const AABBArray &b, AABBArray &out,
+  bool parallel)
+{
+  out.Resize(a.Size());
+  detail::BoundsBatch(a.Size(), parallel,
+    [&] (size_t i) {
+      Min(FloatN::Load(&a.minX[i]), FloatN::Load(&b.minX[i])).Store(&out.minX[i]);
+      Min(FloatN::Load(&a.minY[i]), FloatN::Load(&b.minY[i])).Store(&out.minY[i]);
+      Min(FloatN::Load(&a.minZ[i]), FloatN::Load(&b.minZ[i])).Store(&out.minZ[i]);
+      Max(FloatN::Load(&a.maxX[i]), FloatN::Load(&b.maxX[i])).Store(&out.maxX[i]);
+      Max(FloatN::Load(&a.maxY[i]), FloatN::Load(&b.maxY[i])).Store(&out.maxY[i]);
+      Max(FloatN::Load(&a.maxZ[i]), FloatN::Load(&b.maxZ[i])).Store(&out.maxZ[i]);
+    },
+    [&] (size_t i) {
+      out.Set(i, Merge(a.Get(i), b.Get(i)));
+    });
+}
+
+
+inline AABB ExpandByPoints(const AABB &box, StridedSpan<const Vec3> points, bool parallel)
+{
+  return Merge(box, detail::ReduceBounds(points.count, parallel, [&] (size_t begin, size_t end) {
+    return detail::ExpandByPointsRange(points, begin, end);
+  }));
+}
+
+
+inline AABB FromPoints(StridedSpan<const Vec3> points, bool parallel)
+{
+  return ExpandByPoints(AABB(), points, parallel);
+}
+
+
+inline void TransformBatch(const AABBArray &boxes, const Mat4 &m, AABBArray &out,
+  bool parallel)
+{
+  FloatN rows[12];
+  for (uint32 r = 0; r < 4; ++r) {
+    for (uint32 c = 0; c < 3; ++c) {
+      rows[r * 3 + c] = FloatN(m.data[r][c]);
+    }
+  }
+  out.Resize(boxes.Size());
+  detail::BoundsBatch(boxes.Size(), parallel,
+    [&] (size_t i) {
+      detail::TransformBoxesWide(boxes, i, rows, out);
+    },
+    [&] (size_t i) {
+      out.Set(i, Transform(boxes.Get(i), m));
+    });
+}
+
+
+inline void TransformBatch(const AABBArray &boxes, const Mat4 *matrices, AABBArray &out,
+  bool parallel)
+{
+  const uint32 W = FloatN::Width;
+  out.Resize(boxes.Size());
+  detail::BoundsBatch(boxes.Size(), parallel,
+    [&] (size_t i) {
+      real32 lanes[12][W];
+      for (uint32 l = 0; l < W; ++l) {
+        const Mat4 &m = matrices[i + l];
+        for (uint32 r = 0; r < 4; ++r) {
+          lanes[r * 3 + 0][l] = m.data[r][0];
+          lanes[r * 3 + 1][l] = m.data[r][1];
+          lanes[r * 3 + 2][l] = m.data[r][2];
+        }
+      }
+      FloatN rows[12];
+      for (uint32 k = 0; k < 12; ++k) {
+        rows[k] = FloatN::Load(lanes[k]);
+      }
+      detail::TransformBoxesWide(boxes, i, rows, out);
+    },
+    [&] (size_t i) {
+      out.Set(i, Transform(boxes.Get(i), matrices[i]));
+    });
+}
+} // jkl
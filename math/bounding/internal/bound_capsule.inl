@@ -0,0 +1,86 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../bound_capsule.hpp"
+
+#include <limits>
+
+
+namespace math {
+
+
+template<typename T>
+constexpr bool BoundCapsule<T>::Contains(const Vector3<T> &point) const
+{
+  Vector3<T> axis = end - start;
+  T lengthSq = axis.LengthSquared();
+  T t = lengthSq > static_cast<T>(0) ? Dot(point - start, axis) / lengthSq : static_cast<T>(0);
+  t = t < static_cast<T>(0) ? static_cast<T>(0) : (t > static_cast<T>(1) ? static_cast<T>(1) : t);
+  return (point - (start + axis * t)).LengthSquared() <= radius * radius;
+}
+
+
+template<typename T>
+constexpr BoundBox<T> BoundCapsule<T>::ToBoundBox() const
+{
+  if (IsEmpty()) {
+    return BoundBox<T>();
+  }
+  Vector3<T> r(radius, radius, radius);
+  return BoundBox<T>(Min(start, end) - r, Max(start, end) + r);
+}
+
+
+template<typename T>
+constexpr BoundSphere<T> BoundCapsule<T>::ToBoundSphere() const
+{
+  return IsEmpty() ? BoundSphere<T>()
+    : BoundSphere<T>((start + end) * static_cast<T>(0.5),
+        static_cast<T>(Sqrt((end - start).LengthSquared())) * static_cast<T>(0.5) + radius);
+}
+
+
+// Only the end nearest the plane and the one furthest from it matter, the
+// capsule reaches radius past either.
+template<typename T> constexpr
+int32 Classify(const BoundCapsule<T> &capsule, const Vector4<T> &plane)
+{
+  T d0 = plane.x * capsule.start.x + plane.y * capsule.start.y + plane.z * capsule.start.z + plane.w;
+  T d1 = plane.x * capsule.end.x + plane.y * capsule.end.y + plane.z * capsule.end.z + plane.w;
+  T nearest = d0 < d1 ? d0 : d1;
+  T furthest = d0 < d1 ? d1 : d0;
+  return nearest > capsule.radius ? 1 : (furthest < -capsule.radius ? -1 : 0);
+}
+
+
+// With r the radius, a point at distance d from the axis and t along it is
+// inside while it is within sqrt(r^2 - d^2) of the segment along the axis,
+// which bounds how far in each end can move.
+inline Capsule FitCapsule(StridedSpan<const Vec3> points)
+{
+  if (points.count == 0) {
+    return Capsule();
+  }
+  Vec3 origin, axis;
+  real32 radiusSq;
+  detail::FitAxisLine(points, origin, axis, radiusSq);
+  real32 low = std::numeric_limits<real32>::max();
+  real32 high = std::numeric_limits<real32>::lowest();
+  for (size_t i = 0; i < points.count; ++i) {
+    Vec3 d = points[i] - origin;
+    real32 t = Dot(d, axis);
+    real32 slackSq = radiusSq - (d - axis * t).LengthSquared();
+    real32 slack = slackSq > 0.0f ? static_cast<real32>(Sqrt(slackSq)) : 0.0f;
+    low = t + slack < low ? t + slack : low;
+    high = t - slack > high ? t - slack : high;
+  }
+  // Short point sets fit inside one sphere, where both ends meet.
+  if (low > high) {
+    low = high = (low + high) * 0.5f;
+  }
+  return Capsule(origin + axis * low, origin + axis * high,
+    static_cast<real32>(Sqrt(radiusSq)) + detail::FitPadding(points));
+}
+} // jkl
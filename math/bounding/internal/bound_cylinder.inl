@@ -0,0 +1,94 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../bound_cylinder.hpp"
+
+#include <limits>
+
+
+namespace math {
+
+
+// Measured from the nearest point on the axis, as the capsule does, rather
+// than by taking the squared distance along the axis away from the squared
+// distance to start, which cancels the radial part away for long cylinders.
+template<typename T>
+constexpr bool BoundCylinder<T>::Contains(const Vector3<T> &point) const
+{
+  Vector3<T> axis = end - start;
+  T lengthSq = axis.LengthSquared();
+  T t = lengthSq > static_cast<T>(0) ? Dot(point - start, axis) / lengthSq : static_cast<T>(0);
+  if (t < static_cast<T>(0) || t > static_cast<T>(1)) {
+    return false;
+  }
+  return (point - (start + axis * t)).LengthSquared() <= radius * radius;
+}
+
+
+template<typename T>
+constexpr BoundBox<T> BoundCylinder<T>::ToBoundBox() const
+{
+  if (IsEmpty()) {
+    return BoundBox<T>();
+  }
+  Vector3<T> axis = end - start;
+  T lengthSq = axis.LengthSquared();
+  Vector3<T> e(radius, radius, radius);
+  if (lengthSq > static_cast<T>(0)) {
+    Vector3<T> a2 = axis * axis * (static_cast<T>(1) / lengthSq);
+    T one = static_cast<T>(1);
+    e = Vector3<T>(
+      radius * static_cast<T>(Sqrt(a2.x < one ? one - a2.x : static_cast<T>(0))),
+      radius * static_cast<T>(Sqrt(a2.y < one ? one - a2.y : static_cast<T>(0))),
+      radius * static_cast<T>(Sqrt(a2.z < one ? one - a2.z : static_cast<T>(0))));
+  }
+  return BoundBox<T>(Min(start, end) - e, Max(start, end) + e);
+}
+
+
+template<typename T>
+constexpr BoundSphere<T> BoundCylinder<T>::ToBoundSphere() const
+{
+  return IsEmpty() ? BoundSphere<T>()
+    : BoundSphere<T>((start + end) * static_cast<T>(0.5),
+        static_cast<T>(Sqrt((end - start).LengthSquared() * static_cast<T>(0.25) + radius * radius)));
+}
+
+
+// Like the capsule, but the end discs only reach radius * sqrt(1 - c^2)
+// towards the plane, with c the cosine between the axis and its normal.
+template<typename T> constexpr
+int32 Classify(const BoundCylinder<T> &cylinder, const Vector4<T> &plane)
+{
+  T d0 = plane.x * cylinder.start.x + plane.y * cylinder.start.y + plane.z * cylinder.start.z + plane.w;
+  T d1 = plane.x * cylinder.end.x + plane.y * cylinder.end.y + plane.z * cylinder.end.z + plane.w;
+  T lengthSq = (cylinder.end - cylinder.start).LengthSquared();
+  T r = cylinder.radius;
+  if (lengthSq > static_cast<T>(0)) {
+    T cosSq = (d1 - d0) * (d1 - d0) / lengthSq;
+    r *= static_cast<T>(Sqrt(cosSq < static_cast<T>(1) ? static_cast<T>(1) - cosSq : static_cast<T>(0)));
+  }
+  T nearest = d0 < d1 ? d0 : d1;
+  T furthest = d0 < d1 ? d1 : d0;
+  return nearest > r ? 1 : (furthest < -r ? -1 : 0);
+}
+
+
+inline Cylinder FitCylinder(StridedSpan<const Vec3> points)
+{
+  if (points.count == 0) {
+    return Cylinder();
+  }
+  Vec3 origin, axis;
+  real32 radiusSq;
+  detail::FitAxisLine(points, origin, axis, radiusSq);
+  real32 low, high;
+  detail::ProjectPoints(points, axis, low, high);
+  real32 pad = detail::FitPadding(points);
+  // The line's origin lies on the plane through zero across the axis.
+  return Cylinder(origin + axis * (low - pad), origin + axis * (high + pad),
+    static_cast<real32>(Sqrt(radiusSq)) + pad);
+}
+} // jkl
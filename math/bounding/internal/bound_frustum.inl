@@ -0,0 +1,380 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../bound_frustum.hpp"
+#include "../../wide.hpp"
+#include "../../parallel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+namespace math {
+
+
+// Gribb and Hartmann. With row vectors clip = v * m, so clip.x is v dotted
+// with the first column of m, and -w <= x is Dot(v, column3 + column0) >= 0,
+// which is the left plane. The others follow the same way.
+template<typename T>
+constexpr BoundFrustum<T>::BoundFrustum(const Matrix4x4<T> &viewProjection)
+  : planes()
+{
+  const T (*m)[4] = viewProjection.data;
+  for (uint32 p = 0; p < PlaneCount; ++p) {
+    uint32 column = p / 2;
+    T sign = (p % 2 == 0) ? static_cast<T>(1) : -static_cast<T>(1);
+    Vector4<T> plane(
+      m[0][3] + sign * m[0][column],
+      m[1][3] + sign * m[1][column],
+      m[2][3] + sign * m[2][column],
+      m[3][3] + sign * m[3][column]);
+    T length = static_cast<T>(Sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z));
+    planes[p] = plane * (static_cast<T>(1) / length);
+  }
+}
+
+
+template<typename T>
+constexpr bool BoundFrustum<T>::Contains(const Vector3<T> &point) const
+{
+  for (uint32 p = 0; p < PlaneCount; ++p) {
+    const Vector4<T> &n = planes[p];
+    if (n.x * point.x + n.y * point.y + n.z * point.z + n.w < static_cast<T>(0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+// Only the corner furthest along each plane's normal needs testing.
+template<typename T>
+constexpr bool BoundFrustum<T>::Intersects(const BoundBox<T> &box) const
+{
+  for (uint32 p = 0; p < PlaneCount; ++p) {
+    const Vector4<T> &n = planes[p];
+    T x = n.x >= static_cast<T>(0) ? box.max.x : box.min.x;
+    T y = n.y >= static_cast<T>(0) ? box.max.y : box.min.y;
+    T z = n.z >= static_cast<T>(0) ? box.max.z : box.min.z;
+    if (n.x * x + n.y * y + n.z * z + n.w < static_cast<T>(0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+template<typename T>
+constexpr bool BoundFrustum<T>::Intersects(const BoundSphere<T> &sphere) const
+{
+  for (uint32 p = 0; p < PlaneCount; ++p) {
+    const Vector4<T> &n = planes[p];
+    const Vector3<T> &c = sphere.center;
+    if (n.x * c.x + n.y * c.y + n.z * c.z + n.w < -sphere.radius) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+template<typename T>
+constexpr bool BoundFrustum<T>::Intersects(const BoundOrientedBox<T> &box) const
+{
+  for (uint32 p = 0; p < PlaneCount; ++p) {
+    if (Classify(box, planes[p]) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+template<typename T>
+constexpr bool BoundFrustum<T>::Intersects(const BoundCapsule<T> &capsule) const
+{
+  for (uint32 p = 0; p < PlaneCount; ++p) {
+    if (Classify(capsule, planes[p]) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+template<typename T>
+constexpr bool BoundFrustum<T>::Intersects(const BoundCylinder<T> &cylinder) const
+{
+  for (uint32 p = 0; p < PlaneCount; ++p) {
+    if (Classify(cylinder, planes[p]) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+namespace detail {
+
+
+// Elements per chunk when culling in parallel, each chunk writes its list to
+// its own part of the output first.
+static const size_t CullChunkSize = 16 * 1024;
+
+
+// A frustum plane broadcast to every lane, and for boxes, the arrays holding
+// the corner furthest along its normal.
+struct WideCullPlane {
+  FloatN nx, ny, nz, d;
+  const real32 *xs, *ys, *zs;
+};
+
+
+// Planes only, for volumes that load their own data.
+inline void BroadcastPlanes(const Frustum &frustum, WideCullPlane *planes)
+{
+  for (uint32 p = 0; p < Frustum::PlaneCount; ++p) {
+    const Vec4 &n = frustum.planes[p];
+    WideCullPlane &plane = planes[p];
+    plane.nx = FloatN(n.x); plane.ny = FloatN(n.y); plane.nz = FloatN(n.z);
+    plane.d = FloatN(n.w);
+    plane.xs = plane.ys = plane.zs = nullptr;
+  }
+}
+
+
+struct BoxCuller {
+  BoxCuller(const Frustum &frustum, const AABBArray &boxes)
+    : boxes(boxes) {
+    for (uint32 p = 0; p < Frustum::PlaneCount; ++p) {
+      const Vec4 &n = frustum.planes[p];
+      WideCullPlane &plane = planes[p];
+      plane.nx = FloatN(n.x); plane.ny = FloatN(n.y); plane.nz = FloatN(n.z);
+      plane.d = FloatN(n.w);
+      plane.xs = n.x >= 0.0f ? boxes.maxX.data() : boxes.minX.data();
+      plane.ys = n.y >= 0.0f ? boxes.maxY.data() : boxes.minY.data();
+      plane.zs = n.z >= 0.0f ? boxes.maxZ.data() : boxes.minZ.data();
+    }
+  }
+
+  int32 Wide(size_t i) const {
+    FloatN zero(0.0f);
+    FloatN inside = FloatN::True();
+    for (uint32 p = 0; p < Frustum::PlaneCount; ++p) {
+      const WideCullPlane &plane = planes[p];
+      FloatN distance = plane.nx * FloatN::Load(plane.xs + i) + plane.ny * FloatN::Load(plane.ys + i)
+        + plane.nz * FloatN::Load(plane.zs + i) + plane.d;
+      inside = inside & (distance >= zero);
+    }
+    return MoveMask(inside);
+  }
+
+  bool Scalar(const Frustum &frustum, size_t i) const {
+    return frustum.Intersects(boxes.Get(i));
+  }
+
+  const AABBArray &boxes;
+  WideCullPlane planes[Frustum::PlaneCount];
+};
+
+
+struct SphereCuller {
+  SphereCuller(const Frustum &frustum, const SphereArray &spheres)
+    : spheres(spheres) {
+    BroadcastPlanes(frustum, planes);
+  }
+
+  int32 Wide(size_t i) const {
+    FloatN x = FloatN::Load(&spheres.x[i]), y = FloatN::Load(&spheres.y[i]);
+    FloatN z = FloatN::Load(&spheres.z[i]);
+    FloatN negRadius = FloatN(0.0f) - FloatN::Load(&spheres.radius[i]);
+    FloatN inside = FloatN::True();
+    for (uint32 p = 0; p < Frustum::PlaneCount; ++p) {
+      const WideCullPlane &plane = planes[p];
+      FloatN distance = plane.nx * x + plane.ny * y + plane.nz * z + plane.d;
+      inside = inside & (distance >= negRadius);
+    }
+    return MoveMask(inside);
+  }
+
+  bool Scalar(const Frustum &frustum, size_t i) const {
+    return frustum.Intersects(spheres.Get(i));
+  }
+
+  const SphereArray &spheres;
+  WideCullPlane planes[Frustum::PlaneCount];
+};
+
+
+struct OBBCuller {
+  OBBCuller(const Frustum &frustum, const OBBArray &boxes)
+    : boxes(boxes) {
+    BroadcastPlanes(frustum, planes);
+  }
+
+  int32 Wide(size_t i) const {
+    FloatN cx = FloatN::Load(&boxes.centerX[i]), cy = FloatN::Load(&boxes.centerY[i]);
+    FloatN cz = FloatN::Load(&boxes.centerZ[i]);
+    FloatN ex = FloatN::Load(&boxes.extentX[i]), ey = FloatN::Load(&boxes.extentY[i]);
+    FloatN ez = FloatN::Load(&boxes.extentZ[i]);
+    FloatN m[9];
+    for (uint32 k = 0; k < 9; ++k) {
+      m[k] = FloatN::Load(&boxes.axes[k][i]);
+    }
+    FloatN zero(0.0f);
+    FloatN inside = FloatN::True();
+    for (uint32 p = 0; p < Frustum::PlaneCount; ++p) {
+      const WideCullPlane &plane = planes[p];
+      FloatN r = ex * Abs(plane.nx * m[0] + plane.ny * m[1] + plane.nz * m[2])
+        + ey * Abs(plane.nx * m[3] + plane.ny * m[4] + plane.nz * m[5])
+        + ez * Abs(plane.nx * m[6] + plane.ny * m[7] + plane.nz * m[8]);
+      FloatN distance = plane.nx * cx + plane.ny * cy + plane.nz * cz + plane.d;
+      inside = inside & (distance >= zero - r);
+    }
+    return MoveMask(inside);
+  }
+
+  bool Scalar(const Frustum &frustum, size_t i) const {
+    return frustum.Intersects(boxes.Get(i));
+  }
+
+  const OBBArray &boxes;
+  WideCullPlane planes[Frustum::PlaneCount];
+};
+
+
+// Capsules and cylinders: the end furthest along a plane's normal has to
+// reach within radius of it, for cylinders scaled down by how far the end
+// discs tilt towards the plane.
+template<typename Array, bool Discs>
+struct SegmentCuller {
+  SegmentCuller(const Frustum &frustum, const Array &segments)
+    : segments(segments) {
+    BroadcastPlanes(frustum, planes);
+  }
+
+  int32 Wide(size_t i) const {
+    FloatN ax = FloatN::Load(&segments.startX[i]), ay = FloatN::Load(&segments.startY[i]);
+    FloatN az = FloatN::Load(&segments.startZ[i]);
+    FloatN bx = FloatN::Load(&segments.endX[i]), by = FloatN::Load(&segments.endY[i]);
+    FloatN bz = FloatN::Load(&segments.endZ[i]);
+    FloatN radius = FloatN::Load(&segments.radius[i]);
+    FloatN zero(0.0f);
+    FloatN one(1.0f);
+    FloatN invLengthSq;
+    if (Discs) {
+      FloatN dx = bx - ax, dy = by - ay, dz = bz - az;
+      FloatN lengthSq = dx * dx + dy * dy + dz * dz;
+      invLengthSq = Select(lengthSq > zero, one / Max(lengthSq, FloatN(1e-30f)), zero);
+    }
+    FloatN inside = FloatN::True();
+    for (uint32 p = 0; p < Frustum::PlaneCount; ++p) {
+      const WideCullPlane &plane = planes[p];
+      FloatN d0 = plane.nx * ax + plane.ny * ay + plane.nz * az + plane.d;
+      FloatN d1 = plane.nx * bx + plane.ny * by + plane.nz * bz + plane.d;
+      FloatN r = radius;
+      if (Discs) {
+        FloatN c = d1 - d0;
+        r = radius * Sqrt(Max(one - c * c * invLengthSq, zero));
+      }
+      inside = inside & (Max(d0, d1) >= zero - r);
+    }
+    return MoveMask(inside);
+  }
+
+  bool Scalar(const Frustum &frustum, size_t i) const {
+    return frustum.Intersects(segments.Get(i));
+  }
+
+  const Array &segments;
+  WideCullPlane planes[Frustum::PlaneCount];
+};
+
+
+// Cull [begin, end), writing the visible indices from visible[0] on. Returns
+// how many were written.
+template<typename Culler> inline
+size_t CullRange(const Frustum &frustum, const Culler &culler, size_t begin, size_t end,
+  uint32 *visible)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wideEnd = begin + (end - begin) / W * W;
+  size_t written = 0;
+  size_t i = begin;
+  for (; i < wideEnd; i += W) {
+    AppendLanes(culler.Wide(i), i, visible, written);
+  }
+  for (; i < end; ++i) {
+    visible[written] = static_cast<uint32>(i);
+    written += culler.Scalar(frustum, i) ? 1 : 0;
+  }
+  return written;
+}
+
+
+template<typename Culler> inline
+size_t Cull(const Frustum &frustum, const Culler &culler, size_t count, uint32 *visible,
+  bool parallel)
+{
+  const size_t chunks = (count + CullChunkSize - 1) / CullChunkSize;
+  if (!parallel || chunks < 2) {
+    return CullRange(frustum, culler, 0, count, visible);
+  }
+  std::vector<size_t> written(chunks);
+  ParallelFor(chunks, 1, [&] (size_t begin, size_t end) {
+    for (size_t chunk = begin; chunk < end; ++chunk) {
+      size_t first = chunk * CullChunkSize;
+      written[chunk] = CullRange(frustum, culler, first,
+        std::min(count, first + CullChunkSize), visible + first);
+    }
+  });
+  size_t total = written[0];
+  for (size_t chunk = 1; chunk < chunks; ++chunk) {
+    std::memmove(visible + total, visible + chunk * CullChunkSize, written[chunk] * sizeof(uint32));
+    total += written[chunk];
+  }
+  return total;
+}
+} // detail
+
+
+inline size_t CullBatch(const Frustum &frustum, const AABBArray &boxes, uint32 *visible,
+  bool parallel)
+{
+  return detail::Cull(frustum, detail::BoxCuller(frustum, boxes), boxes.Size(), visible, parallel);
+}
+
+
+inline size_t CullBatch(const Frustum &frustum, const SphereArray &spheres, uint32 *visible,
+  bool parallel)
+{
+  return detail::Cull(frustum, detail::SphereCuller(frustum, spheres), spheres.Size(), visible,
+    parallel);
+}
+
+
+inline size_t CullBatch(const Frustum &frustum, const OBBArray &boxes, uint32 *visible,
+  bool parallel)
+{
+  return detail::Cull(frustum, detail::OBBCuller(frustum, boxes), boxes.Size(), visible, parallel);
+}
+
+
+inline size_t CullBatch(const Frustum &frustum, const CapsuleArray &capsules, uint32 *visible,
+  bool parallel)
+{
+  return detail::Cull(frustum, detail::SegmentCuller<CapsuleArray, false>(frustum, capsules),
+    capsules.Size(), visible, parallel);
+}
+
+
+inline size_t CullBatch(const Frustum &frustum, const CylinderArray &cylinders, uint32 *visible,
+  bool parallel)
+{
+  return detail::Cull(frustum, detail::SegmentCuller<CylinderArray, true>(frustum, cylinders),
+    cylinders.Size(), visible, parallel);
+}
+} // jkl
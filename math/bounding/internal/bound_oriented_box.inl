@@ -0,0 +1,220 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../bound_oriented_box.hpp"
+
+#include <cmath>
+#include <limits>
+
+
+namespace math {
+
+
+template<typename T>
+constexpr bool BoundOrientedBox<T>::Contains(const Vector3<T> &point) const
+{
+  Vector3<T> d = point - center;
+  return Abs(Dot(d, Axis(0))) <= extent.x && Abs(Dot(d, Axis(1))) <= extent.y
+    && Abs(Dot(d, Axis(2))) <= extent.z;
+}
+
+
+// Extent along world axis j is the sum of the box's extents projected onto
+// it, like Transform does for AABBs.
+template<typename T>
+constexpr BoundBox<T> BoundOrientedBox<T>::ToBoundBox() const
+{
+  if (IsEmpty()) {
+    return BoundBox<T>();
+  }
+  const T (*m)[3] = axes.data;
+  Vector3<T> e(
+    extent.x * Abs(m[0][0]) + extent.y * Abs(m[1][0]) + extent.z * Abs(m[2][0]),
+    extent.x * Abs(m[0][1]) + extent.y * Abs(m[1][1]) + extent.z * Abs(m[2][1]),
+    extent.x * Abs(m[0][2]) + extent.y * Abs(m[1][2]) + extent.z * Abs(m[2][2]));
+  return BoundBox<T>::FromCenterExtent(center, e);
+}
+
+
+template<typename T>
+constexpr BoundSphere<T> BoundOrientedBox<T>::ToBoundSphere() const
+{
+  return IsEmpty() ? BoundSphere<T>()
+    : BoundSphere<T>(center, static_cast<T>(Sqrt(extent.LengthSquared())));
+}
+
+
+// The box reaches r = sum of extent_i * |Dot(n, axis_i)| towards the plane
+// from its center.
+template<typename T> constexpr
+int32 Classify(const BoundOrientedBox<T> &box, const Vector4<T> &plane)
+{
+  const T (*m)[3] = box.axes.data;
+  T r = box.extent.x * Abs(plane.x * m[0][0] + plane.y * m[0][1] + plane.z * m[0][2])
+    + box.extent.y * Abs(plane.x * m[1][0] + plane.y * m[1][1] + plane.z * m[1][2])
+    + box.extent.z * Abs(plane.x * m[2][0] + plane.y * m[2][1] + plane.z * m[2][2]);
+  T distance = plane.x * box.center.x + plane.y * box.center.y + plane.z * box.center.z + plane.w;
+  return distance > r ? 1 : (distance < -r ? -1 : 0);
+}
+
+
+namespace detail {
+
+
+// Jacobi eigenvalue iteration on a symmetric 3x3 matrix: rotate away the
+// largest off diagonal element until none are left, which at this size takes
+// a handful of steps. a ends up diagonal, holding the eigenvalues, and the
+// columns of v the eigenvectors.
+inline void SymmetricEigen(double a[3][3], double v[3][3])
+{
+  for (uint32 r = 0; r < 3; ++r) {
+    for (uint32 c = 0; c < 3; ++c) {
+      v[r][c] = r == c ? 1.0 : 0.0;
+    }
+  }
+  for (uint32 step = 0; step < 32; ++step) {
+    uint32 p = 0, q = 1;
+    if (std::fabs(a[0][2]) > std::fabs(a[p][q])) { p = 0; q = 2; }
+    if (std::fabs(a[1][2]) > std::fabs(a[p][q])) { p = 1; q = 2; }
+    double diagonal = std::fabs(a[0][0]) + std::fabs(a[1][1]) + std::fabs(a[2][2]);
+    if (std::fabs(a[p][q]) <= 1e-12 * diagonal || a[p][q] == 0.0) {
+      break;
+    }
+    double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+    double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+    double c = 1.0 / std::sqrt(t * t + 1.0);
+    double s = t * c;
+    for (uint32 k = 0; k < 3; ++k) {
+      double akp = a[k][p], akq = a[k][q];
+      a[k][p] = c * akp - s * akq;
+      a[k][q] = s * akp + c * akq;
+    }
+    for (uint32 k = 0; k < 3; ++k) {
+      double apk = a[p][k], aqk = a[q][k];
+      a[p][k] = c * apk - s * aqk;
+      a[q][k] = s * apk + c * aqk;
+    }
+    for (uint32 k = 0; k < 3; ++k) {
+      double vkp = v[k][p], vkq = v[k][q];
+      v[k][p] = c * vkp - s * vkq;
+      v[k][q] = s * vkp + c * vkq;
+    }
+  }
+}
+
+
+// Smallest and largest projection of points onto axis.
+inline void ProjectPoints(StridedSpan<const Vec3> points, const Vec3 &axis, real32 &min,
+  real32 &max)
+{
+  min = std::numeric_limits<real32>::max();
+  max = std::numeric_limits<real32>::lowest();
+  for (size_t i = 0; i < points.count; ++i) {
+    real32 t = Dot(points[i], axis);
+    min = t < min ? t : min;
+    max = t > max ? t : max;
+  }
+}
+} // detail
+
+
+// Covariance in double, around the mean, since positions far from the
+// origin would otherwise lose the spread in rounding.
+inline Mat3 PrincipalAxes(StridedSpan<const Vec3> points)
+{
+  if (points.count == 0) {
+    return Mat3();
+  }
+  double mean[3] = { 0.0, 0.0, 0.0 };
+  for (size_t i = 0; i < points.count; ++i) {
+    const Vec3 &p = points[i];
+    mean[0] += p.x; mean[1] += p.y; mean[2] += p.z;
+  }
+  for (uint32 k = 0; k < 3; ++k) {
+    mean[k] /= static_cast<double>(points.count);
+  }
+  double covariance[3][3] = { { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+  for (size_t i = 0; i < points.count; ++i) {
+    const Vec3 &p = points[i];
+    double d[3] = { p.x - mean[0], p.y - mean[1], p.z - mean[2] };
+    for (uint32 r = 0; r < 3; ++r) {
+      for (uint32 c = r; c < 3; ++c) {
+        covariance[r][c] += d[r] * d[c];
+      }
+    }
+  }
+  covariance[1][0] = covariance[0][1];
+  covariance[2][0] = covariance[0][2];
+  covariance[2][1] = covariance[1][2];
+
+  double vectors[3][3];
+  detail::SymmetricEigen(covariance, vectors);
+  uint32 order[3] = { 0, 1, 2 };
+  for (uint32 i = 0; i < 2; ++i) {
+    for (uint32 j = i + 1; j < 3; ++j) {
+      if (covariance[order[j]][order[j]] > covariance[order[i]][order[i]]) {
+        uint32 swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+      }
+    }
+  }
+  Vec3 axis[2];
+  for (uint32 i = 0; i < 2; ++i) {
+    uint32 c = order[i];
+    axis[i] = Normalize(Vec3(static_cast<real32>(vectors[0][c]), static_cast<real32>(vectors[1][c]),
+      static_cast<real32>(vectors[2][c])));
+  }
+  return Mat3(axis[0], axis[1], Normalize(Cross(axis[0], axis[1])));
+}
+
+
+inline OBB FitOrientedBox(StridedSpan<const Vec3> points)
+{
+  if (points.count == 0) {
+    return OBB();
+  }
+  Mat3 axes = PrincipalAxes(points);
+  Vec3 center;
+  real32 extent[3];
+  for (uint32 i = 0; i < 3; ++i) {
+    Vec3 axis(axes.data[i][0], axes.data[i][1], axes.data[i][2]);
+    real32 min, max;
+    detail::ProjectPoints(points, axis, min, max);
+    center += axis * ((min + max) * 0.5f);
+    extent[i] = (max - min) * 0.5f;
+  }
+  real32 pad = detail::FitPadding(points);
+  return OBB(center, Vec3(extent[0] + pad, extent[1] + pad, extent[2] + pad), axes);
+}
+
+
+namespace detail {
+
+
+// Line along the principal axis of points, through the middle of their
+// spread across it, and the largest squared distance of any point from it.
+// What capsules and cylinders are fitted around.
+inline void FitAxisLine(StridedSpan<const Vec3> points, Vec3 &origin, Vec3 &axis,
+  real32 &radiusSq)
+{
+  Mat3 axes = PrincipalAxes(points);
+  axis = Vec3(axes.data[0][0], axes.data[0][1], axes.data[0][2]);
+  origin = Vec3();
+  for (uint32 i = 1; i < 3; ++i) {
+    Vec3 across(axes.data[i][0], axes.data[i][1], axes.data[i][2]);
+    real32 min, max;
+    ProjectPoints(points, across, min, max);
+    origin += across * ((min + max) * 0.5f);
+  }
+  radiusSq = 0.0f;
+  for (size_t i = 0; i < points.count; ++i) {
+    Vec3 d = points[i] - origin;
+    real32 distanceSq = (d - axis * Dot(d, axis)).LengthSquared();
+    radiusSq = distanceSq > radiusSq ? distanceSq : radiusSq;
+  }
+}
+} // detail
+} // jkl
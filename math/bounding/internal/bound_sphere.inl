@@ -0,0 +1,376 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../bound_sphere.hpp"
+#include "../../wide.hpp"
+#include "../../parallel.hpp"
+
+
+namespace math {
+
+
+template<typename T>
+constexpr bool BoundSphere<T>::Contains(const BoundSphere &sphere) const
+{
+  if (sphere.IsEmpty()) {
+    return true;
+  }
+  if (IsEmpty()) {
+    return false;
+  }
+  T distance = static_cast<T>(Sqrt((sphere.center - center).LengthSquared()));
+  return distance + sphere.radius <= radius;
+}
+
+
+// The new sphere touches the old one on the far side from point, and point on
+// the other, so it holds both.
+template<typename T>
+constexpr void BoundSphere<T>::Merge(const Vector3<T> &point)
+{
+  if (IsEmpty()) {
+    center = point;
+    radius = static_cast<T>(0);
+    return;
+  }
+  Vector3<T> offset = point - center;
+  T distanceSq = offset.LengthSquared();
+  if (distanceSq <= radius * radius) {
+    return;
+  }
+  T distance = static_cast<T>(Sqrt(distanceSq));
+  T newRadius = (radius + distance) * static_cast<T>(0.5);
+  center += offset * ((newRadius - radius) / distance);
+  radius = newRadius;
+}
+
+
+template<typename T>
+constexpr void BoundSphere<T>::Merge(const BoundSphere &sphere)
+{
+  if (sphere.IsEmpty()) {
+    return;
+  }
+  if (IsEmpty()) {
+    *this = sphere;
+    return;
+  }
+  Vector3<T> offset = sphere.center - center;
+  T distance = static_cast<T>(Sqrt(offset.LengthSquared()));
+  if (distance + sphere.radius <= radius) {
+    return;
+  }
+  if (distance + radius <= sphere.radius) {
+    *this = sphere;
+    return;
+  }
+  T newRadius = (distance + radius + sphere.radius) * static_cast<T>(0.5);
+  center += offset * ((newRadius - radius) / distance);
+  radius = newRadius;
+}
+
+
+template<typename T> constexpr
+BoundSphere<T> Merge(const BoundSphere<T> &a, const BoundSphere<T> &b)
+{
+  BoundSphere<T> result = a;
+  result.Merge(b);
+  return result;
+}
+
+
+// The rows of the upper 3x3 are where m sends the axes, so the longest one is
+// the largest scale.
+template<typename T> constexpr
+BoundSphere<T> Transform(const BoundSphere<T> &sphere, const Matrix4x4<T> &m)
+{
+  if (sphere.IsEmpty()) {
+    return sphere;
+  }
+  const Vector3<T> &c = sphere.center;
+  Vector3<T> center(
+    c.x * m.data[0][0] + c.y * m.data[1][0] + c.z * m.data[2][0] + m.data[3][0],
+    c.x * m.data[0][1] + c.y * m.data[1][1] + c.z * m.data[2][1] + m.data[3][1],
+    c.x * m.data[0][2] + c.y * m.data[1][2] + c.z * m.data[2][2] + m.data[3][2]);
+  // The largest scale is the largest singular value of the 3x3, bounded by
+  // Gershgorin on its rows' dot products: the squared length of a row plus
+  // how far it leans on the others. Rows of rotations and scales are
+  // orthogonal, which leaves the longest row, but a scale under a rotation
+  // shears them.
+  T dots[3][3] = { };
+  for (uint32 r = 0; r < 3; ++r) {
+    for (uint32 k = 0; k < 3; ++k) {
+      dots[r][k] = m.data[r][0] * m.data[k][0] + m.data[r][1] * m.data[k][1] +
+        m.data[r][2] * m.data[k][2];
+    }
+  }
+  T scaleSq = static_cast<T>(0);
+  for (uint32 r = 0; r < 3; ++r) {
+    T rowSq = Abs(dots[r][0]) + Abs(dots[r][1]) + Abs(dots[r][2]);
+    scaleSq = rowSq > scaleSq ? rowSq : scaleSq;
+  }
+  return BoundSphere<T>(center, sphere.radius * static_cast<T>(Sqrt(scaleSq)));
+}
+
+
+template<typename T> constexpr
+int32 Classify(const BoundSphere<T> &sphere, const Vector4<T> &plane)
+{
+  T distance = plane.x * sphere.center.x + plane.y * sphere.center.y
+    + plane.z * sphere.center.z + plane.w;
+  return distance > sphere.radius ? 1 : (distance < -sphere.radius ? -1 : 0);
+}
+
+
+namespace detail {
+
+
+// Gather FloatN::Width points starting at i.
+inline void LoadPoints(StridedSpan<const Vec3> points, size_t i, FloatN &x, FloatN &y, FloatN &z)
+{
+  const uint32 W = FloatN::Width;
+  real32 xs[W], ys[W], zs[W];
+  for (uint32 l = 0; l < W; ++l) {
+    const Vec3 &p = points[i + l];
+    xs[l] = p.x; ys[l] = p.y; zs[l] = p.z;
+  }
+  x = FloatN::Load(xs); y = FloatN::Load(ys); z = FloatN::Load(zs);
+}
+
+
+// Fits round their results to the scale of the coordinates, not of the
+// volume, so far from the origin the points that define a volume can land a
+// few ulp outside it. Fits grow by this much to hold them all the same.
+inline real32 FitPadding(StridedSpan<const Vec3> points)
+{
+  real32 scale = 0.0f;
+  for (size_t i = 0; i < points.count; ++i) {
+    const Vec3 &p = points[i];
+    scale = Abs(p.x) > scale ? Abs(p.x) : scale;
+    scale = Abs(p.y) > scale ? Abs(p.y) : scale;
+    scale = Abs(p.z) > scale ? Abs(p.z) : scale;
+  }
+  return 16.0f * std::numeric_limits<real32>::epsilon() * scale;
+}
+
+
+// Ritter's growing pass over [begin, end). Most points end up inside long
+// before they are reached, so whole FloatN blocks are tested first and only
+// blocks with a point outside are walked one by one.
+inline void GrowSphere(Sphere &sphere, StridedSpan<const Vec3> points, size_t begin, size_t end)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wideEnd = begin + (end - begin) / W * W;
+  size_t i = begin;
+  for (; i < wideEnd; i += W) {
+    FloatN x, y, z;
+    LoadPoints(points, i, x, y, z);
+    FloatN dx = x - FloatN(sphere.center.x);
+    FloatN dy = y - FloatN(sphere.center.y);
+    FloatN dz = z - FloatN(sphere.center.z);
+    FloatN radiusSq(sphere.radius * sphere.radius);
+    if (Any(dx * dx + dy * dy + dz * dz > radiusSq)) {
+      for (uint32 l = 0; l < W; ++l) {
+        sphere.Merge(points[i + l]);
+      }
+    }
+  }
+  for (; i < end; ++i) {
+    sphere.Merge(points[i]);
+  }
+}
+
+
+struct WideSpheres {
+  WideSpheres(const SphereArray &spheres, size_t i)
+    : x(FloatN::Load(&spheres.x[i])), y(FloatN::Load(&spheres.y[i]))
+    , z(FloatN::Load(&spheres.z[i])), radius(FloatN::Load(&spheres.radius[i]))
+  { }
+
+  // Same as Sphere::Intersects, false for empty spheres.
+  FloatN Intersects(const FloatN &ox, const FloatN &oy, const FloatN &oz,
+    const FloatN &oradius) const {
+    FloatN dx = ox - x, dy = oy - y, dz = oz - z;
+    FloatN r = radius + oradius;
+    FloatN zero(0.0f);
+    return (dx * dx + dy * dy + dz * dz <= r * r) & (radius >= zero) & (oradius >= zero);
+  }
+
+  // Signed distance from the centers to plane.
+  FloatN Distance(const Vec4 &plane) const {
+    return x * FloatN(plane.x) + y * FloatN(plane.y) + z * FloatN(plane.z) + FloatN(plane.w);
+  }
+
+  FloatN x, y, z, radius;
+};
+} // detail
+
+
+inline Sphere FitSphere(StridedSpan<const Vec3> points, uint32 refinePasses)
+{
+  if (points.count == 0) {
+    return Sphere();
+  }
+
+  // Extreme points along x, y and z.
+  size_t lowest[3] = { 0, 0, 0 };
+  size_t highest[3] = { 0, 0, 0 };
+  Vec3 low = points[0], high = points[0];
+  for (size_t i = 1; i < points.count; ++i) {
+    const Vec3 &p = points[i];
+    if (p.x < low.x) { low.x = p.x; lowest[0] = i; }
+    if (p.y < low.y) { low.y = p.y; lowest[1] = i; }
+    if (p.z < low.z) { low.z = p.z; lowest[2] = i; }
+    if (p.x > high.x) { high.x = p.x; highest[0] = i; }
+    if (p.y > high.y) { high.y = p.y; highest[1] = i; }
+    if (p.z > high.z) { high.z = p.z; highest[2] = i; }
+  }
+  uint32 axis = 0;
+  real32 spreadSq = -1.0f;
+  for (uint32 a = 0; a < 3; ++a) {
+    real32 s = (points[highest[a]] - points[lowest[a]]).LengthSquared();
+    if (s > spreadSq) {
+      spreadSq = s;
+      axis = a;
+    }
+  }
+  const Vec3 &p0 = points[lowest[axis]];
+  const Vec3 &p1 = points[highest[axis]];
+  Sphere sphere((p0 + p1) * 0.5f, Sqrt(spreadSq) * 0.5f);
+  detail::GrowSphere(sphere, points, 0, points.count);
+
+  // Growing only ever moves the center towards the points reached so far, so
+  // starting every pass at a different point gives a different, sometimes
+  // tighter, sphere.
+  for (uint32 pass = 0; pass < refinePasses; ++pass) {
+    Sphere candidate(sphere.center, sphere.radius * 0.95f);
+    size_t start = points.count * (pass + 1) / (refinePasses + 1);
+    detail::GrowSphere(candidate, points, start, points.count);
+    detail::GrowSphere(candidate, points, 0, start);
+    if (candidate.radius < sphere.radius) {
+      sphere = candidate;
+    }
+  }
+  sphere.radius += detail::FitPadding(points);
+  return sphere;
+}
+
+
+inline size_t IntersectBatch(const SphereArray &spheres, const Sphere &sphere,
+  uint32 *indices)
+{
+  const uint32 W = FloatN::Width;
+  const size_t count = spheres.Size();
+  const size_t wide = count - count % W;
+  FloatN ox(sphere.center.x), oy(sphere.center.y), oz(sphere.center.z), oradius(sphere.radius);
+  size_t written = 0;
+  size_t i = 0;
+  for (; i < wide; i += W) {
+    FloatN hit = detail::WideSpheres(spheres, i).Intersects(ox, oy, oz, oradius);
+    detail::AppendLanes(MoveMask(hit), i, indices, written);
+  }
+  for (; i < count; ++i) {
+    indices[written] = static_cast<uint32>(i);
+    written += spheres.Get(i).Intersects(sphere) ? 1 : 0;
+  }
+  return written;
+}
+
+
+inline void IntersectBatch(const SphereArray &a, const SphereArray &b, uint8 *results,
+  bool parallel)
+{
+  detail::BoundsBatch(a.Size(), parallel,
+    [&] (size_t i) {
+      detail::WideSpheres sb(b, i);
+      int32 bits = MoveMask(detail::WideSpheres(a, i).Intersects(sb.x, sb.y, sb.z, sb.radius));
+      for (uint32 l = 0; l < FloatN::Width; ++l) {
+        results[i + l] = static_cast<uint8>((bits >> l) & 1);
+      }
+    },
+    [&] (size_t i) {
+      results[i] = a.Get(i).Intersects(b.Get(i)) ? 1 : 0;
+    });
+}
+
+
+inline void ClassifyBatch(const SphereArray &spheres, const Vec4 &plane, int8 *sides,
+  bool parallel)
+{
+  detail::BoundsBatch(spheres.Size(), parallel,
+    [&] (size_t i) {
+      detail::WideSpheres s(spheres, i);
+      FloatN distance = s.Distance(plane);
+      int32 front = MoveMask(distance > s.radius);
+      int32 behind = MoveMask(distance < FloatN(0.0f) - s.radius);
+      for (uint32 l = 0; l < FloatN::Width; ++l) {
+        sides[i + l] = static_cast<int8>(((front >> l) & 1) - ((behind >> l) & 1));
+      }
+    },
+    [&] (size_t i) {
+      sides[i] = static_cast<int8>(Classify(spheres.Get(i), plane));
+    });
+}
+
+
+inline size_t InFrontBatch(const SphereArray &spheres, const Vec4 &plane, uint32 *indices)
+{
+  const uint32 W = FloatN::Width;
+  const size_t count = spheres.Size();
+  const size_t wide = count - count % W;
+  size_t written = 0;
+  size_t i = 0;
+  for (; i < wide; i += W) {
+    detail::WideSpheres s(spheres, i);
+    detail::AppendLanes(MoveMask(s.Distance(plane) >= FloatN(0.0f) - s.radius), i, indices, written);
+  }
+  for (; i < count; ++i) {
+    indices[written] = static_cast<uint32>(i);
+    written += Classify(spheres.Get(i), plane) >= 0 ? 1 : 0;
+  }
+  return written;
+}
+
+
+inline void TransformBatch(const SphereArray &spheres, const Mat4 *matrices, SphereArray &out,
+  bool parallel)
+{
+  const uint32 W = FloatN::Width;
+  out.Resize(spheres.Size());
+  detail::BoundsBatch(spheres.Size(), parallel,
+    [&] (size_t i) {
+      real32 lanes[12][W];
+      for (uint32 l = 0; l < W; ++l) {
+        const Mat4 &m = matrices[i + l];
+        for (uint32 r = 0; r < 4; ++r) {
+          lanes[r * 3 + 0][l] = m.data[r][0];
+          lanes[r * 3 + 1][l] = m.data[r][1];
+          lanes[r * 3 + 2][l] = m.data[r][2];
+        }
+      }
+      FloatN m[12];
+      for (uint32 k = 0; k < 12; ++k) {
+        m[k] = FloatN::Load(lanes[k]);
+      }
+      detail::WideSpheres s(spheres, i);
+      // Gershgorin bound on the largest singular value, as in Transform.
+      FloatN d00 = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+      FloatN d11 = m[3] * m[3] + m[4] * m[4] + m[5] * m[5];
+      FloatN d22 = m[6] * m[6] + m[7] * m[7] + m[8] * m[8];
+      FloatN d01 = Abs(m[0] * m[3] + m[1] * m[4] + m[2] * m[5]);
+      FloatN d02 = Abs(m[0] * m[6] + m[1] * m[7] + m[2] * m[8]);
+      FloatN d12 = Abs(m[3] * m[6] + m[4] * m[7] + m[5] * m[8]);
+      FloatN scaleSq = Max(Max(d00 + d01 + d02, d11 + d01 + d12), d22 + d02 + d12);
+      FloatN empty = s.radius < FloatN(0.0f);
+      Select(empty, s.x, s.x * m[0] + s.y * m[3] + s.z * m[6] + m[9]).Store(&out.x[i]);
+      Select(empty, s.y, s.x * m[1] + s.y * m[4] + s.z * m[7] + m[10]).Store(&out.y[i]);
+      Select(empty, s.z, s.x * m[2] + s.y * m[5] + s.z * m[8] + m[11]).Store(&out.z[i]);
+      Select(empty, s.radius, s.radius * Sqrt(scaleSq)).Store(&out.radius[i]);
+    },
+    [&] (size_t i) {
+      out.Set(i, Transform(spheres.Get(i), matrices[i]));
+    });
+}
+} // jkl
@@ -0,0 +1,451 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../bvh.hpp"
+#include "../../parallel.hpp"
+
+#include <algorithm>
+
+
+namespace math {
+namespace detail {
+
+
+static const uint32 BvhBinCount = 16;
+
+// Nodes with fewer primitives than this have both children built on the
+// calling thread.
+static const size_t BvhParallelThreshold = 8 * 1024;
+
+// Deeper than this, nodes are split at the object median instead, which
+// halves them every level and so keeps any tree within MaxDepth.
+static const uint32 BvhMedianDepth = Bvh::MaxDepth - 24;
+
+
+inline AABB TriangleBounds(StridedSpan<const Vec3> positions, const uint32 *indices, size_t i)
+{
+  AABB box;
+  box.Merge(positions[indices[i * 3 + 0]]);
+  box.Merge(positions[indices[i * 3 + 1]]);
+  box.Merge(positions[indices[i * 3 + 2]]);
+  return box;
+}
+
+
+struct BvhBin {
+  AABB bounds;
+  uint32 count;
+};
+
+
+struct BvhBuilder {
+  const AABB *bounds;
+  const Vec3 *centroids;
+  uint32 *primitives;
+  uint32 maxLeafSize;
+  bool parallel;
+};
+
+
+struct BvhSplit {
+  uint32 axis;
+  uint32 bin;
+  real32 cost;
+};
+
+
+inline uint32 BinIndex(real32 centroid, real32 min, real32 scale)
+{
+  uint32 bin = static_cast<uint32>((centroid - min) * scale);
+  return bin < BvhBinCount - 1 ? bin : BvhBinCount - 1;
+}
+
+
+// Best binned SAH split of [begin, end), with cost relative to the node's
+// area, in units of one primitive test. Bins are only filled along axes the
+// centroids spread over, a cost of max means no split was found.
+inline BvhSplit FindSplit(const BvhBuilder &builder, uint32 begin, uint32 end,
+  const AABB &centroidBounds)
+{
+  BvhSplit best = { 0, 0, std::numeric_limits<real32>::max() };
+  for (uint32 axis = 0; axis < 3; ++axis) {
+    real32 min = Axis(centroidBounds.min, axis);
+    real32 extent = Axis(centroidBounds.max, axis) - min;
+    if (extent <= 0.0f) {
+      continue;
+    }
+    real32 scale = BvhBinCount / extent;
+    BvhBin bins[BvhBinCount];
+    for (uint32 b = 0; b < BvhBinCount; ++b) {
+      bins[b].count = 0;
+    }
+    for (uint32 i = begin; i < end; ++i) {
+      uint32 primitive = builder.primitives[i];
+      BvhBin &bin = bins[BinIndex(Axis(builder.centroids[primitive], axis), min, scale)];
+      bin.bounds.Merge(builder.bounds[primitive]);
+      ++bin.count;
+    }
+
+    // Sweep from the right to get the cost of everything past each split,
+    // then from the left to add the rest.
+    real32 rightCost[BvhBinCount];
+    AABB right;
+    uint32 rightCount = 0;
+    for (uint32 b = BvhBinCount - 1; b > 0; --b) {
+      right.Merge(bins[b].bounds);
+      rightCount += bins[b].count;
+      rightCost[b] = right.SurfaceArea() * rightCount;
+    }
+    AABB left;
+    uint32 leftCount = 0;
+    for (uint32 b = 1; b < BvhBinCount; ++b) {
+      left.Merge(bins[b - 1].bounds);
+      leftCount += bins[b - 1].count;
+      real32 cost = left.SurfaceArea() * leftCount + rightCost[b];
+      if (leftCount > 0 && leftCount < end - begin && cost < best.cost) {
+        best.axis = axis;
+        best.bin = b;
+        best.cost = cost;
+      }
+    }
+  }
+  return best;
+}
+
+
+inline void AppendSubtree(std::vector<BvhNode> &nodes, const std::vector<BvhNode> &subtree)
+{
+  uint32 base = static_cast<uint32>(nodes.size());
+  for (size_t i = 0; i < subtree.size(); ++i) {
+    BvhNode node = subtree[i];
+    if (!node.IsLeaf()) {
+      node.offset += base;
+    }
+    nodes.push_back(node);
+  }
+}
+
+
+// Build the subtree over primitives [begin, end), appending its nodes to
+// nodes depth first. Large nodes build their two children into vectors of
+// their own in parallel, which are then appended one after the other.
+inline void BuildBvhRange(const BvhBuilder &builder, uint32 begin, uint32 end, uint32 depth,
+  std::vector<BvhNode> &nodes)
+{
+  const uint32 index = static_cast<uint32>(nodes.size());
+  nodes.push_back(BvhNode());
+
+  AABB bounds;
+  AABB centroidBounds;
+  for (uint32 i = begin; i < end; ++i) {
+    uint32 primitive = builder.primitives[i];
+    bounds.Merge(builder.bounds[primitive]);
+    centroidBounds.Merge(builder.centroids[primitive]);
+  }
+  nodes[index].bounds = bounds;
+
+  const uint32 count = end - begin;
+  const bool fits = count <= builder.maxLeafSize;
+  BvhSplit split = { 0, 0, std::numeric_limits<real32>::max() };
+  if (count > 1 && depth < BvhMedianDepth) {
+    split = FindSplit(builder, begin, end, centroidBounds);
+  }
+  // A leaf costs a test per primitive, a split one traversal step plus the
+  // tests its children are expected to need.
+  const real32 area = bounds.SurfaceArea();
+  if (count == 1 || depth + 1 >= Bvh::MaxDepth
+    || (fits && (split.cost == std::numeric_limits<real32>::max() || area * count <= area + split.cost))) {
+    nodes[index].offset = begin;
+    nodes[index].count = static_cast<uint16>(count);
+    return;
+  }
+
+  uint32 mid;
+  uint32 axis;
+  if (split.cost != std::numeric_limits<real32>::max()) {
+    axis = split.axis;
+    real32 min = Axis(centroidBounds.min, axis);
+    real32 scale = BvhBinCount / (Axis(centroidBounds.max, axis) - min);
+    uint32 *middle = std::partition(builder.primitives + begin, builder.primitives + end,
+      [&] (uint32 primitive) {
+        return BinIndex(Axis(builder.centroids[primitive], axis), min, scale) < split.bin;
+      });
+    mid = static_cast<uint32>(middle - builder.primitives);
+  } else {
+    Vec3 extent = centroidBounds.max - centroidBounds.min;
+    axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    mid = begin + count / 2;
+    std::nth_element(builder.primitives + begin, builder.primitives + mid,
+      builder.primitives + end, [&] (uint32 a, uint32 b) {
+        return Axis(builder.centroids[a], axis) < Axis(builder.centroids[b], axis);
+      });
+  }
+  nodes[index].count = 0;
+  nodes[index].axis = static_cast<uint8>(axis);
+  nodes[index].pad = 0;
+
+  if (builder.parallel && count >= BvhParallelThreshold) {
+    std::vector<BvhNode> children[2];
+    ParallelFor(2, 1, [&] (size_t first, size_t last) {
+      for (size_t child = first; child < last; ++child) {
+        BuildBvhRange(builder, child == 0 ? begin : mid, child == 0 ? mid : end, depth + 1,
+          children[child]);
+      }
+    });
+    AppendSubtree(nodes, children[0]);
+    nodes[index].offset = static_cast<uint32>(nodes.size());
+    AppendSubtree(nodes, children[1]);
+  } else {
+    BuildBvhRange(builder, begin, mid, depth + 1, nodes);
+    nodes[index].offset = static_cast<uint32>(nodes.size());
+    BuildBvhRange(builder, mid, end, depth + 1, nodes);
+  }
+}
+
+
+inline void BuildBvh(Bvh &bvh, const AABB *bounds, size_t count, bool parallel,
+  uint32 maxLeafSize)
+{
+  bvh.Clear();
+  if (count == 0) {
+    return;
+  }
+  std::vector<Vec3> centroids(count);
+  bvh.primitives.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    centroids[i] = bounds[i].Center();
+    bvh.primitives[i] = static_cast<uint32>(i);
+  }
+  BvhBuilder builder;
+  builder.bounds = bounds;
+  builder.centroids = centroids.data();
+  builder.primitives = bvh.primitives.data();
+  builder.maxLeafSize = std::min<uint32>(std::max<uint32>(maxLeafSize, 1),
+    std::numeric_limits<uint16>::max());
+  builder.parallel = parallel;
+  bvh.nodes.reserve(count * 2 / builder.maxLeafSize + 1);
+  BuildBvhRange(builder, 0, static_cast<uint32>(count), 0, bvh.nodes);
+}
+
+
+// Children always come after their parent, so walking the nodes backwards
+// sees both children of a node before the node itself.
+template<typename LeafBounds> inline
+void RefitBvh(Bvh &bvh, const LeafBounds &leafBounds)
+{
+  for (size_t i = bvh.nodes.size(); i-- > 0;) {
+    BvhNode &node = bvh.nodes[i];
+    if (node.IsLeaf()) {
+      AABB bounds;
+      for (uint32 k = 0; k < node.count; ++k) {
+        bounds.Merge(leafBounds(bvh.primitives[node.offset + k]));
+      }
+      node.bounds = bounds;
+    } else {
+      node.bounds = Merge(bvh.nodes[i + 1].bounds, bvh.nodes[node.offset].bounds);
+    }
+  }
+}
+} // detail
+
+
+inline void Bvh::Build(const AABB *bounds, size_t count, bool parallel, uint32 maxLeafSize)
+{
+  detail::BuildBvh(*this, bounds, count, parallel, maxLeafSize);
+}
+
+
+inline void Bvh::Build(StridedSpan<const Vec3> positions, const uint32 *indices,
+  size_t triangleCount, bool parallel, uint32 maxLeafSize)
+{
+  std::vector<AABB> bounds(triangleCount);
+  auto range = [&] (size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      bounds[i] = detail::TriangleBounds(positions, indices, i);
+    }
+  };
+  if (parallel) {
+    ParallelFor(triangleCount, detail::BoundsParallelGrain, range);
+  } else {
+    range(0, triangleCount);
+  }
+  detail::BuildBvh(*this, bounds.data(), triangleCount, parallel, maxLeafSize);
+}
+
+
+inline void Bvh::Refit(const AABB *bounds)
+{
+  detail::RefitBvh(*this, [&] (uint32 primitive) {
+    return bounds[primitive];
+  });
+}
+
+
+inline void Bvh::Refit(StridedSpan<const Vec3> positions, const uint32 *indices)
+{
+  detail::RefitBvh(*this, [&] (uint32 primitive) {
+    return detail::TriangleBounds(positions, indices, primitive);
+  });
+}
+
+
+// Interior nodes push the far child and carry on with the near one, which
+// is the first child when the ray runs towards +axis.
+template<typename Intersect>
+bool Bvh::Raycast(const Ray3 &ray, real32 &maxDistance, const Intersect &intersect) const
+{
+  if (nodes.empty()) {
+    return false;
+  }
+  const bool negative[3] = {
+    ray.direction.x < 0.0f, ray.direction.y < 0.0f, ray.direction.z < 0.0f
+  };
+  uint32 stack[MaxDepth];
+  uint32 size = 0;
+  uint32 current = 0;
+  bool hit = false;
+  for (;;) {
+    const BvhNode &node = nodes[current];
+    real32 distance;
+    if (math::Intersect(ray, node.bounds, distance, maxDistance)) {
+      if (!node.IsLeaf()) {
+        if (negative[node.axis]) {
+          stack[size++] = current + 1;
+          current = node.offset;
+        } else {
+          stack[size++] = node.offset;
+          current = current + 1;
+        }
+        continue;
+      }
+      for (uint32 k = 0; k < node.count; ++k) {
+        if (intersect(primitives[node.offset + k], maxDistance)) {
+          hit = true;
+        }
+      }
+    }
+    if (size == 0) {
+      break;
+    }
+    current = stack[--size];
+  }
+  return hit;
+}
+
+
+inline bool Bvh::Raycast(const Ray3 &ray, StridedSpan<const Vec3> positions,
+  const uint32 *indices, RayHit &hit, real32 maxDistance) const
+{
+  return Raycast(ray, maxDistance, [&] (uint32 primitive, real32 &closest) {
+    real32 distance, u, v;
+    if (!Intersect(ray, positions[indices[primitive * 3 + 0]], positions[indices[primitive * 3 + 1]],
+        positions[indices[primitive * 3 + 2]], distance, u, v, closest)) {
+      return false;
+    }
+    hit.primitive = primitive;
+    hit.distance = distance;
+    hit.u = u;
+    hit.v = v;
+    closest = distance;
+    return true;
+  });
+}
+
+
+// Same walk as for one ray, going down a node while any lane enters it. The
+// near child is picked by the first ray of the packet.
+inline int32 Bvh::Raycast(const WideRay<FloatN> &rays, StridedSpan<const Vec3> positions,
+  const uint32 *indices, RayHit *hits, real32 maxDistance) const
+{
+  if (nodes.empty()) {
+    return 0;
+  }
+  const uint32 W = FloatN::Width;
+  real32 dx[W], dy[W], dz[W];
+  rays.direction.Store(dx, dy, dz);
+  const bool negative[3] = { dx[0] < 0.0f, dy[0] < 0.0f, dz[0] < 0.0f };
+
+  FloatN closest(maxDistance);
+  int32 hitBits = 0;
+  uint32 stack[MaxDepth];
+  uint32 size = 0;
+  uint32 current = 0;
+  for (;;) {
+    const BvhNode &node = nodes[current];
+    FloatN distance;
+    if (Any(Intersect(rays, node.bounds, distance, closest))) {
+      if (!node.IsLeaf()) {
+        if (negative[node.axis]) {
+          stack[size++] = current + 1;
+          current = node.offset;
+        } else {
+          stack[size++] = node.offset;
+          current = current + 1;
+        }
+        continue;
+      }
+      for (uint32 k = 0; k < node.count; ++k) {
+        uint32 primitive = primitives[node.offset + k];
+        FloatN u, v;
+        FloatN mask = Intersect(rays, positions[indices[primitive * 3 + 0]],
+          positions[indices[primitive * 3 + 1]], positions[indices[primitive * 3 + 2]],
+          distance, u, v, closest);
+        int32 bits = MoveMask(mask);
+        if (bits == 0) {
+          continue;
+        }
+        closest = Select(mask, distance, closest);
+        real32 ds[W], us[W], vs[W];
+        distance.Store(ds);
+        u.Store(us);
+        v.Store(vs);
+        for (uint32 l = 0; l < W; ++l) {
+          if ((bits >> l) & 1) {
+            hits[l].primitive = primitive;
+            hits[l].distance = ds[l];
+            hits[l].u = us[l];
+            hits[l].v = vs[l];
+          }
+        }
+        hitBits |= bits;
+      }
+    }
+    if (size == 0) {
+      break;
+    }
+    current = stack[--size];
+  }
+  return hitBits;
+}
+
+
+template<typename Func>
+void Bvh::Query(const AABB &box, const Func &func) const
+{
+  if (nodes.empty()) {
+    return;
+  }
+  uint32 stack[MaxDepth];
+  uint32 size = 0;
+  uint32 current = 0;
+  for (;;) {
+    const BvhNode &node = nodes[current];
+    if (node.bounds.Intersects(box)) {
+      if (!node.IsLeaf()) {
+        stack[size++] = node.offset;
+        current = current + 1;
+        continue;
+      }
+      for (uint32 k = 0; k < node.count; ++k) {
+        func(primitives[node.offset + k]);
+      }
+    }
+    if (size == 0) {
+      break;
+    }
+    current = stack[--size];
+  }
+}
+} // jkl
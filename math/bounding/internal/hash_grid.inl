@@ -0,0 +1,345 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../hash_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+
+namespace math {
+
+
+inline HashGrid::HashGrid(real32 cellSize)
+  : freeCells(InvalidIndex)
+  , large(InvalidIndex)
+  , cellSize(cellSize)
+  , inverseCellSize(1.0f / cellSize)
+{ }
+
+
+inline int32 HashGrid::Coordinate(real32 value) const
+{
+  real32 v = std::floor(value * inverseCellSize);
+  if (!(v >= static_cast<real32>(-CellRange))) {
+    return -CellRange;
+  }
+  return v > static_cast<real32>(CellRange - 1) ? CellRange - 1 : static_cast<int32>(v);
+}
+
+
+inline uint64 HashGrid::Key(int32 x, int32 y, int32 z)
+{
+  return static_cast<uint64>(x + CellRange) | static_cast<uint64>(y + CellRange) << 21
+    | static_cast<uint64>(z + CellRange) << 42;
+}
+
+
+inline bool HashGrid::IsLarge(const AABB &box) const
+{
+  Vec3 center = box.Center();
+  Vec3 extent = box.Extent();
+  // A cell short of the end of the range, so that clamping never kicks in.
+  real32 reach = static_cast<real32>(CellRange - 1) * cellSize;
+  return extent.x > cellSize * 0.5f || extent.y > cellSize * 0.5f || extent.z > cellSize * 0.5f
+    || !(Abs(center.x) < reach && Abs(center.y) < reach && Abs(center.z) < reach);
+}
+
+
+inline uint32 HashGrid::FindCell(const AABB &box)
+{
+  if (IsLarge(box)) {
+    return LargeCell;
+  }
+  Vec3 center = box.Center();
+  int32 x = Coordinate(center.x), y = Coordinate(center.y), z = Coordinate(center.z);
+  uint64 key = Key(x, y, z);
+  auto found = cellMap.find(key);
+  if (found != cellMap.end()) {
+    return found->second;
+  }
+  uint32 index;
+  if (freeCells != InvalidIndex) {
+    index = freeCells;
+    freeCells = cells[index].first;
+  } else {
+    index = static_cast<uint32>(cells.size());
+    cells.push_back(Cell());
+  }
+  Cell &cell = cells[index];
+  cell.x = x;
+  cell.y = y;
+  cell.z = z;
+  cell.first = InvalidIndex;
+  cell.count = 0;
+  cellMap.emplace(key, index);
+  occupied.Merge(LooseBounds(cell));
+  return index;
+}
+
+
+inline bool HashGrid::InCell(uint32 index, const AABB &box) const
+{
+  if (IsLarge(box)) {
+    return index == LargeCell;
+  }
+  if (index == LargeCell) {
+    return false;
+  }
+  const Cell &cell = cells[index];
+  Vec3 center = box.Center();
+  return Coordinate(center.x) == cell.x && Coordinate(center.y) == cell.y
+    && Coordinate(center.z) == cell.z;
+}
+
+
+inline void HashGrid::Attach(uint32 handle)
+{
+  uint32 index = FindCell(objects[handle].box);
+  if (index == LargeCell) {
+    Link(large, handle, LargeCell);
+    return;
+  }
+  Link(cells[index].first, handle, index);
+  ++cells[index].count;
+}
+
+
+inline void HashGrid::Detach(uint32 handle)
+{
+  uint32 index = objects[handle].cell;
+  if (index == LargeCell) {
+    Unlink(large, handle);
+    return;
+  }
+  Cell &cell = cells[index];
+  Unlink(cell.first, handle);
+  if (--cell.count == 0) {
+    cellMap.erase(Key(cell.x, cell.y, cell.z));
+    cell.first = freeCells;
+    freeCells = index;
+  }
+}
+
+
+inline AABB HashGrid::LooseBounds(const Cell &cell) const
+{
+  Vec3 min(static_cast<real32>(cell.x), static_cast<real32>(cell.y),
+    static_cast<real32>(cell.z));
+  real32 half = cellSize * 0.5f;
+  return AABB(min * cellSize - Vec3(half, half, half),
+    (min + Vec3(1.0f, 1.0f, 1.0f)) * cellSize + Vec3(half, half, half));
+}
+
+
+inline uint32 HashGrid::Insert(const AABB &box)
+{
+  uint32 handle = AllocateObject(box);
+  Attach(handle);
+  return handle;
+}
+
+
+inline void HashGrid::Remove(uint32 handle)
+{
+  Detach(handle);
+  FreeObject(handle);
+}
+
+
+inline void HashGrid::Move(uint32 handle, const AABB &box)
+{
+  detail::SpatialObject &object = objects[handle];
+  object.box = box;
+  if (InCell(object.cell, box)) {
+    return;
+  }
+  Detach(handle);
+  Attach(handle);
+}
+
+
+inline void HashGrid::Clear()
+{
+  cells.clear();
+  freeCells = InvalidIndex;
+  cellMap.clear();
+  occupied = AABB();
+  large = InvalidIndex;
+  ClearObjects();
+}
+
+
+// An object's center is inside its cell and it reaches at most half a cell
+// further, so only cells up to half a cell away from region matter. Looking
+// them up one by one beats going through the occupied ones only while there
+// are fewer of them.
+template<typename Visit>
+void HashGrid::ForCells(const AABB &region, const Visit &visit) const
+{
+  real32 half = cellSize * 0.5f;
+  int32 x0 = Coordinate(region.min.x - half), x1 = Coordinate(region.max.x + half);
+  int32 y0 = Coordinate(region.min.y - half), y1 = Coordinate(region.max.y + half);
+  int32 z0 = Coordinate(region.min.z - half), z1 = Coordinate(region.max.z + half);
+  if (x0 > x1 || y0 > y1 || z0 > z1) {
+    return;
+  }
+  double covered = static_cast<double>(x1 - x0 + 1) * static_cast<double>(y1 - y0 + 1)
+    * static_cast<double>(z1 - z0 + 1);
+  if (covered <= static_cast<double>(cellMap.size())) {
+    for (int32 z = z0; z <= z1; ++z) {
+      for (int32 y = y0; y <= y1; ++y) {
+        for (int32 x = x0; x <= x1; ++x) {
+          auto found = cellMap.find(Key(x, y, z));
+          if (found != cellMap.end()) {
+            visit(cells[found->second]);
+          }
+        }
+      }
+    }
+    return;
+  }
+  for (const Cell &cell : cells) {
+    if (cell.count != 0 && cell.x >= x0 && cell.x <= x1 && cell.y >= y0 && cell.y <= y1
+      && cell.z >= z0 && cell.z <= z1) {
+      visit(cell);
+    }
+  }
+}
+
+
+inline void HashGrid::QueryBox(const AABB &box, std::vector<uint32> &results) const
+{
+  Collect(large, [&] (const AABB &object) {
+    return object.Intersects(box);
+  }, results);
+  ForCells(box, [&] (const Cell &cell) {
+    bool inside = detail::Contains(box, LooseBounds(cell));
+    Collect(cell.first, [&] (const AABB &object) {
+      return inside || object.Intersects(box);
+    }, results);
+  });
+}
+
+
+inline void HashGrid::QueryFrustum(const Frustum &frustum, std::vector<uint32> &results) const
+{
+  Collect(large, [&] (const AABB &object) {
+    return frustum.Intersects(object);
+  }, results);
+  for (const Cell &cell : cells) {
+    if (cell.count == 0) {
+      continue;
+    }
+    int32 side = detail::ClassifyBox(frustum, LooseBounds(cell));
+    if (side < 0) {
+      continue;
+    }
+    Collect(cell.first, [&] (const AABB &object) {
+      return side > 0 || frustum.Intersects(object);
+    }, results);
+  }
+}
+
+
+// The ray is clipped to the occupied cells, then a 3D DDA (Amanatides and
+// Woo) walks the cells the segment goes through. An object reaches at most
+// half a cell out of its own cell, so every cell holding an object the
+// segment hits is next to a walked one. The first walked cell looks up all 27
+// around it. Every later one looks up only the 9 new ones, in the face of
+// its neighbourhood on the side it stepped to, since the walk never turns
+// back on any axis. Short segments cost less as a box walk through ForCells.
+inline void HashGrid::QueryRay(const Ray3 &ray, real32 maxDistance,
+  std::vector<uint32> &results) const
+{
+  auto test = [&] (const AABB &box) {
+    real32 distance;
+    return Intersect(ray, box, distance, maxDistance);
+  };
+  Collect(large, test, results);
+  if (cellMap.empty()) {
+    return;
+  }
+  Vec3 t1 = (occupied.min - ray.origin) * ray.invDirection;
+  Vec3 t2 = (occupied.max - ray.origin) * ray.invDirection;
+  Vec3 tNear = Min(t1, t2), tFar = Max(t1, t2);
+  real32 enter = std::max(std::max(std::max(tNear.x, tNear.y), tNear.z), 0.0f);
+  real32 exit = std::min(std::min(std::min(tFar.x, tFar.y), tFar.z), maxDistance);
+  if (!(enter <= exit)) {
+    return;
+  }
+  Vec3 a = ray.At(enter), b = ray.At(exit);
+  int32 cell[3] = { Coordinate(a.x), Coordinate(a.y), Coordinate(a.z) };
+  const int32 last[3] = { Coordinate(b.x), Coordinate(b.y), Coordinate(b.z) };
+  double steps = 0.0, covered = 1.0;
+  for (uint32 k = 0; k < 3; ++k) {
+    double span = static_cast<double>(std::abs(last[k] - cell[k]));
+    steps += span;
+    covered *= span + 2.0;
+  }
+  double probes = 27.0 + 9.0 * steps;
+  if (probes >= covered || probes >= static_cast<double>(cellMap.size())) {
+    ForCells(AABB(Min(a, b), Max(a, b)), [&] (const Cell &cell) {
+      if (test(LooseBounds(cell))) {
+        Collect(cell.first, test, results);
+      }
+    });
+    return;
+  }
+
+  // The slab test is cheaper than the lookup, and rules out most of them.
+  auto probe = [&] (int32 x, int32 y, int32 z) {
+    Cell around = { x, y, z, InvalidIndex, 0 };
+    if (!test(LooseBounds(around))) {
+      return;
+    }
+    auto found = cellMap.find(Key(x, y, z));
+    if (found != cellMap.end()) {
+      Collect(cells[found->second].first, test, results);
+    }
+  };
+  const real32 origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+  const real32 direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+  const real32 inverse[3] = { ray.invDirection.x, ray.invDirection.y, ray.invDirection.z };
+  const real32 infinity = std::numeric_limits<real32>::infinity();
+  int32 step[3];
+  // Distance along the ray to the next cell boundary on each axis, and
+  // between two boundaries. An axis is done once it reaches the last cell.
+  real32 next[3], delta[3];
+  for (uint32 k = 0; k < 3; ++k) {
+    step[k] = direction[k] > 0.0f ? 1 : -1;
+    delta[k] = cellSize * Abs(inverse[k]);
+    real32 boundary = static_cast<real32>(cell[k] + (step[k] > 0 ? 1 : 0)) * cellSize;
+    next[k] = cell[k] != last[k] ? (boundary - origin[k]) * inverse[k] : infinity;
+  }
+  for (int32 dz = -1; dz <= 1; ++dz) {
+    for (int32 dy = -1; dy <= 1; ++dy) {
+      for (int32 dx = -1; dx <= 1; ++dx) {
+        probe(cell[0] + dx, cell[1] + dy, cell[2] + dz);
+      }
+    }
+  }
+  for (;;) {
+    uint32 k = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+    if (!(next[k] <= exit)) {
+      break;
+    }
+    cell[k] += step[k];
+    next[k] = cell[k] != last[k] ? next[k] + delta[k] : infinity;
+    uint32 u = (k + 1) % 3, v = (k + 2) % 3;
+    int32 c[3];
+    c[k] = cell[k] + step[k];
+    for (int32 dv = -1; dv <= 1; ++dv) {
+      for (int32 du = -1; du <= 1; ++du) {
+        c[u] = cell[u] + du;
+        c[v] = cell[v] + dv;
+        probe(c[0], c[1], c[2]);
+      }
+    }
+  }
+}
+} // jkl
@@ -0,0 +1,190 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../lod.hpp"
+#include "../../parallel.hpp"
+#include "../../wide.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+
+namespace math {
+
+
+// The eye is where the view matrix takes the origin from, -t R^T with t its
+// translation row and R its rotation.
+inline LodView::LodView(const Mat4 &view, const Mat4 &projection, real32 viewportHeight)
+{
+  const real32 (*v)[4] = view.data;
+  eye = Vec3(
+    -(v[3][0] * v[0][0] + v[3][1] * v[0][1] + v[3][2] * v[0][2]),
+    -(v[3][0] * v[1][0] + v[3][1] * v[1][1] + v[3][2] * v[1][2]),
+    -(v[3][0] * v[2][0] + v[3][1] * v[2][1] + v[3][2] * v[2][2]));
+  pixelScale = Abs(projection.data[1][1]) * viewportHeight * 0.5f;
+  // Perspective projections put the view depth in w, and nothing else there.
+  perspective = projection.data[3][3] == 0.0f;
+}
+
+
+namespace detail {
+
+
+// The sphere spans an angle of 2 asin(r / d) from the eye, which projects
+// to r / sqrt(d^2 - r^2) at unit distance.
+inline real32 ProjectedRadius(const LodView &view, real32 x, real32 y, real32 z, real32 radius)
+{
+  if (!view.perspective) {
+    return view.pixelScale * radius;
+  }
+  real32 dx = x - view.eye.x, dy = y - view.eye.y, dz = z - view.eye.z;
+  real32 clearance = dx * dx + dy * dy + dz * dz - radius * radius;
+  return clearance > 0.0f ? view.pixelScale * radius / std::sqrt(clearance)
+    : (radius < 0.0f ? radius : std::numeric_limits<real32>::max());
+}
+
+
+// Level for a projected radius, from the level of the frame before. Each
+// threshold passed adds one.
+inline uint32 LodLevel(const LodSettings &settings, real32 pixels, uint32 previous)
+{
+  uint32 level = 0;
+  for (uint32 k = 0; k + 1 < settings.levelCount; ++k) {
+    real32 factor = previous <= k ? 1.0f - settings.hysteresis : 1.0f + settings.hysteresis;
+    level += pixels < settings.thresholds[k] * factor ? 1 : 0;
+  }
+  return level;
+}
+
+
+// Spheres per chunk when selecting in parallel.
+static const size_t LodChunkSize = 16 * 1024;
+
+
+// Select over [begin, end), writing from position out on. Returns how many
+// were written. The wide path does the same sums in the same order as the
+// scalar one, so both agree within rounding, which may differ where the
+// compiler contracts them into fused multiply adds.
+inline size_t SelectLodRange(const LodView &view, const SphereArray &spheres,
+  const LodSettings &settings, size_t begin, size_t end, uint8 *levels, uint32 *visible,
+  uint8 *visibleLevels, real32 *pixelRadii)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wideEnd = begin + (end - begin) / W * W;
+  const FloatN eyeX(view.eye.x), eyeY(view.eye.y), eyeZ(view.eye.z);
+  const FloatN scale(view.pixelScale), zero(0.0f), one(1.0f);
+  const FloatN inside(std::numeric_limits<real32>::max());
+  const FloatN minPixels(settings.minPixelRadius);
+  const FloatN finer(1.0f - settings.hysteresis), coarser(1.0f + settings.hysteresis);
+  size_t written = 0;
+  size_t i = begin;
+  for (; i < wideEnd; i += W) {
+    FloatN radius = FloatN::Load(&spheres.radius[i]);
+    FloatN pixels;
+    if (view.perspective) {
+      FloatN dx = FloatN::Load(&spheres.x[i]) - eyeX;
+      FloatN dy = FloatN::Load(&spheres.y[i]) - eyeY;
+      FloatN dz = FloatN::Load(&spheres.z[i]) - eyeZ;
+      FloatN clearance = dx * dx + dy * dy + dz * dz - radius * radius;
+      FloatN open = clearance > zero;
+      pixels = Select(open, scale * radius / Sqrt(Select(open, clearance, one)),
+        Select(radius < zero, radius, inside));
+    } else {
+      pixels = scale * radius;
+    }
+    int32 bits = MoveMask(pixels >= minPixels);
+    if (bits == 0) {
+      continue;
+    }
+    real32 previous[FloatN::Width];
+    for (uint32 l = 0; l < W; ++l) {
+      previous[l] = static_cast<real32>(levels[i + l]);
+    }
+    FloatN before = FloatN::Load(previous);
+    FloatN level = zero;
+    for (uint32 k = 0; k + 1 < settings.levelCount; ++k) {
+      FloatN factor = Select(before <= FloatN(static_cast<real32>(k)), finer, coarser);
+      level = level + Select(pixels < FloatN(settings.thresholds[k]) * factor, one, zero);
+    }
+    real32 pixelLanes[FloatN::Width], levelLanes[FloatN::Width];
+    pixels.Store(pixelLanes);
+    level.Store(levelLanes);
+    // Only the visible lanes are written, in order. Most groups keep a lane
+    // or two, so walking the set bits beats writing every lane.
+    for (; bits != 0; bits &= bits - 1) {
+      uint32 l = LowestLane(bits);
+      uint8 lod = static_cast<uint8>(levelLanes[l]);
+      levels[i + l] = lod;
+      visible[written] = static_cast<uint32>(i + l);
+      visibleLevels[written] = lod;
+      if (pixelRadii) {
+        pixelRadii[written] = pixelLanes[l];
+      }
+      ++written;
+    }
+  }
+  for (; i < end; ++i) {
+    real32 pixels = ProjectedRadius(view, spheres.x[i], spheres.y[i], spheres.z[i],
+      spheres.radius[i]);
+    if (!(pixels >= settings.minPixelRadius)) {
+      continue;
+    }
+    uint8 lod = static_cast<uint8>(LodLevel(settings, pixels, levels[i]));
+    levels[i] = lod;
+    visible[written] = static_cast<uint32>(i);
+    visibleLevels[written] = lod;
+    if (pixelRadii) {
+      pixelRadii[written] = pixels;
+    }
+    ++written;
+  }
+  return written;
+}
+} // detail
+
+
+inline real32 ProjectedRadius(const LodView &view, const Sphere &sphere)
+{
+  return detail::ProjectedRadius(view, sphere.center.x, sphere.center.y, sphere.center.z,
+    sphere.radius);
+}
+
+
+inline size_t SelectLodBatch(const LodView &view, const SphereArray &spheres,
+  const LodSettings &settings, uint8 *levels, uint32 *visible, uint8 *visibleLevels,
+  real32 *pixelRadii, bool parallel)
+{
+  const size_t count = spheres.Size();
+  const size_t chunkSize = detail::LodChunkSize;
+  const size_t chunks = (count + chunkSize - 1) / chunkSize;
+  if (!parallel || chunks < 2) {
+    return detail::SelectLodRange(view, spheres, settings, 0, count, levels, visible,
+      visibleLevels, pixelRadii);
+  }
+  std::vector<size_t> written(chunks);
+  ParallelFor(chunks, 1, [&] (size_t begin, size_t end) {
+    for (size_t chunk = begin; chunk < end; ++chunk) {
+      size_t first = chunk * chunkSize;
+      written[chunk] = detail::SelectLodRange(view, spheres, settings, first,
+        std::min(count, first + chunkSize), levels, visible + first, visibleLevels + first,
+        pixelRadii ? pixelRadii + first : nullptr);
+    }
+  });
+  size_t total = written[0];
+  for (size_t chunk = 1; chunk < chunks; ++chunk) {
+    size_t first = chunk * chunkSize;
+    std::memmove(visible + total, visible + first, written[chunk] * sizeof(uint32));
+    std::memmove(visibleLevels + total, visibleLevels + first, written[chunk] * sizeof(uint8));
+    if (pixelRadii) {
+      std::memmove(pixelRadii + total, pixelRadii + first, written[chunk] * sizeof(real32));
+    }
+    total += written[chunk];
+  }
+  return total;
+}
+} // jkl
@@ -0,0 +1,269 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../loose_octree.hpp"
+
+
+namespace math {
+
+
+inline LooseOctree::LooseOctree(const AABB &world, uint32 depth)
+  : freeNodes(InvalidIndex)
+  , freeNodeCount(0)
+  , worldCenter(world.Center())
+  , depth(depth < MaxDepth ? depth : MaxDepth)
+{
+  Vec3 extent = world.Extent();
+  worldHalfSize = extent.x > extent.y ? extent.x : extent.y;
+  worldHalfSize = worldHalfSize > extent.z ? worldHalfSize : extent.z;
+  AllocateNode(InvalidIndex, worldCenter, worldHalfSize, 0);
+}
+
+
+inline AABB LooseOctree::LooseBounds(const Node &node) const
+{
+  real32 loose = node.halfSize * 2.0f;
+  return AABB::FromCenterExtent(node.center, Vec3(loose, loose, loose));
+}
+
+
+// The deepest level whose cells are at least as large as the box, so that
+// the box reaches at most half a cell out of the cell holding its center.
+inline uint32 LooseOctree::DepthFor(const AABB &box) const
+{
+  Vec3 center = box.Center();
+  Vec3 extent = box.Extent();
+  real32 radius = extent.x > extent.y ? extent.x : extent.y;
+  radius = radius > extent.z ? radius : extent.z;
+  Vec3 offset = center - worldCenter;
+  if (Abs(offset.x) > worldHalfSize || Abs(offset.y) > worldHalfSize
+    || Abs(offset.z) > worldHalfSize || radius > worldHalfSize) {
+    return 0;
+  }
+  uint32 level = 0;
+  real32 halfSize = worldHalfSize;
+  while (level < depth && halfSize * 0.5f >= radius) {
+    halfSize *= 0.5f;
+    ++level;
+  }
+  return level;
+}
+
+
+inline bool LooseOctree::Fits(const Node &node, const AABB &box, uint32 level) const
+{
+  if (node.depth != level) {
+    return false;
+  }
+  Vec3 offset = box.Center() - node.center;
+  return level == 0 || (Abs(offset.x) <= node.halfSize && Abs(offset.y) <= node.halfSize
+    && Abs(offset.z) <= node.halfSize);
+}
+
+
+inline uint32 LooseOctree::AllocateNode(uint32 parent, const Vec3 &center, real32 halfSize,
+  uint32 level)
+{
+  uint32 index;
+  if (freeNodes != InvalidIndex) {
+    index = freeNodes;
+    freeNodes = nodes[index].first;
+    --freeNodeCount;
+  } else {
+    index = static_cast<uint32>(nodes.size());
+    nodes.push_back(Node());
+  }
+  Node &node = nodes[index];
+  node.center = center;
+  node.halfSize = halfSize;
+  node.parent = parent;
+  for (uint32 c = 0; c < 8; ++c) {
+    node.children[c] = InvalidIndex;
+  }
+  node.first = InvalidIndex;
+  node.objectCount = 0;
+  node.childCount = 0;
+  node.depth = level;
+  return index;
+}
+
+
+inline uint32 LooseOctree::FindNode(const AABB &box)
+{
+  const uint32 level = DepthFor(box);
+  const Vec3 center = box.Center();
+  uint32 index = 0;
+  for (uint32 d = 0; d < level; ++d) {
+    const Node &node = nodes[index];
+    uint32 child = (center.x >= node.center.x ? 1 : 0) | (center.y >= node.center.y ? 2 : 0)
+      | (center.z >= node.center.z ? 4 : 0);
+    uint32 next = node.children[child];
+    if (next == InvalidIndex) {
+      real32 quarter = node.halfSize * 0.5f;
+      Vec3 childCenter(node.center.x + ((child & 1) ? quarter : -quarter),
+        node.center.y + ((child & 2) ? quarter : -quarter),
+        node.center.z + ((child & 4) ? quarter : -quarter));
+      next = AllocateNode(index, childCenter, quarter, d + 1);
+      nodes[index].children[child] = next;
+      ++nodes[index].childCount;
+    }
+    index = next;
+  }
+  return index;
+}
+
+
+inline void LooseOctree::Prune(uint32 index)
+{
+  while (index != 0) {
+    Node &node = nodes[index];
+    if (node.objectCount != 0 || node.childCount != 0) {
+      return;
+    }
+    Node &parent = nodes[node.parent];
+    for (uint32 c = 0; c < 8; ++c) {
+      if (parent.children[c] == index) {
+        parent.children[c] = InvalidIndex;
+      }
+    }
+    --parent.childCount;
+    uint32 next = node.parent;
+    node.first = freeNodes;
+    node.parent = InvalidIndex;
+    freeNodes = index;
+    ++freeNodeCount;
+    index = next;
+  }
+}
+
+
+inline uint32 LooseOctree::Insert(const AABB &box)
+{
+  uint32 handle = AllocateObject(box);
+  uint32 node = FindNode(box);
+  Link(nodes[node].first, handle, node);
+  ++nodes[node].objectCount;
+  return handle;
+}
+
+
+inline void LooseOctree::Remove(uint32 handle)
+{
+  uint32 node = objects[handle].cell;
+  Unlink(nodes[node].first, handle);
+  --nodes[node].objectCount;
+  FreeObject(handle);
+  Prune(node);
+}
+
+
+inline void LooseOctree::Move(uint32 handle, const AABB &box)
+{
+  detail::SpatialObject &object = objects[handle];
+  object.box = box;
+  uint32 old = object.cell;
+  if (Fits(nodes[old], box, DepthFor(box))) {
+    return;
+  }
+  Unlink(nodes[old].first, handle);
+  --nodes[old].objectCount;
+  uint32 node = FindNode(box);
+  Link(nodes[node].first, handle, node);
+  ++nodes[node].objectCount;
+  // Only now, the new node may hang below the old one.
+  Prune(old);
+}
+
+
+inline void LooseOctree::Clear()
+{
+  nodes.clear();
+  freeNodes = InvalidIndex;
+  freeNodeCount = 0;
+  ClearObjects();
+  AllocateNode(InvalidIndex, worldCenter, worldHalfSize, 0);
+}
+
+
+template<typename Test, typename Visit>
+void LooseOctree::Walk(const Test &test, const Visit &visit) const
+{
+  struct Entry {
+    uint32 node;
+    bool inside;
+  };
+  // Every level pushes at most eight children and pops one of them.
+  Entry stack[8 * (MaxDepth + 1)];
+  uint32 size = 0;
+  stack[size++] = Entry{ 0, false };
+  while (size > 0) {
+    Entry entry = stack[--size];
+    const Node &node = nodes[entry.node];
+    int32 result = 1;
+    if (!entry.inside) {
+      result = entry.node == 0 ? 0 : test(LooseBounds(node));
+    }
+    if (result < 0) {
+      continue;
+    }
+    visit(node, result > 0);
+    if (node.childCount == 0) {
+      continue;
+    }
+    for (uint32 c = 0; c < 8; ++c) {
+      if (node.children[c] != InvalidIndex) {
+        stack[size++] = Entry{ node.children[c], result > 0 };
+      }
+    }
+  }
+}
+
+
+// Below the root, the objects of a node lie within its loose bounds, so all
+// of them pass where the whole node does.
+inline void LooseOctree::QueryBox(const AABB &box, std::vector<uint32> &results) const
+{
+  Walk(
+    [&] (const AABB &bounds) {
+      return !bounds.Intersects(box) ? -1 : (detail::Contains(box, bounds) ? 1 : 0);
+    },
+    [&] (const Node &node, bool inside) {
+      Collect(node.first, [&] (const AABB &object) {
+        return inside || object.Intersects(box);
+      }, results);
+    });
+}
+
+
+inline void LooseOctree::QueryFrustum(const Frustum &frustum, std::vector<uint32> &results) const
+{
+  Walk(
+    [&] (const AABB &bounds) {
+      return detail::ClassifyBox(frustum, bounds);
+    },
+    [&] (const Node &node, bool inside) {
+      Collect(node.first, [&] (const AABB &object) {
+        return inside || frustum.Intersects(object);
+      }, results);
+    });
+}
+
+
+inline void LooseOctree::QueryRay(const Ray3 &ray, real32 maxDistance,
+  std::vector<uint32> &results) const
+{
+  Walk(
+    [&] (const AABB &bounds) {
+      real32 distance;
+      return Intersect(ray, bounds, distance, maxDistance) ? 0 : -1;
+    },
+    [&] (const Node &node, bool) {
+      Collect(node.first, [&] (const AABB &object) {
+        real32 distance;
+        return Intersect(ray, object, distance, maxDistance);
+      }, results);
+    });
+}
+} // jkl
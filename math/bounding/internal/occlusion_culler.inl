@@ -0,0 +1,517 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../occlusion_culler.hpp"
+#include "../../parallel.hpp"
+#include "../../wide.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+namespace math {
+namespace detail {
+
+
+// Smallest w taken to be in front of the near plane, anything closer is
+// clipped by the projection anyway.
+static const real32 OcclusionMinW = 1e-6f;
+
+// Boxes per chunk when culling in parallel, see detail::Cull.
+static const size_t OcclusionChunkSize = 4 * 1024;
+
+// Tiles per range when rasterizing in parallel.
+static const size_t OcclusionTileGrain = 8;
+
+
+// Offsets of the lanes within a row of a tile, from the left of the row.
+inline FloatN OcclusionLaneOffsets()
+{
+  static const real32 offsets[8] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+  return FloatN::Load(offsets);
+}
+} // detail
+
+
+inline OcclusionCuller::OcclusionCuller(uint32 width, uint32 height)
+  : width(width)
+  , height(height)
+  , tilesX((width + TileWidth - 1) / TileWidth)
+  , tilesY((height + TileHeight - 1) / TileHeight)
+  , triangleBudget(DefaultTriangleBudget)
+  , frontFace(FrontFace::CounterClockwise)
+  , binStart(tilesX * tilesY + 1, 0)
+  , depth(tilesX * tilesY * TileWidth * TileHeight, 0.0f)
+  , tileDepth(tilesX * tilesY, 0.0f)
+{
+  static_assert(TileWidth % FloatN::Width == 0, "Tile rows must hold whole FloatN.");
+}
+
+
+inline void OcclusionCuller::Begin(const Mat4 &viewProjection)
+{
+  this->viewProjection = viewProjection;
+  occluders.clear();
+  triangles.clear();
+  std::fill(depth.begin(), depth.end(), 0.0f);
+  std::fill(tileDepth.begin(), tileDepth.end(), 0.0f);
+}
+
+
+inline void OcclusionCuller::AddOccluder(const Mat4 &world, const AABB &bounds,
+  StridedSpan<const Vec3> positions, const uint32 *indices, uint32 triangleCount)
+{
+  Occluder occluder;
+  occluder.transform = world * viewProjection;
+  occluder.positions = positions;
+  occluder.indices = indices;
+  occluder.triangleCount = triangleCount;
+  occluder.mirrored = world.Determinant() < 0.0f;
+  ScreenBox rect = ProjectBox(occluder.transform, bounds);
+  if (rect.nearPlane) {
+    // Whatever the camera stands next to hides the most.
+    occluder.area = std::numeric_limits<real32>::max();
+  } else {
+    real32 w = std::min(rect.maxX, static_cast<real32>(width)) - std::max(rect.minX, 0.0f);
+    real32 h = std::min(rect.maxY, static_cast<real32>(height)) - std::max(rect.minY, 0.0f);
+    if (w <= 0.0f || h <= 0.0f) {
+      return;
+    }
+    occluder.area = w * h;
+  }
+  occluders.push_back(occluder);
+}
+
+
+inline void OcclusionCuller::SetupTriangles(const Occluder &occluder)
+{
+  const real32 (*m)[4] = occluder.transform.data;
+  const real32 halfWidth = static_cast<real32>(width) * 0.5f;
+  const real32 halfHeight = static_cast<real32>(height) * 0.5f;
+  for (uint32 t = 0; t < occluder.triangleCount; ++t) {
+    real32 x[3], y[3], z[3];
+    bool behind = false;
+    for (uint32 k = 0; k < 3; ++k) {
+      const Vec3 &p = occluder.positions[occluder.indices[t * 3 + k]];
+      real32 cx = p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0];
+      real32 cy = p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1];
+      real32 cw = p.x * m[0][3] + p.y * m[1][3] + p.z * m[2][3] + m[3][3];
+      behind = behind || cw < detail::OcclusionMinW;
+      z[k] = 1.0f / cw;
+      x[k] = halfWidth * (cx * z[k] + 1.0f);
+      y[k] = halfHeight * (cy * z[k] + 1.0f);
+    }
+    if (behind) {
+      continue;
+    }
+    real32 area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (!(Abs(area) > 1e-8f)) {
+      continue;
+    }
+    // Positive area winds counter clockwise.
+    if (frontFace != FrontFace::Both &&
+        ((area > 0.0f) != occluder.mirrored) != (frontFace == FrontFace::CounterClockwise)) {
+      continue;
+    }
+    // Wind counter clockwise, so that inside is where every edge is positive.
+    if (area < 0.0f) {
+      std::swap(x[1], x[2]);
+      std::swap(y[1], y[2]);
+      std::swap(z[1], z[2]);
+      area = -area;
+    }
+    // Pixels whose centers the bounds hold.
+    real32 minX = std::min(x[0], std::min(x[1], x[2]));
+    real32 maxX = std::max(x[0], std::max(x[1], x[2]));
+    real32 minY = std::min(y[0], std::min(y[1], y[2]));
+    real32 maxY = std::max(y[0], std::max(y[1], y[2]));
+    Triangle tri;
+    tri.x0 = static_cast<int32>(std::max(std::ceil(minX - 0.5f), 0.0f));
+    tri.y0 = static_cast<int32>(std::max(std::ceil(minY - 0.5f), 0.0f));
+    tri.x1 = static_cast<int32>(std::min(std::floor(maxX - 0.5f), static_cast<real32>(width) - 1.0f));
+    tri.y1 = static_cast<int32>(std::min(std::floor(maxY - 0.5f), static_cast<real32>(height) - 1.0f));
+    if (tri.x0 > tri.x1 || tri.y0 > tri.y1) {
+      continue;
+    }
+    for (uint32 e = 0; e < 3; ++e) {
+      uint32 a = e, b = (e + 1) % 3;
+      tri.edgeA[e] = y[a] - y[b];
+      tri.edgeB[e] = x[b] - x[a];
+      tri.edgeC[e] = -(tri.edgeA[e] * x[a] + tri.edgeB[e] * y[a]);
+    }
+    real32 dz1 = z[1] - z[0], dz2 = z[2] - z[0];
+    real32 invArea = 1.0f / area;
+    tri.depthA = (dz1 * (y[2] - y[0]) - dz2 * (y[1] - y[0])) * invArea;
+    tri.depthB = (dz2 * (x[1] - x[0]) - dz1 * (x[2] - x[0])) * invArea;
+    tri.depthC = z[0] - tri.depthA * x[0] - tri.depthB * y[0];
+    triangles.push_back(tri);
+  }
+}
+
+
+inline void OcclusionCuller::RasterizeTile(uint32 tile)
+{
+  const uint32 W = FloatN::Width;
+  const FloatN lanes = detail::OcclusionLaneOffsets();
+  const FloatN zero(0.0f);
+  const int32 left = static_cast<int32>(tile % tilesX * TileWidth);
+  const int32 bottom = static_cast<int32>(tile / tilesX * TileHeight);
+  const int32 right = left + static_cast<int32>(TileWidth) - 1;
+  const int32 top = bottom + static_cast<int32>(TileHeight) - 1;
+  real32 *pixels = &depth[tile * TileWidth * TileHeight];
+
+  for (uint32 b = binStart[tile]; b < binStart[tile + 1]; ++b) {
+    const Triangle &tri = triangles[bins[b]];
+    const int32 y0 = std::max(tri.y0, bottom), y1 = std::min(tri.y1, top);
+    const int32 x0 = std::max(tri.x0, left), x1 = std::min(tri.x1, right);
+    FloatN a0(tri.edgeA[0]), a1(tri.edgeA[1]), a2(tri.edgeA[2]), dA(tri.depthA);
+    for (int32 y = y0; y <= y1; ++y) {
+      const real32 center = static_cast<real32>(y) + 0.5f;
+      FloatN e0(tri.edgeB[0] * center + tri.edgeC[0]);
+      FloatN e1(tri.edgeB[1] * center + tri.edgeC[1]);
+      FloatN e2(tri.edgeB[2] * center + tri.edgeC[2]);
+      FloatN dz(tri.depthB * center + tri.depthC);
+      real32 *row = pixels + (y - bottom) * TileWidth;
+      for (uint32 base = 0; base < TileWidth; base += W) {
+        const int32 first = left + static_cast<int32>(base);
+        if (first > x1 || first + static_cast<int32>(W) - 1 < x0) {
+          continue;
+        }
+        // Columns off the bounds fail an edge, or lie off the screen.
+        FloatN xs = FloatN(static_cast<real32>(first) + 0.5f) + lanes;
+        FloatN inside = (a0 * xs + e0 >= zero) & (a1 * xs + e1 >= zero) & (a2 * xs + e2 >= zero)
+          & (xs < FloatN(static_cast<real32>(width)));
+        FloatN old = FloatN::Load(row + base);
+        Select(inside, Max(old, dA * xs + dz), old).Store(row + base);
+      }
+    }
+  }
+
+  // Furthest pixel on the screen. TileHeight goes to std::min as a copy, as
+  // binding the constant to a reference would need a definition of it.
+  FloatN furthest(std::numeric_limits<real32>::max());
+  const uint32 rows = std::min(static_cast<uint32>(TileHeight), height - static_cast<uint32>(bottom));
+  for (uint32 r = 0; r < rows; ++r) {
+    for (uint32 base = 0; base < TileWidth; base += W) {
+      FloatN xs = FloatN(static_cast<real32>(left + static_cast<int32>(base))) + lanes;
+      FloatN onScreen = xs < FloatN(static_cast<real32>(width));
+      furthest = Min(furthest, Select(onScreen, FloatN::Load(pixels + r * TileWidth + base),
+        FloatN(std::numeric_limits<real32>::max())));
+    }
+  }
+  tileDepth[tile] = ReduceMin(furthest);
+}
+
+
+inline void OcclusionCuller::Rasterize(bool parallel)
+{
+  triangles.clear();
+  std::stable_sort(occluders.begin(), occluders.end(),
+    [] (const Occluder &a, const Occluder &b) { return a.area > b.area; });
+  // Only the triangles kept count against the budget, back faces and those
+  // off the screen don't.
+  for (const Occluder &occluder : occluders) {
+    if (triangles.size() + occluder.triangleCount > triangleBudget) {
+      continue;
+    }
+    SetupTriangles(occluder);
+  }
+
+  // Bin by tile, counting first so that bins is one flat array.
+  const uint32 tileCount = tilesX * tilesY;
+  std::fill(binStart.begin(), binStart.end(), 0);
+  // Tiles whose pixel centers all fall outside one edge are left out, which
+  // matters for long diagonal triangles.
+  auto covers = [] (const Triangle &tri, int32 tx, int32 ty) {
+    const real32 x0 = static_cast<real32>(tx * static_cast<int32>(TileWidth)) + 0.5f;
+    const real32 y0 = static_cast<real32>(ty * static_cast<int32>(TileHeight)) + 0.5f;
+    const real32 x1 = x0 + static_cast<real32>(TileWidth - 1);
+    const real32 y1 = y0 + static_cast<real32>(TileHeight - 1);
+    for (uint32 e = 0; e < 3; ++e) {
+      real32 x = tri.edgeA[e] >= 0.0f ? x1 : x0;
+      real32 y = tri.edgeB[e] >= 0.0f ? y1 : y0;
+      if (tri.edgeA[e] * x + tri.edgeB[e] * y + tri.edgeC[e] < 0.0f) {
+        return false;
+      }
+    }
+    return true;
+  };
+  for (const Triangle &tri : triangles) {
+    for (int32 ty = tri.y0 / static_cast<int32>(TileHeight); ty <= tri.y1 / static_cast<int32>(TileHeight); ++ty) {
+      for (int32 tx = tri.x0 / static_cast<int32>(TileWidth); tx <= tri.x1 / static_cast<int32>(TileWidth); ++tx) {
+        binStart[ty * tilesX + tx + 1] += covers(tri, tx, ty) ? 1 : 0;
+      }
+    }
+  }
+  for (uint32 t = 0; t < tileCount; ++t) {
+    binStart[t + 1] += binStart[t];
+  }
+  bins.resize(binStart[tileCount]);
+  std::vector<uint32> cursor(binStart.begin(), binStart.end() - 1);
+  for (uint32 i = 0; i < triangles.size(); ++i) {
+    const Triangle &tri = triangles[i];
+    for (int32 ty = tri.y0 / static_cast<int32>(TileHeight); ty <= tri.y1 / static_cast<int32>(TileHeight); ++ty) {
+      for (int32 tx = tri.x0 / static_cast<int32>(TileWidth); tx <= tri.x1 / static_cast<int32>(TileWidth); ++tx) {
+        if (covers(tri, tx, ty)) {
+          bins[cursor[ty * tilesX + tx]++] = i;
+        }
+      }
+    }
+  }
+
+  auto rasterize = [this] (size_t begin, size_t end) {
+    for (size_t t = begin; t < end; ++t) {
+      RasterizeTile(static_cast<uint32>(t));
+    }
+  };
+  if (parallel) {
+    ParallelFor(tileCount, detail::OcclusionTileGrain, rasterize);
+  } else {
+    rasterize(0, tileCount);
+  }
+}
+
+
+inline real32 OcclusionCuller::Depth(uint32 x, uint32 y) const
+{
+  uint32 tile = y / TileHeight * tilesX + x / TileWidth;
+  return depth[tile * TileWidth * TileHeight + y % TileHeight * TileWidth + x % TileWidth];
+}
+
+
+// w is affine in the position, so the nearest point of the box is one of its
+// corners, as is the furthest out on the screen.
+inline OcclusionCuller::ScreenBox OcclusionCuller::ProjectBox(const Mat4 &transform,
+  const AABB &box) const
+{
+  const real32 (*m)[4] = transform.data;
+  const real32 halfWidth = static_cast<real32>(width) * 0.5f;
+  const real32 halfHeight = static_cast<real32>(height) * 0.5f;
+  ScreenBox rect;
+  rect.minX = rect.minY = std::numeric_limits<real32>::max();
+  rect.maxX = rect.maxY = std::numeric_limits<real32>::lowest();
+  rect.depth = 0.0f;
+  rect.nearPlane = false;
+  for (uint32 c = 0; c < 8; ++c) {
+    Vec3 p((c & 1) ? box.max.x : box.min.x, (c & 2) ? box.max.y : box.min.y,
+      (c & 4) ? box.max.z : box.min.z);
+    real32 cx = p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0];
+    real32 cy = p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1];
+    real32 cw = p.x * m[0][3] + p.y * m[1][3] + p.z * m[2][3] + m[3][3];
+    if (cw < detail::OcclusionMinW) {
+      rect.nearPlane = true;
+      return rect;
+    }
+    real32 inv = 1.0f / cw;
+    real32 sx = halfWidth * (cx * inv + 1.0f);
+    real32 sy = halfHeight * (cy * inv + 1.0f);
+    rect.minX = std::min(rect.minX, sx);
+    rect.maxX = std::max(rect.maxX, sx);
+    rect.minY = std::min(rect.minY, sy);
+    rect.maxY = std::max(rect.maxY, sy);
+    rect.depth = std::max(rect.depth, inv);
+  }
+  return rect;
+}
+
+
+inline void OcclusionCuller::ProjectWide(const real32 *minX, const real32 *minY,
+  const real32 *minZ, const real32 *maxX, const real32 *maxY, const real32 *maxZ,
+  ScreenBox *rects) const
+{
+  const uint32 W = FloatN::Width;
+  const real32 (*m)[4] = viewProjection.data;
+  // Each coordinate's share of clip x, y and w, at either end of the box.
+  const FloatN lo[3] = { FloatN::Load(minX), FloatN::Load(minY), FloatN::Load(minZ) };
+  const FloatN hi[3] = { FloatN::Load(maxX), FloatN::Load(maxY), FloatN::Load(maxZ) };
+  const uint32 columns[3] = { 0, 1, 3 };
+  FloatN part[3][3][2];
+  for (uint32 axis = 0; axis < 3; ++axis) {
+    for (uint32 c = 0; c < 3; ++c) {
+      part[axis][c][0] = lo[axis] * FloatN(m[axis][columns[c]]);
+      part[axis][c][1] = hi[axis] * FloatN(m[axis][columns[c]]);
+    }
+  }
+  const FloatN halfWidth(static_cast<real32>(width) * 0.5f);
+  const FloatN halfHeight(static_cast<real32>(height) * 0.5f);
+  const FloatN one(1.0f);
+  FloatN sMinX(std::numeric_limits<real32>::max()), sMinY(std::numeric_limits<real32>::max());
+  FloatN sMaxX(std::numeric_limits<real32>::lowest()), sMaxY(std::numeric_limits<real32>::lowest());
+  FloatN nearest(0.0f);
+  FloatN behind(0.0f);
+  for (uint32 corner = 0; corner < 8; ++corner) {
+    uint32 i = corner & 1, j = (corner >> 1) & 1, k = (corner >> 2) & 1;
+    FloatN cx = part[0][0][i] + part[1][0][j] + part[2][0][k] + FloatN(m[3][0]);
+    FloatN cy = part[0][1][i] + part[1][1][j] + part[2][1][k] + FloatN(m[3][1]);
+    FloatN cw = part[0][2][i] + part[1][2][j] + part[2][2][k] + FloatN(m[3][3]);
+    behind = behind | (cw < FloatN(detail::OcclusionMinW));
+    FloatN inv = one / cw;
+    FloatN sx = halfWidth * (cx * inv + one);
+    FloatN sy = halfHeight * (cy * inv + one);
+    sMinX = Min(sMinX, sx);
+    sMaxX = Max(sMaxX, sx);
+    sMinY = Min(sMinY, sy);
+    sMaxY = Max(sMaxY, sy);
+    nearest = Max(nearest, inv);
+  }
+  real32 x0[W], y0[W], x1[W], y1[W], d[W];
+  sMinX.Store(x0);
+  sMinY.Store(y0);
+  sMaxX.Store(x1);
+  sMaxY.Store(y1);
+  nearest.Store(d);
+  int32 bits = MoveMask(behind);
+  for (uint32 l = 0; l < W; ++l) {
+    rects[l].minX = x0[l];
+    rects[l].minY = y0[l];
+    rects[l].maxX = x1[l];
+    rects[l].maxY = y1[l];
+    rects[l].depth = d[l];
+    rects[l].nearPlane = ((bits >> l) & 1) != 0;
+  }
+}
+
+
+// Tiles whose furthest pixel is nearer than the box hide their part of it
+// outright, and tiles the rectangle covers whole show it as soon as their
+// furthest pixel is not. Only the tiles along its edges need their pixels.
+inline bool OcclusionCuller::TestRect(const ScreenBox &rect) const
+{
+  if (rect.nearPlane) {
+    return true;
+  }
+  if (!(rect.maxX >= 0.0f && rect.maxY >= 0.0f && rect.minX < static_cast<real32>(width)
+    && rect.minY < static_cast<real32>(height))) {
+    return false;
+  }
+  const uint32 W = FloatN::Width;
+  const int32 x0 = static_cast<int32>(std::max(std::floor(rect.minX), 0.0f));
+  const int32 y0 = static_cast<int32>(std::max(std::floor(rect.minY), 0.0f));
+  const int32 x1 = static_cast<int32>(std::min(std::floor(rect.maxX), static_cast<real32>(width) - 1.0f));
+  const int32 y1 = static_cast<int32>(std::min(std::floor(rect.maxY), static_cast<real32>(height) - 1.0f));
+  const FloatN lanes = detail::OcclusionLaneOffsets();
+  const FloatN boxDepth(rect.depth);
+  const FloatN columnMin(static_cast<real32>(x0)), columnMax(static_cast<real32>(x1));
+  for (int32 ty = y0 / static_cast<int32>(TileHeight); ty <= y1 / static_cast<int32>(TileHeight); ++ty) {
+    for (int32 tx = x0 / static_cast<int32>(TileWidth); tx <= x1 / static_cast<int32>(TileWidth); ++tx) {
+      const uint32 tile = static_cast<uint32>(ty) * tilesX + static_cast<uint32>(tx);
+      if (rect.depth < tileDepth[tile]) {
+        continue;
+      }
+      const int32 left = tx * static_cast<int32>(TileWidth);
+      const int32 bottom = ty * static_cast<int32>(TileHeight);
+      const int32 right = std::min(left + static_cast<int32>(TileWidth), static_cast<int32>(width)) - 1;
+      const int32 top = std::min(bottom + static_cast<int32>(TileHeight), static_cast<int32>(height)) - 1;
+      if (x0 <= left && x1 >= right && y0 <= bottom && y1 >= top) {
+        return true;
+      }
+      const real32 *pixels = &depth[tile * TileWidth * TileHeight];
+      for (int32 y = std::max(y0, bottom); y <= std::min(y1, top); ++y) {
+        const real32 *row = pixels + (y - bottom) * static_cast<int32>(TileWidth);
+        for (uint32 base = 0; base < TileWidth; base += W) {
+          FloatN xs = FloatN(static_cast<real32>(left + static_cast<int32>(base))) + lanes;
+          FloatN open = (xs >= columnMin) & (xs <= columnMax) & (FloatN::Load(row + base) <= boxDepth);
+          if (Any(open)) {
+            return true;
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
+
+
+inline bool OcclusionCuller::IsVisible(const AABB &box) const
+{
+  return TestRect(ProjectBox(viewProjection, box));
+}
+
+
+inline size_t OcclusionCuller::CullRange(const AABBArray &boxes, size_t begin, size_t end,
+  uint32 *visible) const
+{
+  const uint32 W = FloatN::Width;
+  const size_t wideEnd = begin + (end - begin) / W * W;
+  size_t written = 0;
+  size_t i = begin;
+  ScreenBox rects[FloatN::Width];
+  for (; i < wideEnd; i += W) {
+    ProjectWide(&boxes.minX[i], &boxes.minY[i], &boxes.minZ[i],
+      &boxes.maxX[i], &boxes.maxY[i], &boxes.maxZ[i], rects);
+    int32 bits = 0;
+    for (uint32 l = 0; l < W; ++l) {
+      bits |= TestRect(rects[l]) ? 1 << l : 0;
+    }
+    detail::AppendLanes(bits, i, visible, written);
+  }
+  for (; i < end; ++i) {
+    visible[written] = static_cast<uint32>(i);
+    written += IsVisible(boxes.Get(i)) ? 1 : 0;
+  }
+  return written;
+}
+
+
+inline size_t OcclusionCuller::CullBatch(const AABBArray &boxes, uint32 *visible,
+  bool parallel) const
+{
+  const size_t count = boxes.Size();
+  const size_t chunkSize = detail::OcclusionChunkSize;
+  const size_t chunks = (count + chunkSize - 1) / chunkSize;
+  if (!parallel || chunks < 2) {
+    return CullRange(boxes, 0, count, visible);
+  }
+  std::vector<size_t> written(chunks);
+  ParallelFor(chunks, 1, [&] (size_t begin, size_t end) {
+    for (size_t chunk = begin; chunk < end; ++chunk) {
+      size_t first = chunk * chunkSize;
+      written[chunk] = CullRange(boxes, first, std::min(count, first + chunkSize), visible + first);
+    }
+  });
+  size_t total = written[0];
+  for (size_t chunk = 1; chunk < chunks; ++chunk) {
+    std::memmove(visible + total, visible + chunk * chunkSize, written[chunk] * sizeof(uint32));
+    total += written[chunk];
+  }
+  return total;
+}
+
+
+// Lanes are gathered before anything is written, which is what lets visible
+// be indices.
+inline size_t OcclusionCuller::CullBatch(const AABBArray &boxes, const uint32 *indices,
+  size_t count, uint32 *visible) const
+{
+  const uint32 W = FloatN::Width;
+  const size_t wideEnd = count / W * W;
+  size_t written = 0;
+  size_t i = 0;
+  ScreenBox rects[FloatN::Width];
+  for (; i < wideEnd; i += W) {
+    uint32 ids[FloatN::Width];
+    real32 x0[FloatN::Width], y0[FloatN::Width], z0[FloatN::Width];
+    real32 x1[FloatN::Width], y1[FloatN::Width], z1[FloatN::Width];
+    for (uint32 l = 0; l < W; ++l) {
+      uint32 id = ids[l] = indices[i + l];
+      x0[l] = boxes.minX[id]; y0[l] = boxes.minY[id]; z0[l] = boxes.minZ[id];
+      x1[l] = boxes.maxX[id]; y1[l] = boxes.maxY[id]; z1[l] = boxes.maxZ[id];
+    }
+    ProjectWide(x0, y0, z0, x1, y1, z1, rects);
+    for (uint32 l = 0; l < W; ++l) {
+      visible[written] = ids[l];
+      written += TestRect(rects[l]) ? 1 : 0;
+    }
+  }
+  for (; i < count; ++i) {
+    uint32 id = indices[i];
+    visible[written] = id;
+    written += IsVisible(boxes.Get(id)) ? 1 : 0;
+  }
+  return written;
+}
+} // jkl
@@ -0,0 +1,127 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../spatial_index.hpp"
+
+
+namespace math {
+namespace detail {
+
+
+// Which side of the frustum box is on: 1 inside, -1 outside, 0 straddling
+// or unsure, with the same caveat as Frustum::Intersects.
+inline int32 ClassifyBox(const Frustum &frustum, const AABB &box)
+{
+  int32 result = 1;
+  for (uint32 p = 0; p < Frustum::PlaneCount; ++p) {
+    const Vec4 &n = frustum.planes[p];
+    real32 px = n.x >= 0.0f ? box.max.x : box.min.x;
+    real32 py = n.y >= 0.0f ? box.max.y : box.min.y;
+    real32 pz = n.z >= 0.0f ? box.max.z : box.min.z;
+    if (n.x * px + n.y * py + n.z * pz + n.w < 0.0f) {
+      return -1;
+    }
+    real32 nx = n.x >= 0.0f ? box.min.x : box.max.x;
+    real32 ny = n.y >= 0.0f ? box.min.y : box.max.y;
+    real32 nz = n.z >= 0.0f ? box.min.z : box.max.z;
+    if (n.x * nx + n.y * ny + n.z * nz + n.w < 0.0f) {
+      result = 0;
+    }
+  }
+  return result;
+}
+
+
+inline bool Contains(const AABB &outer, const AABB &inner)
+{
+  return inner.min.x >= outer.min.x && inner.min.y >= outer.min.y && inner.min.z >= outer.min.z
+    && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+} // detail
+
+
+inline SpatialIndex::SpatialIndex()
+  : freeObjects(InvalidIndex)
+  , count(0)
+{ }
+
+
+inline uint32 SpatialIndex::AllocateObject(const AABB &box)
+{
+  uint32 handle;
+  if (freeObjects != InvalidIndex) {
+    handle = freeObjects;
+    freeObjects = objects[handle].next;
+  } else {
+    handle = static_cast<uint32>(objects.size());
+    objects.push_back(detail::SpatialObject());
+  }
+  detail::SpatialObject &object = objects[handle];
+  object.box = box;
+  object.cell = InvalidIndex;
+  object.prev = object.next = InvalidIndex;
+  ++count;
+  return handle;
+}
+
+
+inline void SpatialIndex::FreeObject(uint32 handle)
+{
+  detail::SpatialObject &object = objects[handle];
+  object.box = AABB();
+  object.cell = InvalidIndex;
+  object.prev = InvalidIndex;
+  object.next = freeObjects;
+  freeObjects = handle;
+  --count;
+}
+
+
+inline void SpatialIndex::ClearObjects()
+{
+  objects.clear();
+  freeObjects = InvalidIndex;
+  count = 0;
+}
+
+
+inline void SpatialIndex::Link(uint32 &first, uint32 handle, uint32 cell)
+{
+  detail::SpatialObject &object = objects[handle];
+  object.cell = cell;
+  object.prev = InvalidIndex;
+  object.next = first;
+  if (first != InvalidIndex) {
+    objects[first].prev = handle;
+  }
+  first = handle;
+}
+
+
+inline void SpatialIndex::Unlink(uint32 &first, uint32 handle)
+{
+  detail::SpatialObject &object = objects[handle];
+  if (object.prev != InvalidIndex) {
+    objects[object.prev].next = object.next;
+  } else {
+    first = object.next;
+  }
+  if (object.next != InvalidIndex) {
+    objects[object.next].prev = object.prev;
+  }
+  object.cell = object.prev = object.next = InvalidIndex;
+}
+
+
+template<typename Test>
+void SpatialIndex::Collect(uint32 first, const Test &test, std::vector<uint32> &results) const
+{
+  for (uint32 handle = first; handle != InvalidIndex; handle = objects[handle].next) {
+    if (test(objects[handle].box)) {
+      results.push_back(handle);
+    }
+  }
+}
+} // jkl
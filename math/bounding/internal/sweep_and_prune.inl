@@ -0,0 +1,286 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../sweep_and_prune.hpp"
+
+#include <algorithm>
+#include <limits>
+
+
+namespace math {
+
+
+inline SweepAndPrune::SweepAndPrune()
+  : added(nullptr)
+  , removed(nullptr)
+  , userData(nullptr)
+{ }
+
+
+inline void SweepAndPrune::SetCallbacks(PairCallback added, PairCallback removed,
+  void *userData)
+{
+  this->added = added;
+  this->removed = removed;
+  this->userData = userData;
+}
+
+
+// Mins sort before maxes of the same value, so touching boxes overlap.
+inline bool SweepAndPrune::Less(const Endpoint &a, const Endpoint &b)
+{
+  return a.value < b.value || (a.value == b.value && (a.data & 1) < (b.data & 1));
+}
+
+
+inline void SweepAndPrune::AddPair(uint32 a, uint32 b)
+{
+  if (pairs.insert(PairKey(a, b)).second && added) {
+    added(userData, a < b ? a : b, a < b ? b : a);
+  }
+}
+
+
+inline void SweepAndPrune::RemovePair(uint32 a, uint32 b)
+{
+  if (pairs.erase(PairKey(a, b)) != 0 && removed) {
+    removed(userData, a < b ? a : b, a < b ? b : a);
+  }
+}
+
+
+inline void SweepAndPrune::SetIndex(uint32 axis, const Endpoint &endpoint, uint32 index)
+{
+  Object &object = objects[endpoint.data >> 1];
+  if (endpoint.data & 1) {
+    object.max[axis] = index;
+  } else {
+    object.min[axis] = index;
+  }
+}
+
+
+// Move the endpoint at index towards the front until it is in order. A min
+// passing a max is where two boxes may start overlapping, which the full
+// box test then decides, and a max passing a min where they stop.
+inline void SweepAndPrune::SortDown(uint32 axis, uint32 index)
+{
+  std::vector<Endpoint> &list = endpoints[axis];
+  const Endpoint endpoint = list[index];
+  const uint32 handle = endpoint.data >> 1;
+  while (index > 0 && Less(endpoint, list[index - 1])) {
+    const Endpoint &previous = list[index - 1];
+    const uint32 other = previous.data >> 1;
+    if (other != handle) {
+      const bool isMax = (endpoint.data & 1) != 0;
+      const bool previousMax = (previous.data & 1) != 0;
+      if (!isMax && previousMax) {
+        if (objects[handle].box.Intersects(objects[other].box)) {
+          AddPair(handle, other);
+        }
+      } else if (isMax && !previousMax) {
+        RemovePair(handle, other);
+      }
+    }
+    list[index] = previous;
+    SetIndex(axis, previous, index);
+    --index;
+  }
+  list[index] = endpoint;
+  SetIndex(axis, endpoint, index);
+}
+
+
+// The same towards the back, where a max passing a min may start an overlap.
+inline void SweepAndPrune::SortUp(uint32 axis, uint32 index)
+{
+  std::vector<Endpoint> &list = endpoints[axis];
+  const Endpoint endpoint = list[index];
+  const uint32 handle = endpoint.data >> 1;
+  const uint32 last = static_cast<uint32>(list.size()) - 1;
+  while (index < last && Less(list[index + 1], endpoint)) {
+    const Endpoint &next = list[index + 1];
+    const uint32 other = next.data >> 1;
+    if (other != handle) {
+      const bool isMax = (endpoint.data & 1) != 0;
+      const bool nextMax = (next.data & 1) != 0;
+      if (isMax && !nextMax) {
+        if (objects[handle].box.Intersects(objects[other].box)) {
+          AddPair(handle, other);
+        }
+      } else if (!isMax && nextMax) {
+        RemovePair(handle, other);
+      }
+    }
+    list[index] = next;
+    SetIndex(axis, next, index);
+    ++index;
+  }
+  list[index] = endpoint;
+  SetIndex(axis, endpoint, index);
+}
+
+
+// Growing sides first, so the min never passes its own max.
+inline void SweepAndPrune::UpdateAxis(uint32 axis, uint32 handle, real32 min, real32 max)
+{
+  std::vector<Endpoint> &list = endpoints[axis];
+  const Object &object = objects[handle];
+  const real32 oldMin = list[object.min[axis]].value;
+  const real32 oldMax = list[object.max[axis]].value;
+  list[object.min[axis]].value = min;
+  list[object.max[axis]].value = max;
+  if (min < oldMin) {
+    SortDown(axis, object.min[axis]);
+  }
+  if (max > oldMax) {
+    SortUp(axis, object.max[axis]);
+  }
+  if (min > oldMin) {
+    SortUp(axis, object.min[axis]);
+  }
+  if (max < oldMax) {
+    SortDown(axis, object.max[axis]);
+  }
+}
+
+
+inline void SweepAndPrune::Build(const AABB *boxes, size_t count)
+{
+  Clear();
+  objects.resize(count);
+  for (uint32 axis = 0; axis < 3; ++axis) {
+    std::vector<Endpoint> &list = endpoints[axis];
+    list.resize(count * 2);
+    for (size_t i = 0; i < count; ++i) {
+      Endpoint first = { detail::Axis(boxes[i].min, axis), static_cast<uint32>(i << 1) };
+      Endpoint second = { detail::Axis(boxes[i].max, axis), static_cast<uint32>(i << 1 | 1) };
+      list[i * 2] = first;
+      list[i * 2 + 1] = second;
+    }
+    std::sort(list.begin(), list.end(), Less);
+    for (size_t i = 0; i < list.size(); ++i) {
+      SetIndex(axis, list[i], static_cast<uint32>(i));
+    }
+  }
+  for (size_t i = 0; i < count; ++i) {
+    objects[i].box = boxes[i];
+  }
+
+  // Sweep x, testing every box against those whose x interval is still open.
+  std::vector<uint32> active;
+  std::vector<uint32> activeIndex(count);
+  for (size_t i = 0; i < endpoints[0].size(); ++i) {
+    const Endpoint &endpoint = endpoints[0][i];
+    const uint32 handle = endpoint.data >> 1;
+    if (endpoint.data & 1) {
+      uint32 slot = activeIndex[handle];
+      active[slot] = active.back();
+      activeIndex[active[slot]] = slot;
+      active.pop_back();
+      continue;
+    }
+    for (size_t k = 0; k < active.size(); ++k) {
+      if (objects[handle].box.Intersects(objects[active[k]].box)) {
+        AddPair(handle, active[k]);
+      }
+    }
+    activeIndex[handle] = static_cast<uint32>(active.size());
+    active.push_back(handle);
+  }
+}
+
+
+inline void SweepAndPrune::Clear()
+{
+  for (uint32 axis = 0; axis < 3; ++axis) {
+    endpoints[axis].clear();
+  }
+  objects.clear();
+  freeHandles.clear();
+  pairs.clear();
+}
+
+
+// The box comes in from past the end of every axis, which is also where
+// Remove sends it back to.
+inline uint32 SweepAndPrune::Add(const AABB &box)
+{
+  uint32 handle;
+  if (!freeHandles.empty()) {
+    handle = freeHandles.back();
+    freeHandles.pop_back();
+  } else {
+    handle = static_cast<uint32>(objects.size());
+    objects.push_back(Object());
+  }
+  Object &object = objects[handle];
+  object.box = box;
+  const real32 infinity = std::numeric_limits<real32>::infinity();
+  for (uint32 axis = 0; axis < 3; ++axis) {
+    std::vector<Endpoint> &list = endpoints[axis];
+    Endpoint min = { infinity, handle << 1 };
+    Endpoint max = { infinity, handle << 1 | 1 };
+    object.min[axis] = static_cast<uint32>(list.size());
+    list.push_back(min);
+    object.max[axis] = static_cast<uint32>(list.size());
+    list.push_back(max);
+  }
+  for (uint32 axis = 0; axis < 3; ++axis) {
+    UpdateAxis(axis, handle, detail::Axis(box.min, axis), detail::Axis(box.max, axis));
+  }
+  return handle;
+}
+
+
+// Sending the box off to infinity passes every max it overlapped, removing
+// its pairs on the way. Its endpoints are then the last ones on each axis.
+inline void SweepAndPrune::Remove(uint32 handle)
+{
+  const real32 infinity = std::numeric_limits<real32>::infinity();
+  const Vec3 far(infinity, infinity, infinity);
+  objects[handle].box = AABB(far, far);
+  for (uint32 axis = 0; axis < 3; ++axis) {
+    UpdateAxis(axis, handle, infinity, infinity);
+  }
+  for (uint32 axis = 0; axis < 3; ++axis) {
+    std::vector<Endpoint> &list = endpoints[axis];
+    Object &object = objects[handle];
+    // Unless other boxes reach infinity too, then they may come after.
+    uint32 last = static_cast<uint32>(list.size()) - 1;
+    if (object.max[axis] != last) {
+      std::swap(list[object.max[axis]], list[last]);
+      SetIndex(axis, list[object.max[axis]], object.max[axis]);
+    }
+    list.pop_back();
+    last = static_cast<uint32>(list.size()) - 1;
+    if (object.min[axis] != last) {
+      std::swap(list[object.min[axis]], list[last]);
+      SetIndex(axis, list[object.min[axis]], object.min[axis]);
+    }
+    list.pop_back();
+  }
+  objects[handle].box = AABB();
+  freeHandles.push_back(handle);
+}
+
+
+inline void SweepAndPrune::Move(uint32 handle, const AABB &box)
+{
+  objects[handle].box = box;
+  UpdateAxis(0, handle, box.min.x, box.max.x);
+  UpdateAxis(1, handle, box.min.y, box.max.y);
+  UpdateAxis(2, handle, box.min.z, box.max.z);
+}
+
+
+template<typename Func>
+void SweepAndPrune::ForEachPair(const Func &func) const
+{
+  for (std::unordered_set<uint64>::const_iterator it = pairs.begin(); it != pairs.end(); ++it) {
+    func(static_cast<uint32>(*it >> 32), static_cast<uint32>(*it & 0xffffffffu));
+  }
+}
+} // jkl
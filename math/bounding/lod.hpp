@@ -0,0 +1,89 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../matrix.hpp"
+#include "../vector.hpp"
+#include "bound_sphere.hpp"
+
+#include <cstddef>
+
+
+namespace math {
+
+
+// The camera as far as screen size goes: where it is, and how many pixels a
+// unit of size spans at unit distance, which for a perspective projection is
+// the y scale of the matrix times half the viewport height. Orthographic
+// views keep sizes the same at every distance.
+struct LodView {
+  LodView()
+    : eye()
+    , pixelScale(1.0f)
+    , perspective(true)
+  { }
+
+  // From the view and projection matrices of matrix_math.hpp, for row
+  // vectors, and the height of the viewport in pixels. view must be rigid,
+  // as LookAtLH/RH make it.
+  LodView(const Mat4 &view, const Mat4 &projection, real32 viewportHeight);
+
+  Vec3 eye;
+  real32 pixelScale;
+  bool perspective;
+};
+
+
+// Radius in pixels of sphere on the screen, from the angle it spans, so it
+// grows without bound as the camera closes in, and is the largest float
+// once inside. Negative for empty spheres.
+inline real32 ProjectedRadius(const LodView &view, const Sphere &sphere);
+
+
+// How SelectLodBatch picks levels of detail. Level 0 is the finest, drawn
+// while the projected radius is at least thresholds[0] pixels, level 1 down
+// to thresholds[1], and so on, the coarsest, levelCount - 1, below the last.
+// Thresholds must be decreasing.
+//
+// Hysteresis keeps objects near a threshold from flipping levels every
+// frame: moving to a coarser level takes a radius hysteresis below the
+// threshold, in proportion, and back to a finer one as much above it.
+struct LodSettings {
+  static const uint32 MaxLevels = 8;
+
+  LodSettings()
+    : minPixelRadius(0.5f)
+    , hysteresis(0.1f)
+    , levelCount(1)
+    , thresholds()
+  { }
+
+  // Objects smaller than this on screen are dropped.
+  real32 minPixelRadius;
+  real32 hysteresis;
+  uint32 levelCount;
+  real32 thresholds[MaxLevels - 1];
+};
+
+
+// Screen size pass over spheres. Every sphere whose projected radius is at
+// least settings.minPixelRadius gets its index written to visible, in
+// increasing order, its level to visibleLevels and, unless null, its radius
+// to pixelRadii, each at the same position. Returns how many there are. The
+// output arrays must have room for every sphere.
+//
+// levels holds every sphere's level from the previous frame, which the
+// hysteresis starts from, and gets the new levels of the visible ones.
+// Zero it to begin with.
+//
+// FloatN::Width spheres are done at once. With parallel set, large arrays
+// are split into chunks done across cores with ParallelFor, see
+// parallel.hpp, then the chunks' lists are moved together.
+inline size_t SelectLodBatch(const LodView &view, const SphereArray &spheres,
+  const LodSettings &settings, uint8 *levels, uint32 *visible, uint8 *visibleLevels,
+  real32 *pixelRadii = nullptr, bool parallel = false);
+} // jkl
+
+#include "internal/lod.inl"
@@ -0,0 +1,91 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "spatial_index.hpp"
+
+#include <vector>
+
+
+namespace math {
+
+
+// Loose octree over a cubic region of the world. Every node's bounds are
+// loosened to twice its size, so an object goes straight into the node
+// whose cell holds its center, at the depth where the cells are just larger
+// than it, without ever straddling a boundary. Placing or moving an object
+// then needs no search, only a walk down at most MaxDepth levels to its node,
+// and no walk at all while it stays in its cell. Nodes are created along the
+// way as needed and given back to the pool once empty.
+//
+// Objects sticking out of the region are kept in the root, whose bounds are
+// taken to be infinite, so they are tested by every query. Size the region
+// to the scene.
+class LooseOctree : public SpatialIndex {
+public:
+  static const uint32 MaxDepth = 16;
+
+  // Tree over the cube around world, depth levels deep at most, clamped to
+  // MaxDepth.
+  explicit LooseOctree(const AABB &world, uint32 depth = 8);
+
+  uint32 Insert(const AABB &box) override;
+  void Remove(uint32 handle) override;
+  void Move(uint32 handle, const AABB &box) override;
+  void Clear() override;
+
+  void QueryBox(const AABB &box, std::vector<uint32> &results) const override;
+  void QueryFrustum(const Frustum &frustum, std::vector<uint32> &results) const override;
+  void QueryRay(const Ray3 &ray, real32 maxDistance, std::vector<uint32> &results) const override;
+
+  // Number of nodes in use, the root included.
+  size_t NodeCount() const {
+    return nodes.size() - freeNodeCount;
+  }
+
+private:
+  struct Node {
+    Vec3 center;
+    real32 halfSize;
+    uint32 parent;
+    uint32 children[8];
+    uint32 first;
+    // Objects in the node, and children it has.
+    uint32 objectCount;
+    uint32 childCount;
+    uint32 depth;
+  };
+
+  // Bounds objects in node may reach, twice the size of its cell.
+  AABB LooseBounds(const Node &node) const;
+
+  // Depth of the node box belongs in, 0 for the root.
+  uint32 DepthFor(const AABB &box) const;
+
+  // True if box belongs in node at depth.
+  bool Fits(const Node &node, const AABB &box, uint32 depth) const;
+
+  // Node box belongs in, created if needed.
+  uint32 FindNode(const AABB &box);
+
+  uint32 AllocateNode(uint32 parent, const Vec3 &center, real32 halfSize, uint32 depth);
+
+  // Give node and any ancestors left empty by it back to the pool.
+  void Prune(uint32 node);
+
+  // Walk the nodes test accepts, depth first, calling visit(node, inside)
+  // for each, where inside is true if the whole node passed.
+  template<typename Test, typename Visit>
+  void Walk(const Test &test, const Visit &visit) const;
+
+  std::vector<Node> nodes;
+  uint32 freeNodes;
+  size_t freeNodeCount;
+  Vec3 worldCenter;
+  real32 worldHalfSize;
+  uint32 depth;
+};
+} // jkl
+
+#include "internal/loose_octree.inl"
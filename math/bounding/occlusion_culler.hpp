@@ -0,0 +1,188 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../matrix.hpp"
+#include "../span.hpp"
+#include "../vector.hpp"
+#include "bound_box.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace math {
+
+
+// Software occlusion culling, entirely on the CPU. A few large, low poly
+// occluders, walls, terrain and building shells, are rasterized into a low
+// resolution depth buffer, then the screen rectangles of object boxes are
+// tested against it, so that whatever hides behind them is never submitted.
+//
+// The buffer is split into tiles of TileWidth x TileHeight pixels, each stored
+// contiguously, with FloatN::Width pixels of a row shaded at once. Triangles
+// are binned to the tiles they cover, then the tiles rasterize their bins
+// independently of each other, in parallel if asked to. Each tile also keeps
+// the depth of its furthest pixel, so most boxes are settled a tile at a
+// time, without looking at its pixels.
+//
+// Depth is stored as 1 / w, the inverse of the view depth for the projection
+// matrices of matrix_math.hpp, which is linear in screen space: 0 is
+// infinitely far, and larger is nearer. Occluder triangles crossing the near
+// plane are skipped rather than clipped, and boxes crossing it are always
+// visible, so the culler errs on the side of drawing.
+//
+// Typical frame:
+//   culler.Begin(view * projection);
+//   for each occluder: culler.AddOccluder(world, bounds, positions, indices, triangles);
+//   culler.Rasterize(true);
+//   size_t count = culler.CullBatch(boxes, visible);
+class OcclusionCuller {
+public:
+  static const uint32 TileWidth = 8;
+  static const uint32 TileHeight = 8;
+
+  // Triangles rasterized per frame, unless set otherwise.
+  static const uint32 DefaultTriangleBudget = 4096;
+
+  // Winding of the occluders' front faces on the screen, with y up, as for
+  // glFrontFace. Back faces are skipped before binning, a closed occluder
+  // hides them behind its front faces anyway. Both keeps every triangle, for
+  // open occluders such as single sided walls. Occluders placed by a
+  // mirroring world matrix have their winding flipped to match.
+  enum class FrontFace {
+    CounterClockwise,
+    Clockwise,
+    Both
+  };
+
+  // Depth buffer of width x height pixels, 256 x 128 or so is plenty for
+  // culling.
+  OcclusionCuller(uint32 width, uint32 height);
+
+  // Start a frame seen through viewProjection, for row vectors with
+  // -w <= x, y <= w in clip space, dropping the occluders and depth of the
+  // previous one.
+  void Begin(const Mat4 &viewProjection);
+
+  // Queue an occluder, triangleCount triangles of indices into positions,
+  // placed in the world by world, with bounds its box around positions. The
+  // data is read by Rasterize, and must stay alive until then.
+  void AddOccluder(const Mat4 &world, const AABB &bounds, StridedSpan<const Vec3> positions,
+    const uint32 *indices, uint32 triangleCount);
+
+  // Rasterize the queued occluders, those covering the most of the screen
+  // first, until the triangle budget runs out. With parallel set, tiles are
+  // rasterized across cores with ParallelFor, see parallel.hpp.
+  void Rasterize(bool parallel = false);
+
+  // True if any part of box may be visible past the occluders. Boxes off the
+  // screen are not visible, boxes crossing the near plane always are.
+  bool IsVisible(const AABB &box) const;
+
+  // Write the index of every box in boxes that may be visible to visible, in
+  // increasing order, and return how many there are. visible must have room
+  // for every box. Box corners are projected FloatN::Width boxes at a time.
+  size_t CullBatch(const AABBArray &boxes, uint32 *visible, bool parallel = false) const;
+
+  // Same over the count boxes listed in indices, such as the survivors of
+  // frustum culling. visible may be indices, to filter the list in place.
+  size_t CullBatch(const AABBArray &boxes, const uint32 *indices, size_t count,
+    uint32 *visible) const;
+
+  void SetTriangleBudget(uint32 budget) {
+    triangleBudget = budget;
+  }
+
+  uint32 TriangleBudget() const {
+    return triangleBudget;
+  }
+
+  // CounterClockwise unless set otherwise.
+  void SetFrontFace(FrontFace face) {
+    frontFace = face;
+  }
+
+  FrontFace GetFrontFace() const {
+    return frontFace;
+  }
+
+  // Triangles rasterized by the last Rasterize.
+  uint32 TriangleCount() const {
+    return static_cast<uint32>(triangles.size());
+  }
+
+  uint32 Width() const {
+    return width;
+  }
+
+  uint32 Height() const {
+    return height;
+  }
+
+  // 1 / w of the nearest occluder at pixel (x, y), 0 where there is none.
+  real32 Depth(uint32 x, uint32 y) const;
+
+private:
+  struct Occluder {
+    Mat4 transform;
+    StridedSpan<const Vec3> positions;
+    const uint32 *indices;
+    uint32 triangleCount;
+    real32 area;
+    // The world matrix mirrors, which flips the winding on the screen.
+    bool mirrored;
+  };
+
+  // Triangle set up for rasterization in pixel coordinates: edge functions
+  // a * x + b * y + c, positive inside, 1 / w as a plane over the screen, and
+  // the pixels its bounds cover.
+  struct Triangle {
+    real32 edgeA[3], edgeB[3], edgeC[3];
+    real32 depthA, depthB, depthC;
+    int32 x0, y0, x1, y1;
+  };
+
+  // Screen rectangle in pixels and nearest 1 / w of a box, nearPlane set if
+  // it crosses the near plane, which leaves the rest undefined.
+  struct ScreenBox {
+    real32 minX, minY, maxX, maxY;
+    real32 depth;
+    bool nearPlane;
+  };
+
+  void SetupTriangles(const Occluder &occluder);
+  void RasterizeTile(uint32 tile);
+
+  // The box at rect is visible past the occluders, see IsVisible.
+  bool TestRect(const ScreenBox &rect) const;
+
+  // Project FloatN::Width boxes, one per lane of the arrays, with the view
+  // projection.
+  void ProjectWide(const real32 *minX, const real32 *minY, const real32 *minZ,
+    const real32 *maxX, const real32 *maxY, const real32 *maxZ, ScreenBox *rects) const;
+
+  ScreenBox ProjectBox(const Mat4 &transform, const AABB &box) const;
+
+  size_t CullRange(const AABBArray &boxes, size_t begin, size_t end, uint32 *visible) const;
+
+  uint32 width, height;
+  uint32 tilesX, tilesY;
+  Mat4 viewProjection;
+  uint32 triangleBudget;
+  FrontFace frontFace;
+  std::vector<Occluder> occluders;
+  std::vector<Triangle> triangles;
+  // Triangles binned by tile, those of tile t from binStart[t] to
+  // binStart[t + 1] in bins.
+  std::vector<uint32> binStart;
+  std::vector<uint32> bins;
+  std::vector<real32> depth;
+  // Furthest 1 / w in each tile.
+  std::vector<real32> tileDepth;
+};
+} // jkl
+
+#include "internal/occlusion_culler.inl"
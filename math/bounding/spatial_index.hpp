@@ -0,0 +1,99 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "../ray.hpp"
+#include "bound_box.hpp"
+#include "bound_frustum.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+
+namespace math {
+namespace detail {
+
+
+// An object in a spatial index, linked into the list of the node or cell
+// holding it. Free objects are chained through next.
+struct SpatialObject {
+  AABB box;
+  uint32 cell;
+  uint32 prev;
+  uint32 next;
+};
+} // detail
+
+
+// Common interface of the spatial indices, LooseOctree and HashGrid, for
+// finding the objects near a box, in a frustum or along a ray without going
+// through all of them. Objects are just their boxes, referred to by the
+// handles Insert returns, and moving one is O(1) in the common case where it
+// does not go far, so scenes of dynamic objects never need rebuilding.
+//
+// Objects live in one pooled array, as do the nodes or cells holding them,
+// each with an intrusive list of its objects, so nothing is allocated per
+// insert or move once the pools have grown. Queries append the handles of
+// every object whose box passes the test to results, in no particular order.
+// Queries are const and may run concurrently with each other, but not with
+// changes.
+class SpatialIndex {
+public:
+  static const uint32 InvalidIndex = ~0u;
+
+  SpatialIndex();
+  virtual ~SpatialIndex() { }
+
+  // Returns the new object's handle. Handles of removed objects get reused.
+  virtual uint32 Insert(const AABB &box) = 0;
+
+  virtual void Remove(uint32 handle) = 0;
+
+  virtual void Move(uint32 handle, const AABB &box) = 0;
+
+  // Remove every object.
+  virtual void Clear() = 0;
+
+  // Objects whose boxes intersect box.
+  virtual void QueryBox(const AABB &box, std::vector<uint32> &results) const = 0;
+
+  // Objects whose boxes intersect frustum, see Frustum::Intersects.
+  virtual void QueryFrustum(const Frustum &frustum, std::vector<uint32> &results) const = 0;
+
+  // Objects whose boxes the ray enters within maxDistance.
+  virtual void QueryRay(const Ray3 &ray, real32 maxDistance,
+    std::vector<uint32> &results) const = 0;
+
+  const AABB &Bounds(uint32 handle) const {
+    return objects[handle].box;
+  }
+
+  // Number of objects.
+  size_t Size() const {
+    return count;
+  }
+
+protected:
+  // Take an object from the pool, not linked anywhere yet.
+  uint32 AllocateObject(const AABB &box);
+  void FreeObject(uint32 handle);
+  void ClearObjects();
+
+  // Push handle onto, or take it off, the list starting at first.
+  void Link(uint32 &first, uint32 handle, uint32 cell);
+  void Unlink(uint32 &first, uint32 handle);
+
+  // Append every object of the list starting at first that passes test.
+  template<typename Test>
+  void Collect(uint32 first, const Test &test, std::vector<uint32> &results) const;
+
+  std::vector<detail::SpatialObject> objects;
+  uint32 freeObjects;
+  size_t count;
+};
+} // jkl
+
+#include "internal/spatial_index.inl"
@@ -0,0 +1,112 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../common.hpp"
+#include "bound_box.hpp"
+
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+
+
+namespace math {
+
+
+// Incremental sweep and prune broadphase. Keeps the min and max of every box
+// sorted along each axis, and the set of overlapping pairs. Moving a box
+// insertion sorts its endpoints back into place, and since boxes rarely move
+// far from one frame to the next, that is a few swaps, each of which is
+// exactly where a pair can start or stop overlapping. Frame cost is then
+// linear in the moves plus the swaps, rather than quadratic in the boxes.
+//
+// Boxes are referred to by the handles Add returns, and overlaps reported
+// through the pair callbacks as they change, smaller handle first. Boxes
+// that only touch count as overlapping, like AABB::Intersects. Boxes must be
+// finite and not empty.
+class SweepAndPrune {
+public:
+  // Called with the two handles of a pair, a < b.
+  typedef void (*PairCallback)(void *userData, uint32 a, uint32 b);
+
+  SweepAndPrune();
+
+  // Either callback may be nullptr.
+  void SetCallbacks(PairCallback added, PairCallback removed, void *userData);
+
+  // Replace everything with count boxes, handles 0 to count - 1, sorting
+  // once and sweeping for the pairs instead of adding boxes one at a time.
+  // Reports every pair found as added, and nothing as removed.
+  void Build(const AABB *boxes, size_t count);
+
+  // Drop every box and pair, without reporting anything.
+  void Clear();
+
+  // Returns the new box's handle. Handles of removed boxes get reused.
+  uint32 Add(const AABB &box);
+
+  // Reports the box's pairs as removed.
+  void Remove(uint32 handle);
+
+  void Move(uint32 handle, const AABB &box);
+
+  const AABB &Bounds(uint32 handle) const {
+    return objects[handle].box;
+  }
+
+  // Number of boxes.
+  size_t Size() const {
+    return endpoints[0].size() / 2;
+  }
+
+  size_t PairCount() const {
+    return pairs.size();
+  }
+
+  bool Overlapping(uint32 a, uint32 b) const {
+    return pairs.count(PairKey(a, b)) != 0;
+  }
+
+  // Call func(a, b) for every overlapping pair, a < b, in no particular order.
+  template<typename Func>
+  void ForEachPair(const Func &func) const;
+
+private:
+  struct Endpoint {
+    real32 value;
+    // Handle << 1, with the low bit set for a max.
+    uint32 data;
+  };
+
+  struct Object {
+    AABB box;
+    // Where the endpoints are in endpoints[axis].
+    uint32 min[3];
+    uint32 max[3];
+  };
+
+  static uint64 PairKey(uint32 a, uint32 b) {
+    return a < b ? (static_cast<uint64>(a) << 32) | b : (static_cast<uint64>(b) << 32) | a;
+  }
+
+  static bool Less(const Endpoint &a, const Endpoint &b);
+
+  void AddPair(uint32 a, uint32 b);
+  void RemovePair(uint32 a, uint32 b);
+  void SetIndex(uint32 axis, const Endpoint &endpoint, uint32 index);
+  void SortDown(uint32 axis, uint32 index);
+  void SortUp(uint32 axis, uint32 index);
+  void UpdateAxis(uint32 axis, uint32 handle, real32 min, real32 max);
+
+  std::vector<Endpoint> endpoints[3];
+  std::vector<Object> objects;
+  std::vector<uint32> freeHandles;
+  std::unordered_set<uint64> pairs;
+  PairCallback added;
+  PairCallback removed;
+  void *userData;
+};
+} // jkl
+
+#include "internal/sweep_and_prune.inl"
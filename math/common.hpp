@@ -5,6 +5,8 @@
 
 #include <cstdint>
 #include <cmath>
+#include <limits>
+#include <type_traits>
 
 #define J_PI 3.141592653589793238462643383279502884197169399375
 
@@ -22,59 +24,179 @@ typedef int8_t int8;
 typedef uint64_t uint64;
 typedef int64_t int64; 
 
-inline double Sqrt(double value)
+// True while the enclosing constexpr function is being evaluated by the
+// compiler rather than at runtime. Lets the math functions below stay constexpr
+// while still calling into <cmath> (or simd) at runtime. Compilers without the
+// builtin always take the runtime path, so constant evaluation of anything
+// that needs it is unavailable there.
+#if defined(__has_builtin)
+  #if __has_builtin(__builtin_is_constant_evaluated)
+    #define J_HAS_CONSTANT_EVALUATED 1
+  #endif
+#endif
+#if !defined(J_HAS_CONSTANT_EVALUATED) && \
+    ((defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 9)) || \
+     (defined(_MSC_VER) && (_MSC_VER >= 1925)))
+  #define J_HAS_CONSTANT_EVALUATED 1
+#endif
+
+#if defined(J_HAS_CONSTANT_EVALUATED)
+  #define J_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+  #define J_IS_CONSTANT_EVALUATED() false
+#endif
+
+
+namespace detail {
+// Compile time replacements for the <cmath> functions, which are not
+// constexpr. These are only meant for constant evaluation, they are accurate
+// to the last bit or two of a double but much slower than the std versions.
+constexpr double ConstSqrt(double value)
 {
-  return std::sqrt(value);
+  if (value < 0.0 || value != value) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  if (value == 0.0 || value == value + value) {
+    // Zero or infinity.
+    return value;
+  }
+  // Newton's method from above converges monotonically, so stop as soon as
+  // the guess no longer shrinks.
+  double guess = value > 1.0 ? value : 1.0;
+  double next = 0.5 * (guess + value / guess);
+  while (next < guess) {
+    guess = next;
+    next = 0.5 * (guess + value / guess);
+  }
+  return guess;
+}
+
+
+// Reduce to [-pi, pi] and sum the taylor series until it stops changing.
+constexpr double ConstReduceAngle(double value)
+{
+  const double twoPi = 2.0 * J_PI;
+  double turns = value / twoPi;
+  double whole = static_cast<double>(static_cast<int64>(turns));
+  value -= whole * twoPi;
+  if (value > J_PI) value -= twoPi;
+  if (value < -J_PI) value += twoPi;
+  return value;
+}
+
+
+constexpr double ConstSin(double value)
+{
+  double x = ConstReduceAngle(value);
+  double x2 = x * x;
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 32; ++n) {
+    term *= -x2 / static_cast<double>((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+
+constexpr double ConstCos(double value)
+{
+  double x = ConstReduceAngle(value);
+  double x2 = x * x;
+  double term = 1.0;
+  double sum = 1.0;
+  for (int n = 1; n < 32; ++n) {
+    term *= -x2 / static_cast<double>((2 * n - 1) * (2 * n));
+    sum += term;
+  }
+  return sum;
+}
+} // detail
+
+
+constexpr double Sqrt(double value)
+{
+  return J_IS_CONSTANT_EVALUATED() ? detail::ConstSqrt(value) : std::sqrt(value);
+}
+
+
+constexpr float Sqrtf(float value)
+{
+  return J_IS_CONSTANT_EVALUATED() 
+    ? static_cast<float>(detail::ConstSqrt(value)) : std::sqrt(value);
+}
+
+
+// Single precision overload, so float callers don't round trip through double.
+constexpr float Sqrt(float value)
+{
+  return Sqrtf(value);
+}
+
+
+// Integers go through double, as they did before the float overload, which
+// would otherwise leave the call ambiguous.
+template<typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+constexpr double Sqrt(T value)
+{
+  return Sqrt(static_cast<double>(value));
 }
 
 
 template<typename T>
-inline bool IsNaN(T value)
+constexpr bool IsNaN(T value)
 {
-  return std::isnan(value);
+  return value != value;
 }
 
-// Standard absolute value wrap.
+// Standard absolute value wrap. At runtime floats go through std::abs, which
+// clears the sign bit, rather than the compare, which compilers keep as a
+// branch because of -0.
 template<typename T>
-inline T Abs(T value)
+constexpr T Abs(T value)
 {
-  return std::abs(value);
+  return (std::is_floating_point<T>::value && !J_IS_CONSTANT_EVALUATED())
+    ? std::abs(value) : (value < static_cast<T>(0) ? -value : value);
 }
 
 
-inline double Cos(double value)
+constexpr double Cos(double value)
 {
-  return std::cos(value);
+  return J_IS_CONSTANT_EVALUATED() ? detail::ConstCos(value) : std::cos(value);
 }
 
 
-inline double Sin(double value)
+constexpr double Sin(double value)
 {
-  return std::sin(value);
+  return J_IS_CONSTANT_EVALUATED() ? detail::ConstSin(value) : std::sin(value);
 }
 
-inline double Tan(double value)
+constexpr double Tan(double value)
 {
-  return std::tan(value);
+  return J_IS_CONSTANT_EVALUATED() 
+    ? detail::ConstSin(value) / detail::ConstCos(value) : std::tan(value);
 }
 
-inline float Cosf(float value)
+constexpr float Cosf(float value)
 {
-  return std::cosf(value);
+  return J_IS_CONSTANT_EVALUATED() 
+    ? static_cast<float>(detail::ConstCos(value)) : std::cos(value);
 }
 
-inline float Sinf(float value)
+constexpr float Sinf(float value)
 {
-  return std::sinf(value);
+  return J_IS_CONSTANT_EVALUATED() 
+    ? static_cast<float>(detail::ConstSin(value)) : std::sin(value);
 }
 
-inline float Tanf(float value)
+constexpr float Tanf(float value)
 {
-  return std::tanf(value);
+  return J_IS_CONSTANT_EVALUATED() 
+    ? static_cast<float>(detail::ConstSin(value) / detail::ConstCos(value)) : std::tan(value);
 }
 
 
-inline float ToRadians(float degrees)
+constexpr float ToRadians(float degrees)
 {
   return degrees * (static_cast<float>(J_PI) / 180.0f);
 }
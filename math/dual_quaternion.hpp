@@ -0,0 +1,121 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+#include "quaternion.hpp"
+#include "quaternion_math.hpp"
+#include "precision.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+
+namespace math {
+
+
+// Dual quaternion, a rigid transform (rotation followed by translation) in 8
+// numbers instead of the 16 of a Matrix4x4:
+//
+//   real + dual * e,  e^2 = 0
+//
+// where real is the unit rotation quaternion r, and dual is t * r / 2, with t
+// the translation as a pure quaternion (0, tx, ty, tz).
+//
+// Their main use is skinning. Blending unit dual quaternions and normalizing
+// the result stays a rigid transform, so twisting joints do not collapse like
+// they do with blended matrices (the candy-wrapper effect), see skinning.hpp.
+template<typename T>
+struct DualQuaternion {
+  // The identity transform.
+  static constexpr DualQuaternion<T> Identity() {
+    return DualQuaternion<T>();
+  }
+
+  constexpr DualQuaternion()
+    : real(), dual(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0))
+  { }
+
+  // From the raw real and dual parts.
+  constexpr DualQuaternion(const Quaternion<T> &real, const Quaternion<T> &dual)
+    : real(real), dual(dual)
+  { }
+
+  // Rotate by the unit quaternion rotation, then translate by translation.
+  constexpr DualQuaternion(const Quaternion<T> &rotation, const Vector3<T> &translation);
+
+  // Component wise addition, used for blending.
+  constexpr DualQuaternion operator+(const DualQuaternion &dq) const;
+
+  // Composition of two transforms. Like quaternion multiplication, a * b
+  // applies b first and then a, so (a * b).ToMatrix4x4() is
+  // b.ToMatrix4x4() * a.ToMatrix4x4() with the library's row vectors.
+  constexpr DualQuaternion operator*(const DualQuaternion &dq) const;
+
+  // Scale both parts, used for blending.
+  constexpr DualQuaternion operator*(const T scaler) const;
+
+  constexpr void operator+=(const DualQuaternion &dq);
+  constexpr void operator*=(const DualQuaternion &dq);
+  constexpr void operator*=(const T scaler);
+
+  // Quaternion conjugate of both parts. For a unit dual quaternion this is
+  // the inverse transform.
+  constexpr DualQuaternion Conjugate() const;
+
+  // The rotation part. Expects a unit dual quaternion.
+  constexpr Quaternion<T> GetRotation() const {
+    return real;
+  }
+
+  // The translation part, 2 * dual * conjugate(real). Expects a unit dual
+  // quaternion.
+  constexpr Vector3<T> GetTranslation() const;
+
+  // Apply the transform to a point, rotating and then translating it.
+  constexpr Vector3<T> TransformPoint(const Vector3<T> &point) const;
+
+  // Apply only the rotation, for directions and normals.
+  constexpr Vector3<T> TransformDirection(const Vector3<T> &direction) const;
+
+  // Returns the equivalent matrix, rotation in the upper 3x3 and translation
+  // in the last row, for row vectors like the rest of the library. Expects a
+  // unit dual quaternion.
+  constexpr Matrix4x4<T> ToMatrix4x4() const;
+
+  Quaternion<T> real;
+  Quaternion<T> dual;
+};
+
+typedef DualQuaternion<real32> DualQuat;
+
+
+static_assert(std::is_trivially_copyable<DualQuat>::value && std::is_standard_layout<DualQuat>::value,
+  "DualQuat must be trivially copyable and standard layout.");
+static_assert(sizeof(DualQuat) == 8 * sizeof(real32), "DualQuat must be tightly packed.");
+
+
+// Make dq a unit dual quaternion again: real gets unit length, and dual is
+// made orthogonal to real, so it keeps describing a pure translation.
+template<typename P = Exact, typename T> constexpr
+DualQuaternion<T> Normalize(const DualQuaternion<T> &dq);
+
+// Dual quaternion linear blending (DLB) of two transforms, at time t. dq1 is
+// flipped into dq0's hemisphere first, so the blend takes the shortest path.
+template<typename T> constexpr
+DualQuaternion<T> Blend(const DualQuaternion<T> &dq0, const DualQuaternion<T> &dq1, T t);
+
+// Weighted DLB of count transforms, normalized. Every transform is flipped
+// into the hemisphere of the first one. The weights need not sum to one, but
+// must not all be zero.
+template<typename T>
+DualQuaternion<T> Blend(const DualQuaternion<T> *dqs, const T *weights, size_t count);
+
+template<typename T> constexpr
+Matrix4x4<T> ToMatrix4x4(const DualQuaternion<T> &dq);
+} // jkl
+
+#include "internal/dual_quaternion.inl"
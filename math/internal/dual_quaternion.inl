@@ -0,0 +1,156 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../dual_quaternion.hpp"
+#include "../vector_math.hpp"
+
+
+namespace math {
+
+
+// dual = t * r / 2, with t the pure quaternion (0, translation).
+template<typename T>
+constexpr DualQuaternion<T>::DualQuaternion(const Quaternion<T> &rotation,
+  const Vector3<T> &translation)
+  : real(rotation)
+  , dual(Quaternion<T>(static_cast<T>(0), translation.x, translation.y, translation.z)
+      * rotation * static_cast<T>(0.5))
+{ }
+
+
+template<typename T>
+constexpr DualQuaternion<T> DualQuaternion<T>::operator+(const DualQuaternion &dq) const
+{
+  return DualQuaternion(real + dq.real, dual + dq.dual);
+}
+
+
+// (r0 + d0 e)(r1 + d1 e) = r0 r1 + (r0 d1 + d0 r1) e, as e^2 = 0.
+template<typename T>
+constexpr DualQuaternion<T> DualQuaternion<T>::operator*(const DualQuaternion &dq) const
+{
+  return DualQuaternion(real * dq.real, real * dq.dual + dual * dq.real);
+}
+
+
+template<typename T>
+constexpr DualQuaternion<T> DualQuaternion<T>::operator*(const T scaler) const
+{
+  return DualQuaternion(real * scaler, dual * scaler);
+}
+
+
+template<typename T>
+constexpr void DualQuaternion<T>::operator+=(const DualQuaternion &dq)
+{
+  real += dq.real;
+  dual += dq.dual;
+}
+
+
+template<typename T>
+constexpr void DualQuaternion<T>::operator*=(const DualQuaternion &dq)
+{
+  *this = *this * dq;
+}
+
+
+template<typename T>
+constexpr void DualQuaternion<T>::operator*=(const T scaler)
+{
+  real *= scaler;
+  dual *= scaler;
+}
+
+
+template<typename T>
+constexpr DualQuaternion<T> DualQuaternion<T>::Conjugate() const
+{
+  return DualQuaternion(real.Conjugate(), dual.Conjugate());
+}
+
+
+// Vector part of 2 * dual * conjugate(real), written out:
+// 2 * (rw * dv - dw * rv + rv x dv).
+template<typename T>
+constexpr Vector3<T> DualQuaternion<T>::GetTranslation() const
+{
+  T two = static_cast<T>(2);
+  return Vector3<T>(
+    two * (real.w * dual.x - dual.w * real.x + real.y * dual.z - real.z * dual.y),
+    two * (real.w * dual.y - dual.w * real.y + real.z * dual.x - real.x * dual.z),
+    two * (real.w * dual.z - dual.w * real.z + real.x * dual.y - real.y * dual.x)
+  );
+}
+
+
+// r v r* for unit r, as v + 2 rv x (rv x v + rw v).
+template<typename T>
+constexpr Vector3<T> DualQuaternion<T>::TransformDirection(const Vector3<T> &direction) const
+{
+  Vector3<T> rv(real.x, real.y, real.z);
+  Vector3<T> c = Cross(rv, direction) + direction * real.w;
+  return direction + Cross(rv, c) * static_cast<T>(2);
+}
+
+
+template<typename T>
+constexpr Vector3<T> DualQuaternion<T>::TransformPoint(const Vector3<T> &point) const
+{
+  return TransformDirection(point) + GetTranslation();
+}
+
+
+template<typename T>
+constexpr Matrix4x4<T> DualQuaternion<T>::ToMatrix4x4() const
+{
+  Matrix4x4<T> m = real.ToMatrix4x4();
+  Vector3<T> t = GetTranslation();
+  m.data[3][0] = t.x;
+  m.data[3][1] = t.y;
+  m.data[3][2] = t.z;
+  return m;
+}
+
+
+// After scaling both parts by 1 / |real|, the part of dual along real is
+// removed, since a unit dual quaternion needs Dot(real, dual) = 0.
+template<typename P, typename T> constexpr
+DualQuaternion<T> Normalize(const DualQuaternion<T> &dq)
+{
+  T invLength = InvSqrt<P>(dq.real.LengthSquared());
+  Quaternion<T> real = dq.real * invLength;
+  Quaternion<T> dual = dq.dual * invLength;
+  return DualQuaternion<T>(real, dual - real * Dot(real, dual));
+}
+
+
+template<typename T> constexpr
+DualQuaternion<T> Blend(const DualQuaternion<T> &dq0, const DualQuaternion<T> &dq1, T t)
+{
+  T sign = Dot(dq0.real, dq1.real) < static_cast<T>(0) ? -static_cast<T>(1) : static_cast<T>(1);
+  return Normalize(dq0 * (static_cast<T>(1) - t) + dq1 * (sign * t));
+}
+
+
+template<typename T>
+DualQuaternion<T> Blend(const DualQuaternion<T> *dqs, const T *weights, size_t count)
+{
+  DualQuaternion<T> sum(Quaternion<T>(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)),
+    Quaternion<T>(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)));
+  for (size_t i = 0; i < count; ++i) {
+    T weight = Dot(dqs[0].real, dqs[i].real) < static_cast<T>(0) ? -weights[i] : weights[i];
+    sum += dqs[i] * weight;
+  }
+  return Normalize(sum);
+}
+
+
+template<typename T> constexpr
+Matrix4x4<T> ToMatrix4x4(const DualQuaternion<T> &dq)
+{
+  return dq.ToMatrix4x4();
+}
+} // jkl
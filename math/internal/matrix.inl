@@ -8,55 +8,48 @@ namespace math {
 
 
 template<typename T>
-Matrix4x4<T>::Matrix4x4(
+constexpr Matrix4x4<T>::Matrix4x4(
     T a00, T a01, T a02, T a03,
     T a10, T a11, T a12, T a13,
     T a20, T a21, T a22, T a23,
     T a30, T a31, T a32, T a33)
+  : data{
+    { a00, a01, a02, a03 },
+    { a10, a11, a12, a13 },
+    { a20, a21, a22, a23 },
+    { a30, a31, a32, a33 } }
 {
-  data[0][0] = a00; data[0][1] = a01; data[0][2] = a02; data[0][3] = a03;
-  data[1][0] = a10; data[1][1] = a11; data[1][2] = a12; data[1][3] = a13;
-  data[2][0] = a20; data[2][1] = a21; data[2][2] = a22; data[2][3] = a23;
-  data[3][0] = a30; data[3][1] = a31; data[3][2] = a32; data[3][3] = a33;
 }
 
 
 template<typename T>
-Matrix4x4<T>::Matrix4x4(
+constexpr Matrix4x4<T>::Matrix4x4(
   const Vector4<T> &r1,
   const Vector4<T> &r2,
   const Vector4<T> &r3,
   const Vector4<T> &r4) 
+  : data{
+    { r1.x, r1.y, r1.z, r1.w },
+    { r2.x, r2.y, r2.z, r2.w },
+    { r3.x, r3.y, r3.z, r3.w },
+    { r4.x, r4.y, r4.z, r4.w } }
 {
-  data[0][0] = r1.x; data[0][1] = r1.y; data[0][2] = r1.z; data[0][3] = r1.w;
-  data[1][0] = r2.x; data[1][1] = r2.y; data[1][2] = r2.z; data[1][3] = r2.w;
-  data[2][0] = r3.x; data[2][1] = r3.y; data[2][2] = r3.z; data[2][3] = r3.w;
-  data[3][0] = r4.x; data[3][1] = r4.y; data[3][2] = r4.z; data[3][3] = r4.w;
 }
 
 
 template<typename T>
-Matrix4x4<T>::Matrix4x4(const Matrix3x3<T> &m) 
+constexpr Matrix4x4<T>::Matrix4x4(const Matrix3x3<T> &m) 
+  : data{
+    { m.data[0][0],      m.data[0][1],      m.data[0][2],      static_cast<T>(0) },
+    { m.data[1][0],      m.data[1][1],      m.data[1][2],      static_cast<T>(0) },
+    { m.data[2][0],      m.data[2][1],      m.data[2][2],      static_cast<T>(0) },
+    { static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(1) } }
 {
-  data[0][0] = m.data[0][0];      data[0][1] = m.data[0][1];      data[0][2] = m.data[0][2];      data[0][3] = static_cast<T>(0);
-  data[1][0] = m.data[1][0];      data[1][1] = m.data[1][1];      data[1][2] = m.data[1][2];      data[1][3] = static_cast<T>(0);
-  data[2][0] = m.data[2][0];      data[2][1] = m.data[2][1];      data[2][2] = m.data[2][2];      data[2][3] = static_cast<T>(0);
-  data[3][0] = static_cast<T>(0); data[3][1] = static_cast<T>(0); data[3][2] = static_cast<T>(0); data[3][3] = static_cast<T>(1);
 }
 
 
 template<typename T>
-Matrix4x4<T>::Matrix4x4(const Matrix4x4 &m) 
-{
-  data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = m.data[0][2]; data[0][3] = m.data[0][3];
-  data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = m.data[1][2]; data[1][3] = m.data[1][3];
-  data[2][0] = m.data[2][0]; data[2][1] = m.data[2][1]; data[2][2] = m.data[2][2]; data[2][3] = m.data[2][3];
-  data[3][0] = m.data[3][0]; data[3][1] = m.data[3][1]; data[3][2] = m.data[3][2]; data[3][3] = m.data[3][3];
-}
-
-
-template<typename T>
-Matrix4x4<T> Matrix4x4<T>::operator+(const Matrix4x4 &m) const 
+constexpr Matrix4x4<T> Matrix4x4<T>::operator+(const Matrix4x4 &m) const 
 {
   return Matrix4x4(
     data[0][0] + m.data[0][0], data[0][1] + m.data[0][1], data[0][2] + m.data[0][2], data[0][3] + m.data[0][3],
@@ -68,7 +61,7 @@ Matrix4x4<T> Matrix4x4<T>::operator+(const Matrix4x4 &m) const
 
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::operator-(const Matrix4x4 &m) const 
+constexpr Matrix4x4<T> Matrix4x4<T>::operator-(const Matrix4x4 &m) const 
 {
   return Matrix4x4(
     data[0][0] - m.data[0][0], data[0][1] - m.data[0][1], data[0][2] - m.data[0][2], data[0][3] - m.data[0][3],
@@ -79,10 +72,14 @@ Matrix4x4<T> Matrix4x4<T>::operator-(const Matrix4x4 &m) const
 }
 
 
+namespace detail {
+// Plain matrix product, shared with the Mat4 simd specialization for when it
+// is evaluated at compile time.
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::operator*(const Matrix4x4 &m) const
- {
-  return Matrix4x4(
+constexpr Matrix4x4<T> Multiply4x4(const Matrix4x4<T> &a, const Matrix4x4<T> &m)
+{
+  const T (&data)[4][4] = a.data;
+  return Matrix4x4<T>(
     data[0][0] * m.data[0][0] + data[0][1] * m.data[1][0] + data[0][2] * m.data[2][0] + data[0][3] * m.data[3][0],
     data[0][0] * m.data[0][1] + data[0][1] * m.data[1][1] + data[0][2] * m.data[2][1] + data[0][3] * m.data[3][1],
     data[0][0] * m.data[0][2] + data[0][1] * m.data[1][2] + data[0][2] * m.data[2][2] + data[0][3] * m.data[3][2],
@@ -104,10 +101,18 @@ Matrix4x4<T> Matrix4x4<T>::operator*(const Matrix4x4 &m) const
     data[3][0] * m.data[0][3] + data[3][1] * m.data[1][3] + data[3][2] * m.data[2][3] + data[3][3] * m.data[3][3]
   );
 }
+} // detail
 
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::operator*(const T scale) const 
+constexpr Matrix4x4<T> Matrix4x4<T>::operator*(const Matrix4x4 &m) const
+{
+  return detail::Multiply4x4(*this, m);
+}
+
+
+template<typename T>
+constexpr Matrix4x4<T> Matrix4x4<T>::operator*(const T scale) const 
 {
   return Matrix4x4(
     data[0][0] * scale, data[0][1] * scale, data[0][2] * scale, data[0][3] * scale,
@@ -119,7 +124,7 @@ Matrix4x4<T> Matrix4x4<T>::operator*(const T scale) const
 
 
 template<typename T>
-void Matrix4x4<T>::operator*=(const T scale) 
+constexpr void Matrix4x4<T>::operator*=(const T scale) 
 {
   data[0][0] *= scale; data[0][1] *= scale; data[0][2] *= scale; data[0][3] *= scale;
   data[1][0] *= scale; data[1][1] *= scale; data[1][2] *= scale; data[1][3] *= scale;
@@ -129,7 +134,7 @@ void Matrix4x4<T>::operator*=(const T scale)
 
 
 template<typename T>
-void Matrix4x4<T>::operator+=(const Matrix4x4 &m) 
+constexpr void Matrix4x4<T>::operator+=(const Matrix4x4 &m) 
 {
   data[0][0] += m.data[0][0]; data[0][1] += m.data[0][1]; data[0][2] += m.data[0][2]; data[0][3] += m.data[0][3];
   data[1][0] += m.data[1][0]; data[1][1] += m.data[1][1]; data[1][2] += m.data[1][2]; data[1][3] += m.data[1][3];
@@ -139,7 +144,7 @@ void Matrix4x4<T>::operator+=(const Matrix4x4 &m)
 
 
 template<typename T>
-void Matrix4x4<T>::operator-=(const Matrix4x4 &m) 
+constexpr void Matrix4x4<T>::operator-=(const Matrix4x4 &m) 
 {
   data[0][0] -= m.data[0][0]; data[0][1] -= m.data[0][1]; data[0][2] -= m.data[0][2]; data[0][3] -= m.data[0][3];
   data[1][0] -= m.data[1][0]; data[1][1] -= m.data[1][1]; data[1][2] -= m.data[1][2]; data[1][3] -= m.data[1][3];
@@ -149,7 +154,7 @@ void Matrix4x4<T>::operator-=(const Matrix4x4 &m)
 
 
 template<typename T>
-void Matrix4x4<T>::operator*=(const Matrix4x4 &m) 
+constexpr void Matrix4x4<T>::operator*=(const Matrix4x4 &m) 
 {
   Matrix4x4 ori = *this;
   data[0][0] = ori[0][0] * m.data[0][0] + ori[0][1] * m.data[1][0] + ori[0][2] * m.data[2][0] + ori[0][3] * m.data[3][0];
@@ -175,7 +180,7 @@ void Matrix4x4<T>::operator*=(const Matrix4x4 &m)
 
 
 template<typename T>
-T Matrix4x4<T>::Determinant() const 
+constexpr T Matrix4x4<T>::Determinant() const 
 {
   return  data[0][0] * (  data[1][1] * (data[2][2] * data[3][3] - data[2][3] * data[3][2]) -
                           data[1][2] * (data[2][1] * data[3][3] - data[2][3] * data[3][1]) +
@@ -196,7 +201,7 @@ T Matrix4x4<T>::Determinant() const
 
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::Transpose() const 
+constexpr Matrix4x4<T> Matrix4x4<T>::Transpose() const 
 {
   return Matrix4x4(
     data[0][0], data[1][0], data[2][0], data[3][0],
@@ -207,44 +212,152 @@ Matrix4x4<T> Matrix4x4<T>::Transpose() const
 }
 
 
+namespace detail {
+// Computes the adjugate of the 4x4 matrix a into out, and returns the determinant.
+// Every cofactor is a 3x3 determinant, which we expand along the 2x2
+// subdeterminants of the top two rows (s) and the bottom two rows (c). This way
+// each 2x2 is only computed once, and shared between the cofactors.
+template<typename T>
+constexpr T Adjugate4x4(const T a[4][4], T out[4][4])
+{
+  T s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+  T s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+  T s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+  T s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+  T s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+  T s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+  T c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+  T c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+  T c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+  T c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+  T c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+  T c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+  T r[4][4] = { };
+  r[0][0] =  a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3;
+  r[0][1] = -a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3;
+  r[0][2] =  a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3;
+  r[0][3] = -a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3;
+
+  r[1][0] = -a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1;
+  r[1][1] =  a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1;
+  r[1][2] = -a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1;
+  r[1][3] =  a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1;
+
+  r[2][0] =  a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0;
+  r[2][1] = -a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0;
+  r[2][2] =  a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0;
+  r[2][3] = -a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0;
+
+  r[3][0] = -a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0;
+  r[3][1] =  a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0;
+  r[3][2] = -a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0;
+  r[3][3] =  a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0;
+
+  for (uint32 i = 0; i < 4; ++i) {
+    for (uint32 j = 0; j < 4; ++j) {
+      out[i][j] = r[i][j];
+    }
+  }
+  return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+} // detail
+
+
 // We calculate the inverse of a 4x4 matrix using the standard method
 // of finding the adjugate and multiplying it with one over
 // the determinant. The formula: 
 //
 // inv(A) = (1/detA) * adj(A)
+namespace detail {
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::Inverse() const 
+constexpr Matrix4x4<T> Inverse4x4(const Matrix4x4<T> &m)
 {
-  T detA = Determinant();
+  Matrix4x4<T> inverse;
+  T detA = Adjugate4x4(m.data, inverse.data);
   if (detA == static_cast<T>(0)) {
     return Matrix4x4<T>::Identity();
   }
-  Matrix4x4<T> inverse = Adjugate() * (static_cast<T>(1) / detA);
+  inverse *= (static_cast<T>(1) / detA);
   return inverse;
 }
+} // detail
 
 
 template<typename T>
-Matrix4x4<T> Matrix4x4<T>::Adjugate() const 
+constexpr Matrix4x4<T> Matrix4x4<T>::Inverse() const 
 {
-  // Calculating our adjugate using the transpose of the cofactor of our
-  // matrix.
-  Matrix4x4<T> CofactorMatrix;
-  T sign = static_cast<T>(1);
-  for (uint32 row = 0; row < 4; ++row) {
-    sign = -sign;
-    for (uint32 col = 0; col < 4; ++col) {
-      sign = -sign;
-      CofactorMatrix[row][col] = Minor(row, col).Determinant() * sign;
-    }
+  return detail::Inverse4x4(*this);
+}
+
+
+// With an affine matrix M = | A 0 |, where A is 3x3 and t the translation row,
+//                           | t 1 |
+// the inverse is | inv(A)       0 |
+//                | -t * inv(A)  1 |
+template<typename T>
+constexpr Matrix4x4<T> Matrix4x4<T>::InverseAffine() const
+{
+  // Cofactors of the upper 3x3, already transposed into the adjugate.
+  T a00 = data[1][1] * data[2][2] - data[1][2] * data[2][1];
+  T a01 = data[0][2] * data[2][1] - data[0][1] * data[2][2];
+  T a02 = data[0][1] * data[1][2] - data[0][2] * data[1][1];
+  T a10 = data[1][2] * data[2][0] - data[1][0] * data[2][2];
+  T a11 = data[0][0] * data[2][2] - data[0][2] * data[2][0];
+  T a12 = data[0][2] * data[1][0] - data[0][0] * data[1][2];
+  T a20 = data[1][0] * data[2][1] - data[1][1] * data[2][0];
+  T a21 = data[0][1] * data[2][0] - data[0][0] * data[2][1];
+  T a22 = data[0][0] * data[1][1] - data[0][1] * data[1][0];
+  T det = data[0][0] * a00 + data[0][1] * a10 + data[0][2] * a20;
+  if (det == static_cast<T>(0)) {
+    return Matrix4x4<T>::Identity();
   }
-  // Transpose this CofactorMatrix to get the adjugate.
-  return CofactorMatrix.Transpose();
+  T invDet = static_cast<T>(1) / det;
+  a00 *= invDet; a01 *= invDet; a02 *= invDet;
+  a10 *= invDet; a11 *= invDet; a12 *= invDet;
+  a20 *= invDet; a21 *= invDet; a22 *= invDet;
+  T tx = data[3][0], ty = data[3][1], tz = data[3][2];
+  return Matrix4x4<T>(
+    a00, a01, a02, static_cast<T>(0),
+    a10, a11, a12, static_cast<T>(0),
+    a20, a21, a22, static_cast<T>(0),
+    -(tx * a00 + ty * a10 + tz * a20),
+    -(tx * a01 + ty * a11 + tz * a21),
+    -(tx * a02 + ty * a12 + tz * a22),
+    static_cast<T>(1)
+  );
+}
+
+
+// Same as InverseAffine(), except inv(A) is just the transpose of A.
+template<typename T>
+constexpr Matrix4x4<T> Matrix4x4<T>::InverseOrthonormal() const
+{
+  T tx = data[3][0], ty = data[3][1], tz = data[3][2];
+  return Matrix4x4<T>(
+    data[0][0], data[1][0], data[2][0], static_cast<T>(0),
+    data[0][1], data[1][1], data[2][1], static_cast<T>(0),
+    data[0][2], data[1][2], data[2][2], static_cast<T>(0),
+    -(tx * data[0][0] + ty * data[0][1] + tz * data[0][2]),
+    -(tx * data[1][0] + ty * data[1][1] + tz * data[1][2]),
+    -(tx * data[2][0] + ty * data[2][1] + tz * data[2][2]),
+    static_cast<T>(1)
+  );
+}
+
+
+template<typename T>
+constexpr Matrix4x4<T> Matrix4x4<T>::Adjugate() const 
+{
+  Matrix4x4<T> adjugate;
+  detail::Adjugate4x4(data, adjugate.data);
+  return adjugate;
 }
 
 
 template<typename T>
-Matrix3x3<T> Matrix4x4<T>::Minor(uint32 row, uint32 col) const
+constexpr Matrix3x3<T> Matrix4x4<T>::Minor(uint32 row, uint32 col) const
 {
   Matrix3x3<T> minor;
   uint32 r = 0, c;
@@ -263,7 +376,7 @@ Matrix3x3<T> Matrix4x4<T>::Minor(uint32 row, uint32 col) const
 
 
 template<typename T>
-bool Matrix4x4<T>::ContainsNaN() const 
+constexpr bool Matrix4x4<T>::ContainsNaN() const 
 {
   for (uint32 i = 0; i < 4; ++i) {
     for (uint32 j = 0; j < 4; ++j) {
@@ -277,7 +390,7 @@ bool Matrix4x4<T>::ContainsNaN() const
 
 
 template<typename T>
-bool Matrix4x4<T>::operator==(const Matrix4x4 &m) const 
+constexpr bool Matrix4x4<T>::operator==(const Matrix4x4 &m) const 
 {
   for (uint32 i = 0; i < 4; ++i) {
     for (uint32 j = 0; j < 4; ++j) {
@@ -291,31 +404,33 @@ bool Matrix4x4<T>::operator==(const Matrix4x4 &m) const
 
 
 template<typename T>
-Matrix3x3<T>::Matrix3x3(
+constexpr Matrix3x3<T>::Matrix3x3(
   T a00, T a01, T a02,
   T a10, T a11, T a12,
   T a20, T a21, T a22) 
+  : data{
+    { a00, a01, a02 },
+    { a10, a11, a12 },
+    { a20, a21, a22 } }
 {
-  data[0][0] = a00; data[0][1] = a01; data[0][2] = a02;
-  data[1][0] = a10; data[1][1] = a11; data[1][2] = a12;
-  data[2][0] = a20; data[2][1] = a21; data[2][2] = a22;
 }
 
 
 template<typename T>
-Matrix3x3<T>::Matrix3x3(
+constexpr Matrix3x3<T>::Matrix3x3(
   const Vector3<T> &r1,
   const Vector3<T> &r2,
   const Vector3<T> &r3) 
+  : data{
+    { r1.x, r1.y, r1.z },
+    { r2.x, r2.y, r2.z },
+    { r3.x, r3.y, r3.z } }
 {
-  data[0][0] = r1.x; data[0][1] = r1.y; data[0][2] = r1.z;
-  data[1][0] = r2.x; data[1][1] = r2.y; data[1][2] = r2.z;
-  data[2][0] = r3.x; data[2][1] = r3.y; data[2][2] = r3.z;
 }
 
 
 template<typename T>
-Matrix3x3<T> Matrix3x3<T>::operator+(const Matrix3x3 &m) const
+constexpr Matrix3x3<T> Matrix3x3<T>::operator+(const Matrix3x3 &m) const
 {
   return Matrix3x3(
     data[0][0] + m.data[0][0], data[0][1] + m.data[0][1], data[0][2] + m.data[0][2],
@@ -326,7 +441,7 @@ Matrix3x3<T> Matrix3x3<T>::operator+(const Matrix3x3 &m) const
 
 
 template<typename T>
-Matrix3x3<T> Matrix3x3<T>::operator-(const Matrix3x3 &m) const 
+constexpr Matrix3x3<T> Matrix3x3<T>::operator-(const Matrix3x3 &m) const 
 {
   return Matrix3x3(
     data[0][0] - m.data[0][0], data[0][1] - m.data[0][1], data[0][2] - m.data[0][2],
@@ -337,7 +452,7 @@ Matrix3x3<T> Matrix3x3<T>::operator-(const Matrix3x3 &m) const
 
 
 template<typename T>
-Matrix3x3<T> Matrix3x3<T>::operator*(const Matrix3x3 &m) const 
+constexpr Matrix3x3<T> Matrix3x3<T>::operator*(const Matrix3x3 &m) const 
 {
   return Matrix3x3(
     data[0][0] * m.data[0][0] + data[0][1] * m.data[1][0] + data[0][2] * m.data[2][0],
@@ -356,7 +471,7 @@ Matrix3x3<T> Matrix3x3<T>::operator*(const Matrix3x3 &m) const
 
 
 template<typename T>
-bool Matrix3x3<T>::operator==(const Matrix3x3 &m) const
+constexpr bool Matrix3x3<T>::operator==(const Matrix3x3 &m) const
 {
   for (uint32 i = 0; i < 3; ++i) {
     for (uint32 j = 0; j < 3; ++j) {
@@ -370,7 +485,7 @@ bool Matrix3x3<T>::operator==(const Matrix3x3 &m) const
 
 
 template<typename T>
-T Matrix3x3<T>::Determinant() const
+constexpr T Matrix3x3<T>::Determinant() const
 {
   return  data[0][0] * (data[1][1] * data[2][2] - data[1][2] * data[2][1]) -
           data[0][1] * (data[1][0] * data[2][2] - data[1][2] * data[2][0]) +
@@ -379,27 +494,29 @@ T Matrix3x3<T>::Determinant() const
 
 
 template<typename T>
-Matrix2x2<T>::Matrix2x2(
+constexpr Matrix2x2<T>::Matrix2x2(
   T a00, T a01,
   T a10, T a11) 
+  : data{
+    { a00, a01 },
+    { a10, a11 } }
 {
-  data[0][0] = a00; data[0][1] = a01;
-  data[1][0] = a10; data[1][1] = a11;
 }
 
 
 template<typename T>
-Matrix2x2<T>::Matrix2x2(
+constexpr Matrix2x2<T>::Matrix2x2(
   const Vector2<T> &r1,
   const Vector2<T> &r2) 
+  : data{
+    { r1.x, r1.y },
+    { r2.x, r2.y } }
 {
-  data[0][0] = r1.x; data[0][1] = r1.y;
-  data[1][0] = r2.x; data[1][1] = r2.y;
 }
 
 
 template<typename T>
-Matrix2x2<T> Matrix2x2<T>::operator+(const Matrix2x2 &m) const 
+constexpr Matrix2x2<T> Matrix2x2<T>::operator+(const Matrix2x2 &m) const 
 {
   return Matrix2x2(
     data[0][0] + m.data[0][0], data[0][1] + m.data[0][1],
@@ -409,7 +526,7 @@ Matrix2x2<T> Matrix2x2<T>::operator+(const Matrix2x2 &m) const
 
 
 template<typename T>
-Matrix2x2<T> Matrix2x2<T>::operator-(const Matrix2x2 &m) const 
+constexpr Matrix2x2<T> Matrix2x2<T>::operator-(const Matrix2x2 &m) const 
 {
   return Matrix2x2(
     data[0][0] - m.data[0][0], data[0][1] - m.data[0][1],
@@ -419,7 +536,7 @@ Matrix2x2<T> Matrix2x2<T>::operator-(const Matrix2x2 &m) const
 
 
 template<typename T>
-Matrix2x2<T> Matrix2x2<T>::operator*(const Matrix2x2 &m) const 
+constexpr Matrix2x2<T> Matrix2x2<T>::operator*(const Matrix2x2 &m) const 
 {
   // This could be 
   return Matrix2x2(
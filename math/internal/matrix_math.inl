@@ -8,7 +8,7 @@
 namespace math {
 
 
-template<typename T> inline
+template<typename T> constexpr
 Matrix4x4<T> Translate(const Matrix4x4<T> &original, const Vector3<T> &v)
 {
   Matrix4x4<T> t(
@@ -22,40 +22,38 @@ Matrix4x4<T> Translate(const Matrix4x4<T> &original, const Vector3<T> &v)
 
 
 // Rotation Matrix, which combines all rotation matrices (Rotation for x, y, and z
-// separately, into one rotator matrix. 
-// TODO(Garcia): Transpose this rotation matrix by hand instead of wasting
-// clock cycles like this...
-template<typename T> inline
+// separately, into one rotator matrix. The rotator is written out already
+// transposed, since we multiply row vectors.
+template<typename T> constexpr
 Matrix4x4<T> Rotate(const Matrix4x4<T> &original, 
   const T angle, const Vector3<T> &axis)
 {
-  T oneMinusCosine = static_cast<T>(1) - Cos(angle);
-  T cosine = Cos(angle);
-  T sine = Sin(angle);
+  T sine = static_cast<T>(0), cosine = static_cast<T>(0);
+  SinCos(angle, sine, cosine);
+  T oneMinusCosine = static_cast<T>(1) - cosine;
   Matrix4x4<T> rotator(
     cosine + (axis.x * axis.x) * oneMinusCosine,
-    axis.x * axis.y * oneMinusCosine - axis.z * sine,
-    axis.x * axis.z * oneMinusCosine + axis.y * sine,
+    axis.y * axis.x * oneMinusCosine + axis.z * sine,
+    axis.z * axis.x * oneMinusCosine - axis.y * sine,
     0,
   
-    axis.y * axis.x * oneMinusCosine + axis.z * sine,
+    axis.x * axis.y * oneMinusCosine - axis.z * sine,
     cosine + (axis.y * axis.y) * oneMinusCosine,
-    axis.y * axis.z * oneMinusCosine - axis.x * sine,
+    axis.z * axis.y * oneMinusCosine + axis.x * sine,
     0,
 
-    axis.z * axis.x * oneMinusCosine - axis.y * sine,
-    axis.z * axis.y * oneMinusCosine + axis.x * sine,
+    axis.x * axis.z * oneMinusCosine + axis.y * sine,
+    axis.y * axis.z * oneMinusCosine - axis.x * sine,
     cosine + (axis.z * axis.z) * oneMinusCosine,
     0,
 
     0, 0, 0, 1
   );
-  // I'll fix this soon.
-  return rotator.Transpose() * original;
+  return rotator * original;
 }
 
 
-template<typename T>
+template<typename T> constexpr
 Matrix4x4<T> Scale(const Matrix4x4<T> &original, const Vector3<T> &scale)
 {
   Matrix4x4<T> scaleMatrix(
@@ -68,7 +66,7 @@ Matrix4x4<T> Scale(const Matrix4x4<T> &original, const Vector3<T> &scale)
 }
 
 
-template<typename T> inline
+template<typename T> constexpr
 Matrix4x4<T> LookAtRH(const Vector3<T> &eye, const Vector3<T> &center, const Vector3<T> &up)
 {
   Vector3<T> front(Normalize(center - eye));
@@ -84,7 +82,7 @@ Matrix4x4<T> LookAtRH(const Vector3<T> &eye, const Vector3<T> &center, const Vec
 }
 
 
-template<typename T> inline
+template<typename T> constexpr
 Matrix4x4<T> LookAtLH(const Vector3<T> &eye, const Vector3<T> &center, const Vector3<T> &up)
 {
   Vector3<T> front(Normalize(center - eye));
@@ -100,7 +98,7 @@ Matrix4x4<T> LookAtLH(const Vector3<T> &eye, const Vector3<T> &center, const Vec
 }
 
 
-template<typename T> inline
+template<typename T> constexpr
 Matrix4x4<T> LookAt(const Vector3<T> &eye, const Vector3<T> &center, const Vector3<T> &up, bool left)
 {
   if (left) {
@@ -110,7 +108,7 @@ Matrix4x4<T> LookAt(const Vector3<T> &eye, const Vector3<T> &center, const Vecto
 }
 
 
-template<typename T> inline
+template<typename T> constexpr
 Matrix4x4<T> PerspectiveRH(const T fov, const T aspect, const T zNear, const T zFar)
 {
   T tanHalfFov = Tan(fov / static_cast<T>(2));
@@ -126,7 +124,7 @@ Matrix4x4<T> PerspectiveRH(const T fov, const T aspect, const T zNear, const T z
 }
 
 
-template<typename T> inline
+template<typename T> constexpr
 Matrix4x4<T> PerspectiveLH(const T fov, const T aspect, const T zNear, const T zFar)
 {
   T tanHalfFov = Tan(fov / static_cast<T>(2));
@@ -0,0 +1,268 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+//#include "../matrix.hpp"
+#include "../simd.hpp"
+
+#include <cstring>
+
+
+namespace math {
+namespace simd {
+
+
+// 4x4 float matrix kernels. All matrices are row major, 16 contiguous floats,
+// with no alignment requirement. out may alias a or b.
+inline void Mat4MulScalar(const real32 *a, const real32 *b, real32 *out)
+{
+  real32 l[16], r[16];
+  std::memcpy(l, a, sizeof(l));
+  std::memcpy(r, b, sizeof(r));
+  for (uint32 row = 0; row < 4; ++row) {
+    for (uint32 col = 0; col < 4; ++col) {
+      out[row * 4 + col] = l[row * 4 + 0] * r[col] + l[row * 4 + 1] * r[4 + col] +
+                           l[row * 4 + 2] * r[8 + col] + l[row * 4 + 3] * r[12 + col];
+    }
+  }
+}
+
+
+#if defined(J_SIMD_X86)
+// Each row of the result is a linear combination of the rows of b, weighted
+// by the corresponding row of a, so we broadcast one element of a at a time.
+inline void Mat4MulSSE2(const real32 *a, const real32 *b, real32 *out)
+{
+  __m128 b0 = _mm_loadu_ps(b + 0);
+  __m128 b1 = _mm_loadu_ps(b + 4);
+  __m128 b2 = _mm_loadu_ps(b + 8);
+  __m128 b3 = _mm_loadu_ps(b + 12);
+  for (uint32 row = 0; row < 4; ++row) {
+    __m128 ar = _mm_loadu_ps(a + row * 4);
+    __m128 r = _mm_mul_ps(_mm_shuffle_ps(ar, ar, 0x00), b0);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(ar, ar, 0x55), b1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(ar, ar, 0xAA), b2));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(ar, ar, 0xFF), b3));
+    _mm_storeu_ps(out + row * 4, r);
+  }
+}
+
+
+// Same as the SSE2 kernel, but two rows of a are handled per instruction, with
+// each row of b duplicated into both 128 bit lanes.
+J_TARGET_AVX inline void Mat4MulAVX(const real32 *a, const real32 *b, real32 *out)
+{
+  __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 0));
+  __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 4));
+  __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 8));
+  __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 12));
+  __m256 a01 = _mm256_loadu_ps(a);
+  __m256 a23 = _mm256_loadu_ps(a + 8);
+
+  __m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+  r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1));
+  r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2));
+  r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3));
+
+  __m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0);
+  r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1));
+  r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xAA), b2));
+  r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xFF), b3));
+
+  _mm256_storeu_ps(out, r01);
+  _mm256_storeu_ps(out + 8, r23);
+}
+#endif
+
+
+// Invert a 4x4 matrix. Returns false, and leaves out untouched, if a is
+// singular.
+inline bool Mat4InverseScalar(const real32 *a, real32 *out)
+{
+  real32 adjugate[4][4];
+  real32 det = math::detail::Adjugate4x4(reinterpret_cast<const real32 (*)[4]>(a), adjugate);
+  if (det == 0.0f) {
+    return false;
+  }
+  real32 invDet = 1.0f / det;
+  for (uint32 i = 0; i < 16; ++i) {
+    out[i] = adjugate[i / 4][i % 4] * invDet;
+  }
+  return true;
+}
+
+
+#if defined(J_SIMD_X86)
+#define J_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define J_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps(v, v, J_SHUFFLE_MASK(x, y, z, w))
+
+namespace detail {
+// 2x2 row major matrices packed in one register as | v0 v1 |
+//                                                  | v2 v3 |
+// A * B
+inline __m128 Mat2Mul(__m128 a, __m128 b)
+{
+  return _mm_add_ps(_mm_mul_ps(a, J_SWIZZLE(b, 0, 3, 0, 3)),
+                    _mm_mul_ps(J_SWIZZLE(a, 1, 0, 3, 2), J_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+
+// adj(A) * B
+inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+{
+  return _mm_sub_ps(_mm_mul_ps(J_SWIZZLE(a, 3, 3, 0, 0), b),
+                    _mm_mul_ps(J_SWIZZLE(a, 1, 1, 2, 2), J_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+
+// A * adj(B)
+inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+{
+  return _mm_sub_ps(_mm_mul_ps(a, J_SWIZZLE(b, 3, 0, 3, 0)),
+                    _mm_mul_ps(J_SWIZZLE(a, 1, 0, 3, 2), J_SWIZZLE(b, 2, 1, 2, 1)));
+}
+} // detail
+
+
+// Block matrix inverse. With M = | A B | split into 2x2 blocks, every block of
+//                                | C D |
+// the adjugate is built from 2x2 products, and the 2x2 determinants
+// |A|, |B|, |C|, |D| are computed together in a single register.
+inline bool Mat4InverseSSE2(const real32 *a, real32 *out)
+{
+  __m128 r0 = _mm_loadu_ps(a + 0);
+  __m128 r1 = _mm_loadu_ps(a + 4);
+  __m128 r2 = _mm_loadu_ps(a + 8);
+  __m128 r3 = _mm_loadu_ps(a + 12);
+
+  __m128 A = _mm_movelh_ps(r0, r1);
+  __m128 B = _mm_movehl_ps(r1, r0);
+  __m128 C = _mm_movelh_ps(r2, r3);
+  __m128 D = _mm_movehl_ps(r3, r2);
+
+  // (|A|, |B|, |C|, |D|)
+  __m128 detSub = _mm_sub_ps(
+    _mm_mul_ps(_mm_shuffle_ps(r0, r2, J_SHUFFLE_MASK(0, 2, 0, 2)), 
+               _mm_shuffle_ps(r1, r3, J_SHUFFLE_MASK(1, 3, 1, 3))),
+    _mm_mul_ps(_mm_shuffle_ps(r0, r2, J_SHUFFLE_MASK(1, 3, 1, 3)), 
+               _mm_shuffle_ps(r1, r3, J_SHUFFLE_MASK(0, 2, 0, 2))));
+  __m128 detA = J_SWIZZLE(detSub, 0, 0, 0, 0);
+  __m128 detB = J_SWIZZLE(detSub, 1, 1, 1, 1);
+  __m128 detC = J_SWIZZLE(detSub, 2, 2, 2, 2);
+  __m128 detD = J_SWIZZLE(detSub, 3, 3, 3, 3);
+
+  __m128 adjDC = detail::Mat2AdjMul(D, C);
+  __m128 adjAB = detail::Mat2AdjMul(A, B);
+  __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), detail::Mat2Mul(B, adjDC));
+  __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), detail::Mat2Mul(C, adjAB));
+  __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), detail::Mat2MulAdj(D, adjAB));
+  __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), detail::Mat2MulAdj(A, adjDC));
+
+  // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+  __m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+  __m128 tr = _mm_mul_ps(adjAB, J_SWIZZLE(adjDC, 0, 2, 1, 3));
+  tr = _mm_add_ps(tr, J_SWIZZLE(tr, 1, 0, 3, 2));
+  tr = _mm_add_ps(tr, J_SWIZZLE(tr, 2, 3, 0, 1));
+  detM = _mm_sub_ps(detM, tr);
+  if (_mm_cvtss_f32(detM) == 0.0f) {
+    return false;
+  }
+
+  __m128 invDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+  X = _mm_mul_ps(X, invDetM);
+  Y = _mm_mul_ps(Y, invDetM);
+  Z = _mm_mul_ps(Z, invDetM);
+  W = _mm_mul_ps(W, invDetM);
+
+  // Apply the final 2x2 adjugate while scattering the blocks back into rows.
+  _mm_storeu_ps(out + 0,  _mm_shuffle_ps(X, Y, J_SHUFFLE_MASK(3, 1, 3, 1)));
+  _mm_storeu_ps(out + 4,  _mm_shuffle_ps(X, Y, J_SHUFFLE_MASK(2, 0, 2, 0)));
+  _mm_storeu_ps(out + 8,  _mm_shuffle_ps(Z, W, J_SHUFFLE_MASK(3, 1, 3, 1)));
+  _mm_storeu_ps(out + 12, _mm_shuffle_ps(Z, W, J_SHUFFLE_MASK(2, 0, 2, 0)));
+  return true;
+}
+
+#undef J_SWIZZLE
+#undef J_SHUFFLE_MASK
+#endif
+
+
+// Multiply using the given instruction set. The caller must make sure it is
+// supported, see IsSupported().
+inline void Mat4Mul(Isa isa, const real32 *a, const real32 *b, real32 *out)
+{
+  switch (isa) {
+#if defined(J_SIMD_X86)
+    case Isa::AVX:  Mat4MulAVX(a, b, out); break;
+    case Isa::SSE2: Mat4MulSSE2(a, b, out); break;
+#endif
+    default:        Mat4MulScalar(a, b, out); break;
+  }
+}
+
+
+// Multiply using the active instruction set.
+inline void Mat4Mul(const real32 *a, const real32 *b, real32 *out)
+{
+  Mat4Mul(ActiveIsa(), a, b, out);
+}
+
+
+// Invert using the given instruction set. AVX has nothing to add over SSE2 for
+// a single 4x4, so it shares the SSE2 kernel.
+inline bool Mat4Inverse(Isa isa, const real32 *a, real32 *out)
+{
+  switch (isa) {
+#if defined(J_SIMD_X86)
+    case Isa::AVX:
+    case Isa::SSE2: return Mat4InverseSSE2(a, out);
+#endif
+    default:        return Mat4InverseScalar(a, out);
+  }
+}
+
+
+// Invert using the active instruction set.
+inline bool Mat4Inverse(const real32 *a, real32 *out)
+{
+  return Mat4Inverse(ActiveIsa(), a, out);
+}
+} // simd
+
+
+// Mat4 specializations, routed through the runtime dispatched kernels.
+// The simd kernels can't run at compile time, so constant evaluation falls
+// back to the generic versions in matrix.inl.
+template<> constexpr
+Matrix4x4<real32> Matrix4x4<real32>::operator*(const Matrix4x4<real32> &m) const
+{
+  if (J_IS_CONSTANT_EVALUATED()) {
+    return detail::Multiply4x4(*this, m);
+  }
+  Matrix4x4<real32> result;
+  simd::Mat4Mul(&data[0][0], &m.data[0][0], reinterpret_cast<real32 *>(result.data));
+  return result;
+}
+
+
+template<> constexpr
+void Matrix4x4<real32>::operator*=(const Matrix4x4<real32> &m)
+{
+  if (J_IS_CONSTANT_EVALUATED()) {
+    *this = detail::Multiply4x4(*this, m);
+    return;
+  }
+  simd::Mat4Mul(&data[0][0], &m.data[0][0], reinterpret_cast<real32 *>(data));
+}
+
+
+template<> constexpr
+Matrix4x4<real32> Matrix4x4<real32>::Inverse() const
+{
+  if (J_IS_CONSTANT_EVALUATED()) {
+    return detail::Inverse4x4(*this);
+  }
+  Matrix4x4<real32> inverse;
+  simd::Mat4Inverse(&data[0][0], reinterpret_cast<real32 *>(inverse.data));
+  return inverse;
+}
+} // jkl
@@ -8,7 +8,7 @@ namespace math {
 
 
 template<typename T>
-Quaternion<T> Quaternion<T>::operator+(const Quaternion &q) const 
+constexpr Quaternion<T> Quaternion<T>::operator+(const Quaternion &q) const 
 {
   return Quaternion(
     w + q.w,
@@ -20,7 +20,7 @@ Quaternion<T> Quaternion<T>::operator+(const Quaternion &q) const
 
 
 template<typename T>
-Quaternion<T> Quaternion<T>::operator-(const Quaternion &q) const
+constexpr Quaternion<T> Quaternion<T>::operator-(const Quaternion &q) const
 {
   return Quaternion(
     w - q.w,
@@ -32,7 +32,7 @@ Quaternion<T> Quaternion<T>::operator-(const Quaternion &q) const
 
 
 template<typename T>
-Quaternion<T> Quaternion<T>::operator*(const Quaternion &q) const 
+constexpr Quaternion<T> Quaternion<T>::operator*(const Quaternion &q) const 
 {
   return Quaternion(
     (w * q.w) - (x * q.x) - (y * q.y) - (z * q.z),
@@ -44,7 +44,7 @@ Quaternion<T> Quaternion<T>::operator*(const Quaternion &q) const
 
 
 template<typename T>
-Quaternion<T> Quaternion<T>::operator/(const T scaler) const
+constexpr Quaternion<T> Quaternion<T>::operator/(const T scaler) const
 {
   return Quaternion(
     w / scaler,
@@ -56,7 +56,7 @@ Quaternion<T> Quaternion<T>::operator/(const T scaler) const
 
 
 template<typename T>
-void Quaternion<T>::operator*=(const Quaternion &q) 
+constexpr void Quaternion<T>::operator*=(const Quaternion &q) 
 {
   Quaternion ori = *this;
   w = (ori.w * q.w) - (ori.x * q.x) - (ori.y * q.y) - (ori.z * q.z);
@@ -67,7 +67,7 @@ void Quaternion<T>::operator*=(const Quaternion &q)
 
 
 template<typename T>
-void Quaternion<T>::operator+=(const Quaternion &q)
+constexpr void Quaternion<T>::operator+=(const Quaternion &q)
 {
   w += q.w;
   x += q.x;
@@ -77,17 +77,17 @@ void Quaternion<T>::operator+=(const Quaternion &q)
 
 
 template<typename T>
-void Quaternion<T>::operator-=(const Quaternion &q)
+constexpr void Quaternion<T>::operator-=(const Quaternion &q)
 {
-  w -= v.w;
-  x -= v.x;
-  y -= v.y;
-  z -= v.z;
+  w -= q.w;
+  x -= q.x;
+  y -= q.y;
+  z -= q.z;
 }
 
 
 template<typename T>
-Quaternion<T> Quaternion<T>::operator*(const T scaler) const
+constexpr Quaternion<T> Quaternion<T>::operator*(const T scaler) const
 {
   return Quaternion(
     w * scaler,
@@ -99,7 +99,7 @@ Quaternion<T> Quaternion<T>::operator*(const T scaler) const
 
 
 template<typename T>
-void Quaternion<T>::operator*=(const T scaler)
+constexpr void Quaternion<T>::operator*=(const T scaler)
 {
   w *= scaler;
   x *= scaler;
@@ -109,7 +109,7 @@ void Quaternion<T>::operator*=(const T scaler)
 
 
 template<typename T>
-Quaternion<T> Quaternion<T>::operator/(const Quaternion &q) const
+constexpr Quaternion<T> Quaternion<T>::operator/(const Quaternion &q) const
 {
   return Quaternion(
     w / q.w,
@@ -121,7 +121,7 @@ Quaternion<T> Quaternion<T>::operator/(const Quaternion &q) const
 
 
 template<typename T>
-void Quaternion<T>::operator/=(const Quaternion &q)
+constexpr void Quaternion<T>::operator/=(const Quaternion &q)
 {
   w /= q.w;
   x /= q.x;
@@ -131,7 +131,7 @@ void Quaternion<T>::operator/=(const Quaternion &q)
 
 
 template<typename T>
-void Quaternion<T>::operator/=(const T scaler)
+constexpr void Quaternion<T>::operator/=(const T scaler)
 {
   w /= scaler;
   x /= scaler;
@@ -141,14 +141,14 @@ void Quaternion<T>::operator/=(const T scaler)
 
 
 template<typename T>
-Quaternion<T> Quaternion<T>::Conjugate() const
+constexpr Quaternion<T> Quaternion<T>::Conjugate() const
 {
   return Quaternion(w, -x, -y, -z);
 }
 
 
 template<typename T>
-Quaternion<T> Quaternion<T>::Inverse() const
+constexpr Quaternion<T> Quaternion<T>::Inverse() const
 {
   Quaternion conjugate = Conjugate();
   T norm = Length();
@@ -157,4 +157,37 @@ Quaternion<T> Quaternion<T>::Inverse() const
   conjugate /= norm;
   return conjugate;
 }
+
+
+template<typename T>
+constexpr Vector3<T> Quaternion<T>::ToEulerAngles() const
+{
+  T one = static_cast<T>(1);
+  T two = static_cast<T>(2);
+  T sinPitch = two * (w * x - y * z);
+  sinPitch = sinPitch > one ? one : (sinPitch < -one ? -one : sinPitch);
+  return Vector3<T>(
+    Atan2(sinPitch, static_cast<T>(Sqrt(one - sinPitch * sinPitch))),
+    Atan2(two * (x * z + w * y), one - two * (x * x + y * y)),
+    Atan2(two * (x * y + w * z), one - two * (x * x + z * z))
+  );
+}
+
+
+// Rows are the images of the x, y and z axes under the rotation.
+template<typename T>
+constexpr Matrix4x4<T> Quaternion<T>::ToMatrix4x4() const
+{
+  T one = static_cast<T>(1);
+  T two = static_cast<T>(2);
+  T xx = x * x, yy = y * y, zz = z * z;
+  T xy = x * y, xz = x * z, yz = y * z;
+  T wx = w * x, wy = w * y, wz = w * z;
+  return Matrix4x4<T>(
+    one - two * (yy + zz), two * (xy + wz),       two * (xz - wy),       static_cast<T>(0),
+    two * (xy - wz),       one - two * (xx + zz), two * (yz + wx),       static_cast<T>(0),
+    two * (xz + wy),       two * (yz - wx),       one - two * (xx + yy), static_cast<T>(0),
+    static_cast<T>(0),     static_cast<T>(0),     static_cast<T>(0),     one
+  );
+}
 } // jkl
\ No newline at end of file
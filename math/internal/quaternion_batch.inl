@@ -0,0 +1,225 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../quaternion_batch.hpp"
+#include "../parallel.hpp"
+
+
+namespace math {
+namespace detail {
+
+
+// Quaternions are small, so batches need to be large before it is worth
+// waking other cores.
+static const size_t QuatBatchParallelGrain = 8 * 1024;
+
+
+// Runs wide(i) for every full FloatN over [begin, end), and scalar(i) for the
+// leftovers.
+template<typename Wide, typename Scalar> inline
+void QuatBatchRange(size_t begin, size_t end, const Wide &wide, const Scalar &scalar)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wideEnd = begin + (end - begin) / W * W;
+  size_t i = begin;
+  for (; i < wideEnd; i += W) {
+    wide(i);
+  }
+  for (; i < end; ++i) {
+    scalar(i);
+  }
+}
+
+
+template<typename Wide, typename Scalar> inline
+void QuatBatch(size_t count, bool parallel, const Wide &wide, const Scalar &scalar)
+{
+  if (!parallel) {
+    QuatBatchRange(0, count, wide, scalar);
+    return;
+  }
+  ParallelFor(count, QuatBatchParallelGrain, [&] (size_t begin, size_t end) {
+    QuatBatchRange(begin, end, wide, scalar);
+  });
+}
+
+
+inline WideQuaternion<FloatN> LoadQuats(const QuatArray &a, size_t i)
+{
+  return WideQuaternion<FloatN>::Load(&a.w[i], &a.x[i], &a.y[i], &a.z[i]);
+}
+
+
+inline void StoreQuats(const WideQuaternion<FloatN> &q, QuatArray &a, size_t i)
+{
+  q.Store(&a.w[i], &a.x[i], &a.y[i], &a.z[i]);
+}
+
+
+// Blend weights, either one per element or one for the whole batch.
+struct BlendPerElement {
+  FloatN Wide(size_t i) const { return FloatN::Load(t + i); }
+  real32 Scalar(size_t i) const { return t[i]; }
+  const real32 *t;
+};
+
+
+struct BlendUniform {
+  FloatN Wide(size_t) const { return FloatN(t); }
+  real32 Scalar(size_t) const { return t; }
+  real32 t;
+};
+
+
+template<typename Blend> inline
+void NlerpBatchWith(const QuatArray &a, const QuatArray &b, const Blend &blend,
+  QuatArray &out, bool parallel)
+{
+  out.Resize(a.Size());
+  QuatBatch(a.Size(), parallel,
+    [&] (size_t i) {
+      StoreQuats(Nlerp(LoadQuats(a, i), LoadQuats(b, i), blend.Wide(i)), out, i);
+    },
+    [&] (size_t i) {
+      out.Set(i, Nlerp(a.Get(i), b.Get(i), blend.Scalar(i)));
+    });
+}
+
+
+template<typename P, typename Blend> inline
+void SlerpBatchWith(const QuatArray &a, const QuatArray &b, const Blend &blend,
+  QuatArray &out, bool parallel)
+{
+  out.Resize(a.Size());
+  QuatBatch(a.Size(), parallel,
+    [&] (size_t i) {
+      StoreQuats(Slerp<P>(LoadQuats(a, i), LoadQuats(b, i), blend.Wide(i)), out, i);
+    },
+    [&] (size_t i) {
+      out.Set(i, Slerp<P>(a.Get(i), b.Get(i), blend.Scalar(i)));
+    });
+}
+
+
+// Writes one row of four matrices, lane l of a, b, c and d going to
+// dst[l].data[row].
+inline void StoreMatrixRows(const Float4 &a, const Float4 &b, const Float4 &c,
+  const Float4 &d, Mat4 *dst, uint32 row)
+{
+#if defined(J_SIMD_X86)
+  __m128 r0 = a.v, r1 = b.v, r2 = c.v, r3 = d.v;
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_ps(dst[0].data[row], r0);
+  _mm_storeu_ps(dst[1].data[row], r1);
+  _mm_storeu_ps(dst[2].data[row], r2);
+  _mm_storeu_ps(dst[3].data[row], r3);
+#else
+  for (uint32 l = 0; l < 4; ++l) {
+    dst[l].data[row][0] = a.v[l];
+    dst[l].data[row][1] = b.v[l];
+    dst[l].data[row][2] = c.v[l];
+    dst[l].data[row][3] = d.v[l];
+  }
+#endif
+}
+
+
+inline void StoreMatrixRows(const Float8 &a, const Float8 &b, const Float8 &c,
+  const Float8 &d, Mat4 *dst, uint32 row)
+{
+  StoreMatrixRows(a.Low(), b.Low(), c.Low(), d.Low(), dst, row);
+  StoreMatrixRows(a.High(), b.High(), c.High(), d.High(), dst + 4, row);
+}
+
+
+// Same layout as Quaternion::ToMatrix4x4(), for FloatN::Width matrices at a
+// time, transposed back into the AoS palette a row at a time.
+inline void ToMatrixWide(const WideQuaternion<FloatN> &q, const Vec3 *translations,
+  Mat4 *palette)
+{
+  FloatN zero(0.0f), one(1.0f), two(2.0f);
+  FloatN xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+  FloatN xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+  FloatN wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+  StoreMatrixRows(one - two * (yy + zz), two * (xy + wz), two * (xz - wy), zero, palette, 0);
+  StoreMatrixRows(two * (xy - wz), one - two * (xx + zz), two * (yz + wx), zero, palette, 1);
+  StoreMatrixRows(two * (xz + wy), two * (yz - wx), one - two * (xx + yy), zero, palette, 2);
+  if (translations) {
+    WideVector3<FloatN> t = WideVector3<FloatN>::Load(translations);
+    StoreMatrixRows(t.x, t.y, t.z, one, palette, 3);
+  } else {
+    StoreMatrixRows(zero, zero, zero, one, palette, 3);
+  }
+}
+} // detail
+
+
+inline void NlerpBatch(const QuatArray &a, const QuatArray &b, const real32 *t,
+  QuatArray &out, bool parallel)
+{
+  detail::BlendPerElement blend = { t };
+  detail::NlerpBatchWith(a, b, blend, out, parallel);
+}
+
+
+inline void NlerpBatch(const QuatArray &a, const QuatArray &b, real32 t,
+  QuatArray &out, bool parallel)
+{
+  detail::BlendUniform blend = { t };
+  detail::NlerpBatchWith(a, b, blend, out, parallel);
+}
+
+
+template<typename P>
+void SlerpBatch(const QuatArray &a, const QuatArray &b, const real32 *t,
+  QuatArray &out, bool parallel)
+{
+  detail::BlendPerElement blend = { t };
+  detail::SlerpBatchWith<P>(a, b, blend, out, parallel);
+}
+
+
+template<typename P>
+void SlerpBatch(const QuatArray &a, const QuatArray &b, real32 t,
+  QuatArray &out, bool parallel)
+{
+  detail::BlendUniform blend = { t };
+  detail::SlerpBatchWith<P>(a, b, blend, out, parallel);
+}
+
+
+inline void MulBatch(const QuatArray &a, const QuatArray &b, QuatArray &out,
+  bool parallel)
+{
+  out.Resize(a.Size());
+  detail::QuatBatch(a.Size(), parallel,
+    [&] (size_t i) {
+      detail::StoreQuats(detail::LoadQuats(a, i) * detail::LoadQuats(b, i), out, i);
+    },
+    [&] (size_t i) {
+      out.Set(i, a.Get(i) * b.Get(i));
+    });
+}
+
+
+inline void ToMatrixBatch(const QuatArray &rotations, const Vec3 *translations,
+  Mat4 *palette, bool parallel)
+{
+  detail::QuatBatch(rotations.Size(), parallel,
+    [&] (size_t i) {
+      detail::ToMatrixWide(detail::LoadQuats(rotations, i),
+        translations ? translations + i : nullptr, palette + i);
+    },
+    [&] (size_t i) {
+      palette[i] = rotations.Get(i).ToMatrix4x4();
+      if (translations) {
+        palette[i].data[3][0] = translations[i].x;
+        palette[i].data[3][1] = translations[i].y;
+        palette[i].data[3][2] = translations[i].z;
+      }
+    });
+}
+} // jkl
@@ -8,10 +8,130 @@
 namespace math {
 
 
-template<typename T> inline
+template<typename P, typename T> constexpr
 Quaternion<T> Normalize(const Quaternion<T> &q)
 {
-  T norm = q.Length();
-  return (q / norm);
+  return detail::NormalizeWith(q, P());
+}
+
+
+template<typename T> constexpr
+Vector4<T> ToVector4(const Quaternion<T> &q)
+{
+  return Vector4<T>(q.x, q.y, q.z, q.w);
+}
+
+
+template<typename T> constexpr
+Matrix4x4<T> ToMatrix4x4(const Quaternion<T> &q)
+{
+  return q.ToMatrix4x4();
+}
+
+
+template<typename T> constexpr
+T Dot(const Quaternion<T> &q0, const Quaternion<T> &q1)
+{
+  return (q0.w * q1.w) + (q0.x * q1.x) + (q0.y * q1.y) + (q0.z * q1.z);
+}
+
+
+// q and -q are the same rotation, so q1 is flipped into q0's hemisphere
+// first, otherwise we would take the long way around.
+template<typename T> constexpr
+Quaternion<T> Nlerp(const Quaternion<T> &q0, const Quaternion<T> &q1, T t)
+{
+  T sign = Dot(q0, q1) < static_cast<T>(0) ? -static_cast<T>(1) : static_cast<T>(1);
+  return Normalize(q0 * (static_cast<T>(1) - t) + q1 * (sign * t));
+}
+
+
+namespace detail {
+// Past this cosine the angle is too small for sin(theta) to divide by, and
+// nlerp is just as good.
+constexpr real32 SlerpNlerpThreshold = 0.9995f;
+
+
+template<typename T> constexpr
+Quaternion<T> SlerpWith(const Quaternion<T> &q0, const Quaternion<T> &q1, T t, Exact)
+{
+  T one = static_cast<T>(1);
+  T cosTheta = Dot(q0, q1);
+  T sign = cosTheta < static_cast<T>(0) ? -one : one;
+  cosTheta *= sign;
+  if (cosTheta > static_cast<T>(SlerpNlerpThreshold)) {
+    return Normalize(q0 * (one - t) + q1 * (sign * t));
+  }
+  T theta = Acos(cosTheta);
+  T invSinTheta = one / static_cast<T>(Sqrt(one - cosTheta * cosTheta));
+  T s0 = static_cast<T>(0), s1 = static_cast<T>(0), c = static_cast<T>(0);
+  SinCos((one - t) * theta, s0, c);
+  SinCos(t * theta, s1, c);
+  return q0 * (s0 * invSinTheta) + q1 * (sign * s1 * invSinTheta);
+}
+
+
+// Nlerp moves too slowly near the ends and too fast in the middle. Warping t
+// with a cubic, whose strength depends on the angle, evens that out. The
+// coefficients are fit to minimize the angular error against real slerp,
+// from "Approximating slerp" by Arseny Kapoulkine.
+template<typename T> constexpr
+T SlerpCorrectT(T t, T cosTheta)
+{
+  T d = cosTheta;
+  T a = static_cast<T>(1.0904f) + d * (static_cast<T>(-3.2452f) + 
+    d * (static_cast<T>(3.55645f) - d * static_cast<T>(1.43519f)));
+  T b = static_cast<T>(0.848013f) + d * (static_cast<T>(-1.06021f) + d * static_cast<T>(0.215638f));
+  T half = t - static_cast<T>(0.5f);
+  T k = a * half * half + b;
+  return t + t * half * (t - static_cast<T>(1)) * k;
+}
+
+
+template<typename T> constexpr
+Quaternion<T> SlerpWith(const Quaternion<T> &q0, const Quaternion<T> &q1, T t, Fast)
+{
+  T one = static_cast<T>(1);
+  T cosTheta = Dot(q0, q1);
+  T sign = cosTheta < static_cast<T>(0) ? -one : one;
+  T warped = SlerpCorrectT(t, cosTheta * sign);
+  return Normalize<Fast>(q0 * (one - warped) + q1 * (sign * warped));
+}
+} // detail
+
+
+template<typename P, typename T> constexpr
+Quaternion<T> Slerp(const Quaternion<T> &q0, const Quaternion<T> &q1, T t)
+{
+  return detail::SlerpWith(q0, q1, t, P());
+}
+
+
+template<typename T> constexpr
+Quaternion<T> ToQuaternion(const Vector3<T> &eulerAngle)
+{
+  T half = static_cast<T>(0.5);
+  T sx = static_cast<T>(0), cx = static_cast<T>(0);
+  T sy = static_cast<T>(0), cy = static_cast<T>(0);
+  T sz = static_cast<T>(0), cz = static_cast<T>(0);
+  SinCos(eulerAngle.x * half, sx, cx);
+  SinCos(eulerAngle.y * half, sy, cy);
+  SinCos(eulerAngle.z * half, sz, cz);
+  return Quaternion<T>(
+    cy * cx * cz + sy * sx * sz,
+    cy * sx * cz + sy * cx * sz,
+    sy * cx * cz - cy * sx * sz,
+    cy * cx * sz - sy * sx * cz
+  );
+}
+
+
+// axis is expected to be normalized.
+template<typename T> constexpr
+Quaternion<T> AngleAxis(T angle, const Vector3<T> &axis)
+{
+  T sine = static_cast<T>(0), cosine = static_cast<T>(0);
+  SinCos(angle * static_cast<T>(0.5), sine, cosine);
+  return Quaternion<T>(cosine, axis.x * sine, axis.y * sine, axis.z * sine);
 }
 } // jkl
\ No newline at end of file
@@ -0,0 +1,188 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../ray.hpp"
+#include "../bounding/bound_box.hpp"
+
+
+namespace math {
+namespace detail {
+
+
+// Triangles whose determinant is below this are taken as parallel to the ray.
+static const real32 RayTriangleEpsilon = 1e-8f;
+} // detail
+
+
+// Kay and Kajiya. The ray is inside slab x between t1 and t2, and inside the
+// box over the intersection of the three slabs.
+template<typename T> constexpr
+bool Intersect(const Ray<T> &ray, const BoundBox<T> &box, T &distance, T maxDistance)
+{
+  Vector3<T> t1 = (box.min - ray.origin) * ray.invDirection;
+  Vector3<T> t2 = (box.max - ray.origin) * ray.invDirection;
+  Vector3<T> tMin = Min(t1, t2);
+  Vector3<T> tMax = Max(t1, t2);
+  T tNear = tMin.x > tMin.y ? tMin.x : tMin.y;
+  tNear = tNear > tMin.z ? tNear : tMin.z;
+  tNear = tNear > static_cast<T>(0) ? tNear : static_cast<T>(0);
+  T tFar = tMax.x < tMax.y ? tMax.x : tMax.y;
+  tFar = tFar < tMax.z ? tFar : tMax.z;
+  if (tNear > tFar || tNear > maxDistance) {
+    return false;
+  }
+  distance = tNear;
+  return true;
+}
+
+
+template<typename T> constexpr
+bool Intersect(const Ray<T> &ray, const Vector3<T> &v0, const Vector3<T> &v1,
+  const Vector3<T> &v2, T &distance, T &u, T &v, T maxDistance)
+{
+  Vector3<T> edge1 = v1 - v0;
+  Vector3<T> edge2 = v2 - v0;
+  Vector3<T> p = Cross(ray.direction, edge2);
+  T det = Dot(edge1, p);
+  if (Abs(det) < static_cast<T>(detail::RayTriangleEpsilon)) {
+    return false;
+  }
+  T invDet = static_cast<T>(1) / det;
+  Vector3<T> s = ray.origin - v0;
+  T b1 = Dot(s, p) * invDet;
+  if (b1 < static_cast<T>(0) || b1 > static_cast<T>(1)) {
+    return false;
+  }
+  Vector3<T> q = Cross(s, edge1);
+  T b2 = Dot(ray.direction, q) * invDet;
+  if (b2 < static_cast<T>(0) || b1 + b2 > static_cast<T>(1)) {
+    return false;
+  }
+  T t = Dot(edge2, q) * invDet;
+  if (t <= static_cast<T>(0) || t > maxDistance) {
+    return false;
+  }
+  distance = t;
+  u = b1;
+  v = b2;
+  return true;
+}
+
+
+template<typename F>
+WideRay<F> WideRay<F>::Load(const Ray3 *rays)
+{
+  Vec3 origins[F::Width];
+  Vec3 directions[F::Width];
+  Vec3 invDirections[F::Width];
+  for (uint32 i = 0; i < F::Width; ++i) {
+    origins[i] = rays[i].origin;
+    directions[i] = rays[i].direction;
+    invDirections[i] = rays[i].invDirection;
+  }
+  WideRay result;
+  result.origin = WideVector3<F>::Load(origins);
+  result.direction = WideVector3<F>::Load(directions);
+  result.invDirection = WideVector3<F>::Load(invDirections);
+  return result;
+}
+
+
+namespace detail {
+
+
+template<typename F> inline
+F IntersectSlabs(const WideRay<F> &ray, const F &minX, const F &minY, const F &minZ,
+  const F &maxX, const F &maxY, const F &maxZ, F &distance, const F &maxDistance)
+{
+  F t1x = (minX - ray.origin.x) * ray.invDirection.x;
+  F t2x = (maxX - ray.origin.x) * ray.invDirection.x;
+  F t1y = (minY - ray.origin.y) * ray.invDirection.y;
+  F t2y = (maxY - ray.origin.y) * ray.invDirection.y;
+  F t1z = (minZ - ray.origin.z) * ray.invDirection.z;
+  F t2z = (maxZ - ray.origin.z) * ray.invDirection.z;
+  F tNear = Max(Max(Min(t1x, t2x), Min(t1y, t2y)), Max(Min(t1z, t2z), F(0.0f)));
+  F tFar = Min(Min(Max(t1x, t2x), Max(t1y, t2y)), Max(t1z, t2z));
+  distance = tNear;
+  return (tNear <= tFar) & (tNear <= maxDistance);
+}
+} // detail
+
+
+template<typename F>
+F Intersect(const WideRay<F> &rays, const AABB &box, F &distance, const F &maxDistance)
+{
+  return detail::IntersectSlabs(rays, F(box.min.x), F(box.min.y), F(box.min.z),
+    F(box.max.x), F(box.max.y), F(box.max.z), distance, maxDistance);
+}
+
+
+template<typename F>
+F Intersect(const WideRay<F> &ray, const AABBArray &boxes, size_t i, F &distance,
+  const F &maxDistance)
+{
+  return detail::IntersectSlabs(ray,
+    F::Load(&boxes.minX[i]), F::Load(&boxes.minY[i]), F::Load(&boxes.minZ[i]),
+    F::Load(&boxes.maxX[i]), F::Load(&boxes.maxY[i]), F::Load(&boxes.maxZ[i]),
+    distance, maxDistance);
+}
+
+
+template<typename F>
+F Intersect(const WideRay<F> &rays, const Vec3 &v0, const Vec3 &v1, const Vec3 &v2,
+  F &distance, F &u, F &v, const F &maxDistance)
+{
+  return Intersect(rays, WideVector3<F>(v0), WideVector3<F>(v1), WideVector3<F>(v2),
+    distance, u, v, maxDistance);
+}
+
+
+// The scalar test without its early outs, every condition folded into the
+// mask instead.
+template<typename F>
+F Intersect(const WideRay<F> &rays, const WideVector3<F> &v0, const WideVector3<F> &v1,
+  const WideVector3<F> &v2, F &distance, F &u, F &v, const F &maxDistance)
+{
+  F zero(0.0f);
+  F one(1.0f);
+  WideVector3<F> edge1 = v1 - v0;
+  WideVector3<F> edge2 = v2 - v0;
+  WideVector3<F> p = Cross(rays.direction, edge2);
+  F det = Dot(edge1, p);
+  F invDet = one / det;
+  WideVector3<F> s = rays.origin - v0;
+  WideVector3<F> q = Cross(s, edge1);
+  u = Dot(s, p) * invDet;
+  v = Dot(rays.direction, q) * invDet;
+  distance = Dot(edge2, q) * invDet;
+  return (Abs(det) >= F(detail::RayTriangleEpsilon))
+    & (u >= zero) & (v >= zero) & (u + v <= one)
+    & (distance > zero) & (distance <= maxDistance);
+}
+
+
+inline size_t IntersectBatch(const Ray3 &ray, const AABBArray &boxes, uint32 *hits,
+  real32 maxDistance)
+{
+  const uint32 W = FloatN::Width;
+  const size_t count = boxes.Size();
+  const size_t wideEnd = count / W * W;
+  WideRay<FloatN> wideRay(ray);
+  FloatN wideMax(maxDistance);
+  FloatN distance;
+  size_t written = 0;
+  size_t i = 0;
+  for (; i < wideEnd; i += W) {
+    detail::AppendLanes(MoveMask(Intersect(wideRay, boxes, i, distance, wideMax)), i, hits,
+      written);
+  }
+  for (; i < count; ++i) {
+    real32 t;
+    hits[written] = static_cast<uint32>(i);
+    written += Intersect(ray, boxes.Get(i), t, maxDistance) ? 1 : 0;
+  }
+  return written;
+}
+} // jkl
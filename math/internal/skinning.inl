@@ -0,0 +1,235 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../skinning.hpp"
+#include "../wide.hpp"
+#include "../parallel.hpp"
+
+
+namespace math {
+namespace detail {
+
+
+// Skinning does a lot more work per vertex than the plain transforms, so
+// smaller batches are already worth splitting.
+static const size_t SkinParallelGrain = 4 * 1024;
+
+
+// Weighted sum of the joints of one vertex, each flipped into the hemisphere
+// of the first joint. Not normalized.
+inline DualQuat SumInfluences(const DualQuat *palette, const SkinInfluence &influence)
+{
+  const DualQuat &first = palette[influence.joints[0]];
+  DualQuat sum = first * influence.weights[0];
+  for (uint32 k = 1; k < 4; ++k) {
+    const DualQuat &dq = palette[influence.joints[k]];
+    real32 weight = influence.weights[k];
+    sum += dq * (Dot(first.real, dq.real) < 0.0f ? -weight : weight);
+  }
+  return sum;
+}
+
+
+// Blended and normalized dual quaternions of FloatN::Width vertices, as
+// structure of arrays.
+struct WideDualQuat {
+  FloatN rw, rx, ry, rz;
+  FloatN dw, dx, dy, dz;
+};
+
+
+// Gather the quaternions src[0..Width) into structure of arrays form.
+inline void GatherQuats(const Quat *const *src, Float4 &w, Float4 &x, Float4 &y, Float4 &z)
+{
+#if defined(J_SIMD_X86)
+  __m128 r0 = _mm_loadu_ps(&src[0]->w);
+  __m128 r1 = _mm_loadu_ps(&src[1]->w);
+  __m128 r2 = _mm_loadu_ps(&src[2]->w);
+  __m128 r3 = _mm_loadu_ps(&src[3]->w);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  w = Float4(r0); x = Float4(r1); y = Float4(r2); z = Float4(r3);
+#else
+  w = Float4(src[0]->w, src[1]->w, src[2]->w, src[3]->w);
+  x = Float4(src[0]->x, src[1]->x, src[2]->x, src[3]->x);
+  y = Float4(src[0]->y, src[1]->y, src[2]->y, src[3]->y);
+  z = Float4(src[0]->z, src[1]->z, src[2]->z, src[3]->z);
+#endif
+}
+
+
+inline void GatherQuats(const Quat *const *src, Float8 &w, Float8 &x, Float8 &y, Float8 &z)
+{
+  Float4 w0, x0, y0, z0, w1, x1, y1, z1;
+  GatherQuats(src, w0, x0, y0, z0);
+  GatherQuats(src + 4, w1, x1, y1, z1);
+  w = Float8(w0, w1); x = Float8(x0, x1); y = Float8(y0, y1); z = Float8(z0, z1);
+}
+
+
+// Same as SumInfluences, then Normalize, lane by lane. The dual part is only
+// scaled, not made orthogonal to real, as the part along real cancels out of
+// the translation anyway.
+template<typename P> inline
+WideDualQuat BlendInfluences(const DualQuat *palette,
+  StridedSpan<const SkinInfluence> influences, size_t i)
+{
+  const uint32 W = FloatN::Width;
+  WideDualQuat b;
+  FloatN firstW, firstX, firstY, firstZ;
+  for (uint32 k = 0; k < 4; ++k) {
+    const Quat *reals[W];
+    const Quat *duals[W];
+    real32 weights[W];
+    for (uint32 l = 0; l < W; ++l) {
+      const SkinInfluence &influence = influences[i + l];
+      const DualQuat &dq = palette[influence.joints[k]];
+      reals[l] = &dq.real;
+      duals[l] = &dq.dual;
+      weights[l] = influence.weights[k];
+    }
+    FloatN rw, rx, ry, rz, dw, dx, dy, dz;
+    GatherQuats(reals, rw, rx, ry, rz);
+    GatherQuats(duals, dw, dx, dy, dz);
+    FloatN weight = FloatN::Load(weights);
+    if (k == 0) {
+      firstW = rw; firstX = rx; firstY = ry; firstZ = rz;
+      b.rw = rw * weight; b.rx = rx * weight; b.ry = ry * weight; b.rz = rz * weight;
+      b.dw = dw * weight; b.dx = dx * weight; b.dy = dy * weight; b.dz = dz * weight;
+      continue;
+    }
+    FloatN dot = firstW * rw + firstX * rx + firstY * ry + firstZ * rz;
+    weight = Select(dot < FloatN(0.0f), FloatN(0.0f) - weight, weight);
+    b.rw += rw * weight; b.rx += rx * weight; b.ry += ry * weight; b.rz += rz * weight;
+    b.dw += dw * weight; b.dx += dx * weight; b.dy += dy * weight; b.dz += dz * weight;
+  }
+
+  FloatN invLength = InvSqrt<P>(b.rw * b.rw + b.rx * b.rx + b.ry * b.ry + b.rz * b.rz);
+  b.rw *= invLength; b.rx *= invLength; b.ry *= invLength; b.rz *= invLength;
+  b.dw *= invLength; b.dx *= invLength; b.dy *= invLength; b.dz *= invLength;
+  return b;
+}
+
+
+// v + 2 rv x (rv x v + rw v), see DualQuaternion::TransformDirection.
+inline void RotateWide(const WideDualQuat &b, FloatN &x, FloatN &y, FloatN &z)
+{
+  FloatN cx = b.ry * z - b.rz * y + b.rw * x;
+  FloatN cy = b.rz * x - b.rx * z + b.rw * y;
+  FloatN cz = b.rx * y - b.ry * x + b.rw * z;
+  FloatN two(2.0f);
+  x += two * (b.ry * cz - b.rz * cy);
+  y += two * (b.rz * cx - b.rx * cz);
+  z += two * (b.rx * cy - b.ry * cx);
+}
+
+
+inline void LoadVec3s(StridedSpan<const Vec3> in, size_t i, FloatN &x, FloatN &y, FloatN &z)
+{
+  const uint32 W = FloatN::Width;
+  real32 xs[W], ys[W], zs[W];
+  for (uint32 l = 0; l < W; ++l) {
+    const Vec3 &v = in[i + l];
+    xs[l] = v.x; ys[l] = v.y; zs[l] = v.z;
+  }
+  x = FloatN::Load(xs); y = FloatN::Load(ys); z = FloatN::Load(zs);
+}
+
+
+inline void StoreVec3s(const FloatN &x, const FloatN &y, const FloatN &z,
+  StridedSpan<Vec3> out, size_t i)
+{
+  const uint32 W = FloatN::Width;
+  real32 xs[W], ys[W], zs[W];
+  x.Store(xs); y.Store(ys); z.Store(zs);
+  for (uint32 l = 0; l < W; ++l) {
+    Vec3 &o = out[i + l];
+    o.x = xs[l]; o.y = ys[l]; o.z = zs[l];
+  }
+}
+
+
+// Works on [begin, end).
+template<typename P, bool Normals>
+void SkinDualQuaternionsRange(const DualQuat *palette,
+  StridedSpan<const SkinInfluence> influences,
+  StridedSpan<const Vec3> positions, StridedSpan<Vec3> outPositions,
+  StridedSpan<const Vec3> normals, StridedSpan<Vec3> outNormals,
+  size_t begin, size_t end)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wideEnd = begin + (end - begin) / W * W;
+  size_t i = begin;
+  for (; i < wideEnd; i += W) {
+    WideDualQuat b = BlendInfluences<P>(palette, influences, i);
+
+    FloatN x, y, z;
+    LoadVec3s(positions, i, x, y, z);
+    RotateWide(b, x, y, z);
+    // 2 * (rw * dv - dw * rv + rv x dv), see DualQuaternion::GetTranslation.
+    FloatN two(2.0f);
+    x += two * (b.rw * b.dx - b.dw * b.rx + b.ry * b.dz - b.rz * b.dy);
+    y += two * (b.rw * b.dy - b.dw * b.ry + b.rz * b.dx - b.rx * b.dz);
+    z += two * (b.rw * b.dz - b.dw * b.rz + b.rx * b.dy - b.ry * b.dx);
+    StoreVec3s(x, y, z, outPositions, i);
+
+    if (Normals) {
+      LoadVec3s(normals, i, x, y, z);
+      RotateWide(b, x, y, z);
+      StoreVec3s(x, y, z, outNormals, i);
+    }
+  }
+
+  for (; i < end; ++i) {
+    DualQuat b = Normalize<P>(SumInfluences(palette, influences[i]));
+    outPositions[i] = b.TransformPoint(positions[i]);
+    if (Normals) {
+      outNormals[i] = b.TransformDirection(normals[i]);
+    }
+  }
+}
+
+
+template<typename P, bool Normals>
+void SkinDualQuaternions(const DualQuat *palette,
+  StridedSpan<const SkinInfluence> influences,
+  StridedSpan<const Vec3> positions, StridedSpan<Vec3> outPositions,
+  StridedSpan<const Vec3> normals, StridedSpan<Vec3> outNormals,
+  bool parallel)
+{
+  if (!parallel) {
+    SkinDualQuaternionsRange<P, Normals>(palette, influences, positions, outPositions,
+      normals, outNormals, 0, positions.count);
+    return;
+  }
+  ParallelFor(positions.count, SkinParallelGrain, [&] (size_t begin, size_t end) {
+    SkinDualQuaternionsRange<P, Normals>(palette, influences, positions, outPositions,
+      normals, outNormals, begin, end);
+  });
+}
+} // detail
+
+
+template<typename P>
+void SkinDualQuaternions(const DualQuat *palette,
+  StridedSpan<const SkinInfluence> influences,
+  StridedSpan<const Vec3> positions, StridedSpan<Vec3> outPositions,
+  bool parallel)
+{
+  detail::SkinDualQuaternions<P, false>(palette, influences, positions, outPositions,
+    StridedSpan<const Vec3>(), StridedSpan<Vec3>(), parallel);
+}
+
+
+template<typename P>
+void SkinDualQuaternions(const DualQuat *palette,
+  StridedSpan<const SkinInfluence> influences,
+  StridedSpan<const Vec3> positions, StridedSpan<Vec3> outPositions,
+  StridedSpan<const Vec3> normals, StridedSpan<Vec3> outNormals,
+  bool parallel)
+{
+  detail::SkinDualQuaternions<P, true>(palette, influences, positions, outPositions,
+    normals, outNormals, parallel);
+}
+} // jkl
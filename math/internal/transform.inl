@@ -0,0 +1,152 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../wide.hpp"
+#include "../parallel.hpp"
+
+
+namespace math {
+namespace detail {
+
+
+// Batches smaller than this are not worth handing out to other cores.
+static const size_t TransformParallelGrain = 16 * 1024;
+
+
+// out = in * | m00 m01 m02 |  (+ t)
+//            | m10 m11 m12 |
+//            | m20 m21 m22 |
+// optionally normalized. Works on [begin, end).
+template<typename F, bool Translate, bool Renormalize>
+void TransformVec3Range(const real32 m[3][3], const real32 t[3],
+  StridedSpan<const Vec3> in, StridedSpan<Vec3> out, size_t begin, size_t end)
+{
+  const uint32 W = F::Width;
+  F m00(m[0][0]), m01(m[0][1]), m02(m[0][2]);
+  F m10(m[1][0]), m11(m[1][1]), m12(m[1][2]);
+  F m20(m[2][0]), m21(m[2][1]), m22(m[2][2]);
+  F tx(t[0]), ty(t[1]), tz(t[2]);
+
+  size_t i = begin;
+  for (; i + W <= end; i += W) {
+    real32 xs[W], ys[W], zs[W];
+    for (uint32 l = 0; l < W; ++l) {
+      const Vec3 &v = in[i + l];
+      xs[l] = v.x; ys[l] = v.y; zs[l] = v.z;
+    }
+    F x = F::Load(xs), y = F::Load(ys), z = F::Load(zs);
+    F rx = x * m00 + y * m10 + z * m20;
+    F ry = x * m01 + y * m11 + z * m21;
+    F rz = x * m02 + y * m12 + z * m22;
+    if (Translate) {
+      rx += tx; ry += ty; rz += tz;
+    }
+    if (Renormalize) {
+      F lengthSq = rx * rx + ry * ry + rz * rz;
+      F invLength = Select(lengthSq > F(0.0f), F(1.0f) / Sqrt(lengthSq), F(1.0f));
+      rx *= invLength; ry *= invLength; rz *= invLength;
+    }
+    rx.Store(xs); ry.Store(ys); rz.Store(zs);
+    for (uint32 l = 0; l < W; ++l) {
+      Vec3 &o = out[i + l];
+      o.x = xs[l]; o.y = ys[l]; o.z = zs[l];
+    }
+  }
+
+  for (; i < end; ++i) {
+    Vec3 v = in[i];
+    real32 rx = v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0];
+    real32 ry = v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1];
+    real32 rz = v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2];
+    if (Translate) {
+      rx += t[0]; ry += t[1]; rz += t[2];
+    }
+    if (Renormalize) {
+      real32 lengthSq = rx * rx + ry * ry + rz * rz;
+      if (lengthSq > 0.0f) {
+        real32 invLength = 1.0f / std::sqrt(lengthSq);
+        rx *= invLength; ry *= invLength; rz *= invLength;
+      }
+    }
+    Vec3 &o = out[i];
+    o.x = rx; o.y = ry; o.z = rz;
+  }
+}
+
+
+template<bool Translate, bool Renormalize>
+void TransformVec3(const real32 m[3][3], const real32 t[3],
+  StridedSpan<const Vec3> in, StridedSpan<Vec3> out, bool parallel)
+{
+  if (!parallel) {
+    TransformVec3Range<FloatN, Translate, Renormalize>(m, t, in, out, 0, in.count);
+    return;
+  }
+  ParallelFor(in.count, TransformParallelGrain, [&] (size_t begin, size_t end) {
+    TransformVec3Range<FloatN, Translate, Renormalize>(m, t, in, out, begin, end);
+  });
+}
+
+
+inline void Upper3x3(const Mat4 &m, real32 out[3][3])
+{
+  for (uint32 i = 0; i < 3; ++i) {
+    for (uint32 j = 0; j < 3; ++j) {
+      out[i][j] = m.data[i][j];
+    }
+  }
+}
+} // detail
+
+
+inline void TransformPoints(const Mat4 &m, StridedSpan<const Vec3> in,
+  StridedSpan<Vec3> out, bool parallel)
+{
+  real32 r[3][3];
+  detail::Upper3x3(m, r);
+  detail::TransformVec3<true, false>(r, m.data[3], in, out, parallel);
+}
+
+
+inline void TransformDirections(const Mat4 &m, StridedSpan<const Vec3> in,
+  StridedSpan<Vec3> out, bool parallel)
+{
+  real32 r[3][3];
+  detail::Upper3x3(m, r);
+  const real32 zero[3] = { 0.0f, 0.0f, 0.0f };
+  detail::TransformVec3<false, false>(r, zero, in, out, parallel);
+}
+
+
+// The inverse transpose of A is its cofactor matrix over its determinant. We
+// keep the division, even though we normalize afterwards, since a negative
+// determinant (mirroring) must flip the normals back around.
+inline void TransformNormals(const Mat4 &m, StridedSpan<const Vec3> in,
+  StridedSpan<Vec3> out, bool parallel)
+{
+  const real32 (*a)[4] = m.data;
+  real32 c[3][3];
+  c[0][0] = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+  c[0][1] = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+  c[0][2] = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+  c[1][0] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+  c[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+  c[1][2] = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+  c[2][0] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+  c[2][1] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+  c[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+  real32 det = a[0][0] * c[0][0] + a[0][1] * c[0][1] + a[0][2] * c[0][2];
+  if (det != 0.0f) {
+    real32 invDet = 1.0f / det;
+    for (uint32 i = 0; i < 3; ++i) {
+      for (uint32 j = 0; j < 3; ++j) {
+        c[i][j] *= invDet;
+      }
+    }
+  }
+  const real32 zero[3] = { 0.0f, 0.0f, 0.0f };
+  detail::TransformVec3<false, true>(c, zero, in, out, parallel);
+}
+} // jkl
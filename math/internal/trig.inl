@@ -0,0 +1,417 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "../trig.hpp"
+
+
+namespace math {
+namespace detail {
+
+
+// Cody-Waite reduction: pi/2 split into three floats, the first two with
+// enough trailing zero bits that q * TrigHalfPi1 and q * TrigHalfPi2 are exact
+// for the quotients TrigMaxAngle allows.
+constexpr real32 TrigTwoOverPi = 0.636619772367581343f;
+constexpr real32 TrigHalfPi1   = 1.5703125f;
+constexpr real32 TrigHalfPi2   = 4.837512969970703125e-4f;
+constexpr real32 TrigHalfPi3   = 7.54978995489188216e-8f;
+constexpr real32 TrigHalfPi    = 1.57079632679489661923f;
+constexpr real32 TrigPi        = 3.14159265358979323846f;
+
+// Rounds to the nearest integer (ties to even) by pushing the fraction out of
+// the mantissa. Only valid for |v| < 2^22, which the reduction guarantees.
+constexpr real32 TrigRoundMagic = 12582912.0f;
+
+
+// Minimax polynomials on [-pi/4, pi/4] (sin, cos, tan), [0, tan(pi/8)] (atan)
+// and [0, 0.5] (asin), with z = x * x. Coefficients from Cephes.
+template<typename V>
+constexpr V SinPoly(const V &x, const V &z)
+{
+  return x + x * z * ((V(-1.9515295891e-4f) * z + V(8.3321608736e-3f)) * z + V(-1.6666654611e-1f));
+}
+
+
+template<typename V>
+constexpr V CosPoly(const V &z)
+{
+  return V(1.0f) - V(0.5f) * z + z * z *
+    ((V(2.443315711809948e-5f) * z + V(-1.388731625493765e-3f)) * z + V(4.166664568298827e-2f));
+}
+
+
+template<typename V>
+constexpr V TanPoly(const V &x, const V &z)
+{
+  return x + x * z * (((((V(9.38540185543e-3f) * z + V(3.11992232697e-3f)) * z +
+    V(2.44301354525e-2f)) * z + V(5.34112807005e-2f)) * z + V(1.33387994085e-1f)) * z +
+    V(3.33331568548e-1f));
+}
+
+
+template<typename V>
+constexpr V AtanPoly(const V &x, const V &z)
+{
+  return x + x * z * (((V(8.05374449538e-2f) * z + V(-1.38776856032e-1f)) * z +
+    V(1.99777106478e-1f)) * z + V(-3.33329491539e-1f));
+}
+
+
+template<typename V>
+constexpr V AsinPoly(const V &x, const V &z)
+{
+  return x + x * z * ((((V(4.2163199048e-2f) * z + V(2.4181311049e-2f)) * z +
+    V(4.5470025998e-2f)) * z + V(7.4953002686e-2f)) * z + V(1.6666752422e-1f));
+}
+
+
+// angle - q * pi/2.
+template<typename V>
+constexpr V TrigReduce(const V &angle, const V &q)
+{
+  return ((angle - q * V(TrigHalfPi1)) - q * V(TrigHalfPi2)) - q * V(TrigHalfPi3);
+}
+
+
+// Nearest multiple of pi/2 to the angle, and the quadrant it lands in.
+constexpr int32 TrigQuadrant(real32 angle, real32 &q)
+{
+  q = (angle * TrigTwoOverPi + TrigRoundMagic) - TrigRoundMagic;
+  return static_cast<int32>(q) & 3;
+}
+
+
+// atan of a non negative value.
+// Sign bit of value, so -0 counts as negative, as for the Float4 and Float8
+// masks. Constant evaluation cannot see it, and takes -0 for 0.
+constexpr bool SignBit(real32 value)
+{
+  return J_IS_CONSTANT_EVALUATED() ? value < 0.0f : std::signbit(value);
+}
+
+
+constexpr real32 AtanPositive(real32 x)
+{
+  real32 offset = 0.0f;
+  if (x > 2.414213562373095f) {
+    offset = TrigHalfPi;
+    x = -1.0f / x;
+  } else if (x > 0.4142135623730950f) {
+    offset = 0.25f * TrigPi;
+    x = (x - 1.0f) / (x + 1.0f);
+  }
+  return offset + AtanPoly(x, x * x);
+}
+
+
+template<typename F>
+inline F WideRound(const F &v)
+{
+  return (v + F(TrigRoundMagic)) - F(TrigRoundMagic);
+}
+
+
+template<typename F>
+inline F WideFloor(const F &v)
+{
+  F r = WideRound(v);
+  return r - ((r > v) & F(1.0f));
+}
+
+
+// Negate the lanes of v where the mask is set.
+template<typename F>
+inline F NegateIf(const F &mask, const F &v)
+{
+  return v ^ (mask & F(-0.0f));
+}
+
+
+template<typename F>
+inline void WideSinCos(const F &angle, F &sine, F &cosine)
+{
+  F q = WideRound(angle * F(TrigTwoOverPi));
+  F quadrant = q - F(4.0f) * WideFloor(q * F(0.25f));
+  F r = TrigReduce(angle, q);
+  F z = r * r;
+  F s = SinPoly(r, z);
+  F c = CosPoly(z);
+
+  // sin(r + q pi/2) cycles through sin, cos, -sin, -cos.
+  F odd = (quadrant == F(1.0f)) | (quadrant == F(3.0f));
+  sine = NegateIf(quadrant >= F(2.0f), Select(odd, c, s));
+  cosine = NegateIf((quadrant == F(1.0f)) | (quadrant == F(2.0f)), Select(odd, s, c));
+
+  F inRange = Abs(angle) <= F(TrigMaxAngle);
+  if (!All(inRange)) {
+    real32 a[F::Width], sl[F::Width], cl[F::Width];
+    angle.Store(a);
+    sine.Store(sl);
+    cosine.Store(cl);
+    int32 mask = MoveMask(inRange);
+    for (uint32 i = 0; i < F::Width; ++i) {
+      if (!(mask & (1 << i))) {
+        sl[i] = std::sin(a[i]);
+        cl[i] = std::cos(a[i]);
+      }
+    }
+    sine = F::Load(sl);
+    cosine = F::Load(cl);
+  }
+}
+
+
+template<typename F>
+inline F WideTan(const F &angle)
+{
+  F q = WideRound(angle * F(TrigTwoOverPi));
+  F r = TrigReduce(angle, q);
+  F t = TanPoly(r, r * r);
+  // tan(r + pi/2) = -1 / tan(r).
+  F odd = (q - F(2.0f) * WideRound(q * F(0.5f))) != F(0.0f);
+  t = Select(odd, F(-1.0f) / t, t);
+
+  F inRange = Abs(angle) <= F(TrigMaxAngle);
+  if (!All(inRange)) {
+    real32 a[F::Width], tl[F::Width];
+    angle.Store(a);
+    t.Store(tl);
+    int32 mask = MoveMask(inRange);
+    for (uint32 i = 0; i < F::Width; ++i) {
+      if (!(mask & (1 << i))) {
+        tl[i] = std::tan(a[i]);
+      }
+    }
+    t = F::Load(tl);
+  }
+  return t;
+}
+
+
+template<typename F>
+inline F WideAtan2(const F &y, const F &x)
+{
+  F ax = Abs(x);
+  F ay = Abs(y);
+  F mn = Min(ax, ay);
+  F mx = Max(ax, ay);
+  // Both zero gives 0 / 0, make that 0.
+  F t = Select(mx > F(0.0f), mn / mx, F(0.0f));
+
+  F mid = t > F(0.4142135623730950f);
+  F xr = Select(mid, (t - F(1.0f)) / (t + F(1.0f)), t);
+  F a = AtanPoly(xr, xr * xr) + (mid & F(0.25f * TrigPi));
+
+  a = Select(ay > ax, F(TrigHalfPi) - a, a);
+  a = Select(x < F(0.0f), F(TrigPi) - a, a);
+  // NaN in, NaN out, y first, as the scalar Atan2 does.
+  a = Select(x != x, x, a ^ (y & F(-0.0f)));
+  return Select(y != y, y, a);
+}
+
+
+template<typename F>
+inline F WideAcos(const F &value)
+{
+  F ax = Abs(value);
+  F big = ax > F(0.5f);
+  F z = Select(big, F(0.5f) * (F(1.0f) - ax), value * value);
+  F s = Select(big, Sqrt(z), ax);
+  F asinS = AsinPoly(s, z);
+
+  // |x| > 0.5: acos(x) = 2 asin(sqrt((1 - x) / 2)), mirrored for negative x.
+  F twice = asinS + asinS;
+  F large = Select(value > F(0.0f), twice, F(TrigPi) - twice);
+  // |x| <= 0.5: acos(x) = pi/2 - asin(x).
+  F small = F(TrigHalfPi) - (asinS ^ (value & F(-0.0f)));
+  return Select(big, large, small);
+}
+} // detail
+
+
+constexpr void SinCos(real32 angle, real32 &sine, real32 &cosine)
+{
+  if (!(Abs(angle) <= TrigMaxAngle)) {
+    sine = std::sin(angle);
+    cosine = std::cos(angle);
+    return;
+  }
+  real32 q = 0.0f;
+  int32 quadrant = detail::TrigQuadrant(angle, q);
+  real32 r = detail::TrigReduce(angle, q);
+  real32 z = r * r;
+  real32 s = detail::SinPoly(r, z);
+  real32 c = detail::CosPoly(z);
+  switch (quadrant) {
+    case 0:  sine = s;  cosine = c;  break;
+    case 1:  sine = c;  cosine = -s; break;
+    case 2:  sine = -s; cosine = -c; break;
+    default: sine = -c; cosine = s;  break;
+  }
+}
+
+
+constexpr void SinCos(real64 angle, real64 &sine, real64 &cosine)
+{
+  sine = Sin(angle);
+  cosine = Cos(angle);
+}
+
+
+constexpr real32 Sin(real32 angle)
+{
+  real32 sine = 0.0f, cosine = 0.0f;
+  SinCos(angle, sine, cosine);
+  return sine;
+}
+
+
+constexpr real32 Cos(real32 angle)
+{
+  real32 sine = 0.0f, cosine = 0.0f;
+  SinCos(angle, sine, cosine);
+  return cosine;
+}
+
+
+constexpr real32 Tan(real32 angle)
+{
+  if (!(Abs(angle) <= TrigMaxAngle)) {
+    return std::tan(angle);
+  }
+  real32 q = 0.0f;
+  int32 quadrant = detail::TrigQuadrant(angle, q);
+  real32 r = detail::TrigReduce(angle, q);
+  real32 t = detail::TanPoly(r, r * r);
+  return (quadrant & 1) ? -1.0f / t : t;
+}
+
+
+constexpr real32 Atan2(real32 y, real32 x)
+{
+  if (y != y) {
+    return y;
+  }
+  if (x != x) {
+    return x;
+  }
+  real32 ax = Abs(x);
+  real32 ay = Abs(y);
+  real32 a = 0.0f;
+  if (ay > ax) {
+    a = detail::TrigHalfPi - detail::AtanPositive(ax / ay);
+  } else if (ax > 0.0f) {
+    a = detail::AtanPositive(ay / ax);
+  }
+  if (x < 0.0f) {
+    a = detail::TrigPi - a;
+  }
+  return detail::SignBit(y) ? -a : a;
+}
+
+
+inline real64 Atan2(real64 y, real64 x)
+{
+  return std::atan2(y, x);
+}
+
+
+constexpr real32 Acos(real32 value)
+{
+  real32 ax = Abs(value);
+  if (ax > 0.5f) {
+    real32 z = 0.5f * (1.0f - ax);
+    real32 s = Sqrtf(z);
+    real32 twice = 2.0f * detail::AsinPoly(s, z);
+    return value > 0.0f ? twice : detail::TrigPi - twice;
+  }
+  return detail::TrigHalfPi - detail::AsinPoly(value, value * value);
+}
+
+
+inline real64 Acos(real64 value)
+{
+  return std::acos(value);
+}
+
+
+inline void SinCos(const Float4 &angle, Float4 &sine, Float4 &cosine)
+{
+  detail::WideSinCos(angle, sine, cosine);
+}
+
+
+inline void SinCos(const Float8 &angle, Float8 &sine, Float8 &cosine)
+{
+  detail::WideSinCos(angle, sine, cosine);
+}
+
+
+inline Float4 Tan(const Float4 &angle) { return detail::WideTan(angle); }
+inline Float8 Tan(const Float8 &angle) { return detail::WideTan(angle); }
+inline Float4 Atan2(const Float4 &y, const Float4 &x) { return detail::WideAtan2(y, x); }
+inline Float8 Atan2(const Float8 &y, const Float8 &x) { return detail::WideAtan2(y, x); }
+inline Float4 Acos(const Float4 &value) { return detail::WideAcos(value); }
+inline Float8 Acos(const Float8 &value) { return detail::WideAcos(value); }
+
+
+inline void SinCos(const real32 *angles, real32 *sines, real32 *cosines, size_t count)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wide = count - count % W;
+  size_t i = 0;
+  for (; i < wide; i += W) {
+    FloatN s, c;
+    SinCos(FloatN::Load(angles + i), s, c);
+    s.Store(sines + i);
+    c.Store(cosines + i);
+  }
+  for (; i < count; ++i) {
+    SinCos(angles[i], sines[i], cosines[i]);
+  }
+}
+
+
+inline void Tan(const real32 *angles, real32 *out, size_t count)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wide = count - count % W;
+  size_t i = 0;
+  for (; i < wide; i += W) {
+    Tan(FloatN::Load(angles + i)).Store(out + i);
+  }
+  for (; i < count; ++i) {
+    out[i] = Tan(angles[i]);
+  }
+}
+
+
+inline void Atan2(const real32 *ys, const real32 *xs, real32 *out, size_t count)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wide = count - count % W;
+  size_t i = 0;
+  for (; i < wide; i += W) {
+    Atan2(FloatN::Load(ys + i), FloatN::Load(xs + i)).Store(out + i);
+  }
+  for (; i < count; ++i) {
+    out[i] = Atan2(ys[i], xs[i]);
+  }
+}
+
+
+inline void Acos(const real32 *values, real32 *out, size_t count)
+{
+  const uint32 W = FloatN::Width;
+  const size_t wide = count - count % W;
+  size_t i = 0;
+  for (; i < wide; i += W) {
+    Acos(FloatN::Load(values + i)).Store(out + i);
+  }
+  for (; i < count; ++i) {
+    out[i] = Acos(values[i]);
+  }
+}
+} // jkl
@@ -8,7 +8,7 @@ namespace math {
 
 
 template<typename T>
-Vector4<T> Vector4<T>::operator+(const Vector4 &v) const 
+constexpr Vector4<T> Vector4<T>::operator+(const Vector4 &v) const 
 {
   return Vector4(
     x + v.x,
@@ -20,7 +20,7 @@ Vector4<T> Vector4<T>::operator+(const Vector4 &v) const
 
 
 template<typename T>
-Vector4<T> Vector4<T>::operator-(const Vector4 &v) const 
+constexpr Vector4<T> Vector4<T>::operator-(const Vector4 &v) const 
 {
   return Vector4(
     x - v.x,
@@ -32,7 +32,7 @@ Vector4<T> Vector4<T>::operator-(const Vector4 &v) const
 
 
 template<typename T>
-Vector4<T> Vector4<T>::operator*(const Vector4 &v) const 
+constexpr Vector4<T> Vector4<T>::operator*(const Vector4 &v) const 
 {
   return Vector4(
     x * v.x,
@@ -44,7 +44,7 @@ Vector4<T> Vector4<T>::operator*(const Vector4 &v) const
 
 
 template<typename T>
-Vector4<T> Vector4<T>::operator*(const T scale) const 
+constexpr Vector4<T> Vector4<T>::operator*(const T scale) const 
 {
   return Vector4(
     x * scale,
@@ -56,7 +56,7 @@ Vector4<T> Vector4<T>::operator*(const T scale) const
 
 
 template<typename T>
-Vector4<T> Vector4<T>::operator/(const Vector4 &v) const 
+constexpr Vector4<T> Vector4<T>::operator/(const Vector4 &v) const 
 {
   return Vector4(
     x / v.x,
@@ -68,7 +68,7 @@ Vector4<T> Vector4<T>::operator/(const Vector4 &v) const
 
 
 template<typename T>
-Vector4<T> Vector4<T>::operator/(const T scaler) const
+constexpr Vector4<T> Vector4<T>::operator/(const T scaler) const
 {
   return Vector4(
     x / scaler,
@@ -80,7 +80,7 @@ Vector4<T> Vector4<T>::operator/(const T scaler) const
 
 
 template<typename T>
-void Vector4<T>::operator+=(const Vector4 &v)
+constexpr void Vector4<T>::operator+=(const Vector4 &v)
 {
   x += v.x;
   y += v.y;
@@ -90,7 +90,7 @@ void Vector4<T>::operator+=(const Vector4 &v)
 
 
 template<typename T>
-void Vector4<T>::operator-=(const Vector4 &v)
+constexpr void Vector4<T>::operator-=(const Vector4 &v)
 {
   x -= v.x;
   y -= v.y;
@@ -100,7 +100,7 @@ void Vector4<T>::operator-=(const Vector4 &v)
 
 
 template<typename T>
-void Vector4<T>::operator*=(const Vector4 &v)
+constexpr void Vector4<T>::operator*=(const Vector4 &v)
 {
   x *= v.x;
   y *= v.y;
@@ -110,7 +110,7 @@ void Vector4<T>::operator*=(const Vector4 &v)
 
 
 template<typename T>
-void Vector4<T>::operator*=(const T scale)
+constexpr void Vector4<T>::operator*=(const T scale)
 {
   x *= scale;
   y *= scale;
@@ -120,7 +120,7 @@ void Vector4<T>::operator*=(const T scale)
 
 
 template<typename T>
-void Vector4<T>::operator/=(const Vector4 &v)
+constexpr void Vector4<T>::operator/=(const Vector4 &v)
 {
   x /= v.x;
   y /= v.y;
@@ -130,7 +130,7 @@ void Vector4<T>::operator/=(const Vector4 &v)
 
 
 template<typename T>
-void Vector4<T>::operator/=(const T scaler)
+constexpr void Vector4<T>::operator/=(const T scaler)
 {
   x /= scaler;
   y /= scaler;
@@ -140,7 +140,7 @@ void Vector4<T>::operator/=(const T scaler)
 
 
 template<typename T>
-Vector4<T> Vector4<T>::operator-() const 
+constexpr Vector4<T> Vector4<T>::operator-() const 
 {
   return Vector4(
     -x,
@@ -152,7 +152,7 @@ Vector4<T> Vector4<T>::operator-() const
 
 
 template<typename T>
-Vector3<T> Vector3<T>::operator+(const Vector3 &v) const 
+constexpr Vector3<T> Vector3<T>::operator+(const Vector3 &v) const 
 {
   return Vector3(
     x + v.x,
@@ -163,7 +163,7 @@ Vector3<T> Vector3<T>::operator+(const Vector3 &v) const
 
 
 template<typename T>
-Vector3<T> Vector3<T>::operator-(const Vector3 &v) const 
+constexpr Vector3<T> Vector3<T>::operator-(const Vector3 &v) const 
 {
   return Vector3(
     x - v.x,
@@ -174,7 +174,7 @@ Vector3<T> Vector3<T>::operator-(const Vector3 &v) const
 
 
 template<typename T>
-Vector3<T> Vector3<T>::operator*(const Vector3 &v) const 
+constexpr Vector3<T> Vector3<T>::operator*(const Vector3 &v) const 
 {
   return Vector3(
     x * v.x,
@@ -185,7 +185,7 @@ Vector3<T> Vector3<T>::operator*(const Vector3 &v) const
 
 
 template<typename T>
-Vector3<T> Vector3<T>::operator*(const T scale) const 
+constexpr Vector3<T> Vector3<T>::operator*(const T scale) const 
 {
   return Vector3(
     x * scale,
@@ -196,7 +196,7 @@ Vector3<T> Vector3<T>::operator*(const T scale) const
 
 
 template<typename T>
-Vector3<T> Vector3<T>::operator/(const Vector3 &v) const 
+constexpr Vector3<T> Vector3<T>::operator/(const Vector3 &v) const 
 {
   return Vector3(
     x / v.x,
@@ -207,7 +207,7 @@ Vector3<T> Vector3<T>::operator/(const Vector3 &v) const
 
 
 template<typename T>
-Vector3<T> Vector3<T>::operator/(const T scaler) const
+constexpr Vector3<T> Vector3<T>::operator/(const T scaler) const
 {
   return Vector3(
     x / scaler,
@@ -218,7 +218,7 @@ Vector3<T> Vector3<T>::operator/(const T scaler) const
 
 
 template<typename T>
-void Vector3<T>::operator+=(const Vector3 &v)
+constexpr void Vector3<T>::operator+=(const Vector3 &v)
 {
   x += v.x;
   y += v.y;
@@ -227,7 +227,7 @@ void Vector3<T>::operator+=(const Vector3 &v)
 
 
 template<typename T>
-void Vector3<T>::operator-=(const Vector3 &v)
+constexpr void Vector3<T>::operator-=(const Vector3 &v)
 {
   x -= v.x;
   y -= v.y;
@@ -236,7 +236,7 @@ void Vector3<T>::operator-=(const Vector3 &v)
 
 
 template<typename T>
-void Vector3<T>::operator*=(const Vector3 &v)
+constexpr void Vector3<T>::operator*=(const Vector3 &v)
 {
   x *= v.x;
   y *= v.y;
@@ -245,7 +245,7 @@ void Vector3<T>::operator*=(const Vector3 &v)
 
 
 template<typename T>
-void Vector3<T>::operator*=(const T scale)
+constexpr void Vector3<T>::operator*=(const T scale)
 {
   x *= scale;
   y *= scale;
@@ -254,7 +254,7 @@ void Vector3<T>::operator*=(const T scale)
 
 
 template<typename T>
-void Vector3<T>::operator/=(const Vector3 &v)
+constexpr void Vector3<T>::operator/=(const Vector3 &v)
 {
   x /= v.x;
   y /= v.y;
@@ -263,7 +263,7 @@ void Vector3<T>::operator/=(const Vector3 &v)
 
 
 template<typename T>
-void Vector3<T>::operator/=(const T scaler)
+constexpr void Vector3<T>::operator/=(const T scaler)
 {
   x /= scaler;
   y /= scaler;
@@ -272,7 +272,7 @@ void Vector3<T>::operator/=(const T scaler)
 
 
 template<typename T>
-Vector3<T> Vector3<T>::operator-() const 
+constexpr Vector3<T> Vector3<T>::operator-() const 
 {
   return Vector3(
     -x,
@@ -283,7 +283,7 @@ Vector3<T> Vector3<T>::operator-() const
 
 
 template<typename T>
-Vector2<T> Vector2<T>::operator+(const Vector2 &v) const 
+constexpr Vector2<T> Vector2<T>::operator+(const Vector2 &v) const 
 {
   return Vector2(
     x + v.x,
@@ -293,7 +293,7 @@ Vector2<T> Vector2<T>::operator+(const Vector2 &v) const
 
 
 template<typename T>
-Vector2<T> Vector2<T>::operator-(const Vector2 &v) const 
+constexpr Vector2<T> Vector2<T>::operator-(const Vector2 &v) const 
 {
   return Vector2(
     x - v.x,
@@ -303,7 +303,7 @@ Vector2<T> Vector2<T>::operator-(const Vector2 &v) const
 
 
 template<typename T>
-Vector2<T> Vector2<T>::operator*(const Vector2 &v) const 
+constexpr Vector2<T> Vector2<T>::operator*(const Vector2 &v) const 
 {
   return Vector2(
     x * v.x,
@@ -313,7 +313,7 @@ Vector2<T> Vector2<T>::operator*(const Vector2 &v) const
 
 
 template<typename T>
-Vector2<T> Vector2<T>::operator*(const T scale) const 
+constexpr Vector2<T> Vector2<T>::operator*(const T scale) const 
 {
   return Vector2(
     x * scale,
@@ -323,7 +323,7 @@ Vector2<T> Vector2<T>::operator*(const T scale) const
 
 
 template<typename T>
-Vector2<T> Vector2<T>::operator/(const Vector2 &v) const 
+constexpr Vector2<T> Vector2<T>::operator/(const Vector2 &v) const 
 {
     return Vector2(
       x / v.x,
@@ -333,7 +333,7 @@ Vector2<T> Vector2<T>::operator/(const Vector2 &v) const
 
 
 template<typename T>
-Vector2<T> Vector2<T>::operator/(const T scaler) const
+constexpr Vector2<T> Vector2<T>::operator/(const T scaler) const
 {
   return Vector2(
     x / scaler,
@@ -343,7 +343,7 @@ Vector2<T> Vector2<T>::operator/(const T scaler) const
 
 
 template<typename T>
-void Vector2<T>::operator+=(const Vector2 &v)
+constexpr void Vector2<T>::operator+=(const Vector2 &v)
 {
   x += v.x;
   y += v.y;
@@ -351,7 +351,7 @@ void Vector2<T>::operator+=(const Vector2 &v)
 
 
 template<typename T>
-void Vector2<T>::operator-=(const Vector2 &v)
+constexpr void Vector2<T>::operator-=(const Vector2 &v)
 {
   x -= v.x;
   y -= v.y;
@@ -359,7 +359,7 @@ void Vector2<T>::operator-=(const Vector2 &v)
 
 
 template<typename T>
-void Vector2<T>::operator*=(const Vector2 &v)
+constexpr void Vector2<T>::operator*=(const Vector2 &v)
 {
   x *= v.x;
   y *= v.y;
@@ -367,7 +367,7 @@ void Vector2<T>::operator*=(const Vector2 &v)
 
 
 template<typename T>
-void Vector2<T>::operator*=(const T scale)
+constexpr void Vector2<T>::operator*=(const T scale)
 {
   x *= scale;
   y *= scale;
@@ -375,7 +375,7 @@ void Vector2<T>::operator*=(const T scale)
 
 
 template<typename T>
-void Vector2<T>::operator/=(const Vector2 &v)
+constexpr void Vector2<T>::operator/=(const Vector2 &v)
 {
   x /= v.x;
   y /= v.y;
@@ -383,7 +383,7 @@ void Vector2<T>::operator/=(const Vector2 &v)
 
 
 template<typename T>
-void Vector2<T>::operator/=(const T scaler)
+constexpr void Vector2<T>::operator/=(const T scaler)
 {
   x /= scaler;
   y /= scaler;
@@ -391,7 +391,7 @@ void Vector2<T>::operator/=(const T scaler)
 
 
 template<typename T>
-Vector2<T> Vector2<T>::operator-() const 
+constexpr Vector2<T> Vector2<T>::operator-() const 
 {
   return Vector2(
     -x,
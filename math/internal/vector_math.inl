@@ -6,43 +6,116 @@ namespace math {
 
 
 
-template<typename T> inline
+namespace detail {
+template<typename V> constexpr
+V NormalizeWith(const V &vec, Exact)
+{
+  return vec / vec.Length();
+}
+
+
+template<typename V> constexpr
+V NormalizeWith(const V &vec, Fast)
+{
+  return vec * InvSqrt<Fast>(vec.LengthSquared());
+}
+
+
+template<typename V> constexpr
+auto LengthWith(const V &vec, Exact) -> decltype(vec.Length())
+{
+  return vec.Length();
+}
+
+
+// length = lengthSq * 1 / sqrt(lengthSq), which would be 0 * inf for zero.
+template<typename V> constexpr
+auto LengthWith(const V &vec, Fast) -> decltype(vec.Length())
+{
+  auto lengthSq = vec.LengthSquared();
+  return lengthSq > 0 ? lengthSq * InvSqrt<Fast>(lengthSq) : lengthSq;
+}
+
+
+template<typename V, typename T> constexpr
+V DivideWith(const V &vec, T scaler, Exact)
+{
+  return vec / scaler;
+}
+
+
+template<typename V, typename T> constexpr
+V DivideWith(const V &vec, T scaler, Fast)
+{
+  return vec * Reciprocal<Fast>(scaler);
+}
+} // detail
+
+
+template<typename P, typename T> constexpr
 Vector4<T> Normalize(const Vector4<T> &vec)
 {
-  T length = vec.Length();
-  return Vector4<T>(
-    vec.x / length,
-    vec.y / length,
-    vec.z / length,
-    vec.w / length
-  );
+  return detail::NormalizeWith(vec, P());
 }
 
 
-template<typename T> inline
+template<typename P, typename T> constexpr
 Vector3<T> Normalize(const Vector3<T> &vec)
 {
-  T length = vec.Length();
-  return Vector3<T>(
-    vec.x / length,
-    vec.y / length,
-    vec.z / length
-  );
+  return detail::NormalizeWith(vec, P());
 }
 
 
-template<typename T> inline
+template<typename P, typename T> constexpr
 Vector2<T> Normalize(const Vector2<T> &vec)
 {
-  T length = vec.Length();
-  return Vector2<T>(
-    vec.x / length,
-    vec.y / length
-  );
+  return detail::NormalizeWith(vec, P());
+}
+
+
+template<typename P, typename T> constexpr
+T Length(const Vector4<T> &vec)
+{
+  return detail::LengthWith(vec, P());
 }
 
 
-template<typename T> inline
+template<typename P, typename T> constexpr
+T Length(const Vector3<T> &vec)
+{
+  return detail::LengthWith(vec, P());
+}
+
+
+template<typename P, typename T> constexpr
+T Length(const Vector2<T> &vec)
+{
+  return detail::LengthWith(vec, P());
+}
+
+
+template<typename P, typename T> constexpr
+Vector4<T> Divide(const Vector4<T> &vec, T scaler)
+{
+  return detail::DivideWith(vec, scaler, P());
+}
+
+
+template<typename P, typename T> constexpr
+Vector3<T> Divide(const Vector3<T> &vec, T scaler)
+{
+  return detail::DivideWith(vec, scaler, P());
+}
+
+
+template<typename P, typename T> constexpr
+Vector2<T> Divide(const Vector2<T> &vec, T scaler)
+{
+  return detail::DivideWith(vec, scaler, P());
+}
+
+
+template<typename T> constexpr
 Vector3<T> Cross(const Vector3<T> &u, const Vector3<T> &v)
 {
   return Vector3<T>(
@@ -53,21 +126,21 @@ Vector3<T> Cross(const Vector3<T> &u, const Vector3<T> &v)
 }
 
 
-template<typename T> inline
+template<typename T> constexpr
 T Dot(const Vector3<T> &u, const Vector3<T> &v)
 {
   return (u.x * v.x) + (u.y * v.y) + (u.z * v.z);
 }
 
 
-template<typename T> inline
+template<typename T> constexpr
 T Dot(const Vector4<T> &u, const Vector4<T> &v)
 {
   return (u.x * v.x) + (u.y * v.y) + (u.z * v.z) + (u.w * v.w);
 }
 
 
-template<typename T> inline
+template<typename T> constexpr
 T Dot(const Vector2<T> &u, const Vector2<T> &v)
 {
   return (u.x * v.x) + (u.y * v.y);
@@ -76,16 +149,38 @@ T Dot(const Vector2<T> &u, const Vector2<T> &v)
 
 // Precise method to calculate linear interpolation.
 // This may be hardware dependent.
-template<typename T> inline
+template<typename T> constexpr
 Vector2<T> Lerp(const Vector2<T> &v0, const Vector2<T> &v1, T t)
 {
   return v0 * (static_cast<T>(1) - t) + v1 * t;
 }
 
 
-template<typename T> inline
+template<typename T> constexpr
 Vector3<T> Lerp(const Vector3<T> &v0, const Vector3<T> &v1, T t)
 {
   return v0 * (static_cast<T>(1) - t) + v1 * t;
 }
+
+
+template<typename T> constexpr
+Vector3<T> Min(const Vector3<T> &u, const Vector3<T> &v)
+{
+  return Vector3<T>(
+    u.x < v.x ? u.x : v.x,
+    u.y < v.y ? u.y : v.y,
+    u.z < v.z ? u.z : v.z
+  );
+}
+
+
+template<typename T> constexpr
+Vector3<T> Max(const Vector3<T> &u, const Vector3<T> &v)
+{
+  return Vector3<T>(
+    u.x > v.x ? u.x : v.x,
+    u.y > v.y ? u.y : v.y,
+    u.z > v.z ? u.z : v.z
+  );
+}
 } // jkl
@@ -0,0 +1,245 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+// 
+#pragma once
+
+
+namespace math {
+
+template<typename F>
+WideQuaternion<F> WideQuaternion<F>::Load(const Quaternion<real32> *src)
+{
+  real32 ws[F::Width];
+  real32 xs[F::Width];
+  real32 ys[F::Width];
+  real32 zs[F::Width];
+  for (uint32 i = 0; i < F::Width; ++i) {
+    ws[i] = src[i].w;
+    xs[i] = src[i].x;
+    ys[i] = src[i].y;
+    zs[i] = src[i].z;
+  }
+  return WideQuaternion(F::Load(ws), F::Load(xs), F::Load(ys), F::Load(zs));
+}
+
+
+template<typename F>
+void WideQuaternion<F>::Store(Quaternion<real32> *dst) const
+{
+  real32 ws[F::Width];
+  real32 xs[F::Width];
+  real32 ys[F::Width];
+  real32 zs[F::Width];
+  w.Store(ws);
+  x.Store(xs);
+  y.Store(ys);
+  z.Store(zs);
+  for (uint32 i = 0; i < F::Width; ++i) {
+    dst[i].w = ws[i];
+    dst[i].x = xs[i];
+    dst[i].y = ys[i];
+    dst[i].z = zs[i];
+  }
+}
+
+
+template<typename F>
+Quaternion<real32> WideQuaternion<F>::Get(uint32 lane) const
+{
+  return Quaternion<real32>(w[lane], x[lane], y[lane], z[lane]);
+}
+
+
+template<typename F>
+WideQuaternion<F> WideQuaternion<F>::operator+(const WideQuaternion &q) const
+{
+  return WideQuaternion(
+    w + q.w,
+    x + q.x,
+    y + q.y,
+    z + q.z
+  );
+}
+
+
+template<typename F>
+WideQuaternion<F> WideQuaternion<F>::operator-(const WideQuaternion &q) const
+{
+  return WideQuaternion(
+    w - q.w,
+    x - q.x,
+    y - q.y,
+    z - q.z
+  );
+}
+
+
+template<typename F>
+WideQuaternion<F> WideQuaternion<F>::operator*(const WideQuaternion &q) const
+{
+  return WideQuaternion(
+    (w * q.w) - (x * q.x) - (y * q.y) - (z * q.z),
+    (w * q.x) + (x * q.w) + (y * q.z) - (z * q.y),
+    (w * q.y) - (x * q.z) + (y * q.w) + (z * q.x),
+    (w * q.z) + (x * q.y) - (y * q.x) + (z * q.w)
+  );
+}
+
+
+template<typename F>
+WideQuaternion<F> WideQuaternion<F>::operator*(const F &scaler) const
+{
+  return WideQuaternion(
+    w * scaler,
+    x * scaler,
+    y * scaler,
+    z * scaler
+  );
+}
+
+
+template<typename F>
+WideQuaternion<F> WideQuaternion<F>::operator/(const F &scaler) const
+{
+  return WideQuaternion(
+    w / scaler,
+    x / scaler,
+    y / scaler,
+    z / scaler
+  );
+}
+
+
+template<typename F>
+void WideQuaternion<F>::operator+=(const WideQuaternion &q)
+{
+  w += q.w;
+  x += q.x;
+  y += q.y;
+  z += q.z;
+}
+
+
+template<typename F>
+void WideQuaternion<F>::operator-=(const WideQuaternion &q)
+{
+  w -= q.w;
+  x -= q.x;
+  y -= q.y;
+  z -= q.z;
+}
+
+
+template<typename F>
+void WideQuaternion<F>::operator*=(const WideQuaternion &q)
+{
+  *this = *this * q;
+}
+
+
+template<typename F>
+void WideQuaternion<F>::operator*=(const F &scaler)
+{
+  w *= scaler;
+  x *= scaler;
+  y *= scaler;
+  z *= scaler;
+}
+
+
+template<typename F>
+void WideQuaternion<F>::operator/=(const F &scaler)
+{
+  w /= scaler;
+  x /= scaler;
+  y /= scaler;
+  z /= scaler;
+}
+
+
+template<typename F>
+WideQuaternion<F> WideQuaternion<F>::operator-() const
+{
+  return WideQuaternion(-w, -x, -y, -z);
+}
+
+
+template<typename F> inline
+F Dot(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1)
+{
+  return (q0.w * q1.w) + (q0.x * q1.x) + (q0.y * q1.y) + (q0.z * q1.z);
+}
+
+
+template<typename P, typename F> inline
+WideQuaternion<F> Normalize(const WideQuaternion<F> &q)
+{
+  return q * InvSqrt<P>(Dot(q, q));
+}
+
+
+template<typename F> inline
+WideQuaternion<F> Lerp(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1, const F &t)
+{
+  return q0 * (F(1.0f) - t) + q1 * t;
+}
+
+
+// q and -q are the same rotation, so flip q1 into q0's hemisphere first,
+// otherwise we would take the long way around.
+template<typename F> inline
+WideQuaternion<F> Nlerp(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1, const F &t)
+{
+  F sign = Select(Dot(q0, q1) < F(0.0f), F(-1.0f), F(1.0f));
+  return Normalize(Lerp(q0, q1 * sign, t));
+}
+
+
+namespace detail {
+template<typename F> inline
+WideQuaternion<F> WideSlerpWith(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1,
+  const F &t, Exact)
+{
+  F cosTheta = Dot(q0, q1);
+  F flip = cosTheta < F(0.0f);
+  WideQuaternion<F> q1s(NegateIf(flip, q1.w), NegateIf(flip, q1.x), 
+    NegateIf(flip, q1.y), NegateIf(flip, q1.z));
+  cosTheta = Min(Abs(cosTheta), F(1.0f));
+
+  // Lanes past the threshold nlerp instead, like the scalar version.
+  F nearly = cosTheta > F(SlerpNlerpThreshold);
+  F theta = Acos(cosTheta);
+  F sinThetaSq = Select(nearly, F(1.0f), F(1.0f) - cosTheta * cosTheta);
+  F invSinTheta = F(1.0f) / Sqrt(sinThetaSq);
+  F s0, s1, unused;
+  SinCos((F(1.0f) - t) * theta, s0, unused);
+  SinCos(t * theta, s1, unused);
+  F w0 = Select(nearly, F(1.0f) - t, s0 * invSinTheta);
+  F w1 = Select(nearly, t, s1 * invSinTheta);
+
+  WideQuaternion<F> r = q0 * w0 + q1s * w1;
+  F scale = Select(nearly, F(1.0f) / Sqrt(Dot(r, r)), F(1.0f));
+  return r * scale;
+}
+
+
+template<typename F> inline
+WideQuaternion<F> WideSlerpWith(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1,
+  const F &t, Fast)
+{
+  F cosTheta = Dot(q0, q1);
+  F flip = cosTheta < F(0.0f);
+  WideQuaternion<F> q1s(NegateIf(flip, q1.w), NegateIf(flip, q1.x), 
+    NegateIf(flip, q1.y), NegateIf(flip, q1.z));
+  F warped = SlerpCorrectT(t, Abs(cosTheta));
+  return Normalize<Fast>(q0 * (F(1.0f) - warped) + q1s * warped);
+}
+} // detail
+
+
+template<typename P, typename F> inline
+WideQuaternion<F> Slerp(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1, const F &t)
+{
+  return detail::WideSlerpWith(q0, q1, t, P());
+}
+} // jkl
\ No newline at end of file
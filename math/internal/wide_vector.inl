@@ -0,0 +1,553 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+
+namespace math {
+
+template<typename F>
+WideVector4<F> WideVector4<F>::Load(const Vector4<real32> *src)
+{
+  real32 xs[F::Width];
+  real32 ys[F::Width];
+  real32 zs[F::Width];
+  real32 ws[F::Width];
+  for (uint32 i = 0; i < F::Width; ++i) {
+    xs[i] = src[i].x;
+    ys[i] = src[i].y;
+    zs[i] = src[i].z;
+    ws[i] = src[i].w;
+  }
+  return WideVector4(F::Load(xs), F::Load(ys), F::Load(zs), F::Load(ws));
+}
+
+
+template<typename F>
+void WideVector4<F>::Store(Vector4<real32> *dst) const
+{
+  real32 xs[F::Width];
+  real32 ys[F::Width];
+  real32 zs[F::Width];
+  real32 ws[F::Width];
+  x.Store(xs);
+  y.Store(ys);
+  z.Store(zs);
+  w.Store(ws);
+  for (uint32 i = 0; i < F::Width; ++i) {
+    dst[i].x = xs[i];
+    dst[i].y = ys[i];
+    dst[i].z = zs[i];
+    dst[i].w = ws[i];
+  }
+}
+
+
+template<typename F>
+Vector4<real32> WideVector4<F>::Get(uint32 lane) const
+{
+  return Vector4<real32>(x[lane], y[lane], z[lane], w[lane]);
+}
+
+
+template<typename F>
+WideVector4<F> WideVector4<F>::operator+(const WideVector4 &v) const
+{
+  return WideVector4(
+    x + v.x,
+    y + v.y,
+    z + v.z,
+    w + v.w
+  );
+}
+
+
+template<typename F>
+WideVector4<F> WideVector4<F>::operator-(const WideVector4 &v) const
+{
+  return WideVector4(
+    x - v.x,
+    y - v.y,
+    z - v.z,
+    w - v.w
+  );
+}
+
+
+template<typename F>
+WideVector4<F> WideVector4<F>::operator*(const WideVector4 &v) const
+{
+  return WideVector4(
+    x * v.x,
+    y * v.y,
+    z * v.z,
+    w * v.w
+  );
+}
+
+
+template<typename F>
+WideVector4<F> WideVector4<F>::operator*(const F &scale) const
+{
+  return WideVector4(
+    x * scale,
+    y * scale,
+    z * scale,
+    w * scale
+  );
+}
+
+
+template<typename F>
+WideVector4<F> WideVector4<F>::operator/(const WideVector4 &v) const
+{
+  return WideVector4(
+    x / v.x,
+    y / v.y,
+    z / v.z,
+    w / v.w
+  );
+}
+
+
+template<typename F>
+WideVector4<F> WideVector4<F>::operator/(const F &scaler) const
+{
+  return WideVector4(
+    x / scaler,
+    y / scaler,
+    z / scaler,
+    w / scaler
+  );
+}
+
+
+template<typename F>
+void WideVector4<F>::operator+=(const WideVector4 &v)
+{
+  x += v.x;
+  y += v.y;
+  z += v.z;
+  w += v.w;
+}
+
+
+template<typename F>
+void WideVector4<F>::operator-=(const WideVector4 &v)
+{
+  x -= v.x;
+  y -= v.y;
+  z -= v.z;
+  w -= v.w;
+}
+
+
+template<typename F>
+void WideVector4<F>::operator*=(const WideVector4 &v)
+{
+  x *= v.x;
+  y *= v.y;
+  z *= v.z;
+  w *= v.w;
+}
+
+
+template<typename F>
+void WideVector4<F>::operator*=(const F &scale)
+{
+  x *= scale;
+  y *= scale;
+  z *= scale;
+  w *= scale;
+}
+
+
+template<typename F>
+void WideVector4<F>::operator/=(const WideVector4 &v)
+{
+  x /= v.x;
+  y /= v.y;
+  z /= v.z;
+  w /= v.w;
+}
+
+
+template<typename F>
+void WideVector4<F>::operator/=(const F &scaler)
+{
+  x /= scaler;
+  y /= scaler;
+  z /= scaler;
+  w /= scaler;
+}
+
+
+template<typename F>
+WideVector4<F> WideVector4<F>::operator-() const
+{
+  return WideVector4(-x, -y, -z, -w);
+}
+
+
+template<typename F>
+WideVector3<F> WideVector3<F>::Load(const Vector3<real32> *src)
+{
+  real32 xs[F::Width];
+  real32 ys[F::Width];
+  real32 zs[F::Width];
+  for (uint32 i = 0; i < F::Width; ++i) {
+    xs[i] = src[i].x;
+    ys[i] = src[i].y;
+    zs[i] = src[i].z;
+  }
+  return WideVector3(F::Load(xs), F::Load(ys), F::Load(zs));
+}
+
+
+template<typename F>
+void WideVector3<F>::Store(Vector3<real32> *dst) const
+{
+  real32 xs[F::Width];
+  real32 ys[F::Width];
+  real32 zs[F::Width];
+  x.Store(xs);
+  y.Store(ys);
+  z.Store(zs);
+  for (uint32 i = 0; i < F::Width; ++i) {
+    dst[i].x = xs[i];
+    dst[i].y = ys[i];
+    dst[i].z = zs[i];
+  }
+}
+
+
+template<typename F>
+Vector3<real32> WideVector3<F>::Get(uint32 lane) const
+{
+  return Vector3<real32>(x[lane], y[lane], z[lane]);
+}
+
+
+template<typename F>
+WideVector3<F> WideVector3<F>::operator+(const WideVector3 &v) const
+{
+  return WideVector3(
+    x + v.x,
+    y + v.y,
+    z + v.z
+  );
+}
+
+
+template<typename F>
+WideVector3<F> WideVector3<F>::operator-(const WideVector3 &v) const
+{
+  return WideVector3(
+    x - v.x,
+    y - v.y,
+    z - v.z
+  );
+}
+
+
+template<typename F>
+WideVector3<F> WideVector3<F>::operator*(const WideVector3 &v) const
+{
+  return WideVector3(
+    x * v.x,
+    y * v.y,
+    z * v.z
+  );
+}
+
+
+template<typename F>
+WideVector3<F> WideVector3<F>::operator*(const F &scale) const
+{
+  return WideVector3(
+    x * scale,
+    y * scale,
+    z * scale
+  );
+}
+
+
+template<typename F>
+WideVector3<F> WideVector3<F>::operator/(const WideVector3 &v) const
+{
+  return WideVector3(
+    x / v.x,
+    y / v.y,
+    z / v.z
+  );
+}
+
+
+template<typename F>
+WideVector3<F> WideVector3<F>::operator/(const F &scaler) const
+{
+  return WideVector3(
+    x / scaler,
+    y / scaler,
+    z / scaler
+  );
+}
+
+
+template<typename F>
+void WideVector3<F>::operator+=(const WideVector3 &v)
+{
+  x += v.x;
+  y += v.y;
+  z += v.z;
+}
+
+
+template<typename F>
+void WideVector3<F>::operator-=(const WideVector3 &v)
+{
+  x -= v.x;
+  y -= v.y;
+  z -= v.z;
+}
+
+
+template<typename F>
+void WideVector3<F>::operator*=(const WideVector3 &v)
+{
+  x *= v.x;
+  y *= v.y;
+  z *= v.z;
+}
+
+
+template<typename F>
+void WideVector3<F>::operator*=(const F &scale)
+{
+  x *= scale;
+  y *= scale;
+  z *= scale;
+}
+
+
+template<typename F>
+void WideVector3<F>::operator/=(const WideVector3 &v)
+{
+  x /= v.x;
+  y /= v.y;
+  z /= v.z;
+}
+
+
+template<typename F>
+void WideVector3<F>::operator/=(const F &scaler)
+{
+  x /= scaler;
+  y /= scaler;
+  z /= scaler;
+}
+
+
+template<typename F>
+WideVector3<F> WideVector3<F>::operator-() const
+{
+  return WideVector3(-x, -y, -z);
+}
+
+
+template<typename F>
+WideVector2<F> WideVector2<F>::Load(const Vector2<real32> *src)
+{
+  real32 xs[F::Width];
+  real32 ys[F::Width];
+  for (uint32 i = 0; i < F::Width; ++i) {
+    xs[i] = src[i].x;
+    ys[i] = src[i].y;
+  }
+  return WideVector2(F::Load(xs), F::Load(ys));
+}
+
+
+template<typename F>
+void WideVector2<F>::Store(Vector2<real32> *dst) const
+{
+  real32 xs[F::Width];
+  real32 ys[F::Width];
+  x.Store(xs);
+  y.Store(ys);
+  for (uint32 i = 0; i < F::Width; ++i) {
+    dst[i].x = xs[i];
+    dst[i].y = ys[i];
+  }
+}
+
+
+template<typename F>
+Vector2<real32> WideVector2<F>::Get(uint32 lane) const
+{
+  return Vector2<real32>(x[lane], y[lane]);
+}
+
+
+template<typename F>
+WideVector2<F> WideVector2<F>::operator+(const WideVector2 &v) const
+{
+  return WideVector2(
+    x + v.x,
+    y + v.y
+  );
+}
+
+
+template<typename F>
+WideVector2<F> WideVector2<F>::operator-(const WideVector2 &v) const
+{
+  return WideVector2(
+    x - v.x,
+    y - v.y
+  );
+}
+
+
+template<typename F>
+WideVector2<F> WideVector2<F>::operator*(const WideVector2 &v) const
+{
+  return WideVector2(
+    x * v.x,
+    y * v.y
+  );
+}
+
+
+template<typename F>
+WideVector2<F> WideVector2<F>::operator*(const F &scale) const
+{
+  return WideVector2(
+    x * scale,
+    y * scale
+  );
+}
+
+
+template<typename F>
+WideVector2<F> WideVector2<F>::operator/(const WideVector2 &v) const
+{
+  return WideVector2(
+    x / v.x,
+    y / v.y
+  );
+}
+
+
+template<typename F>
+WideVector2<F> WideVector2<F>::operator/(const F &scaler) const
+{
+  return WideVector2(
+    x / scaler,
+    y / scaler
+  );
+}
+
+
+template<typename F>
+void WideVector2<F>::operator+=(const WideVector2 &v)
+{
+  x += v.x;
+  y += v.y;
+}
+
+
+template<typename F>
+void WideVector2<F>::operator-=(const WideVector2 &v)
+{
+  x -= v.x;
+  y -= v.y;
+}
+
+
+template<typename F>
+void WideVector2<F>::operator*=(const WideVector2 &v)
+{
+  x *= v.x;
+  y *= v.y;
+}
+
+
+template<typename F>
+void WideVector2<F>::operator*=(const F &scale)
+{
+  x *= scale;
+  y *= scale;
+}
+
+
+template<typename F>
+void WideVector2<F>::operator/=(const WideVector2 &v)
+{
+  x /= v.x;
+  y /= v.y;
+}
+
+
+template<typename F>
+void WideVector2<F>::operator/=(const F &scaler)
+{
+  x /= scaler;
+  y /= scaler;
+}
+
+
+template<typename F>
+WideVector2<F> WideVector2<F>::operator-() const
+{
+  return WideVector2(-x, -y);
+}
+
+
+#if defined(J_SIMD_X86)
+// Float4 loads and stores of whole vectors are plain 4x4 transposes.
+template<>
+inline WideVector4<Float4> WideVector4<Float4>::Load(const Vector4<real32> *src)
+{
+  const real32 *p = &src[0].x;
+  __m128 r0 = _mm_loadu_ps(p + 0);
+  __m128 r1 = _mm_loadu_ps(p + 4);
+  __m128 r2 = _mm_loadu_ps(p + 8);
+  __m128 r3 = _mm_loadu_ps(p + 12);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  return WideVector4<Float4>(Float4(r0), Float4(r1), Float4(r2), Float4(r3));
+}
+
+
+template<>
+inline void WideVector4<Float4>::Store(Vector4<real32> *dst) const
+{
+  real32 *p = &dst[0].x;
+  __m128 r0 = x.v, r1 = y.v, r2 = z.v, r3 = w.v;
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_ps(p + 0, r0);
+  _mm_storeu_ps(p + 4, r1);
+  _mm_storeu_ps(p + 8, r2);
+  _mm_storeu_ps(p + 12, r3);
+}
+
+
+// Four Vector3 are 12 contiguous floats, x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3,
+// which we shuffle apart into x, y and z registers.
+template<>
+inline WideVector3<Float4> WideVector3<Float4>::Load(const Vector3<real32> *src)
+{
+  const real32 *p = &src[0].x;
+  __m128 a = _mm_loadu_ps(p + 0);
+  __m128 b = _mm_loadu_ps(p + 4);
+  __m128 c = _mm_loadu_ps(p + 8);
+  // (x2, y2, x3, y3) and (y0, z0, y1, z1)
+  __m128 x2y2x3y3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+  __m128 y0z0y1z1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+  __m128 xs = _mm_shuffle_ps(a, x2y2x3y3, _MM_SHUFFLE(2, 0, 3, 0));
+  __m128 ys = _mm_shuffle_ps(y0z0y1z1, x2y2x3y3, _MM_SHUFFLE(3, 1, 2, 0));
+  __m128 zs = _mm_shuffle_ps(y0z0y1z1, c, _MM_SHUFFLE(3, 0, 3, 1));
+  return WideVector3<Float4>(Float4(xs), Float4(ys), Float4(zs));
+}
+#endif
+} // jkl
@@ -0,0 +1,81 @@
+//
+// Copyright(c) Jackal Engine. MIT License.
+//
+
+namespace math {
+namespace detail {
+template<typename P, typename V> inline
+auto WideInvLength(const V &vec) -> decltype(vec.Length())
+{
+  return InvSqrt<P>(Dot(vec, vec));
+}
+} // detail
+
+
+
+template<typename P, typename F> inline
+WideVector4<F> Normalize(const WideVector4<F> &vec)
+{
+  return vec * detail::WideInvLength<P>(vec);
+}
+
+
+template<typename P, typename F> inline
+WideVector3<F> Normalize(const WideVector3<F> &vec)
+{
+  return vec * detail::WideInvLength<P>(vec);
+}
+
+
+template<typename P, typename F> inline
+WideVector2<F> Normalize(const WideVector2<F> &vec)
+{
+  return vec * detail::WideInvLength<P>(vec);
+}
+
+
+template<typename F> inline
+WideVector3<F> Cross(const WideVector3<F> &u, const WideVector3<F> &v)
+{
+  return WideVector3<F>(
+    u.y * v.z - u.z * v.y,
+    u.z * v.x - u.x * v.z,
+    u.x * v.y - u.y * v.x
+  );
+}
+
+
+template<typename F> inline
+F Dot(const WideVector3<F> &u, const WideVector3<F> &v)
+{
+  return (u.x * v.x) + (u.y * v.y) + (u.z * v.z);
+}
+
+
+template<typename F> inline
+F Dot(const WideVector4<F> &u, const WideVector4<F> &v)
+{
+  return (u.x * v.x) + (u.y * v.y) + (u.z * v.z) + (u.w * v.w);
+}
+
+
+template<typename F> inline
+F Dot(const WideVector2<F> &u, const WideVector2<F> &v)
+{
+  return (u.x * v.x) + (u.y * v.y);
+}
+
+
+template<typename F> inline
+WideVector3<F> Lerp(const WideVector3<F> &v0, const WideVector3<F> &v1, const F &t)
+{
+  return v0 * (F(1.0f) - t) + v1 * t;
+}
+
+
+template<typename F> inline
+WideVector2<F> Lerp(const WideVector2<F> &v0, const WideVector2<F> &v1, const F &t)
+{
+  return v0 * (F(1.0f) - t) + v1 * t;
+}
+} // jkl
@@ -6,6 +6,8 @@
 #include "vector.hpp"
 #include "common.hpp"
 
+#include <type_traits>
+
 
 namespace math {
 
@@ -26,68 +28,66 @@ template<typename T>
 struct Matrix4x4 {
   // Get the Identity Matrix4x4 of this class. By default, this Matrix4x4 creates an
   // identity matrix, so this is simply for code clarification.
-  static Matrix4x4<T> Identity() {
+  static constexpr Matrix4x4<T> Identity() {
     return Matrix4x4<T>();
   }
 
   // Constructor for a 4x4 matrix.
-  Matrix4x4(
+  constexpr Matrix4x4(
     T a00 = static_cast<T>(1), T a01 = static_cast<T>(0), T a02 = static_cast<T>(0), T a03 = static_cast<T>(0),
     T a10 = static_cast<T>(0), T a11 = static_cast<T>(1), T a12 = static_cast<T>(0), T a13 = static_cast<T>(0),
     T a20 = static_cast<T>(0), T a21 = static_cast<T>(0), T a22 = static_cast<T>(1), T a23 = static_cast<T>(0),
     T a30 = static_cast<T>(0), T a31 = static_cast<T>(0), T a32 = static_cast<T>(0), T a33 = static_cast<T>(1));
 
   // Another constructor for a 4x4 matrix, using 4 component vectors as rows.
-  Matrix4x4(
+  constexpr Matrix4x4(
     const Vector4<T> &r1,
     const Vector4<T> &r2,
     const Vector4<T> &r3,
     const Vector4<T> &r4
   );
 
-  Matrix4x4(const Matrix3x3<T> &m);
-
-  // Copy constructor to copy values of m matrix to this matrix.
-  Matrix4x4(const Matrix4x4 &m);
+  constexpr Matrix4x4(const Matrix3x3<T> &m);
 
   // Matrix Addition with matrix m. Returns a newly constructed matrix,
   // after adding this with m.
-  Matrix4x4 operator+(const Matrix4x4 &m) const;
+  constexpr Matrix4x4 operator+(const Matrix4x4 &m) const;
 
   // Matrix Subtraction with matrix m. Returns a newly constructed matrix,
   // after subtracting this with m.
-  Matrix4x4 operator-(const Matrix4x4 &m) const;
+  constexpr Matrix4x4 operator-(const Matrix4x4 &m) const;
 
   // typical matrix multiplication. M1 x M2. Returns a newly constructed
-  // matrix after multiplying this with m.
-  Matrix4x4 operator*(const Matrix4x4 &m) const;
+  // matrix after multiplying this with m. Mat4 is specialized to use the
+  // fastest simd kernel the cpu supports, see internal/matrix_simd.inl.
+  constexpr Matrix4x4 operator*(const Matrix4x4 &m) const;
 
   // Typical matrix multiplication. Instead of constructing a newly created
   // matrix, contents of this matrix are updated and modified.
-  void operator*=(const Matrix4x4 &m);
+  constexpr void operator*=(const Matrix4x4 &m);
 
   // Multiply all values in the matrix with the scaler value.
-  Matrix4x4 operator*(const T scale) const;
+  constexpr Matrix4x4 operator*(const T scale) const;
 
   // Multiplay all values in the matrix with the scaler value. Does not
   // return a newly constructed matrix.
-  void operator*=(const T scale);
+  constexpr void operator*=(const T scale);
 
   // Matrix addition with m matrix. This does not return a newly constructed
   // matrix.
-  void operator+=(const Matrix4x4 &m);
+  constexpr void operator+=(const Matrix4x4 &m);
 
   // Matrix subtraction with m matrix. This does not return a newly constructed
   // matrix.
-  void operator-=(const Matrix4x4 &m);
+  constexpr void operator-=(const Matrix4x4 &m);
 
   // Retrieve the raw data array of the matrix. This is mainly used for the rendering engine.
-  T *Raw() { 
+  constexpr T *Raw() { 
     return data[0]; 
   }
 
   // Quick access to a value in the matrix.
-  T *operator[](const uint32 row) { 
+  constexpr T *operator[](const uint32 row) { 
     return data[row]; 
   }
 
@@ -95,35 +95,45 @@ struct Matrix4x4 {
   // Not very high quality, and can be sped up with a little parallel processing, but none the less,
   // any attempted speedup will only increase performance by a fraction of an inch, so no need to speed 
   // up these math calls.
-  T Determinant() const; 
+  constexpr T Determinant() const; 
 
   // Get the transpose of the matrix. This will create a new matrix.
-  Matrix4x4 Transpose() const;
+  constexpr Matrix4x4 Transpose() const;
+
+  // Obtain the inverse of this matrix. Returns the identity matrix if this matrix
+  // is singular. Mat4 is specialized with a simd kernel.
+  constexpr Matrix4x4 Inverse() const;
 
-  // Obtain the inverse of this matrix.
-  // TODO(): Implement inverse!
-  Matrix4x4 Inverse() const;
+  // Inverse of an affine transform, where the last column is (0, 0, 0, 1), like
+  // any combination of Translate, Rotate and Scale. Only the upper 3x3 needs
+  // inverting, so this is much cheaper than Inverse(). Returns the identity
+  // matrix if the upper 3x3 is singular.
+  constexpr Matrix4x4 InverseAffine() const;
+
+  // Inverse of a rigid transform, where the upper 3x3 is orthonormal (rotation
+  // only, no scale) and the last column is (0, 0, 0, 1). Views produced by
+  // LookAtLH and LookAtRH are such matrices. The rotation is simply transposed.
+  constexpr Matrix4x4 InverseOrthonormal() const;
 
-  // TODO(): Implement Adjoint!
   // Retrieves the adjugate matrix from this matrix. The adjugate is the transpose of this
   // matrix's cofactor matrix.
-  Matrix4x4 Adjugate() const;
+  constexpr Matrix4x4 Adjugate() const;
 
-  Matrix3x3<T> Minor(uint32 row, uint32 col) const;
+  constexpr Matrix3x3<T> Minor(uint32 row, uint32 col) const;
 
   // Checks if this matrix does not contain a finite number.
   // If a number is NaN, within this matrix, true will be returned. Otherwise, false will
   // return after traversing the entire matrix.
-  bool ContainsNaN() const;
+  constexpr bool ContainsNaN() const;
 
   // Check if matrix m is equal to this matrix, by values in their structures.
   // True if m matrix is the same as this matrix.
-  bool operator==(const Matrix4x4 &m) const;
+  constexpr bool operator==(const Matrix4x4 &m) const;
 
   // Opposite of operator==, checks if matrix m is not equal to this matrix.
   // Should define a tolerance, but for now, it's exact in some way. Float
   // values will likely have issues.
-  bool operator!=(const Matrix4x4 &m) const { 
+  constexpr bool operator!=(const Matrix4x4 &m) const { 
     return !(*this == m); 
   }
 
@@ -138,74 +148,74 @@ struct Matrix3x3 {
   // Creates an identity matrix by default. In reality, this Matrix3x3 class
   // already constructs an identity matrix by default, if no parameters are
   // specified.
-  static Matrix3x3<T> Identity() {
+  static constexpr Matrix3x3<T> Identity() {
     return Matrix3x3<T>();
   }
   
-  Matrix3x3(
+  constexpr Matrix3x3(
     T a00 = static_cast<T>(1), T a01 = static_cast<T>(0), T a02 = static_cast<T>(0),
     T a10 = static_cast<T>(0), T a11 = static_cast<T>(1), T a12 = static_cast<T>(0),
     T a20 = static_cast<T>(0), T a21 = static_cast<T>(0), T a22 = static_cast<T>(1));
 
-  Matrix3x3(
+  constexpr Matrix3x3(
     const Vector3<T> &r1,
     const Vector3<T> &r2,
     const Vector3<T> &r3);
 
   // Typical Matrix addition. Returns a newly constructed matrix after 
   // adding this matrix with m matrix.
-  Matrix3x3 operator+(const Matrix3x3 &m) const;
+  constexpr Matrix3x3 operator+(const Matrix3x3 &m) const;
 
   // Typical Matrix subtraction. Returns a newly constructed matrix after
   // subtracting this matrix with m matrix.
-  Matrix3x3 operator-(const Matrix3x3 &m) const;
+  constexpr Matrix3x3 operator-(const Matrix3x3 &m) const;
 
   // Matrix multiplication. Returns newly constructed matrix after 
   // multiplying this matrix with matrix m.
-  Matrix3x3 operator*(const Matrix3x3 &m) const;
+  constexpr Matrix3x3 operator*(const Matrix3x3 &m) const;
 
   // Matrix multiplation with scaler. It is commutative.
-  Matrix3x3 operator*(const T scaler) const;
+  constexpr Matrix3x3 operator*(const T scaler) const;
 
   // Matrix addition. Adds m matrix to this, without the need to 
   // create a new matrix.
-  void operator+=(const Matrix3x3 &m);
+  constexpr void operator+=(const Matrix3x3 &m);
 
   // Matrix subtraction. Subtracts m matrix from this, without the
   // need to create a new matrix. This matrix gets modified.
-  void operator-=(const Matrix3x3 &m);
+  constexpr void operator-=(const Matrix3x3 &m);
 
-  void operator*=(const Matrix3x3 &m);
+  constexpr void operator*=(const Matrix3x3 &m);
 
-  void operator*=(const T scaler);
+  constexpr void operator*=(const T scaler);
 
   // Checks if this matrix is equal (in terms of values) to matrix m.
-  bool operator==(const Matrix3x3 &m) const;
+  constexpr bool operator==(const Matrix3x3 &m) const;
 
   // Get the 2x2 minor matrix within any position in the matrix.
-  Matrix2x2<T> Minor(uint32 row, uint32 col) const;
+  constexpr Matrix2x2<T> Minor(uint32 row, uint32 col) const;
 
   // Get the inverse of this 3x3 matrix.
-  Matrix3x3 Inverse() const;
+  constexpr Matrix3x3 Inverse() const;
 
   // Get the adjugate of this 3x3 matrix.
-  Matrix3x3 Adjugate() const;
+  constexpr Matrix3x3 Adjugate() const;
 
   // Get the determinant of this matrix 3x3.
-  T Determinant() const;
+  constexpr T Determinant() const;
 
   // Opposite of operator== in that it checks if this matrix is not equal
   // to matrix m.
-  bool operator!=(const Matrix3x3 &m) {
+  constexpr bool operator!=(const Matrix3x3 &m) {
     return !(*this == m);
   }
 
-  T *Raw() {
+  constexpr T *Raw() {
     return data[0];
   }
 
   // Access the matrix without having to access data.
-  T *operator[](const uint32 row) {
+  constexpr T *operator[](const uint32 row) {
     return data[row];
   }
 
@@ -217,40 +227,40 @@ struct Matrix3x3 {
 // 2x2 Matrix. This handles relatively easy transformations, or conducting minors and whatnot.
 template<typename T>
 struct Matrix2x2 {
-  Matrix2x2(
+  constexpr Matrix2x2(
     T a00 = static_cast<T>(1), T a01 = static_cast<T>(0),
     T a10 = static_cast<T>(0), T a11 = static_cast<T>(1));
 
-  Matrix2x2(
+  constexpr Matrix2x2(
     const Vector2<T> &r1,
     const Vector2<T> &r2);
 
   // Typical Matrix addition. Returns a newly constructed matrix after 
   // adding this matrix with m matrix.
-  Matrix2x2 operator+(const Matrix2x2 &m) const;
+  constexpr Matrix2x2 operator+(const Matrix2x2 &m) const;
 
   // Typical Matrix subtraction. Returns a newly constructed matrix after
   // subtracting this matrix with m matrix.
-  Matrix2x2 operator-(const Matrix2x2 &m) const;
+  constexpr Matrix2x2 operator-(const Matrix2x2 &m) const;
 
   // Matrix multiplication. Returns newly constructed matrix after 
   // multiplying this matrix with matrix m.
-  Matrix2x2 operator*(const Matrix2x2 &m) const;
+  constexpr Matrix2x2 operator*(const Matrix2x2 &m) const;
 
   // Get the determinant of this 2x2 matrix.
-  T Determinant() const;
+  constexpr T Determinant() const;
 
   // Get the adjugate of this 2x2 matrix.
-  Matrix2x2 Adjugate() const;
+  constexpr Matrix2x2 Adjugate() const;
   
   // Get the inverse of this matrix.
-  Matrix2x2 Inverse() const;
+  constexpr Matrix2x2 Inverse() const;
 
-  T *operator[](const uint32 row) {
+  constexpr T *operator[](const uint32 row) {
     return data[row];
   }
 
-  T *Raw() {
+  constexpr T *Raw() {
     return data[0];
   }
     
@@ -262,5 +272,15 @@ struct Matrix2x2 {
 typedef Matrix4x4<real32> Mat4;
 typedef Matrix3x3<real32> Mat3;
 typedef Matrix2x2<real32> Mat2;
+
+
+static_assert(std::is_trivially_copyable<Mat4>::value && std::is_standard_layout<Mat4>::value,
+  "Mat4 must be trivially copyable and standard layout.");
+static_assert(std::is_trivially_copyable<Mat3>::value && std::is_standard_layout<Mat3>::value,
+  "Mat3 must be trivially copyable and standard layout.");
+static_assert(std::is_trivially_copyable<Mat2>::value && std::is_standard_layout<Mat2>::value,
+  "Mat2 must be trivially copyable and standard layout.");
+static_assert(sizeof(Mat4) == 16 * sizeof(real32), "Mat4 must be tightly packed.");
 } // jkl
-#include "internal/matrix.inl"
\ No newline at end of file
+#include "internal/matrix.inl"
+#include "internal/matrix_simd.inl"
\ No newline at end of file
@@ -0,0 +1,93 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+
+namespace math {
+
+
+// Callback run over the half open range of elements [begin, end).
+typedef void (*RangeCallback)(void *userData, size_t begin, size_t end);
+
+// Splits [0, count) into ranges of at least grain elements, and runs callback
+// over every one of them, possibly in parallel. Must return only once all
+// ranges are done.
+typedef void (*ParallelForExecutor)(void *context, size_t count, size_t grain,
+  RangeCallback callback, void *userData);
+
+
+namespace detail {
+struct ParallelExecutorState {
+  ParallelForExecutor executor;
+  void *context;
+};
+
+
+inline ParallelExecutorState &ParallelExecutorStorage()
+{
+  static ParallelExecutorState state = { nullptr, nullptr };
+  return state;
+}
+
+
+// Fallback executor, used until someone installs a proper one. Spawns a thread
+// per core for every call, so it only pays off for large batches.
+inline void ThreadExecutor(void *, size_t count, size_t grain,
+  RangeCallback callback, void *userData)
+{
+  size_t threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  size_t chunk = (count + threads - 1) / threads;
+  if (chunk < grain) chunk = grain;
+
+  std::vector<std::thread> workers;
+  for (size_t begin = chunk; begin < count; begin += chunk) {
+    size_t end = begin + chunk < count ? begin + chunk : count;
+    workers.push_back(std::thread(callback, userData, begin, end));
+  }
+  callback(userData, 0, chunk < count ? chunk : count);
+  for (size_t i = 0; i < workers.size(); ++i) {
+    workers[i].join();
+  }
+}
+} // detail
+
+
+// Route every ParallelFor in the math library through the given executor,
+// typically the engine's job system. Pass nullptr to go back to the fallback
+// thread executor. Not thread safe, call this at startup or shutdown.
+inline void SetParallelExecutor(ParallelForExecutor executor, void *context)
+{
+  detail::ParallelExecutorStorage().executor = executor;
+  detail::ParallelExecutorStorage().context = context;
+}
+
+
+// Run func(begin, end) over [0, count), split into ranges of at least grain
+// elements that may run in parallel. Small counts run inline on the caller.
+template<typename Func> inline
+void ParallelFor(size_t count, size_t grain, const Func &func)
+{
+  if (count <= grain) {
+    if (count > 0) func(static_cast<size_t>(0), count);
+    return;
+  }
+  RangeCallback trampoline = [] (void *userData, size_t begin, size_t end) {
+    (*static_cast<const Func *>(userData))(begin, end);
+  };
+  void *userData = const_cast<Func *>(&func);
+  detail::ParallelExecutorState &state = detail::ParallelExecutorStorage();
+  if (state.executor) {
+    state.executor(state.context, count, grain, trampoline, userData);
+  } else {
+    detail::ThreadExecutor(nullptr, count, grain, trampoline, userData);
+  }
+}
+} // jkl
@@ -0,0 +1,132 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+#include "simd.hpp"
+#include "wide.hpp"
+
+
+namespace math {
+
+
+// Precision policies, passed as the first template argument of the functions
+// that have a cheaper approximate form, e.g. Normalize<Fast>(v). Leaving it out
+// picks Exact, which gives the same results the library always has.
+//
+// Exact: correctly rounded square roots and true divisions.
+// Fast:  hardware reciprocal square root and reciprocal estimates, refined
+//        with one Newton-Raphson step, and multiplies instead of divides.
+//        Results are within about 2 ulp for real32 (a few ulp more after
+//        the multiplies downstream), good enough for gameplay and rendering,
+//        but not for tools that need reproducible results.
+//
+// For real64, and under constant evaluation, Fast takes the Exact path. The
+// Float4 and Float8 overloads work lane by lane.
+struct Exact { };
+struct Fast { };
+
+
+// 1 / sqrt(value).
+template<typename P = Exact, typename T>
+constexpr T InvSqrt(T value);
+
+// 1 / value.
+template<typename P = Exact, typename T>
+constexpr T Reciprocal(T value);
+
+
+namespace detail {
+template<typename P>
+struct PrecisionOps;
+
+
+template<>
+struct PrecisionOps<Exact> {
+  template<typename T>
+  static constexpr T InvSqrt(T value) {
+    return static_cast<T>(1) / static_cast<T>(Sqrt(value));
+  }
+
+  template<typename T>
+  static constexpr T Reciprocal(T value) {
+    return static_cast<T>(1) / value;
+  }
+
+  static Float4 InvSqrt(const Float4 &value) { return Float4(1.0f) / Sqrt(value); }
+  static Float8 InvSqrt(const Float8 &value) { return Float8(1.0f) / Sqrt(value); }
+  static Float4 Reciprocal(const Float4 &value) { return Float4(1.0f) / value; }
+  static Float8 Reciprocal(const Float8 &value) { return Float8(1.0f) / value; }
+};
+
+
+template<>
+struct PrecisionOps<Fast> {
+  template<typename T>
+  static constexpr T InvSqrt(T value) {
+    return PrecisionOps<Exact>::InvSqrt(value);
+  }
+
+  static constexpr real32 InvSqrt(real32 value) {
+#if defined(J_SIMD_X86)
+    if (!J_IS_CONSTANT_EVALUATED()) {
+      // rsqrtss is good to 12 bits, one Newton step brings that to ~23.
+      real32 y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+      return y * (1.5f - 0.5f * value * y * y);
+    }
+#endif
+    return PrecisionOps<Exact>::InvSqrt(value);
+  }
+
+  template<typename T>
+  static constexpr T Reciprocal(T value) {
+    return PrecisionOps<Exact>::Reciprocal(value);
+  }
+
+  static constexpr real32 Reciprocal(real32 value) {
+#if defined(J_SIMD_X86)
+    if (!J_IS_CONSTANT_EVALUATED()) {
+      real32 y = _mm_cvtss_f32(_mm_rcp_ss(_mm_set_ss(value)));
+      return y * (2.0f - value * y);
+    }
+#endif
+    return PrecisionOps<Exact>::Reciprocal(value);
+  }
+
+  static Float4 InvSqrt(const Float4 &value) { return WideInvSqrt(value); }
+  static Float8 InvSqrt(const Float8 &value) { return WideInvSqrt(value); }
+  static Float4 Reciprocal(const Float4 &value) { return WideReciprocal(value); }
+  static Float8 Reciprocal(const Float8 &value) { return WideReciprocal(value); }
+
+private:
+  // Estimate, then one Newton-Raphson step: y' = y * (1.5 - 0.5 * x * y^2).
+  template<typename F>
+  static F WideInvSqrt(const F &value) {
+    F y = RSqrt(value);
+    return y * (F(1.5f) - F(0.5f) * value * y * y);
+  }
+
+  // y' = y * (2 - x * y).
+  template<typename F>
+  static F WideReciprocal(const F &value) {
+    F y = Rcp(value);
+    return y * (F(2.0f) - value * y);
+  }
+};
+} // detail
+
+
+template<typename P, typename T>
+constexpr T InvSqrt(T value)
+{
+  return detail::PrecisionOps<P>::InvSqrt(value);
+}
+
+
+template<typename P, typename T>
+constexpr T Reciprocal(T value)
+{
+  return detail::PrecisionOps<P>::Reciprocal(value);
+}
+} // jkl
@@ -7,6 +7,9 @@
 #include "common.hpp"
 #include "matrix.hpp"
 #include "vector.hpp"
+#include "trig.hpp"
+
+#include <type_traits>
 
 
 namespace math {
@@ -32,12 +35,12 @@ struct Quaternion {
   // Returns the quaternion identity. By default,
   // the default constructor already returns it, but this
   // is for code clarification.
-  static Quaternion<T> Identity() {
+  static constexpr Quaternion<T> Identity() {
     return Quaternion<T>();
   }
   
   // Initial state of the quaternion.
-  Quaternion(
+  constexpr Quaternion(
     T w = static_cast<T>(1), 
     T x = static_cast<T>(0), 
     T y = static_cast<T>(0), 
@@ -45,84 +48,87 @@ struct Quaternion {
   ) : w(w), x(x), y(y), z(z) 
   { } 
 
-  Quaternion(const Quaternion &quat)
-    : w(quat.w), x(quat.x), y(quat.y), z(quat.z)
-  { }
-
   // Add this quaternion to another quaternion,
   // to make a new quaternion.
-  Quaternion operator+(const Quaternion &q) const;
+  constexpr Quaternion operator+(const Quaternion &q) const;
 
   // Subtact this quaternion from another quaternion,
   // to make a new quaternion.
-  Quaternion operator-(const Quaternion &q) const;
+  constexpr Quaternion operator-(const Quaternion &q) const;
 
   // Quaternion multiplication, using the Hamilton Product.
   // Note that quaternion multiplication is non-commutative
   // so order matters!
-  Quaternion operator*(const Quaternion &q) const;
+  constexpr Quaternion operator*(const Quaternion &q) const;
 
   // Scaler multiplication with quaternions. This will return
   // a fresh copy of a quaternion.
-  Quaternion operator*(const T scaler) const;
+  constexpr Quaternion operator*(const T scaler) const;
 
   // Division between quaternions. this will return a fresh
   // copy of the resulting quaternion.
-  Quaternion operator/(const Quaternion &q) const;
+  constexpr Quaternion operator/(const Quaternion &q) const;
 
   // Division of a scaler value to this quaternion.
   // Will return a fresh copy of the resulting 
   // quaternion.
-  Quaternion operator/(const T scaler) const;
+  constexpr Quaternion operator/(const T scaler) const;
 
   // Quaternion multiplication, using the Hamilton Product.
   // Note that quaternion multiplicatio is non-commutative,
   // so order matters!
   // Be aware that this operator will write to this quaternion object.
-  void operator*=(const Quaternion &q);
+  constexpr void operator*=(const Quaternion &q);
 
   // Multiply this quaternion by a scaler value.
-  void operator*=(const T scaler);
+  constexpr void operator*=(const T scaler);
 
   // Addition of quaternion q onto this quaternion. Does not
   // create a new quaternion, instead will modify this one.
-  void operator+=(const Quaternion &q);
+  constexpr void operator+=(const Quaternion &q);
 
   // Subtraction of quaternion q from this quaternion. Does not
   // create a new quaternion, instead will modify this one.
-  void operator-=(const Quaternion &q);
+  constexpr void operator-=(const Quaternion &q);
 
   // Division between two quaternion values.
   // modifies this quaternion.
-  void operator/=(const Quaternion &q);
+  constexpr void operator/=(const Quaternion &q);
 
   // Division between this quaternion, and the given scaler value.
   // Modifies this quaternion.
-  void operator/=(const T scaler);
+  constexpr void operator/=(const T scaler);
 
   // Get the conjugate of this quaternion object.
   // Represented as q*
-  Quaternion Conjugate() const;
+  constexpr Quaternion Conjugate() const;
 
   // Get the inverse of this quaternion object.
   // Returns an inverse copy of the quaternion.
   // Represented as q^-1
-  Quaternion Inverse() const;
+  constexpr Quaternion Inverse() const;
 
-  // Returns the vector representation of this quaternion object.
-  Vector3<T> ToEulerAngles() const;
+  // Returns the euler angles (pitch, yaw, roll), in radians, of this
+  // quaternion object. The inverse of ToQuaternion(), see quaternion_math.hpp.
+  // Expects a unit quaternion.
+  constexpr Vector3<T> ToEulerAngles() const;
 
-  // Returns the matrix representation of this quaternion object.
-  Matrix4x4<T> ToMatrix4x4() const;
+  // Returns the rotation matrix of this quaternion object, for row vectors
+  // like the rest of the library. Expects a unit quaternion.
+  constexpr Matrix4x4<T> ToMatrix4x4() const;
 
   
 
   // TODO(): More to be added soon.
 
   // Returns the magnitude/norm/length of the quaternion.
-  T Length() const {
-    return 
-      static_cast<T>(Sqrt((w * w) + (x * x) + (y * y) + (z * z)));
+  constexpr T Length() const {
+    return static_cast<T>(Sqrt(LengthSquared()));
+  }
+
+  // Returns the squared magnitude of the quaternion.
+  constexpr T LengthSquared() const {
+    return (w * w) + (x * x) + (y * y) + (z * z);
   }
 
   // Quaternion parameters set up like in 
@@ -130,11 +136,16 @@ struct Quaternion {
   union {
     struct { T w, x, y, z; };
     struct { T a, r, g, b; };
-    struct { T q, s, t, r; };
+    struct { T q, s, t, p; };
   };
 };
 
 typedef Quaternion<real32> Quat;
+
+
+static_assert(std::is_trivially_copyable<Quat>::value && std::is_standard_layout<Quat>::value,
+  "Quat must be trivially copyable and standard layout.");
+static_assert(sizeof(Quat) == 4 * sizeof(real32), "Quat must be tightly packed.");
 } // jkl
 
 #include "internal/quaternion.inl"
\ No newline at end of file
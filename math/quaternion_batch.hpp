@@ -0,0 +1,91 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+#include "quaternion.hpp"
+#include "wide_quaternion.hpp"
+#include "wide_vector.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace math {
+
+
+// Structure of arrays storage for many quaternions, e.g. the joint rotations
+// of every animated skeleton in a frame. Each component lives in its own
+// array, so the batch kernels below load FloatN::Width quaternions with four
+// plain loads.
+struct QuatArray {
+  QuatArray() { }
+
+  explicit QuatArray(size_t count) {
+    Resize(count);
+  }
+
+  void Resize(size_t count) {
+    w.resize(count, 1.0f);
+    x.resize(count, 0.0f);
+    y.resize(count, 0.0f);
+    z.resize(count, 0.0f);
+  }
+
+  size_t Size() const {
+    return w.size();
+  }
+
+  void Set(size_t i, const Quat &q) {
+    w[i] = q.w; x[i] = q.x; y[i] = q.y; z[i] = q.z;
+  }
+
+  Quat Get(size_t i) const {
+    return Quat(w[i], x[i], y[i], z[i]);
+  }
+
+  std::vector<real32> w, x, y, z;
+};
+
+
+// Batch kernels over QuatArrays. Every kernel works element by element,
+// out[i] = op(a[i], b[i]), over a.Size() elements, resizing out to match. b
+// must be at least as long as a. out may be the same array as a or b.
+//
+// With parallel set, large batches are split across cores with ParallelFor,
+// see parallel.hpp.
+
+// out[i] = Nlerp(a[i], b[i], t[i]).
+inline void NlerpBatch(const QuatArray &a, const QuatArray &b, const real32 *t,
+  QuatArray &out, bool parallel = false);
+
+// out[i] = Nlerp(a[i], b[i], t), blending two whole poses by one weight.
+inline void NlerpBatch(const QuatArray &a, const QuatArray &b, real32 t,
+  QuatArray &out, bool parallel = false);
+
+// out[i] = Slerp<P>(a[i], b[i], t[i]). SlerpBatch<Fast> uses the polynomial
+// approximation, see Slerp in quaternion_math.hpp.
+template<typename P = Exact>
+void SlerpBatch(const QuatArray &a, const QuatArray &b, const real32 *t,
+  QuatArray &out, bool parallel = false);
+
+template<typename P = Exact>
+void SlerpBatch(const QuatArray &a, const QuatArray &b, real32 t,
+  QuatArray &out, bool parallel = false);
+
+// out[i] = a[i] * b[i], e.g. local joint rotations onto their parents'.
+inline void MulBatch(const QuatArray &a, const QuatArray &b, QuatArray &out,
+  bool parallel = false);
+
+// palette[i] = the rotation matrix of rotations[i], with translations[i] in the
+// translation row, written straight into a matrix palette ready for upload.
+// translations may be null for pure rotations. palette must hold
+// rotations.Size() matrices.
+inline void ToMatrixBatch(const QuatArray &rotations, const Vec3 *translations,
+  Mat4 *palette, bool parallel = false);
+} // jkl
+
+#include "internal/quaternion_batch.inl"
@@ -8,6 +8,9 @@
 #include "quaternion.hpp"
 #include "vector.hpp"
 #include "matrix.hpp"
+#include "trig.hpp"
+#include "precision.hpp"
+#include "vector_math.hpp"
 
 
 namespace math {
@@ -15,32 +18,51 @@ namespace math {
 
 // Convert a quaternion into a 4 component vector
 // representation.
-template<typename T> inline
+template<typename T> constexpr
 Vector4<T> ToVector4(const Quaternion<T> &q);
 
 // Convert a quaternion into a 4 by 4 matrix
 // representation.
-template<typename T> inline
+template<typename T> constexpr
 Matrix4x4<T> ToMatrix4x4(const Quaternion<T> &q);
 
 
-template<typename T> inline
+// Convert euler angles, in radians, into a quaternion. x is the pitch, y the
+// yaw and z the roll, applied roll first, then pitch, then yaw.
+template<typename T> constexpr
 Quaternion<T> ToQuaternion(const Vector3<T> &eulerAngle);
 
 // Normalize the quaternion. Normally, we should
 // be sticking to unit quaternions, so this call
 // should be kept limited.
-template<typename T> inline
+template<typename P = Exact, typename T> constexpr
 Quaternion<T> Normalize(const Quaternion<T> &q);
 
+// Dot product of two quaternions, the cosine of half the angle between the
+// rotations they represent.
+template<typename T> constexpr
+T Dot(const Quaternion<T> &q0, const Quaternion<T> &q1);
+
+// Normalized linear interpolation, at time t, taking the shortest path. Not
+// constant speed, but close to Slerp for small angles and much cheaper.
+template<typename T> constexpr
+Quaternion<T> Nlerp(const Quaternion<T> &q0, const Quaternion<T> &q1, T t);
+
 // Spherical Linear Interpolation. Useful for 
-// animations and whatnot.
-template<typename T> inline
+// animations and whatnot. Takes the shortest path between q0 and q1, which
+// should be unit quaternions.
+//
+// Slerp<Fast> replaces the acos and sines with a polynomial correction of
+// the nlerp parameter, which keeps the angular error below 1e-3 radians
+// (about 0.05 degrees) for every t and angle.
+template<typename P = Exact, typename T> constexpr
 Quaternion<T> Slerp(const Quaternion<T> &q0, const Quaternion<T> &q1, T t);
 
 // Produce a rotation about the hypersphere using x, y, z coordinates
 // and an angle to tell about how much the quaternion will rotate.
 // Quaternion q param descibes the initial position of the quaternion.
-template<typename T> inline
+template<typename T> constexpr
 Quaternion<T> AngleAxis(T angle, const Vector3<T> &axis);
-} // jkl
\ No newline at end of file
+} // jkl
+
+#include "internal/quaternion_math.inl"
\ No newline at end of file
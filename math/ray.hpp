@@ -0,0 +1,135 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+#include "vector.hpp"
+#include "vector_math.hpp"
+#include "wide.hpp"
+#include "wide_vector.hpp"
+#include "wide_vector_math.hpp"
+#include "bounding/bound_box.hpp"
+
+#include <cstddef>
+#include <limits>
+
+
+namespace math {
+
+
+// Half line from origin along direction, the points origin + direction * t
+// for t >= 0. The reciprocal of the direction is kept alongside, since every
+// box test divides by it. Zero components of direction give infinite
+// reciprocals, which the slab test handles, except for rays that start
+// exactly on the plane of a box face they run parallel to.
+//
+// direction need not be unit length, distances are then in units of its
+// length.
+template<typename T>
+struct Ray {
+  // Ray from the origin along +z.
+  constexpr Ray()
+    : origin()
+    , direction(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1))
+    , invDirection(std::numeric_limits<T>::infinity(), std::numeric_limits<T>::infinity(),
+        static_cast<T>(1))
+  { }
+
+  Ray(const Vector3<T> &origin, const Vector3<T> &direction)
+    : origin(origin)
+    , direction(direction)
+    , invDirection(static_cast<T>(1) / direction.x, static_cast<T>(1) / direction.y,
+        static_cast<T>(1) / direction.z)
+  { }
+
+  // The point at distance t along the ray.
+  constexpr Vector3<T> At(T t) const {
+    return origin + direction * t;
+  }
+
+  Vector3<T> origin;
+  Vector3<T> direction;
+  Vector3<T> invDirection;
+};
+
+typedef Ray<real32> Ray3;
+
+
+// Slab test. True if the ray enters box at a distance in [0, maxDistance],
+// or starts inside it. distance is set to the entry distance on a hit, 0 for
+// rays starting inside.
+template<typename T> constexpr
+bool Intersect(const Ray<T> &ray, const BoundBox<T> &box, T &distance,
+  T maxDistance = std::numeric_limits<T>::max());
+
+// Moller-Trumbore. True if the ray hits the triangle (v0, v1, v2), from
+// either side, at a distance in (0, maxDistance]. On a hit, distance is set,
+// and u and v to the barycentric coordinates of the hit point, which is
+// v0 * (1 - u - v) + v1 * u + v2 * v.
+template<typename T> constexpr
+bool Intersect(const Ray<T> &ray, const Vector3<T> &v0, const Vector3<T> &v1,
+  const Vector3<T> &v2, T &distance, T &u, T &v,
+  T maxDistance = std::numeric_limits<T>::max());
+
+
+// F::Width rays in structure of arrays form, for testing a packet of rays,
+// e.g. neighbouring lightmap texels, against the same box or triangle.
+template<typename F>
+struct WideRay {
+  WideRay() = default;
+
+  WideRay(const WideVector3<F> &origin, const WideVector3<F> &direction)
+    : origin(origin)
+    , direction(direction)
+    , invDirection(F(1.0f) / direction.x, F(1.0f) / direction.y, F(1.0f) / direction.z)
+  { }
+
+  // The same ray in every lane.
+  explicit WideRay(const Ray3 &ray)
+    : origin(ray.origin), direction(ray.direction), invDirection(ray.invDirection)
+  { }
+
+  // Load Width consecutive rays.
+  static WideRay Load(const Ray3 *rays);
+
+  WideVector3<F> origin;
+  WideVector3<F> direction;
+  WideVector3<F> invDirection;
+};
+
+
+// Packet tests, lane by lane the same as the scalar tests above, returning a
+// mask of the lanes that hit. distance, u and v are only meaningful in those
+// lanes.
+
+// Many rays against one box.
+template<typename F>
+F Intersect(const WideRay<F> &rays, const AABB &box, F &distance,
+  const F &maxDistance = F(std::numeric_limits<real32>::max()));
+
+// One ray against F::Width boxes, boxes [i, i + Width) of an AABBArray.
+template<typename F>
+F Intersect(const WideRay<F> &ray, const AABBArray &boxes, size_t i, F &distance,
+  const F &maxDistance = F(std::numeric_limits<real32>::max()));
+
+// Many rays against one triangle.
+template<typename F>
+F Intersect(const WideRay<F> &rays, const Vec3 &v0, const Vec3 &v1, const Vec3 &v2,
+  F &distance, F &u, F &v, const F &maxDistance = F(std::numeric_limits<real32>::max()));
+
+// Rays against triangles lane by lane, e.g. one ray, broadcast with
+// WideRay(ray), against F::Width triangles.
+template<typename F>
+F Intersect(const WideRay<F> &rays, const WideVector3<F> &v0, const WideVector3<F> &v1,
+  const WideVector3<F> &v2, F &distance, F &u, F &v,
+  const F &maxDistance = F(std::numeric_limits<real32>::max()));
+
+// Write the index of every box in boxes the ray hits within maxDistance to
+// hits, which must have room for boxes.Size() entries, FloatN::Width boxes at
+// a time. Returns how many were written.
+inline size_t IntersectBatch(const Ray3 &ray, const AABBArray &boxes, uint32 *hits,
+  real32 maxDistance = std::numeric_limits<real32>::max());
+} // jkl
+
+#include "internal/ray.inl"
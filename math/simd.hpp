@@ -0,0 +1,146 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+
+// x86 SIMD is assumed whenever the compiler targets SSE2 or better, which is
+// every x64 compiler. Anything else (ARM, wasm, old x86) takes the scalar path.
+// Define J_NO_SIMD to force the scalar path everywhere.
+#if !defined(J_NO_SIMD) && (defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+  #define J_SIMD_X86 1
+  #include <immintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #endif
+#endif
+
+// Set when the whole project is compiled with AVX enabled (-mavx, /arch:AVX),
+// so AVX types can be used directly instead of through runtime dispatch.
+#if defined(J_SIMD_X86) && defined(__AVX__)
+  #define J_SIMD_AVX 1
+#endif
+
+// MSVC lets us use any intrinsic in any function, GCC and Clang need to be
+// told per function which instruction sets it may emit, so the AVX kernels
+// can live in the same headers as everything else without -mavx.
+#if defined(J_SIMD_X86) && !defined(_MSC_VER)
+  #define J_TARGET_AVX __attribute__((target("avx")))
+#else
+  #define J_TARGET_AVX
+#endif
+
+
+namespace math {
+namespace simd {
+
+
+// Instruction sets our kernels are written for, from slowest to fastest.
+enum class Isa {
+  Scalar = 0,
+  SSE2   = 1,
+  AVX    = 2
+};
+
+
+// Features the running cpu (and operating system) supports.
+struct CpuFeatures {
+  bool sse2;
+  bool avx;
+};
+
+
+// Query the cpu for supported instruction sets. This is somewhat expensive, so
+// use GetCpuFeatures() instead, which caches the result.
+inline CpuFeatures DetectCpuFeatures()
+{
+  CpuFeatures features = { false, false };
+#if defined(J_SIMD_X86)
+  features.sse2 = true;
+ #if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx = (info[2] & (1 << 28)) != 0;
+  // The OS must also be saving the ymm registers on context switch.
+  if (osxsave && avx) {
+    features.avx = (_xgetbv(0) & 0x6) == 0x6;
+  }
+ #else
+  __builtin_cpu_init();
+  features.avx = __builtin_cpu_supports("avx") != 0;
+ #endif
+#endif
+  return features;
+}
+
+
+inline const CpuFeatures &GetCpuFeatures()
+{
+  static const CpuFeatures features = DetectCpuFeatures();
+  return features;
+}
+
+
+// Check if the running machine can execute the given instruction set.
+inline bool IsSupported(Isa isa)
+{
+  switch (isa) {
+    case Isa::AVX:  return GetCpuFeatures().avx;
+    case Isa::SSE2: return GetCpuFeatures().sse2;
+    default:        return true;
+  }
+}
+
+
+// Fastest instruction set the running machine supports.
+inline Isa BestIsa()
+{
+  if (IsSupported(Isa::AVX)) return Isa::AVX;
+  if (IsSupported(Isa::SSE2)) return Isa::SSE2;
+  return Isa::Scalar;
+}
+
+
+inline const char *IsaName(Isa isa)
+{
+  switch (isa) {
+    case Isa::AVX:  return "AVX";
+    case Isa::SSE2: return "SSE2";
+    default:        return "Scalar";
+  }
+}
+
+
+namespace detail {
+inline Isa &ActiveIsaStorage()
+{
+  static Isa isa = BestIsa();
+  return isa;
+}
+} // detail
+
+
+// Instruction set the math kernels currently dispatch to. Chosen on first use
+// from the cpu features, so the fastest supported path is taken by default.
+inline Isa ActiveIsa()
+{
+  return detail::ActiveIsaStorage();
+}
+
+
+// Force the math kernels onto a specific instruction set, mainly for
+// benchmarking and debugging. Returns false, and leaves the current selection
+// alone, if the cpu does not support it. Not thread safe, call this at startup.
+inline bool SetActiveIsa(Isa isa)
+{
+  if (!IsSupported(isa)) {
+    return false;
+  }
+  detail::ActiveIsaStorage() = isa;
+  return true;
+}
+} // simd
+} // jkl
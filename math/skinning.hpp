@@ -0,0 +1,55 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+#include "vector.hpp"
+#include "dual_quaternion.hpp"
+#include "precision.hpp"
+#include "span.hpp"
+
+
+namespace math {
+
+
+// The joints that move one skinned vertex, and how much each one pulls on it.
+// Unused slots should have a weight of zero, their joint index is still read,
+// so it must be valid. Weights should add up to one.
+struct SkinInfluence {
+  uint16 joints[4];
+  real32 weights[4];
+};
+
+
+// CPU skinning with dual quaternion linear blending (DLB). For every vertex,
+// the palette entries of its joints are blended by weight, normalized, and
+// the result applied to the vertex. palette holds one unit dual quaternion
+// per joint, the joint's skinning transform (inverse bind pose, then the
+// current pose), at half the size of a Mat4 palette.
+//
+// Every element of positions, normals and influences is for the same vertex,
+// and the outputs must be at least as long as positions. Outputs may be the
+// same spans as their inputs, for skinning in place. Normals only get the
+// blended rotation, then stay unit length.
+//
+// The kernel blends FloatN::Width vertices at a time, gathering their joints
+// into structure of arrays form, so any stride works. With parallel set, large
+// meshes are split across cores with ParallelFor, see parallel.hpp.
+// SkinDualQuaternions<Fast> normalizes the blend with the Fast InvSqrt, see
+// precision.hpp.
+template<typename P = Exact>
+void SkinDualQuaternions(const DualQuat *palette,
+  StridedSpan<const SkinInfluence> influences,
+  StridedSpan<const Vec3> positions, StridedSpan<Vec3> outPositions,
+  bool parallel = false);
+
+template<typename P = Exact>
+void SkinDualQuaternions(const DualQuat *palette,
+  StridedSpan<const SkinInfluence> influences,
+  StridedSpan<const Vec3> positions, StridedSpan<Vec3> outPositions,
+  StridedSpan<const Vec3> normals, StridedSpan<Vec3> outNormals,
+  bool parallel = false);
+} // jkl
+
+#include "internal/skinning.inl"
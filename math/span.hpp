@@ -0,0 +1,67 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+
+namespace math {
+
+
+// A view of count elements of type T, spaced stride bytes apart. Handy for
+// walking one attribute of an interleaved vertex buffer, such as the position
+// of every vertex, without copying it out first:
+//
+//   StridedSpan<const Vec3> positions(&vertices[0].position, count, sizeof(Vertex));
+//
+// The span does not own its memory.
+template<typename T>
+struct StridedSpan {
+  StridedSpan()
+    : data(nullptr), count(0), stride(sizeof(T))
+    { }
+
+  // Tightly packed array of count elements.
+  StridedSpan(T *data, size_t count)
+    : data(data), count(count), stride(sizeof(T))
+    { }
+
+  StridedSpan(T *data, size_t count, size_t stride)
+    : data(data), count(count), stride(stride)
+    { }
+
+  // Allow a span of T to be passed where a span of const T is expected.
+  template<typename U>
+  StridedSpan(const StridedSpan<U> &span)
+    : data(span.data), count(span.count), stride(span.stride)
+    { }
+
+  T &operator[](size_t i) const {
+    return *Ptr(i);
+  }
+
+  // Address of element i. i may be one past the end.
+  T *Ptr(size_t i) const {
+    typedef typename std::conditional<std::is_const<T>::value, const char, char>::type Byte;
+    return reinterpret_cast<T *>(reinterpret_cast<Byte *>(data) + i * stride);
+  }
+
+  // Sub range of subCount elements, starting at element first.
+  StridedSpan Sub(size_t first, size_t subCount) const {
+    return StridedSpan(Ptr(first), subCount, stride);
+  }
+
+  size_t Size() const {
+    return count;
+  }
+
+  T *data;
+  size_t count;
+  // Distance between two consecutive elements, in bytes.
+  size_t stride;
+};
+} // jkl
@@ -0,0 +1,40 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+#include "span.hpp"
+
+
+namespace math {
+
+
+// Batched transforms of 3-component vectors by a 4x4 matrix, using row vectors
+// like the rest of the library (v' = v * m). Every element of in is transformed
+// into the same element of out, which must be at least as long as in. in and
+// out may be the same span, for transforming in place.
+//
+// The inner loops gather FloatN::Width vectors at a time into structure of
+// arrays form, so any stride works. With parallel set, large batches are split
+// across cores with ParallelFor, see parallel.hpp.
+
+// Transform points, including the translation of m. m is treated as affine, no
+// perspective divide is done.
+inline void TransformPoints(const Mat4 &m, StridedSpan<const Vec3> in,
+  StridedSpan<Vec3> out, bool parallel = false);
+
+// Transform directions, ignoring the translation of m.
+inline void TransformDirections(const Mat4 &m, StridedSpan<const Vec3> in,
+  StridedSpan<Vec3> out, bool parallel = false);
+
+// Transform normals by the inverse transpose of the upper 3x3 of m, so they
+// stay perpendicular to their surface under non uniform scale, then normalize
+// them.
+inline void TransformNormals(const Mat4 &m, StridedSpan<const Vec3> in,
+  StridedSpan<Vec3> out, bool parallel = false);
+} // jkl
+
+#include "internal/transform.inl"
@@ -0,0 +1,77 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+#include "wide.hpp"
+
+#include <cstddef>
+
+
+namespace math {
+
+
+// Single precision trig. The Sin, Cos and Tan wrappers in common.hpp go through
+// double precision libm, which is more accuracy than any float caller can use
+// and several times slower. These kernels do the range reduction and the
+// polynomials in float, with the same code for one value, a Float4/Float8, and
+// whole arrays.
+//
+// Error bounds are measured against the double precision result, over the
+// valid range given for each function, in units in the last place of the float
+// result (ulp). See BenchTrig in tests/math_bench, which reports them next to
+// libm.
+//
+// The real64 overloads simply forward to libm, so templated code can call
+// SinCos and friends for any T.
+
+// Largest angle, in radians, the sin/cos/tan range reduction handles in float.
+// Angles outside of [-TrigMaxAngle, TrigMaxAngle], inf and NaN fall back to
+// libm, so the result stays correct, just slower.
+constexpr real32 TrigMaxAngle = 8192.0f;
+
+// Sine and cosine of angle, computed together for about the price of one.
+// Max error 2 ulp for |angle| <= pi, 3 ulp for |angle| <= 64. Further out the
+// absolute error stays below 1e-7 up to TrigMaxAngle, but near the roots the
+// results are tiny, so the ulp error grows with the angle.
+constexpr void SinCos(real32 angle, real32 &sine, real32 &cosine);
+constexpr void SinCos(real64 angle, real64 &sine, real64 &cosine);
+
+constexpr real32 Sin(real32 angle);
+constexpr real32 Cos(real32 angle);
+
+// Max error 3 ulp for |angle| <= pi. Larger angles lose relative precision
+// close to the poles, same as SinCos close to its roots.
+constexpr real32 Tan(real32 angle);
+
+// Angle of the point (x, y) from the x axis, in [-pi, pi]. Max error 4 ulp.
+// The result takes the sign of y, -0 included, so Atan2(-0, -1) is -pi as in
+// libm. Atan2(0, 0) returns 0, as does Atan2(0, -0). NaN if either is NaN.
+// Under constant evaluation -0 counts as 0.
+constexpr real32 Atan2(real32 y, real32 x);
+inline real64 Atan2(real64 y, real64 x);
+
+// Inverse cosine, in [0, pi]. Max error 2 ulp. NaN outside of [-1, 1].
+constexpr real32 Acos(real32 value);
+inline real64 Acos(real64 value);
+
+// Wide versions, lane by lane identical to the scalar kernels above.
+inline void SinCos(const Float4 &angle, Float4 &sine, Float4 &cosine);
+inline void SinCos(const Float8 &angle, Float8 &sine, Float8 &cosine);
+inline Float4 Tan(const Float4 &angle);
+inline Float8 Tan(const Float8 &angle);
+inline Float4 Atan2(const Float4 &y, const Float4 &x);
+inline Float8 Atan2(const Float8 &y, const Float8 &x);
+inline Float4 Acos(const Float4 &value);
+inline Float8 Acos(const Float8 &value);
+
+// Batched versions over arrays of count floats, FloatN::Width lanes at a time.
+// Outputs may alias their inputs.
+inline void SinCos(const real32 *angles, real32 *sines, real32 *cosines, size_t count);
+inline void Tan(const real32 *angles, real32 *out, size_t count);
+inline void Atan2(const real32 *ys, const real32 *xs, real32 *out, size_t count);
+inline void Acos(const real32 *values, real32 *out, size_t count);
+} // jkl
+
+#include "internal/trig.inl"
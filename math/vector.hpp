@@ -5,6 +5,8 @@
 
 #include "common.hpp"
 
+#include <type_traits>
+
 
 namespace math {
 
@@ -21,7 +23,7 @@ template<typename T> struct Vector2;
 template<typename T>
 struct Vector4 {
   // Constructors.
-  Vector4( 
+  constexpr Vector4( 
     T x = static_cast<T>(0), 
     T y = static_cast<T>(0), 
     T z = static_cast<T>(0), 
@@ -29,13 +31,13 @@ struct Vector4 {
   ) : x(x), y(y), z(z), w(w) 
     { }
 
-  Vector4(
+  constexpr Vector4(
     const Vector3<T> &v, 
     T w = static_cast<T>(1)
   ) : x(v.x), y(v.y), z(v.z), w(w)
     { }
 
-  Vector4(
+  constexpr Vector4(
     const Vector2<T> &v, 
     T z = static_cast<T>(0), 
     T w = static_cast<T>(1)
@@ -44,103 +46,109 @@ struct Vector4 {
 
   // Adds this vector to v, and returns a new
   // 4 component vector.
-  Vector4 operator+(const Vector4 &v) const;
+  constexpr Vector4 operator+(const Vector4 &v) const;
 
   // Subtracts this vector to v, and returns a new
   // 4 component vector.
-  Vector4 operator-(const Vector4 &v) const;
+  constexpr Vector4 operator-(const Vector4 &v) const;
   
   // Multiplies this vector to v, and returns a new
   // 4 component vector.
-  Vector4 operator*(const Vector4 &v) const;
+  constexpr Vector4 operator*(const Vector4 &v) const;
 
   // Multiplies this vector to a scaler value, and 
   // returns a new 4 component vector.
-  Vector4 operator*(const T scale) const;
+  constexpr Vector4 operator*(const T scale) const;
 
   // Performs division of this vector with vector v,
   // and returns a resulting 4 component vector.
-  Vector4 operator/(const Vector4 &v) const;
+  constexpr Vector4 operator/(const Vector4 &v) const;
 
   // Vector division. Divides this vector by the scaler
   // value, and returns a new, fresh copy of a 4-component 
   // vector.
-  Vector4 operator/(const T scaler) const;
+  constexpr Vector4 operator/(const T scaler) const;
 
   // Add values of v into this vector. This will not
   // create a new vector object, it will instead modify
   // this vector.
-  void operator+=(const Vector4 &v);
+  constexpr void operator+=(const Vector4 &v);
 
   // Subtract values of v into this vector. This will not
   // create a new vector object, it will instead modify
   // this vector.
-  void operator-=(const Vector4 &v);
+  constexpr void operator-=(const Vector4 &v);
 
   // Multiply values of v into this vector. This will not
   // create a new vector object, it will instead modify
   // this vector.
-  void operator*=(const Vector4 &v);
+  constexpr void operator*=(const Vector4 &v);
 
   // Multiply a scaler value into this vector. Thise will 
   // not create a new vector object, it will instead modify
   // this vector.
-  void operator*=(const T scale);
+  constexpr void operator*=(const T scale);
 
   // Divide values of v into this vector. This will not 
   // create a new vector object, it will instead modify 
   // this vector.
-  void operator/=(const Vector4 &v);
+  constexpr void operator/=(const Vector4 &v);
 
   // Divides this vector's 4 components with the provided
   // scaler value. Modifies this vector object.
-  void operator/=(const T scaler);
+  constexpr void operator/=(const T scaler);
 
   // Take the invert of this vector, and return it as
   // a new 4 component vector.
-  Vector4 operator-() const;
+  constexpr Vector4 operator-() const;
 
-  Vector4 operator!() const {
+  constexpr Vector4 operator!() const {
     return -(*this);
   }
 
-  // Comparison by length.
-  bool operator<(const Vector4 &v) const {
-    return Length() < v.Length();
+  // Comparison by length. Squared lengths order the same way, without the
+  // square roots.
+  constexpr bool operator<(const Vector4 &v) const {
+    return LengthSquared() < v.LengthSquared();
   }
 
-  bool operator>(const Vector4 &v) const {
-    return Length() > v.Length();
+  constexpr bool operator>(const Vector4 &v) const {
+    return LengthSquared() > v.LengthSquared();
   }
 
-  bool operator<=(const Vector4 &v) const {
-    return Length() <= v.Length();
+  constexpr bool operator<=(const Vector4 &v) const {
+    return LengthSquared() <= v.LengthSquared();
   }
 
-  bool operator>=(const Vector4 &v) const {
-    return Length() >= v.Length();
+  constexpr bool operator>=(const Vector4 &v) const {
+    return LengthSquared() >= v.LengthSquared();
   }
 
   // Comparison by actual values in the vector.
-  bool operator!=(const Vector4 &v) const {
+  constexpr bool operator!=(const Vector4 &v) const {
     return (x != v.x || y != v.y || z != v.z || w != v.w);  
   }
 
-  bool operator==(const Vector4 &v) const {
+  constexpr bool operator==(const Vector4 &v) const {
     return (x == v.x && y == v.y && z == v.z && w == v.w);
   }
 
 
   // Returns the length of this vector.
-  T Length() const {
-    return 
-      static_cast<T>(Sqrt((x * x) + (y * y) + (z * z) + (w * w))); 
+  constexpr T Length() const {
+    return static_cast<T>(Sqrt(LengthSquared()));
+  }
+
+  // Returns the squared length of this vector. Cheaper than Length(), use it
+  // for comparing lengths.
+  constexpr T LengthSquared() const {
+    return (x * x) + (y * y) + (z * z) + (w * w);
   }
 
   union {
     struct { T x, y, z, w; };
     struct { T r, g, b, a; };
-    struct { T s, t, r, q; };
+    struct { T s, t, p, q; };
   };
 };
 
@@ -152,7 +160,7 @@ struct Vector4 {
 template<typename T>
 struct Vector3 {
 
-  Vector3(
+  constexpr Vector3(
     T x = static_cast<T>(0),
     T y = static_cast<T>(0),
     T z = static_cast<T>(0)
@@ -160,117 +168,117 @@ struct Vector3 {
   { }
 
   // Performs perspective divide.
-  Vector3(const Vector4<T> &v)
+  constexpr Vector3(const Vector4<T> &v)
     : x(v.x / v.w), y(v.y / v.w), z(v.z / v.w)
     { }
 
-  Vector3(
+  constexpr Vector3(
     const Vector2<T> &v, 
     T z = static_cast<T>(0)
   ) : x(v.x), y(v.y), z(z)
     { }
 
-  Vector3(
-    const Vector3 &v
-  ) : x(v.x), y(v.y), z(v.z)
-  { }
-
   // Adds this vector to v, and returns a new
   // 3 component vector.
-  Vector3 operator+(const Vector3 &v) const;
+  constexpr Vector3 operator+(const Vector3 &v) const;
 
   // Subtracts this vector to v, and returns a new
   // 3 component vector.
-  Vector3 operator-(const Vector3 &v) const;
+  constexpr Vector3 operator-(const Vector3 &v) const;
   
   // Multiplies this vector to v, and returns a new
   // 3 component vector.
-  Vector3 operator*(const Vector3 &v) const;
+  constexpr Vector3 operator*(const Vector3 &v) const;
 
   // Multiplies this vector to a scaler value, and 
   // returns a new 3 component vector.
-  Vector3 operator*(const T scale) const;
+  constexpr Vector3 operator*(const T scale) const;
 
   // Performs division of this vector with vector v,
   // and returns a resulting 3 component vector.
-  Vector3 operator/(const Vector3 &v) const;
+  constexpr Vector3 operator/(const Vector3 &v) const;
 
   // Vector division. Divides this vector by the scaler
   // value, and returns a new, fresh copy of a 3-component 
   // vector.
-  Vector3 operator/(const T scaler) const;
+  constexpr Vector3 operator/(const T scaler) const;
 
   // Add a 3-component vector v into this vector.
   // This will not create a new vector, it will instead
   // modify this vector.
-  void operator+=(const Vector3 &v);
+  constexpr void operator+=(const Vector3 &v);
 
   // Subtract a 3-component vector v into this vector.
   // This will not create new vector, it will instead
   // modify this vector.
-  void operator-=(const Vector3 &v);
+  constexpr void operator-=(const Vector3 &v);
 
   // Multiply a 3-component vector v into this vector.
   // This will not create a new vector, it will instead
   // modify this vector.
-  void operator*=(const Vector3 &v);
+  constexpr void operator*=(const Vector3 &v);
 
   // Multiply a scaler value into this vector.
   // This will not create a new vector, it will instead
   // modify this vector.
-  void operator*=(const T scale);
+  constexpr void operator*=(const T scale);
 
   // Divide a 3-component vector v into this vector.
   // This will not create a new vector, it will instead
   // modify this vector.
-  void operator/=(const Vector3 &v);
+  constexpr void operator/=(const Vector3 &v);
 
   // Divides this vector's 3 components with the provided
   // scaler value. Modifies this vector object.
-  void operator/=(const T scaler);
+  constexpr void operator/=(const T scaler);
 
   // Take the invert of this vector, and return it as
   // a new 3 component vector.
-  Vector3 operator-() const;
+  constexpr Vector3 operator-() const;
   
-  Vector3 operator!() {
+  constexpr Vector3 operator!() {
     return -(*this);
   }
 
   // comparisons by length.
-  bool operator<(const Vector3 &v) const {
-    return Length() < v.Length();
+  constexpr bool operator<(const Vector3 &v) const {
+    return LengthSquared() < v.LengthSquared();
   }
 
-  bool operator<=(const Vector3 &v) const {
-    return Length() <= v.Length();
+  constexpr bool operator<=(const Vector3 &v) const {
+    return LengthSquared() <= v.LengthSquared();
   }
 
-  bool operator>(const Vector3 &v) const {
-    return Length() > v.Length();
+  constexpr bool operator>(const Vector3 &v) const {
+    return LengthSquared() > v.LengthSquared();
   }
 
-  bool operator>=(const Vector3 &v) const {
-    return Length() >= v.Length();
+  constexpr bool operator>=(const Vector3 &v) const {
+    return LengthSquared() >= v.LengthSquared();
   }
 
   // comparison by actual components.
-  bool operator!=(const Vector3 &v) const {
+  constexpr bool operator!=(const Vector3 &v) const {
     return (x != v.x || y != v.y || z != v.z);
   }
 
-  bool operator==(const Vector3 &v) const {
+  constexpr bool operator==(const Vector3 &v) const {
     return (x == v.x && y == v.y && z == v.z);
   }
 
-  T Length() const {
-    return 
-      static_cast<T>(Sqrt((x * x) + (y * y) + (z * z)));
+  constexpr T Length() const {
+    return static_cast<T>(Sqrt(LengthSquared()));
+  }
+
+  // Returns the squared length of this vector. Cheaper than Length(), use it
+  // for comparing lengths.
+  constexpr T LengthSquared() const {
+    return (x * x) + (y * y) + (z * z);
   }
   union {
     struct { T x, y, z; };
     struct { T r, g, b; };
-    struct { T s, t, r; };
+    struct { T s, t, p; };
   };
 };
 
@@ -278,7 +286,7 @@ struct Vector3 {
 template<typename T>
 struct Vector2 {
 
-  Vector2(
+  constexpr Vector2(
     T x = static_cast<T>(0),
     T y = static_cast<T>(0)
   ) : x(x), y(y)
@@ -286,95 +294,100 @@ struct Vector2 {
 
   // Adds this vector to v, and returns a new
   // 2 component vector.
-  Vector2 operator+(const Vector2 &v) const;
+  constexpr Vector2 operator+(const Vector2 &v) const;
 
   // Subtracts this vector to v, and returns a new
   // 2 component vector.
-  Vector2 operator-(const Vector2 &v) const;
+  constexpr Vector2 operator-(const Vector2 &v) const;
 
   // Multiplies this vector to v, and returns a new
   // 2 component vector.
-  Vector2 operator*(const Vector2 &v) const;
+  constexpr Vector2 operator*(const Vector2 &v) const;
 
   // Multiplies this vector to a scaler value, and 
   // returns a new 2 component vector.
-  Vector2 operator*(const T scale) const;
+  constexpr Vector2 operator*(const T scale) const;
 
   // Performs division of this vector with vector v,
   // and returns a resulting 2 component vector.
-  Vector2 operator/(const Vector2 &v) const;
+  constexpr Vector2 operator/(const Vector2 &v) const;
 
   // Vector division. Divides this vector by the scaler
   // value, and returns a new, fresh copy of a 2-component 
   // vector.
-  Vector2 operator/(const T scaler) const;
+  constexpr Vector2 operator/(const T scaler) const;
 
   // Add a 2-component vector v into this vector.
   // It will not create a new vector, it will modify
   // this vector instead.
-  void operator+=(const Vector2 &v);
+  constexpr void operator+=(const Vector2 &v);
 
   // Subtract a 2-component vector v into this vector.
   // It will not create a new vector, it will modify 
   // this vector instead.
-  void operator-=(const Vector2 &v);
+  constexpr void operator-=(const Vector2 &v);
 
   // Multiply a 2-component vector v into this vector.
   // It will not create a new vector, it will modify
   // this vector instead.
-  void operator*=(const Vector2 &v);
+  constexpr void operator*=(const Vector2 &v);
 
   // Multiply a scaler value into this vector.
   // It will not create a new vector, it will modify 
   // this vector instead.
-  void operator*=(const T scale);
+  constexpr void operator*=(const T scale);
   
   // Divide a 2-component vector v into this vector.
   // It will not create a new vector, it will modify
   // this vector instead.
-  void operator/=(const Vector2 &v);
+  constexpr void operator/=(const Vector2 &v);
 
   // Divides this vector's 2 components with the provided
   // scaler value. Modifies this vector object.
-  void operator/=(const T scaler);
+  constexpr void operator/=(const T scaler);
 
   // Take the invert of this vector, and return it as
   // a new 2 component vector.
-  Vector2 operator-() const;
+  constexpr Vector2 operator-() const;
 
-  Vector2 operator!() const {
+  constexpr Vector2 operator!() const {
     return -(*this);
   }
 
   // comparisons by length.
-  bool operator<(const Vector2 &v) const {
-    return Length() < v.Length();
+  constexpr bool operator<(const Vector2 &v) const {
+    return LengthSquared() < v.LengthSquared();
   }
 
-  bool operator<=(const Vector2 &v) const {
-    return Length() <= v.Length();
+  constexpr bool operator<=(const Vector2 &v) const {
+    return LengthSquared() <= v.LengthSquared();
   }
 
-  bool operator>(const Vector2 &v) const {
-    return Length() > v.Length();
+  constexpr bool operator>(const Vector2 &v) const {
+    return LengthSquared() > v.LengthSquared();
   }
 
-  bool operator>=(const Vector2 &v) const {
-    return Length() >= v.Length();
+  constexpr bool operator>=(const Vector2 &v) const {
+    return LengthSquared() >= v.LengthSquared();
   }
 
   // comparisons by actual component values.
-  bool operator!=(const Vector2 &v) const { 
+  constexpr bool operator!=(const Vector2 &v) const { 
     return (x != v.x || y != v.y);
   }
 
-  bool operator==(const Vector2 &v) const {
+  constexpr bool operator==(const Vector2 &v) const {
     return (x == v.x && y == v.y);
   }
 
-  T Length() const {
-    return 
-      static_cast<T>(Sqrt((x * x) + (y * y)));
+  constexpr T Length() const {
+    return static_cast<T>(Sqrt(LengthSquared()));
+  }
+
+  // Returns the squared length of this vector. Cheaper than Length(), use it
+  // for comparing lengths.
+  constexpr T LengthSquared() const {
+    return (x * x) + (y * y);
   }
 
   union {
@@ -388,6 +401,19 @@ struct Vector2 {
 typedef Vector3<real32> Vec3;
 typedef Vector2<real32> Vec2;
 typedef Vector4<real32> Vec4;
+
+
+// Vectors are copied around in bulk and handed straight to the gpu, so they
+// must stay plain old data: no user defined copies, no padding.
+static_assert(std::is_trivially_copyable<Vec4>::value && std::is_standard_layout<Vec4>::value,
+  "Vec4 must be trivially copyable and standard layout.");
+static_assert(std::is_trivially_copyable<Vec3>::value && std::is_standard_layout<Vec3>::value,
+  "Vec3 must be trivially copyable and standard layout.");
+static_assert(std::is_trivially_copyable<Vec2>::value && std::is_standard_layout<Vec2>::value,
+  "Vec2 must be trivially copyable and standard layout.");
+static_assert(sizeof(Vec4) == 4 * sizeof(real32), "Vec4 must be tightly packed.");
+static_assert(sizeof(Vec3) == 3 * sizeof(real32), "Vec3 must be tightly packed.");
+static_assert(sizeof(Vec2) == 2 * sizeof(real32), "Vec2 must be tightly packed.");
 } // jkl
 
 #include "internal/vector.inl"
\ No newline at end of file
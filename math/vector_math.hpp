@@ -5,48 +5,82 @@
 
 #include "vector.hpp"
 #include "common.hpp"
+#include "precision.hpp"
 
 
 namespace math {
 
 
+// Functions with a precision policy P take Exact by default, or Fast for the
+// approximate path, e.g. Normalize<Fast>(v). See precision.hpp.
+
 // Normalize the Vector4 object to a unit length.
-template<typename T> inline
+template<typename P = Exact, typename T> constexpr
 Vector4<T> Normalize(const Vector4<T> &vec);
 
 // Normalize a Vector3 object to a unit length.
-template<typename T> inline 
+template<typename P = Exact, typename T> constexpr 
 Vector3<T> Normalize(const Vector3<T> &vec);
 
 // Normalize a Vector2 object to a unit length.
-template<typename T> inline
+template<typename P = Exact, typename T> constexpr
 Vector2<T> Normalize(const Vector2<T> &vec);
 
+// Length of a vector. Prefer comparing LengthSquared() where possible, which
+// needs no square root at all.
+template<typename P = Exact, typename T> constexpr
+T Length(const Vector4<T> &vec);
+
+template<typename P = Exact, typename T> constexpr
+T Length(const Vector3<T> &vec);
+
+template<typename P = Exact, typename T> constexpr
+T Length(const Vector2<T> &vec);
+
+// Divide every component of vec by scaler. Fast multiplies by the reciprocal
+// instead.
+template<typename P = Exact, typename T> constexpr
+Vector4<T> Divide(const Vector4<T> &vec, T scaler);
+
+template<typename P = Exact, typename T> constexpr
+Vector3<T> Divide(const Vector3<T> &vec, T scaler);
+
+template<typename P = Exact, typename T> constexpr
+Vector2<T> Divide(const Vector2<T> &vec, T scaler);
+
 // Get the cross product of two 3-component vectors.
-template<typename T> inline
+template<typename T> constexpr
 Vector3<T> Cross(const Vector3<T> &u, const Vector3<T> &v);
 
 // Get the dot product of two 3-component vectors.
-template<typename T> inline
+template<typename T> constexpr
 T Dot(const Vector3<T> &u, const Vector3<T> &v);
 
 // Get the dot product of two 4-component vectors.
-template<typename T> inline
+template<typename T> constexpr
 T Dot(const Vector4<T> &u, const Vector4<T> &v);
 
 // Get the dot product of two 2-component vectors.
-template<typename T> inline
+template<typename T> constexpr
 T Dot(const Vector2<T> &u, const Vector2<T> &v); 
 
 // Calculate the linear interpolation of a 3-component vector in space, at time
 // t.
-template<typename T> inline
+template<typename T> constexpr
 Vector3<T> Lerp(const Vector3<T> &u, const Vector3<T> &v, T t);
 
 // Calculat the linear interpolation of a 2-component vector in space, at time
 // t.
-template<typename T> inline
+template<typename T> constexpr
 Vector2<T> Lerp(const Vector2<T> &v0, const Vector2<T> &v1, T t);
+
+// Component wise minimum of two 3-component vectors.
+template<typename T> constexpr
+Vector3<T> Min(const Vector3<T> &u, const Vector3<T> &v);
+
+// Component wise maximum of two 3-component vectors.
+template<typename T> constexpr
+Vector3<T> Max(const Vector3<T> &u, const Vector3<T> &v);
 } // jkl
 
 #include "internal/vector_math.inl"
\ No newline at end of file
@@ -0,0 +1,587 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+#include "simd.hpp"
+
+#include <cstring>
+
+
+namespace math {
+
+
+// Wide floats, several lanes of real32 processed by one instruction. These are
+// the building blocks of the structure of arrays types in wide_vector.hpp.
+//
+// Float4 is a single SSE register. Float8 is a single AVX register when the
+// project is built with AVX enabled (-mavx, /arch:AVX), and otherwise a pair of
+// Float4, so code written against Float8 still runs everywhere.
+//
+// Comparisons return masks, where every bit of a lane is set if the comparison
+// is true for that lane. Masks are consumed by Select(), MoveMask(), Any() and
+// All(), or combined with &, | and AndNot().
+//
+// Default construction leaves the lanes uninitialized.
+namespace detail {
+inline uint32 FloatBits(real32 f)
+{
+  uint32 bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+
+inline real32 BitsFloat(uint32 bits)
+{
+  real32 f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+} // detail
+
+
+struct Float4 {
+  static const uint32 Width = 4;
+
+  Float4() = default;
+
+#if defined(J_SIMD_X86)
+  Float4(real32 s) : v(_mm_set1_ps(s)) { }
+
+  Float4(real32 a, real32 b, real32 c, real32 d)
+    : v(_mm_setr_ps(a, b, c, d)) { }
+
+  explicit Float4(__m128 v) : v(v) { }
+
+  // Load and store 4 floats. No alignment is required.
+  static Float4 Load(const real32 *p) {
+    return Float4(_mm_loadu_ps(p));
+  }
+
+  void Store(real32 *p) const {
+    _mm_storeu_ps(p, v);
+  }
+
+  // Mask with every lane set.
+  static Float4 True() {
+    return Float4(_mm_castsi128_ps(_mm_set1_epi32(-1)));
+  }
+
+  __m128 v;
+#else
+  Float4(real32 s) {
+    v[0] = s; v[1] = s; v[2] = s; v[3] = s;
+  }
+
+  Float4(real32 a, real32 b, real32 c, real32 d) {
+    v[0] = a; v[1] = b; v[2] = c; v[3] = d;
+  }
+
+  static Float4 Load(const real32 *p) {
+    return Float4(p[0], p[1], p[2], p[3]);
+  }
+
+  void Store(real32 *p) const {
+    p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3];
+  }
+
+  static Float4 True() {
+    return Float4(detail::BitsFloat(0xFFFFFFFFu));
+  }
+
+  real32 v[4];
+#endif
+
+  // Extract a single lane. Slow, meant for tails and debugging.
+  real32 operator[](uint32 lane) const {
+    real32 lanes[4];
+    Store(lanes);
+    return lanes[lane];
+  }
+
+  void operator+=(const Float4 &f);
+  void operator-=(const Float4 &f);
+  void operator*=(const Float4 &f);
+  void operator/=(const Float4 &f);
+};
+
+
+#if defined(J_SIMD_X86)
+#define J_FLOAT4_BINARY(op, intrinsic) \
+  inline Float4 op(const Float4 &a, const Float4 &b) { return Float4(intrinsic(a.v, b.v)); }
+#else
+#define J_FLOAT4_BINARY(op, expr) \
+  inline Float4 op(const Float4 &a, const Float4 &b) { \
+    Float4 r; \
+    for (uint32 i = 0; i < 4; ++i) { real32 x = a.v[i], y = b.v[i]; r.v[i] = (expr); } \
+    return r; \
+  }
+#endif
+
+#if defined(J_SIMD_X86)
+J_FLOAT4_BINARY(operator+, _mm_add_ps)
+J_FLOAT4_BINARY(operator-, _mm_sub_ps)
+J_FLOAT4_BINARY(operator*, _mm_mul_ps)
+J_FLOAT4_BINARY(operator/, _mm_div_ps)
+J_FLOAT4_BINARY(Min, _mm_min_ps)
+J_FLOAT4_BINARY(Max, _mm_max_ps)
+J_FLOAT4_BINARY(operator<, _mm_cmplt_ps)
+J_FLOAT4_BINARY(operator<=, _mm_cmple_ps)
+J_FLOAT4_BINARY(operator>, _mm_cmpgt_ps)
+J_FLOAT4_BINARY(operator>=, _mm_cmpge_ps)
+J_FLOAT4_BINARY(operator==, _mm_cmpeq_ps)
+J_FLOAT4_BINARY(operator!=, _mm_cmpneq_ps)
+J_FLOAT4_BINARY(operator&, _mm_and_ps)
+J_FLOAT4_BINARY(operator|, _mm_or_ps)
+J_FLOAT4_BINARY(operator^, _mm_xor_ps)
+
+
+// a & ~b
+inline Float4 AndNot(const Float4 &a, const Float4 &b)
+{
+  return Float4(_mm_andnot_ps(b.v, a.v));
+}
+
+
+inline Float4 operator-(const Float4 &a)
+{
+  return Float4(_mm_xor_ps(a.v, _mm_set1_ps(-0.0f)));
+}
+
+
+inline Float4 Abs(const Float4 &a)
+{
+  return Float4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v));
+}
+
+
+inline Float4 Sqrt(const Float4 &a)
+{
+  return Float4(_mm_sqrt_ps(a.v));
+}
+
+
+// Estimates of 1 / sqrt(a) and 1 / a, good to about 12 bits. Refine with a
+// Newton-Raphson step when more is needed, see precision.hpp.
+inline Float4 RSqrt(const Float4 &a)
+{
+  return Float4(_mm_rsqrt_ps(a.v));
+}
+
+
+inline Float4 Rcp(const Float4 &a)
+{
+  return Float4(_mm_rcp_ps(a.v));
+}
+
+
+// Picks a where the mask is set, b otherwise.
+inline Float4 Select(const Float4 &mask, const Float4 &a, const Float4 &b)
+{
+  return Float4(_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)));
+}
+
+
+// One bit per lane, lane 0 in the lowest bit.
+inline int32 MoveMask(const Float4 &mask)
+{
+  return _mm_movemask_ps(mask.v);
+}
+#else
+J_FLOAT4_BINARY(operator+, x + y)
+J_FLOAT4_BINARY(operator-, x - y)
+J_FLOAT4_BINARY(operator*, x * y)
+J_FLOAT4_BINARY(operator/, x / y)
+J_FLOAT4_BINARY(Min, x < y ? x : y)
+J_FLOAT4_BINARY(Max, x > y ? x : y)
+J_FLOAT4_BINARY(operator<, detail::BitsFloat(x < y ? 0xFFFFFFFFu : 0u))
+J_FLOAT4_BINARY(operator<=, detail::BitsFloat(x <= y ? 0xFFFFFFFFu : 0u))
+J_FLOAT4_BINARY(operator>, detail::BitsFloat(x > y ? 0xFFFFFFFFu : 0u))
+J_FLOAT4_BINARY(operator>=, detail::BitsFloat(x >= y ? 0xFFFFFFFFu : 0u))
+J_FLOAT4_BINARY(operator==, detail::BitsFloat(x == y ? 0xFFFFFFFFu : 0u))
+J_FLOAT4_BINARY(operator!=, detail::BitsFloat(x != y ? 0xFFFFFFFFu : 0u))
+J_FLOAT4_BINARY(operator&, detail::BitsFloat(detail::FloatBits(x) & detail::FloatBits(y)))
+J_FLOAT4_BINARY(operator|, detail::BitsFloat(detail::FloatBits(x) | detail::FloatBits(y)))
+J_FLOAT4_BINARY(operator^, detail::BitsFloat(detail::FloatBits(x) ^ detail::FloatBits(y)))
+J_FLOAT4_BINARY(AndNot, detail::BitsFloat(detail::FloatBits(x) & ~detail::FloatBits(y)))
+
+
+inline Float4 operator-(const Float4 &a)
+{
+  return Float4(-a.v[0], -a.v[1], -a.v[2], -a.v[3]);
+}
+
+
+inline Float4 Abs(const Float4 &a)
+{
+  return Float4(std::abs(a.v[0]), std::abs(a.v[1]), std::abs(a.v[2]), std::abs(a.v[3]));
+}
+
+
+inline Float4 Sqrt(const Float4 &a)
+{
+  return Float4(std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]));
+}
+
+
+inline Float4 RSqrt(const Float4 &a)
+{
+  return Float4(1.0f) / Sqrt(a);
+}
+
+
+inline Float4 Rcp(const Float4 &a)
+{
+  return Float4(1.0f) / a;
+}
+
+
+inline Float4 Select(const Float4 &mask, const Float4 &a, const Float4 &b)
+{
+  return (mask & a) | AndNot(b, mask);
+}
+
+
+inline int32 MoveMask(const Float4 &mask)
+{
+  int32 bits = 0;
+  for (uint32 i = 0; i < 4; ++i) {
+    bits |= static_cast<int32>(detail::FloatBits(mask.v[i]) >> 31) << i;
+  }
+  return bits;
+}
+#endif
+#undef J_FLOAT4_BINARY
+
+
+inline void Float4::operator+=(const Float4 &f) { *this = *this + f; }
+inline void Float4::operator-=(const Float4 &f) { *this = *this - f; }
+inline void Float4::operator*=(const Float4 &f) { *this = *this * f; }
+inline void Float4::operator/=(const Float4 &f) { *this = *this / f; }
+
+
+// a * b + c.
+inline Float4 MulAdd(const Float4 &a, const Float4 &b, const Float4 &c)
+{
+  return a * b + c;
+}
+
+
+inline bool Any(const Float4 &mask)
+{
+  return MoveMask(mask) != 0;
+}
+
+
+inline bool All(const Float4 &mask)
+{
+  return MoveMask(mask) == 0xF;
+}
+
+
+// Lowest lane set in bits, a MoveMask result other than zero. Clearing it
+// with bits &= bits - 1 walks the set lanes in order.
+inline uint32 LowestLane(int32 bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32>(__builtin_ctz(static_cast<unsigned>(bits)));
+#elif defined(_MSC_VER) && defined(J_SIMD_X86)
+  unsigned long lane;
+  _BitScanForward(&lane, static_cast<unsigned long>(bits));
+  return static_cast<uint32>(lane);
+#else
+  uint32 lane = 0;
+  while (!((bits >> lane) & 1)) {
+    ++lane;
+  }
+  return lane;
+#endif
+}
+
+
+// Horizontal reductions across all lanes.
+inline real32 ReduceMin(const Float4 &a)
+{
+  real32 l[4];
+  a.Store(l);
+  real32 m0 = l[0] < l[1] ? l[0] : l[1];
+  real32 m1 = l[2] < l[3] ? l[2] : l[3];
+  return m0 < m1 ? m0 : m1;
+}
+
+
+inline real32 ReduceMax(const Float4 &a)
+{
+  real32 l[4];
+  a.Store(l);
+  real32 m0 = l[0] > l[1] ? l[0] : l[1];
+  real32 m1 = l[2] > l[3] ? l[2] : l[3];
+  return m0 > m1 ? m0 : m1;
+}
+
+
+inline real32 ReduceAdd(const Float4 &a)
+{
+  real32 l[4];
+  a.Store(l);
+  return (l[0] + l[1]) + (l[2] + l[3]);
+}
+
+
+struct Float8 {
+  static const uint32 Width = 8;
+
+  Float8() = default;
+
+#if defined(J_SIMD_AVX)
+  Float8(real32 s) : v(_mm256_set1_ps(s)) { }
+
+  Float8(real32 a, real32 b, real32 c, real32 d,
+         real32 e, real32 f, real32 g, real32 h)
+    : v(_mm256_setr_ps(a, b, c, d, e, f, g, h)) { }
+
+  explicit Float8(__m256 v) : v(v) { }
+
+  Float8(const Float4 &lo, const Float4 &hi)
+    : v(_mm256_insertf128_ps(_mm256_castps128_ps256(lo.v), hi.v, 1)) { }
+
+  static Float8 Load(const real32 *p) {
+    return Float8(_mm256_loadu_ps(p));
+  }
+
+  void Store(real32 *p) const {
+    _mm256_storeu_ps(p, v);
+  }
+
+  static Float8 True() {
+    return Float8(_mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+  }
+
+  Float4 Low() const { return Float4(_mm256_castps256_ps128(v)); }
+  Float4 High() const { return Float4(_mm256_extractf128_ps(v, 1)); }
+
+  __m256 v;
+#else
+  Float8(real32 s) : lo(s), hi(s) { }
+
+  Float8(real32 a, real32 b, real32 c, real32 d,
+         real32 e, real32 f, real32 g, real32 h)
+    : lo(a, b, c, d), hi(e, f, g, h) { }
+
+  Float8(const Float4 &lo, const Float4 &hi) : lo(lo), hi(hi) { }
+
+  static Float8 Load(const real32 *p) {
+    return Float8(Float4::Load(p), Float4::Load(p + 4));
+  }
+
+  void Store(real32 *p) const {
+    lo.Store(p);
+    hi.Store(p + 4);
+  }
+
+  static Float8 True() {
+    return Float8(Float4::True(), Float4::True());
+  }
+
+  Float4 Low() const { return lo; }
+  Float4 High() const { return hi; }
+
+  Float4 lo, hi;
+#endif
+
+  real32 operator[](uint32 lane) const {
+    real32 lanes[8];
+    Store(lanes);
+    return lanes[lane];
+  }
+
+  void operator+=(const Float8 &f);
+  void operator-=(const Float8 &f);
+  void operator*=(const Float8 &f);
+  void operator/=(const Float8 &f);
+};
+
+
+#if defined(J_SIMD_AVX)
+#define J_FLOAT8_BINARY(op, expr) \
+  inline Float8 op(const Float8 &a, const Float8 &b) { return Float8(expr); }
+J_FLOAT8_BINARY(operator+, _mm256_add_ps(a.v, b.v))
+J_FLOAT8_BINARY(operator-, _mm256_sub_ps(a.v, b.v))
+J_FLOAT8_BINARY(operator*, _mm256_mul_ps(a.v, b.v))
+J_FLOAT8_BINARY(operator/, _mm256_div_ps(a.v, b.v))
+J_FLOAT8_BINARY(Min, _mm256_min_ps(a.v, b.v))
+J_FLOAT8_BINARY(Max, _mm256_max_ps(a.v, b.v))
+J_FLOAT8_BINARY(operator<, _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ))
+J_FLOAT8_BINARY(operator<=, _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ))
+J_FLOAT8_BINARY(operator>, _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ))
+J_FLOAT8_BINARY(operator>=, _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ))
+J_FLOAT8_BINARY(operator==, _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ))
+J_FLOAT8_BINARY(operator!=, _mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ))
+J_FLOAT8_BINARY(operator&, _mm256_and_ps(a.v, b.v))
+J_FLOAT8_BINARY(operator|, _mm256_or_ps(a.v, b.v))
+J_FLOAT8_BINARY(operator^, _mm256_xor_ps(a.v, b.v))
+J_FLOAT8_BINARY(AndNot, _mm256_andnot_ps(b.v, a.v))
+
+
+inline Float8 operator-(const Float8 &a)
+{
+  return Float8(_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)));
+}
+
+
+inline Float8 Abs(const Float8 &a)
+{
+  return Float8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v));
+}
+
+
+inline Float8 Sqrt(const Float8 &a)
+{
+  return Float8(_mm256_sqrt_ps(a.v));
+}
+
+
+inline Float8 RSqrt(const Float8 &a)
+{
+  return Float8(_mm256_rsqrt_ps(a.v));
+}
+
+
+inline Float8 Rcp(const Float8 &a)
+{
+  return Float8(_mm256_rcp_ps(a.v));
+}
+
+
+// Masks, as Float4 does. GCC turns blendv into a compare of the mask as
+// integers, which AVX without AVX2 can't do on 256 bits, so it splits the
+// select up lane by lane.
+inline Float8 Select(const Float8 &mask, const Float8 &a, const Float8 &b)
+{
+  return Float8(_mm256_or_ps(_mm256_and_ps(mask.v, a.v), _mm256_andnot_ps(mask.v, b.v)));
+}
+
+
+inline int32 MoveMask(const Float8 &mask)
+{
+  return _mm256_movemask_ps(mask.v);
+}
+#else
+#define J_FLOAT8_BINARY(op, expr) \
+  inline Float8 op(const Float8 &a, const Float8 &b) { \
+    return Float8(op(a.lo, b.lo), op(a.hi, b.hi)); \
+  }
+J_FLOAT8_BINARY(operator+, _)
+J_FLOAT8_BINARY(operator-, _)
+J_FLOAT8_BINARY(operator*, _)
+J_FLOAT8_BINARY(operator/, _)
+J_FLOAT8_BINARY(Min, _)
+J_FLOAT8_BINARY(Max, _)
+J_FLOAT8_BINARY(operator<, _)
+J_FLOAT8_BINARY(operator<=, _)
+J_FLOAT8_BINARY(operator>, _)
+J_FLOAT8_BINARY(operator>=, _)
+J_FLOAT8_BINARY(operator==, _)
+J_FLOAT8_BINARY(operator!=, _)
+J_FLOAT8_BINARY(operator&, _)
+J_FLOAT8_BINARY(operator|, _)
+J_FLOAT8_BINARY(operator^, _)
+J_FLOAT8_BINARY(AndNot, _)
+
+
+inline Float8 operator-(const Float8 &a)
+{
+  return Float8(-a.lo, -a.hi);
+}
+
+
+inline Float8 Abs(const Float8 &a)
+{
+  return Float8(Abs(a.lo), Abs(a.hi));
+}
+
+
+inline Float8 Sqrt(const Float8 &a)
+{
+  return Float8(Sqrt(a.lo), Sqrt(a.hi));
+}
+
+
+inline Float8 RSqrt(const Float8 &a)
+{
+  return Float8(RSqrt(a.lo), RSqrt(a.hi));
+}
+
+
+inline Float8 Rcp(const Float8 &a)
+{
+  return Float8(Rcp(a.lo), Rcp(a.hi));
+}
+
+
+inline Float8 Select(const Float8 &mask, const Float8 &a, const Float8 &b)
+{
+  return Float8(Select(mask.lo, a.lo, b.lo), Select(mask.hi, a.hi, b.hi));
+}
+
+
+inline int32 MoveMask(const Float8 &mask)
+{
+  return MoveMask(mask.lo) | (MoveMask(mask.hi) << 4);
+}
+#endif
+#undef J_FLOAT8_BINARY
+
+
+inline void Float8::operator+=(const Float8 &f) { *this = *this + f; }
+inline void Float8::operator-=(const Float8 &f) { *this = *this - f; }
+inline void Float8::operator*=(const Float8 &f) { *this = *this * f; }
+inline void Float8::operator/=(const Float8 &f) { *this = *this / f; }
+
+
+inline Float8 MulAdd(const Float8 &a, const Float8 &b, const Float8 &c)
+{
+  return a * b + c;
+}
+
+
+inline bool Any(const Float8 &mask)
+{
+  return MoveMask(mask) != 0;
+}
+
+
+inline bool All(const Float8 &mask)
+{
+  return MoveMask(mask) == 0xFF;
+}
+
+
+inline real32 ReduceMin(const Float8 &a)
+{
+  return ReduceMin(Min(a.Low(), a.High()));
+}
+
+
+inline real32 ReduceMax(const Float8 &a)
+{
+  return ReduceMax(Max(a.Low(), a.High()));
+}
+
+
+inline real32 ReduceAdd(const Float8 &a)
+{
+  return ReduceAdd(a.Low() + a.High());
+}
+
+
+// Widest float the build handles natively, for kernels that just want as many
+// lanes as the hardware gives them.
+#if defined(J_SIMD_AVX)
+typedef Float8 FloatN;
+#else
+typedef Float4 FloatN;
+#endif
+} // jkl
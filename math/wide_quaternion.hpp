@@ -0,0 +1,108 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+// 
+#pragma once
+
+#include "common.hpp"
+#include "quaternion.hpp"
+#include "quaternion_math.hpp"
+#include "wide.hpp"
+#include "precision.hpp"
+#include "trig.hpp"
+
+
+namespace math {
+
+
+// Structure of arrays companion to Quaternion, holding Width quaternions, one
+// per lane of the wide float F. See wide_vector.hpp.
+template<typename F>
+struct WideQuaternion {
+  static const uint32 Width = F::Width;
+
+  WideQuaternion() = default;
+
+  WideQuaternion(const F &w, const F &x, const F &y, const F &z)
+    : w(w), x(x), y(y), z(z)
+    { }
+
+  // Broadcast a single quaternion to all lanes.
+  explicit WideQuaternion(const Quaternion<real32> &q)
+    : w(q.w), x(q.x), y(q.y), z(q.z)
+    { }
+
+  // Load Width consecutive quaternions from an AoS array.
+  static WideQuaternion Load(const Quaternion<real32> *src);
+
+  // Store all lanes as Width consecutive quaternions into an AoS array.
+  void Store(Quaternion<real32> *dst) const;
+
+  // Load from four separate arrays of w, x, y and z components.
+  static WideQuaternion Load(const real32 *ws, const real32 *xs, const real32 *ys, const real32 *zs) {
+    return WideQuaternion(F::Load(ws), F::Load(xs), F::Load(ys), F::Load(zs));
+  }
+
+  void Store(real32 *ws, real32 *xs, real32 *ys, real32 *zs) const {
+    w.Store(ws);
+    x.Store(xs);
+    y.Store(ys);
+    z.Store(zs);
+  }
+
+  // Extract a single lane as a regular quaternion.
+  Quaternion<real32> Get(uint32 lane) const;
+
+  WideQuaternion operator+(const WideQuaternion &q) const;
+  WideQuaternion operator-(const WideQuaternion &q) const;
+
+  // Per lane Hamilton product. Order matters!
+  WideQuaternion operator*(const WideQuaternion &q) const;
+  WideQuaternion operator*(const F &scaler) const;
+  WideQuaternion operator/(const F &scaler) const;
+  void operator+=(const WideQuaternion &q);
+  void operator-=(const WideQuaternion &q);
+  void operator*=(const WideQuaternion &q);
+  void operator*=(const F &scaler);
+  void operator/=(const F &scaler);
+  WideQuaternion operator-() const;
+
+  WideQuaternion Conjugate() const {
+    return WideQuaternion(w, -x, -y, -z);
+  }
+
+  F Length() const {
+    return Sqrt(w * w + x * x + y * y + z * z);
+  }
+
+  F w, x, y, z;
+};
+
+
+// Per lane 4D dot product of two quaternions.
+template<typename F> inline
+F Dot(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1);
+
+// Normalize every lane to a unit quaternion. See precision.hpp for P.
+template<typename P = Exact, typename F> inline
+WideQuaternion<F> Normalize(const WideQuaternion<F> &q);
+
+// Per lane component wise linear interpolation, at time t. The result is not
+// normalized, see Nlerp.
+template<typename F> inline
+WideQuaternion<F> Lerp(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1, const F &t);
+
+// Per lane normalized linear interpolation, taking the shortest path.
+template<typename F> inline
+WideQuaternion<F> Nlerp(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1, const F &t);
+
+// Per lane spherical linear interpolation, taking the shortest path. Matches
+// Slerp<P> in quaternion_math.hpp, including the Fast approximation.
+template<typename P = Exact, typename F> inline
+WideQuaternion<F> Slerp(const WideQuaternion<F> &q0, const WideQuaternion<F> &q1, const F &t);
+
+
+typedef WideQuaternion<Float4> Quatx4;
+typedef WideQuaternion<Float8> Quatx8;
+} // jkl
+
+#include "internal/wide_quaternion.inl"
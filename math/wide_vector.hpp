@@ -0,0 +1,172 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "common.hpp"
+#include "vector.hpp"
+#include "wide.hpp"
+
+
+namespace math {
+
+
+// Structure of arrays companions to the vectors in vector.hpp. Where a Vector3
+// holds one x, y, z, a WideVector3 holds Width of each, one per lane of a wide
+// float (Float4 or Float8), so every operation works on Width vectors at once.
+// Use these for bulk work (culling, skinning, particles), and load/store from
+// regular AoS arrays of vectors at the edges.
+//
+// Scaler arguments are wide as well, so each lane may be scaled differently.
+// A plain real32 converts to a wide float by broadcasting to every lane.
+template<typename F>
+struct WideVector4 {
+  static const uint32 Width = F::Width;
+
+  WideVector4() = default;
+
+  WideVector4(const F &x, const F &y, const F &z, const F &w)
+    : x(x), y(y), z(z), w(w)
+    { }
+
+  // Broadcast a single vector to all lanes.
+  explicit WideVector4(const Vector4<real32> &v)
+    : x(v.x), y(v.y), z(v.z), w(v.w)
+    { }
+
+  // Load Width consecutive vectors from an AoS array.
+  static WideVector4 Load(const Vector4<real32> *src);
+
+  // Store all lanes as Width consecutive vectors into an AoS array.
+  void Store(Vector4<real32> *dst) const;
+
+  // Extract a single lane as a regular vector.
+  Vector4<real32> Get(uint32 lane) const;
+
+  WideVector4 operator+(const WideVector4 &v) const;
+  WideVector4 operator-(const WideVector4 &v) const;
+  WideVector4 operator*(const WideVector4 &v) const;
+  WideVector4 operator*(const F &scale) const;
+  WideVector4 operator/(const WideVector4 &v) const;
+  WideVector4 operator/(const F &scaler) const;
+  void operator+=(const WideVector4 &v);
+  void operator-=(const WideVector4 &v);
+  void operator*=(const WideVector4 &v);
+  void operator*=(const F &scale);
+  void operator/=(const WideVector4 &v);
+  void operator/=(const F &scaler);
+  WideVector4 operator-() const;
+
+  // Per lane length.
+  F Length() const {
+    return Sqrt(x * x + y * y + z * z + w * w);
+  }
+
+  F x, y, z, w;
+};
+
+
+template<typename F>
+struct WideVector3 {
+  static const uint32 Width = F::Width;
+
+  WideVector3() = default;
+
+  WideVector3(const F &x, const F &y, const F &z)
+    : x(x), y(y), z(z)
+    { }
+
+  explicit WideVector3(const Vector3<real32> &v)
+    : x(v.x), y(v.y), z(v.z)
+    { }
+
+  static WideVector3 Load(const Vector3<real32> *src);
+
+  // Load from three separate arrays of x, y and z components.
+  static WideVector3 Load(const real32 *xs, const real32 *ys, const real32 *zs) {
+    return WideVector3(F::Load(xs), F::Load(ys), F::Load(zs));
+  }
+
+  void Store(Vector3<real32> *dst) const;
+
+  void Store(real32 *xs, real32 *ys, real32 *zs) const {
+    x.Store(xs);
+    y.Store(ys);
+    z.Store(zs);
+  }
+
+  Vector3<real32> Get(uint32 lane) const;
+
+  WideVector3 operator+(const WideVector3 &v) const;
+  WideVector3 operator-(const WideVector3 &v) const;
+  WideVector3 operator*(const WideVector3 &v) const;
+  WideVector3 operator*(const F &scale) const;
+  WideVector3 operator/(const WideVector3 &v) const;
+  WideVector3 operator/(const F &scaler) const;
+  void operator+=(const WideVector3 &v);
+  void operator-=(const WideVector3 &v);
+  void operator*=(const WideVector3 &v);
+  void operator*=(const F &scale);
+  void operator/=(const WideVector3 &v);
+  void operator/=(const F &scaler);
+  WideVector3 operator-() const;
+
+  F Length() const {
+    return Sqrt(x * x + y * y + z * z);
+  }
+
+  F x, y, z;
+};
+
+
+template<typename F>
+struct WideVector2 {
+  static const uint32 Width = F::Width;
+
+  WideVector2() = default;
+
+  WideVector2(const F &x, const F &y)
+    : x(x), y(y)
+    { }
+
+  explicit WideVector2(const Vector2<real32> &v)
+    : x(v.x), y(v.y)
+    { }
+
+  static WideVector2 Load(const Vector2<real32> *src);
+
+  void Store(Vector2<real32> *dst) const;
+
+  Vector2<real32> Get(uint32 lane) const;
+
+  WideVector2 operator+(const WideVector2 &v) const;
+  WideVector2 operator-(const WideVector2 &v) const;
+  WideVector2 operator*(const WideVector2 &v) const;
+  WideVector2 operator*(const F &scale) const;
+  WideVector2 operator/(const WideVector2 &v) const;
+  WideVector2 operator/(const F &scaler) const;
+  void operator+=(const WideVector2 &v);
+  void operator-=(const WideVector2 &v);
+  void operator*=(const WideVector2 &v);
+  void operator*=(const F &scale);
+  void operator/=(const WideVector2 &v);
+  void operator/=(const F &scaler);
+  WideVector2 operator-() const;
+
+  F Length() const {
+    return Sqrt(x * x + y * y);
+  }
+
+  F x, y;
+};
+
+
+typedef WideVector4<Float4> Vec4x4;
+typedef WideVector3<Float4> Vec3x4;
+typedef WideVector2<Float4> Vec2x4;
+typedef WideVector4<Float8> Vec4x8;
+typedef WideVector3<Float8> Vec3x8;
+typedef WideVector2<Float8> Vec2x8;
+} // jkl
+
+#include "internal/wide_vector.inl"
@@ -0,0 +1,54 @@
+//
+// Copyright (c) Jackal Engine. MIT License.
+//
+#pragma once
+
+#include "wide_vector.hpp"
+#include "common.hpp"
+#include "precision.hpp"
+
+
+namespace math {
+
+
+// Wide overloads of vector_math.hpp. Each works lane by lane, so the results
+// match calling the scalar versions Width times, up to rounding.
+
+// Normalize every lane of a WideVector4 to unit length.
+template<typename P = Exact, typename F> inline
+WideVector4<F> Normalize(const WideVector4<F> &vec);
+
+// Normalize every lane of a WideVector3 to unit length.
+template<typename P = Exact, typename F> inline
+WideVector3<F> Normalize(const WideVector3<F> &vec);
+
+// Normalize every lane of a WideVector2 to unit length.
+template<typename P = Exact, typename F> inline
+WideVector2<F> Normalize(const WideVector2<F> &vec);
+
+// Per lane cross product of two 3-component vectors.
+template<typename F> inline
+WideVector3<F> Cross(const WideVector3<F> &u, const WideVector3<F> &v);
+
+// Per lane dot product of two 3-component vectors.
+template<typename F> inline
+F Dot(const WideVector3<F> &u, const WideVector3<F> &v);
+
+// Per lane dot product of two 4-component vectors.
+template<typename F> inline
+F Dot(const WideVector4<F> &u, const WideVector4<F> &v);
+
+// Per lane dot product of two 2-component vectors.
+template<typename F> inline
+F Dot(const WideVector2<F> &u, const WideVector2<F> &v);
+
+// Per lane linear interpolation of 3-component vectors, at time t.
+template<typename F> inline
+WideVector3<F> Lerp(const WideVector3<F> &v0, const WideVector3<F> &v1, const F &t);
+
+// Per lane linear interpolation of 2-component vectors, at time t.
+template<typename F> inline
+WideVector2<F> Lerp(const WideVector2<F> &v0, const WideVector2<F> &v1, const F &t);
+} // jkl
+
+#include "internal/wide_vector_math.inl"
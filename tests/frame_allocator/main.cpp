@@ -0,0 +1,121 @@
+// Behavior tests for the frame allocator and scratch arenas: starting a
+// frame hands the memory of the oldest frame out again, while what the
+// frames still in flight allocated stays intact, and scratch scopes give
+// back everything allocated within them.
+#include <cstring>
+#include <iostream>
+#include "memory/frame_allocator.hpp"
+
+
+using namespace qengine;
+
+
+static int failures = 0;
+
+
+static void Check(bool passed, const char *what)
+{
+  if (!passed) {
+    std::cout << "FAILED: " << what << "\n";
+    ++failures;
+  }
+}
+
+
+static bool Filled(const unsigned char *memory, size_t size, unsigned char value)
+{
+  for (size_t i = 0; i < size; ++i) {
+    if (memory[i] != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+static void TestNextFrame()
+{
+  const uint32_t frameCount = 3;
+  const size_t size = 256;
+  FrameAllocator frames;
+  frames.Create(64 * 1024, frameCount);
+
+  unsigned char *first[frameCount];
+  for (uint32_t f = 0; f < frameCount; ++f) {
+    first[f] = static_cast<unsigned char *>(frames.Allocate(size));
+    std::memset(first[f], static_cast<int>(f + 1), size);
+    Check(frames.Used() >= size, "Used counts the frame's allocations");
+    frames.NextFrame();
+    Check(frames.Used() == 0, "a new frame starts empty");
+    Check(frames.LastFrameUsed() >= size, "LastFrameUsed is the frame before");
+  }
+  for (uint32_t f = 1; f < frameCount; ++f) {
+    Check(Filled(first[f], size, static_cast<unsigned char>(f + 1)),
+      "frames in flight keep their memory");
+  }
+
+  // Every buffer has come round once: each frame now starts over at the
+  // beginning of the memory of the frame frameCount before it.
+  for (uint32_t f = 0; f < frameCount; ++f) {
+    void *again = frames.Allocate(size);
+    Check(again == first[f], "NextFrame resets the oldest frame's memory");
+    frames.NextFrame();
+  }
+  Check(frames.Frame() == 2 * frameCount, "Frame counts NextFrame calls");
+
+  // A frame outgrowing its buffer gets the rest from the heap, and the
+  // buffer grows to fit once it comes round again.
+  frames.Allocate(48 * 1024);
+  frames.Allocate(48 * 1024);
+  frames.NextFrame();
+  Check(frames.LastFrameOverflow() > 0, "overflow goes to the heap");
+  for (uint32_t f = 0; f < frameCount; ++f) {
+    frames.NextFrame();
+  }
+  frames.Allocate(48 * 1024);
+  frames.Allocate(48 * 1024);
+  frames.NextFrame();
+  Check(frames.LastFrameOverflow() == 0, "buffers grow to the peak frame");
+  Check(frames.Capacity() >= frames.PeakUsed(), "capacity covers the peak");
+}
+
+
+static void TestScratch()
+{
+  LinearArena &arena = ScratchArena();
+  size_t before = arena.Used();
+  {
+    ScratchScope scope;
+    ArenaVector<int> values{ArenaAllocator<int>(scope.Arena())};
+    for (int i = 0; i < 10000; ++i) {
+      values.push_back(i);
+    }
+    Check(values[9999] == 9999, "arena vector holds its values");
+    Check(arena.Used() > before, "scratch allocations come from the arena");
+  }
+  Check(arena.Used() == before, "ScratchScope rewinds the arena");
+
+  LinearArena local(1024);
+  local.Allocate(100);
+  size_t mark = local.Mark();
+  local.Allocate(4000);
+  local.Rewind(mark);
+  Check(local.Used() == mark, "Rewind goes back to the mark");
+  local.Reset();
+  Check(local.Used() == 0 && local.Capacity() >= local.Peak(), "Reset grows to the peak");
+  void *start = local.Allocate(4000);
+  local.Reset();
+  Check(local.Allocate(4000) == start, "Reset reuses the grown block");
+}
+
+
+int main()
+{
+  TestNextFrame();
+  TestScratch();
+  if (failures) {
+    return 1;
+  }
+  std::cout << "Frame allocator tests passed.\n";
+  return 0;
+}
@@ -0,0 +1,98 @@
+// Behavior tests for handle pools: removing an item bumps its slot's
+// generation, after which its handles are rejected even once the slot holds
+// another item, and retired slots come back rather than the slot table
+// growing under churn.
+#include <iostream>
+#include <vector>
+#include "memory/handle_pool.hpp"
+
+
+using namespace qengine;
+
+
+typedef HandlePool<int> IntPool;
+typedef IntPool::HandleType IntHandle;
+
+
+static int failures = 0;
+
+
+static void Check(bool passed, const char *what)
+{
+  if (!passed) {
+    std::cout << "FAILED: " << what << "\n";
+    ++failures;
+  }
+}
+
+
+static void TestStaleHandles()
+{
+  IntPool pool;
+  IntHandle a = pool.Add(1);
+  IntHandle b = pool.Add(2);
+  IntHandle c = pool.Add(3);
+  Check(!a.IsNull() && a.Generation() == 1, "generations start at 1");
+  Check(pool.Get(IntHandle()) == nullptr, "the null handle is rejected");
+
+  Check(pool.Remove(a), "Remove takes a live handle");
+  Check(pool.Get(a) == nullptr && !pool.Contains(a), "a removed handle is stale");
+  Check(!pool.Remove(a), "Remove rejects a stale handle");
+  Check(pool.Size() == 2 && *pool.Get(b) == 2 && *pool.Get(c) == 3,
+    "removing moves the last item into the hole");
+
+  IntHandle reused = pool.Add(4);
+  Check(reused.Index() == a.Index(), "Add reuses the freed slot");
+  Check(reused.Generation() == a.Generation() + 1, "with its generation bumped");
+  Check(pool.Get(a) == nullptr && *pool.Get(reused) == 4,
+    "the stale handle does not reach the new item");
+
+  for (size_t i = 0; i < pool.Size(); ++i) {
+    Check(pool.Get(pool.HandleAt(i)) == &pool[i], "HandleAt refers to the item at i");
+  }
+
+  pool.Clear();
+  Check(pool.Empty(), "Clear removes every item");
+  Check(!pool.Contains(b) && !pool.Contains(c) && !pool.Contains(reused),
+    "Clear stales every handle");
+}
+
+
+static void TestChurn()
+{
+  IntPool pool;
+  std::vector<IntHandle> kept;
+  for (int i = 0; i < 4; ++i) {
+    kept.push_back(pool.Add(i));
+  }
+
+  // Enough churn through one slot to run its generation out many times over.
+  const uint32_t rounds = 20 * IntHandle::MaxGeneration;
+  IntHandle first = pool.Add(-1);
+  pool.Remove(first);
+  uint32_t highestIndex = 0;
+  bool staleRejected = true;
+  for (uint32_t i = 0; i < rounds; ++i) {
+    IntHandle handle = pool.Add(static_cast<int>(i));
+    highestIndex = handle.Index() > highestIndex ? handle.Index() : highestIndex;
+    pool.Remove(handle);
+    staleRejected = staleRejected && !pool.Contains(handle);
+  }
+  Check(staleRejected, "every removed handle is stale right after");
+  Check(highestIndex < 8, "retired slots are recycled instead of growing the table");
+  for (int i = 0; i < 4; ++i) {
+    Check(pool.Get(kept[i]) && *pool.Get(kept[i]) == i, "live items survive the churn");
+  }
+}
+
+
+int main()
+{
+  TestStaleHandles();
+  TestChurn();
+  if (failures) {
+    return 1;
+  }
+  std::cout << "Handle pool tests passed.\n";
+  return 0;
+}
@@ -0,0 +1,173 @@
+// Behavior tests for the job system: every job runs once, even with threads
+// inside and outside the system piling jobs on at once, and jobs held back
+// by a dependency only start once all of it is done.
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "jobs/job_system.hpp"
+
+
+using namespace qengine;
+
+
+static int failures = 0;
+
+
+static void Check(bool passed, const char *what, uint32_t workers)
+{
+  if (!passed) {
+    std::cout << "FAILED with " << workers << " workers: " << what << "\n";
+    ++failures;
+  }
+}
+
+
+static void Count(void *userData, size_t begin, size_t end)
+{
+  static_cast<std::atomic<size_t> *>(userData)->fetch_add(end - begin);
+}
+
+
+// Jobs of a stage, which the next stage depends on. Each takes a while, so
+// that jobs of the next stage starting early would see it unfinished.
+struct Stage {
+  std::atomic<uint32_t> done;
+  std::atomic<uint32_t> early;
+  Stage *previous;
+  uint32_t previousCount;
+};
+
+
+static void RunStage(void *userData, size_t, size_t)
+{
+  Stage *stage = static_cast<Stage *>(userData);
+  if (stage->previous && stage->previous->done.load() != stage->previousCount) {
+    stage->early.fetch_add(1);
+  }
+  std::this_thread::sleep_for(std::chrono::microseconds(50));
+  stage->done.fetch_add(1);
+}
+
+
+// Jobs waiting on jobs of their own, down to n = 1.
+struct Fib {
+  JobSystem *jobs;
+  size_t result;
+};
+
+
+static void RunFib(void *userData, size_t n, size_t)
+{
+  Fib *fib = static_cast<Fib *>(userData);
+  if (n < 2) {
+    fib->result = n;
+    return;
+  }
+  Fib a = { fib->jobs, 0 }, b = { fib->jobs, 0 };
+  Job halves[2] = { { RunFib, &a, n - 1, 0 }, { RunFib, &b, n - 2, 0 } };
+  JobCounter counter;
+  fib->jobs->Run(halves, 2, &counter);
+  fib->jobs->Wait(counter);
+  fib->result = a.result + b.result;
+}
+
+
+static void TestCompletion(JobSystem &jobs, uint32_t workers)
+{
+  const size_t perThread = 20000;
+  const uint32_t outside = 3;
+  std::atomic<size_t> total(0);
+  Job job = { Count, &total, 0, 1 };
+
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < outside; ++t) {
+    threads.push_back(std::thread([&] {
+      JobCounter counter;
+      for (size_t i = 0; i < perThread; ++i) {
+        jobs.Run(job, &counter);
+      }
+      jobs.Wait(counter);
+    }));
+  }
+  JobCounter counter;
+  for (size_t i = 0; i < perThread; ++i) {
+    jobs.Run(job, &counter);
+  }
+  jobs.Wait(counter);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  Check(counter.IsDone(), "counter done after Wait", workers);
+  Check(total.load() == perThread * (outside + 1), "every job runs once", workers);
+
+  Fib fib = { &jobs, 0 };
+  Job root = { RunFib, &fib, 20, 0 };
+  JobCounter fibCounter;
+  jobs.Run(root, &fibCounter);
+  jobs.Wait(fibCounter);
+  Check(fib.result == 6765, "nested waits", workers);
+
+  std::vector<std::atomic<uint32_t>> hits(100003);
+  for (std::atomic<uint32_t> &hit : hits) {
+    hit = 0;
+  }
+  jobs.ParallelFor(hits.size(), 64, [&] (size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      hits[i].fetch_add(1);
+    }
+  });
+  bool once = true;
+  for (std::atomic<uint32_t> &hit : hits) {
+    once = once && hit.load() == 1;
+  }
+  Check(once, "ParallelFor covers every index once", workers);
+}
+
+
+static void TestDependencies(JobSystem &jobs, uint32_t workers)
+{
+  const uint32_t count = 16;
+  for (uint32_t round = 0; round < 20; ++round) {
+    Stage first = { { 0 }, { 0 }, nullptr, 0 };
+    Stage second = { { 0 }, { 0 }, &first, count };
+    Stage third = { { 0 }, { 0 }, &second, count };
+    std::vector<Job> firstJobs(count, Job { RunStage, &first, 0, 0 });
+    std::vector<Job> secondJobs(count, Job { RunStage, &second, 0, 0 });
+    std::vector<Job> thirdJobs(count, Job { RunStage, &third, 0, 0 });
+    JobCounter a, b, c;
+    jobs.Run(firstJobs.data(), count, &a);
+    jobs.Run(secondJobs.data(), count, &b, &a);
+    jobs.Run(thirdJobs.data(), count, &c, &b);
+    jobs.Wait(c);
+    Check(third.done.load() == count, "dependent jobs all run", workers);
+    Check(second.early.load() == 0 && third.early.load() == 0,
+      "no job starts before its dependency is done", workers);
+  }
+
+  // A dependency already done holds nothing back.
+  std::atomic<size_t> total(0);
+  JobCounter done, counter;
+  Job job = { Count, &total, 0, 1 };
+  jobs.Run(job, &counter, &done);
+  jobs.Wait(counter);
+  Check(total.load() == 1, "done dependency", workers);
+}
+
+
+int main()
+{
+  for (uint32_t workers : { 0u, 1u, 3u, 7u }) {
+    JobSystem jobs;
+    jobs.Start(workers);
+    TestCompletion(jobs, workers);
+    TestDependencies(jobs, workers);
+    jobs.Stop();
+  }
+  if (failures) {
+    return 1;
+  }
+  std::cout << "Job system tests passed.\n";
+  return 0;
+}
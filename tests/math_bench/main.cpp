@@ -0,0 +1,1649 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include "bounding/bound_box.hpp"
+#include "bounding/bound_frustum.hpp"
+#include "bounding/bound_sphere.hpp"
+#include "bounding/bvh.hpp"
+#include "bounding/hash_grid.hpp"
+#include "bounding/lod.hpp"
+#include "bounding/loose_octree.hpp"
+#include "bounding/occlusion_culler.hpp"
+#include "bounding/sweep_and_prune.hpp"
+#include "matrix.hpp"
+#include "matrix_math.hpp"
+#include "quaternion_batch.hpp"
+#include "ray.hpp"
+#include "simd.hpp"
+#include "skinning.hpp"
+#include "trig.hpp"
+#include "vector_math.hpp"
+#include "wide_vector_math.hpp"
+
+
+typedef std::chrono::high_resolution_clock Clock;
+
+
+static math::real32 Random()
+{
+  return static_cast<math::real32>(std::rand()) / static_cast<math::real32>(RAND_MAX) * 2.0f - 1.0f;
+}
+
+
+static math::Mat4 RandomMat4()
+{
+  math::Mat4 m;
+  for (math::uint32 i = 0; i < 16; ++i) {
+    m.Raw()[i] = Random();
+  }
+  return m;
+}
+
+
+static double Seconds(Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+
+static void Report(const char *name, double count, double seconds)
+{
+  std::cout << std::setw(28) << std::left << name
+            << std::setw(14) << std::right << std::fixed << std::setprecision(2)
+            << (count / seconds) / 1.0e6 << " M/s\n";
+}
+
+
+// A kernel disagreed with its reference: print where, and end the run with an
+// error, so that a broken kernel can't pass for a fast one.
+static void Mismatch(const char *what, size_t index)
+{
+  std::cout << "  mismatch against " << what << " at " << index << "\n";
+  std::exit(1);
+}
+
+
+// The count indices in list must be the expected ones in reference.
+static void CheckList(const char *what, const math::uint32 *list, size_t count,
+  const std::vector<math::uint32> &reference, size_t expected)
+{
+  for (size_t i = 0; i < std::max(count, expected); ++i) {
+    if (i >= count || i >= expected || list[i] != reference[i]) {
+      Mismatch(what, i);
+    }
+  }
+}
+
+
+// Time per element, for kernels where that reads better than throughput.
+static void ReportNs(const char *name, double count, double seconds)
+{
+  std::cout << std::setw(28) << std::left << name
+            << std::setw(14) << std::right << std::fixed << std::setprecision(2)
+            << seconds * 1.0e9 / count << " ns/object\n";
+}
+
+
+static bool NearBox(const math::AABB &a, const math::AABB &b, math::real32 epsilon)
+{
+  return math::Abs(a.min.x - b.min.x) <= epsilon && math::Abs(a.min.y - b.min.y) <= epsilon &&
+    math::Abs(a.min.z - b.min.z) <= epsilon && math::Abs(a.max.x - b.max.x) <= epsilon &&
+    math::Abs(a.max.y - b.max.y) <= epsilon && math::Abs(a.max.z - b.max.z) <= epsilon;
+}
+
+
+// Concatenate lots of matrices through each kernel, and through Mat4::operator*
+// which dispatches at runtime.
+static void BenchMat4Mul()
+{
+  const math::uint32 count = 1 << 10;
+  const math::uint32 passes = 4096;
+  std::vector<math::Mat4> a(count), b(count), out(count), reference(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    a[i] = RandomMat4();
+    b[i] = RandomMat4();
+    math::simd::Mat4MulScalar(a[i].Raw(), b[i].Raw(), reference[i].Raw());
+  }
+
+  std::cout << "Mat4 multiply (" << count << " x " << passes << ")\n";
+  const math::simd::Isa isas[] = { 
+    math::simd::Isa::Scalar, math::simd::Isa::SSE2, math::simd::Isa::AVX 
+  };
+  for (math::simd::Isa isa : isas) {
+    if (!math::simd::IsSupported(isa)) {
+      std::cout << std::setw(28) << std::left << math::simd::IsaName(isa) << "unsupported\n";
+      continue;
+    }
+    Clock::time_point start = Clock::now();
+    for (math::uint32 p = 0; p < passes; ++p) {
+      for (math::uint32 i = 0; i < count; ++i) {
+        math::simd::Mat4Mul(isa, a[i].Raw(), b[i].Raw(), out[i].Raw());
+      }
+    }
+    Report(math::simd::IsaName(isa), double(count) * passes, Seconds(start));
+    for (math::uint32 i = 0; i < count; ++i) {
+      for (math::uint32 j = 0; j < 16; ++j) {
+        if (math::Abs(out[i].Raw()[j] - reference[i].Raw()[j]) > 1.0e-4f) {
+          std::cout << "  mismatch against scalar at matrix " << i << "\n";
+          std::exit(1);
+        }
+      }
+    }
+  }
+
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      out[i] = a[i] * b[i];
+    }
+  }
+  std::string name = std::string("operator* (") + math::simd::IsaName(math::simd::ActiveIsa()) + ")";
+  Report(name.c_str(), double(count) * passes, Seconds(start));
+}
+
+
+// General inverse through each kernel, versus the affine and orthonormal fast
+// paths on camera style matrices.
+static void BenchMat4Inverse()
+{
+  const math::uint32 count = 1 << 10;
+  const math::uint32 passes = 2048;
+  std::vector<math::Mat4> views(count), out(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Vec3 eye(Random() * 100.0f, Random() * 100.0f, Random() * 100.0f);
+    views[i] = math::LookAtRH(eye, math::Vec3(), math::Vec3(0.0f, 1.0f, 0.0f));
+  }
+
+  std::cout << "Mat4 inverse (" << count << " x " << passes << ")\n";
+  const math::simd::Isa isas[] = { math::simd::Isa::Scalar, math::simd::Isa::SSE2 };
+  for (math::simd::Isa isa : isas) {
+    if (!math::simd::IsSupported(isa)) {
+      continue;
+    }
+    Clock::time_point start = Clock::now();
+    for (math::uint32 p = 0; p < passes; ++p) {
+      for (math::uint32 i = 0; i < count; ++i) {
+        math::simd::Mat4Inverse(isa, views[i].Raw(), out[i].Raw());
+      }
+    }
+    Report(math::simd::IsaName(isa), double(count) * passes, Seconds(start));
+  }
+
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      out[i] = views[i].InverseAffine();
+    }
+  }
+  Report("InverseAffine", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      out[i] = views[i].InverseOrthonormal();
+    }
+  }
+  Report("InverseOrthonormal", double(count) * passes, Seconds(start));
+}
+
+
+// How far the longest or shortest of the normalized vectors is from 1.
+static double MaxLengthError(const std::vector<math::Vec3> &vectors)
+{
+  double error = 0.0;
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    const math::Vec3 &v = vectors[i];
+    double length = std::sqrt(double(v.x) * v.x + double(v.y) * v.y + double(v.z) * v.z);
+    error = std::max(error, std::abs(length - 1.0));
+  }
+  return error;
+}
+
+
+// Exact against Fast precision for normalizing, scalar and wide. Fast trades
+// the length error printed below for the sqrt and divide.
+static void BenchNormalize()
+{
+  const math::uint32 count = 1 << 12;
+  const math::uint32 passes = 4096;
+  std::vector<math::Vec3> in(count), out(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    in[i] = math::Vec3(Random() * 100.0f, Random() * 100.0f, Random() * 100.0f);
+  }
+
+  std::cout << "Vec3 normalize (" << count << " x " << passes << ")\n";
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      out[i] = math::Normalize(in[i]);
+    }
+  }
+  Report("Exact", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      out[i] = math::Normalize<math::Fast>(in[i]);
+    }
+  }
+  Report("Fast", double(count) * passes, Seconds(start));
+  std::cout << "  (max length error " << std::scientific << std::setprecision(1)
+            << MaxLengthError(out) << ")\n";
+
+  const math::uint32 W = math::FloatN::Width;
+  typedef math::WideVector3<math::FloatN> Vec3xN;
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; i += W) {
+      math::Normalize(Vec3xN::Load(&in[i])).Store(&out[i]);
+    }
+  }
+  Report("Exact wide", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; i += W) {
+      math::Normalize<math::Fast>(Vec3xN::Load(&in[i])).Store(&out[i]);
+    }
+  }
+  Report("Fast wide", double(count) * passes, Seconds(start));
+  std::cout << "  (max length error " << std::scientific << std::setprecision(1)
+            << MaxLengthError(out) << ")\n";
+}
+
+
+// Error of a float result against a double reference, in units in the last
+// place of the float closest to the reference.
+static double UlpError(math::real32 value, double reference)
+{
+  math::real32 rounded = std::fabs(static_cast<math::real32>(reference));
+  double ulp = static_cast<double>(std::nextafter(rounded, 2.0f * rounded + 1.0f)) - rounded;
+  return std::fabs(static_cast<double>(value) - reference) / ulp;
+}
+
+
+static double MaxUlpError(const std::vector<math::real32> &values, const std::vector<double> &reference)
+{
+  double error = 0.0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    error = std::max(error, UlpError(values[i], reference[i]));
+  }
+  return error;
+}
+
+
+static void ReportUlp(const char *name, double count, double seconds, double ulp)
+{
+  std::cout << std::setw(28) << std::left << name
+            << std::setw(14) << std::right << std::fixed << std::setprecision(2)
+            << (count / seconds) / 1.0e6 << " M/s"
+            << std::setw(12) << std::right << ulp << " ulp\n";
+}
+
+
+// Time passes runs of func over the inputs, then check its output against the
+// double precision reference.
+template<typename Func>
+static void BenchTrigCase(const char *name, math::uint32 count, math::uint32 passes,
+  std::vector<math::real32> &out, const std::vector<double> &reference, Func func)
+{
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    func();
+  }
+  ReportUlp(name, double(count) * passes, Seconds(start), MaxUlpError(out, reference));
+}
+
+
+static math::uint32 Bits(math::real32 value)
+{
+  math::uint32 bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+
+// The scalar, wide and batch Atan2 must agree to the bit, signed zeros, NaN
+// and infinities included, since the batch runs the wide kernel on whole
+// lanes and the scalar one on the tail.
+static void CheckAtan2(const std::vector<math::real32> &randomYs,
+  const std::vector<math::real32> &randomXs)
+{
+  const math::uint32 W = math::FloatN::Width;
+  const math::real32 inf = std::numeric_limits<math::real32>::infinity();
+  const math::real32 nan = std::numeric_limits<math::real32>::quiet_NaN();
+  const math::real32 special[] = {
+    0.0f, -0.0f, 1.0f, -1.0f, inf, -inf, nan, -nan, 1e-38f, -1e-38f, 1e-45f, 3e38f, -3e38f
+  };
+  const size_t specialCount = sizeof(special) / sizeof(special[0]);
+  std::vector<math::real32> ys(randomYs), xs(randomXs);
+  for (size_t j = 0; j < specialCount; ++j) {
+    for (size_t k = 0; k < specialCount; ++k) {
+      ys.push_back(special[j]);
+      xs.push_back(special[k]);
+    }
+  }
+  // Odd length, so the batch has a scalar tail.
+  size_t count = ys.size() | 1;
+  ys.resize(count + W, 0.0f);
+  xs.resize(count + W, -0.0f);
+
+  std::vector<math::real32> wide(count + W), batch(count);
+  for (size_t i = 0; i < count; i += W) {
+    math::Atan2(math::FloatN::Load(&ys[i]), math::FloatN::Load(&xs[i])).Store(&wide[i]);
+  }
+  math::Atan2(ys.data(), xs.data(), batch.data(), count);
+  for (size_t i = 0; i < count; ++i) {
+    math::uint32 scalar = Bits(math::Atan2(ys[i], xs[i]));
+    if (Bits(wide[i]) != scalar) {
+      Mismatch("the wide Atan2", i);
+    }
+    if (Bits(batch[i]) != scalar) {
+      Mismatch("the batch Atan2", i);
+    }
+  }
+}
+
+
+// The float trig kernels against libm, both the float overloads and the
+// double precision wrappers in common.hpp, over angles in [-pi, pi].
+static void BenchTrig()
+{
+  const math::uint32 count = 1 << 12;
+  const math::uint32 passes = 4096;
+  const math::real32 pi = static_cast<math::real32>(J_PI);
+  std::vector<math::real32> angles(count), xs(count), ys(count), cosines(count), sines(count);
+  std::vector<double> sinRef(count), cosRef(count), tanRef(count), atanRef(count), acosRef(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    angles[i] = Random() * pi;
+    xs[i] = Random() * 10.0f;
+    ys[i] = Random() * 10.0f;
+    sinRef[i] = std::sin(static_cast<double>(angles[i]));
+    cosRef[i] = std::cos(static_cast<double>(angles[i]));
+    tanRef[i] = std::tan(static_cast<double>(angles[i]) * 0.5);
+    atanRef[i] = std::atan2(static_cast<double>(ys[i]), static_cast<double>(xs[i]));
+    acosRef[i] = std::acos(static_cast<double>(angles[i] / pi));
+  }
+  std::vector<math::real32> halfAngles(count), unit(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    halfAngles[i] = angles[i] * 0.5f;
+    unit[i] = angles[i] / pi;
+  }
+
+  std::cout << "Sin (" << count << " x " << passes << ")" << std::setw(38) << "max error\n";
+  BenchTrigCase("libm float", count, passes, sines, sinRef, [&] () {
+    for (math::uint32 i = 0; i < count; ++i) sines[i] = std::sin(angles[i]);
+  });
+  BenchTrigCase("libm double", count, passes, sines, sinRef, [&] () {
+    for (math::uint32 i = 0; i < count; ++i) sines[i] = static_cast<math::real32>(math::Sin(double(angles[i])));
+  });
+  BenchTrigCase("SinCos", count, passes, sines, sinRef, [&] () {
+    for (math::uint32 i = 0; i < count; ++i) math::SinCos(angles[i], sines[i], cosines[i]);
+  });
+  BenchTrigCase("SinCos batch", count, passes, sines, sinRef, [&] () {
+    math::SinCos(angles.data(), sines.data(), cosines.data(), count);
+  });
+  std::cout << "  (batch cosine max error " << MaxUlpError(cosines, cosRef) << " ulp)\n";
+
+  std::cout << "Tan\n";
+  BenchTrigCase("libm float", count, passes, sines, tanRef, [&] () {
+    for (math::uint32 i = 0; i < count; ++i) sines[i] = std::tan(halfAngles[i]);
+  });
+  BenchTrigCase("Tan", count, passes, sines, tanRef, [&] () {
+    for (math::uint32 i = 0; i < count; ++i) sines[i] = math::Tan(halfAngles[i]);
+  });
+  BenchTrigCase("Tan batch", count, passes, sines, tanRef, [&] () {
+    math::Tan(halfAngles.data(), sines.data(), count);
+  });
+
+  std::cout << "Atan2\n";
+  BenchTrigCase("libm float", count, passes, sines, atanRef, [&] () {
+    for (math::uint32 i = 0; i < count; ++i) sines[i] = std::atan2(ys[i], xs[i]);
+  });
+  BenchTrigCase("Atan2", count, passes, sines, atanRef, [&] () {
+    for (math::uint32 i = 0; i < count; ++i) sines[i] = math::Atan2(ys[i], xs[i]);
+  });
+  BenchTrigCase("Atan2 batch", count, passes, sines, atanRef, [&] () {
+    math::Atan2(ys.data(), xs.data(), sines.data(), count);
+  });
+  CheckAtan2(ys, xs);
+
+  std::cout << "Acos\n";
+  BenchTrigCase("libm float", count, passes, sines, acosRef, [&] () {
+    for (math::uint32 i = 0; i < count; ++i) sines[i] = std::acos(unit[i]);
+  });
+  BenchTrigCase("Acos", count, passes, sines, acosRef, [&] () {
+    for (math::uint32 i = 0; i < count; ++i) sines[i] = math::Acos(unit[i]);
+  });
+  BenchTrigCase("Acos batch", count, passes, sines, acosRef, [&] () {
+    math::Acos(unit.data(), sines.data(), count);
+  });
+}
+
+
+static math::Quat RandomQuat()
+{
+  return math::Normalize(math::Quat(Random(), Random(), Random(), Random()));
+}
+
+
+// Blending and converting whole poses, one quaternion at a time against the
+// SoA batch kernels.
+static void BenchQuatBatch()
+{
+  const math::uint32 count = 1 << 12;
+  const math::uint32 passes = 1024;
+  math::QuatArray a(count), b(count), out(count);
+  std::vector<math::Quat> qa(count), qb(count), qout(count);
+  std::vector<math::real32> t(count);
+  std::vector<math::Mat4> palette(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    qa[i] = RandomQuat();
+    qb[i] = RandomQuat();
+    a.Set(i, qa[i]);
+    b.Set(i, qb[i]);
+    t[i] = Random() * 0.5f + 0.5f;
+  }
+
+  std::cout << "Quaternion batch (" << count << " x " << passes << ")\n";
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      qout[i] = math::Nlerp(qa[i], qb[i], t[i]);
+    }
+  }
+  Report("Nlerp", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::NlerpBatch(a, b, t.data(), out);
+  }
+  Report("NlerpBatch", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      qout[i] = math::Slerp(qa[i], qb[i], t[i]);
+    }
+  }
+  Report("Slerp", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      qout[i] = math::Slerp<math::Fast>(qa[i], qb[i], t[i]);
+    }
+  }
+  Report("Slerp Fast", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::SlerpBatch(a, b, t.data(), out);
+  }
+  Report("SlerpBatch", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::SlerpBatch<math::Fast>(a, b, t.data(), out);
+  }
+  Report("SlerpBatch Fast", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      qout[i] = qa[i] * qb[i];
+    }
+  }
+  Report("Mul", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::MulBatch(a, b, out);
+  }
+  Report("MulBatch", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      palette[i] = qa[i].ToMatrix4x4();
+    }
+  }
+  Report("ToMatrix4x4", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::ToMatrixBatch(a, nullptr, palette.data());
+  }
+  Report("ToMatrixBatch", double(count) * passes, Seconds(start));
+}
+
+
+// Linear blend skinning with a Mat4 palette against dual quaternion blending,
+// per vertex and through the batch kernel.
+static void BenchSkinning()
+{
+  const math::uint32 joints = 64;
+  const math::uint32 count = 1 << 14;
+  const math::uint32 passes = 256;
+  std::vector<math::DualQuat> palette(joints);
+  std::vector<math::Mat4> matrices(joints);
+  for (math::uint32 j = 0; j < joints; ++j) {
+    palette[j] = math::DualQuat(RandomQuat(), math::Vec3(Random(), Random(), Random()));
+    matrices[j] = palette[j].ToMatrix4x4();
+  }
+  std::vector<math::SkinInfluence> influences(count);
+  std::vector<math::Vec3> positions(count), out(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::real32 sum = 0.0f;
+    for (math::uint32 k = 0; k < 4; ++k) {
+      influences[i].joints[k] = static_cast<math::uint16>(std::rand() % joints);
+      influences[i].weights[k] = Random() + 1.0f;
+      sum += influences[i].weights[k];
+    }
+    for (math::uint32 k = 0; k < 4; ++k) {
+      influences[i].weights[k] /= sum;
+    }
+    positions[i] = math::Vec3(Random(), Random(), Random());
+  }
+
+  std::cout << "Skinning, 4 joints per vertex (" << count << " x " << passes << ")\n";
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      const math::SkinInfluence &s = influences[i];
+      math::real32 m[4][3] = { };
+      for (math::uint32 k = 0; k < 4; ++k) {
+        const math::Mat4 &joint = matrices[s.joints[k]];
+        for (math::uint32 r = 0; r < 4; ++r) {
+          m[r][0] += joint.data[r][0] * s.weights[k];
+          m[r][1] += joint.data[r][1] * s.weights[k];
+          m[r][2] += joint.data[r][2] * s.weights[k];
+        }
+      }
+      const math::Vec3 &v = positions[i];
+      out[i] = math::Vec3(
+        v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + m[3][0],
+        v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + m[3][1],
+        v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + m[3][2]);
+    }
+  }
+  Report("Mat4 LBS", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      const math::SkinInfluence &s = influences[i];
+      math::DualQuat dqs[4] = {
+        palette[s.joints[0]], palette[s.joints[1]], palette[s.joints[2]], palette[s.joints[3]]
+      };
+      out[i] = math::Blend(dqs, s.weights, 4).TransformPoint(positions[i]);
+    }
+  }
+  Report("DualQuat DLB", double(count) * passes, Seconds(start));
+
+  math::StridedSpan<const math::SkinInfluence> influenceSpan(influences.data(), count);
+  math::StridedSpan<const math::Vec3> in(positions.data(), count);
+  math::StridedSpan<math::Vec3> outSpan(out.data(), count);
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::SkinDualQuaternions(palette.data(), influenceSpan, in, outSpan);
+  }
+  Report("SkinDualQuaternions", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::SkinDualQuaternions<math::Fast>(palette.data(), influenceSpan, in, outSpan);
+  }
+  Report("SkinDualQuaternions Fast", double(count) * passes, Seconds(start));
+}
+
+
+// World bounds of many objects: eight transformed corners per box, against
+// the center/extent method, one box at a time and batched.
+static void BenchBoundBox()
+{
+  const math::uint32 count = 1 << 14;
+  const math::uint32 passes = 256;
+  math::AABBArray local(count), world(count);
+  std::vector<math::Mat4> matrices(count);
+  std::vector<math::AABB> boxes(count), out(count), reference(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Vec3 center(Random() * 100.0f, Random() * 100.0f, Random() * 100.0f);
+    math::Vec3 extent(Random() + 1.0f, Random() + 1.0f, Random() + 1.0f);
+    boxes[i] = math::AABB::FromCenterExtent(center, extent);
+    local.Set(i, boxes[i]);
+    matrices[i] = RandomQuat().ToMatrix4x4();
+    matrices[i].data[3][0] = Random() * 10.0f;
+    matrices[i].data[3][1] = Random() * 10.0f;
+    matrices[i].data[3][2] = Random() * 10.0f;
+  }
+
+  std::cout << "AABB transform (" << count << " x " << passes << ")\n";
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      const math::AABB &b = boxes[i];
+      const math::Mat4 &m = matrices[i];
+      math::AABB r;
+      for (math::uint32 c = 0; c < 8; ++c) {
+        math::real32 x = (c & 1) ? b.max.x : b.min.x;
+        math::real32 y = (c & 2) ? b.max.y : b.min.y;
+        math::real32 z = (c & 4) ? b.max.z : b.min.z;
+        r.Merge(math::Vec3(
+          x * m.data[0][0] + y * m.data[1][0] + z * m.data[2][0] + m.data[3][0],
+          x * m.data[0][1] + y * m.data[1][1] + z * m.data[2][1] + m.data[3][1],
+          x * m.data[0][2] + y * m.data[1][2] + z * m.data[2][2] + m.data[3][2]));
+      }
+      reference[i] = r;
+    }
+  }
+  Report("8 corners", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      out[i] = math::Transform(boxes[i], matrices[i]);
+    }
+  }
+  Report("Transform", double(count) * passes, Seconds(start));
+  for (math::uint32 i = 0; i < count; ++i) {
+    if (!NearBox(out[i], reference[i], 1.0e-3f)) {
+      Mismatch("8 corners", i);
+    }
+  }
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::TransformBatch(local, matrices.data(), world);
+  }
+  Report("TransformBatch", double(count) * passes, Seconds(start));
+  for (math::uint32 i = 0; i < count; ++i) {
+    if (!NearBox(world.Get(i), reference[i], 1.0e-3f)) {
+      Mismatch("8 corners", i);
+    }
+  }
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::TransformBatch(local, matrices[0], world);
+  }
+  Report("TransformBatch one matrix", double(count) * passes, Seconds(start));
+  for (math::uint32 i = 0; i < count; ++i) {
+    if (!NearBox(world.Get(i), math::Transform(boxes[i], matrices[0]), 1.0e-3f)) {
+      Mismatch("Transform", i);
+    }
+  }
+}
+
+
+// Sphere fitting over a mesh sized point cloud, and plane tests over many
+// spheres, one at a time against the batch kernel.
+static void BenchBoundSphere()
+{
+  const math::uint32 count = 1 << 16;
+  const math::uint32 passes = 64;
+  std::vector<math::Vec3> points(count);
+  math::SphereArray spheres(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    points[i] = math::Vec3(Random() * 4.0f, Random(), Random() * 2.0f);
+    spheres.Set(i, math::Sphere(math::Vec3(Random() * 100.0f, Random() * 100.0f, Random() * 100.0f),
+      Random() + 1.0f));
+  }
+  math::StridedSpan<const math::Vec3> span(points.data(), count);
+
+  std::cout << "Bounding spheres (" << count << " x " << passes << ")\n";
+  math::Sphere fit;
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    fit = math::FitSphere(span);
+  }
+  Report("FitSphere", double(count) * passes, Seconds(start));
+  std::cout << "  radius " << fit.radius << "\n";
+  for (math::uint32 i = 0; i < count; ++i) {
+    if (!fit.Contains(points[i])) {
+      Mismatch("the fitted points", i);
+    }
+  }
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    fit = math::FitSphere(span, 4);
+  }
+  Report("FitSphere 4 passes", double(count) * passes, Seconds(start));
+  std::cout << "  radius " << fit.radius << "\n";
+  for (math::uint32 i = 0; i < count; ++i) {
+    if (!fit.Contains(points[i])) {
+      Mismatch("the fitted points", i);
+    }
+  }
+
+  const math::Vec4 plane(0.6f, 0.8f, 0.0f, -10.0f);
+  std::vector<math::uint32> indices(count), reference(count);
+  size_t visible = 0;
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    visible = 0;
+    for (math::uint32 i = 0; i < count; ++i) {
+      if (math::Classify(spheres.Get(i), plane) >= 0) {
+        reference[visible++] = i;
+      }
+    }
+  }
+  Report("Classify", double(count) * passes, Seconds(start));
+  size_t expected = visible;
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    visible = math::InFrontBatch(spheres, plane, indices.data());
+  }
+  Report("InFrontBatch", double(count) * passes, Seconds(start));
+  CheckList("Classify", indices.data(), visible, reference, expected);
+
+  // General affine matrices, with shear, as a non uniform parent scale under
+  // a rotated child gives. Points on each sphere must land in its bounds.
+  std::vector<math::Mat4> matrices(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    matrices[i] = RandomMat4();
+    matrices[i].data[0][3] = matrices[i].data[1][3] = matrices[i].data[2][3] = 0.0f;
+    matrices[i].data[3][3] = 1.0f;
+  }
+  math::SphereArray world;
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    math::TransformBatch(spheres, matrices.data(), world);
+  }
+  Report("TransformBatch", double(count) * passes, Seconds(start));
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Sphere local = spheres.Get(i), bounds = math::Transform(local, matrices[i]);
+    if (math::Abs(world.Get(i).radius - bounds.radius) > 1.0e-5f * bounds.radius) {
+      Mismatch("the scalar Transform", i);
+    }
+    const math::Mat4 &m = matrices[i];
+    for (math::uint32 k = 0; k < 16; ++k) {
+      math::Vec3 p = local.center + math::Normalize(math::Vec3(Random(), Random(), Random())) * local.radius;
+      math::Vec3 q(p.x * m.data[0][0] + p.y * m.data[1][0] + p.z * m.data[2][0] + m.data[3][0],
+        p.x * m.data[0][1] + p.y * m.data[1][1] + p.z * m.data[2][1] + m.data[3][1],
+        p.x * m.data[0][2] + p.y * m.data[1][2] + p.z * m.data[2][2] + m.data[3][2]);
+      // Slack for rounding in the centers, which dominates tiny spheres.
+      if (math::Length(q - bounds.center) > bounds.radius * 1.0001f + math::Length(q) * 1.0e-6f) {
+        Mismatch("points on the transformed sphere", i);
+      }
+    }
+  }
+}
+
+
+// Cull a million boxes and spheres scattered around the camera, about a quarter
+// of which end up visible.
+static void BenchFrustumCull()
+{
+  const math::uint32 count = 1 << 20;
+  const math::uint32 passes = 16;
+  math::AABBArray boxes(count);
+  math::SphereArray spheres(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Vec3 center(Random() * 500.0f, Random() * 500.0f, Random() * 500.0f);
+    math::Vec3 extent(Random() + 1.5f, Random() + 1.5f, Random() + 1.5f);
+    boxes.Set(i, math::AABB::FromCenterExtent(center, extent));
+    spheres.Set(i, math::Sphere(center, extent.x));
+  }
+  math::Mat4 view = math::LookAtRH(math::Vec3(0.0f, 0.0f, 0.0f), math::Vec3(0.0f, 0.0f, -1.0f),
+    math::Vec3(0.0f, 1.0f, 0.0f));
+  math::Mat4 projection = math::PerspectiveRH(math::ToRadians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+  math::Frustum frustum(view * projection);
+  std::vector<math::uint32> visible(count), reference(count), sphereReference(count);
+  size_t sphereExpected = 0;
+  for (math::uint32 i = 0; i < count; ++i) {
+    if (frustum.Intersects(spheres.Get(i))) {
+      sphereReference[sphereExpected++] = i;
+    }
+  }
+
+  std::cout << "Frustum culling (" << count << " x " << passes << ")\n";
+  size_t written = 0;
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = 0;
+    for (math::uint32 i = 0; i < count; ++i) {
+      if (frustum.Intersects(boxes.Get(i))) {
+        reference[written++] = i;
+      }
+    }
+  }
+  ReportNs("AABB scalar", double(count) * passes, Seconds(start));
+  std::cout << "  visible " << written << "\n";
+  size_t expected = written;
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::CullBatch(frustum, boxes, visible.data());
+  }
+  ReportNs("AABB CullBatch", double(count) * passes, Seconds(start));
+  CheckList("the scalar Intersects", visible.data(), written, reference, expected);
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::CullBatch(frustum, boxes, visible.data(), true);
+  }
+  ReportNs("AABB CullBatch parallel", double(count) * passes, Seconds(start));
+  CheckList("the scalar Intersects", visible.data(), written, reference, expected);
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::CullBatch(frustum, spheres, visible.data());
+  }
+  ReportNs("Sphere CullBatch", double(count) * passes, Seconds(start));
+  std::cout << "  visible " << written << "\n";
+  CheckList("the scalar Intersects", visible.data(), written, sphereReference, sphereExpected);
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::CullBatch(frustum, spheres, visible.data(), true);
+  }
+  ReportNs("Sphere CullBatch parallel", double(count) * passes, Seconds(start));
+  CheckList("the scalar Intersects", visible.data(), written, sphereReference, sphereExpected);
+}
+
+
+// One ray against a scene's worth of boxes, as when picking, and a packet of
+// rays against one triangle, as when baking.
+static void BenchRay()
+{
+  const math::uint32 count = 1 << 20;
+  const math::uint32 passes = 16;
+  math::AABBArray boxes(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Vec3 center(Random() * 500.0f, Random() * 500.0f, Random() * 500.0f);
+    math::Vec3 extent(Random() + 1.5f, Random() + 1.5f, Random() + 1.5f);
+    boxes.Set(i, math::AABB::FromCenterExtent(center, extent));
+  }
+  math::Ray3 ray(math::Vec3(-500.0f, -20.0f, 10.0f), math::Vec3(1.0f, 0.05f, -0.02f));
+  std::vector<math::uint32> hits(count), reference(count);
+
+  std::cout << "Ray queries (" << count << " x " << passes << ")\n";
+  size_t written = 0;
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = 0;
+    for (math::uint32 i = 0; i < count; ++i) {
+      math::real32 distance;
+      if (math::Intersect(ray, boxes.Get(i), distance)) {
+        reference[written++] = i;
+      }
+    }
+  }
+  ReportNs("Ray/AABB scalar", double(count) * passes, Seconds(start));
+  std::cout << "  hits " << written << "\n";
+  size_t expected = written;
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::IntersectBatch(ray, boxes, hits.data());
+  }
+  ReportNs("Ray/AABB IntersectBatch", double(count) * passes, Seconds(start));
+  CheckList("the scalar Intersect", hits.data(), written, reference, expected);
+
+  std::vector<math::Ray3> rays(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    rays[i] = math::Ray3(math::Vec3(Random(), Random(), 5.0f),
+      math::Vec3(Random() * 0.2f, Random() * 0.2f, -1.0f));
+  }
+  math::Vec3 v0(-1.0f, -1.0f, 0.0f), v1(1.0f, -1.0f, 0.0f), v2(0.0f, 1.0f, 0.0f);
+
+  written = 0;
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = 0;
+    for (math::uint32 i = 0; i < count; ++i) {
+      math::real32 distance, u, v;
+      written += math::Intersect(rays[i], v0, v1, v2, distance, u, v) ? 1 : 0;
+    }
+  }
+  ReportNs("Ray/triangle scalar", double(count) * passes, Seconds(start));
+  std::cout << "  hits " << written << "\n";
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = 0;
+    for (math::uint32 i = 0; i < count; i += math::FloatN::Width) {
+      math::WideRay<math::FloatN> packet = math::WideRay<math::FloatN>::Load(&rays[i]);
+      math::FloatN distance, u, v;
+      math::int32 bits = math::MoveMask(math::Intersect(packet, v0, v1, v2, distance, u, v));
+      for (; bits != 0; bits &= bits - 1) {
+        ++written;
+      }
+    }
+  }
+  ReportNs("Ray/triangle packet", double(count) * passes, Seconds(start));
+  std::cout << "  hits " << written << "\n";
+
+  // Each lane must hit where its ray does alone, at the same distance.
+  for (math::uint32 i = 0; i < count; i += math::FloatN::Width) {
+    math::WideRay<math::FloatN> packet = math::WideRay<math::FloatN>::Load(&rays[i]);
+    math::FloatN distance, u, v;
+    math::int32 bits = math::MoveMask(math::Intersect(packet, v0, v1, v2, distance, u, v));
+    math::real32 distances[math::FloatN::Width];
+    distance.Store(distances);
+    for (math::uint32 l = 0; l < math::FloatN::Width; ++l) {
+      math::real32 single, su, sv;
+      bool hit = math::Intersect(rays[i + l], v0, v1, v2, single, su, sv);
+      if (hit != (((bits >> l) & 1) != 0) || (hit && math::Abs(single - distances[l]) > 1.0e-4f)) {
+        Mismatch("the scalar Intersect", i + l);
+      }
+    }
+  }
+}
+
+
+// Raycasts against a bumpy terrain mesh through a Bvh, next to testing every
+// triangle, plus what a build and a refit cost.
+static void BenchBvh()
+{
+  const math::uint32 size = 512;
+  const math::uint32 rayCount = 1 << 16;
+  std::vector<math::Vec3> positions;
+  for (math::uint32 z = 0; z <= size; ++z) {
+    for (math::uint32 x = 0; x <= size; ++x) {
+      positions.push_back(math::Vec3(math::real32(x), Random() * 2.0f, math::real32(z)));
+    }
+  }
+  std::vector<math::uint32> indices;
+  for (math::uint32 z = 0; z < size; ++z) {
+    for (math::uint32 x = 0; x < size; ++x) {
+      math::uint32 i = z * (size + 1) + x;
+      math::uint32 quad[6] = { i, i + size + 1, i + 1, i + 1, i + size + 1, i + size + 2 };
+      indices.insert(indices.end(), quad, quad + 6);
+    }
+  }
+  const size_t triangleCount = indices.size() / 3;
+  math::StridedSpan<const math::Vec3> span(positions.data(), positions.size());
+  std::vector<math::Ray3> rays(rayCount);
+  for (math::uint32 i = 0; i < rayCount; ++i) {
+    math::real32 x = (i % 256) * 2.0f, z = (i / 256) * 2.0f;
+    rays[i] = math::Ray3(math::Vec3(x, 50.0f, z), math::Vec3(0.3f, -1.0f, 0.2f));
+  }
+
+  std::cout << "Bvh (" << triangleCount << " triangles, " << rayCount << " rays)\n";
+  math::Bvh bvh;
+  Clock::time_point start = Clock::now();
+  bvh.Build(span, indices.data(), triangleCount);
+  std::cout << std::setw(28) << std::left << "Build" << std::setw(14) << std::right
+            << Seconds(start) * 1.0e3 << " ms\n";
+  start = Clock::now();
+  bvh.Build(span, indices.data(), triangleCount, true);
+  std::cout << std::setw(28) << std::left << "Build parallel" << std::setw(14) << std::right
+            << Seconds(start) * 1.0e3 << " ms\n";
+  start = Clock::now();
+  bvh.Refit(span, indices.data());
+  std::cout << std::setw(28) << std::left << "Refit" << std::setw(14) << std::right
+            << Seconds(start) * 1.0e3 << " ms\n";
+
+  const math::uint32 bruteCount = 64;
+  std::vector<math::real32> bruteDistances(bruteCount);
+  size_t hits = 0;
+  start = Clock::now();
+  for (math::uint32 r = 0; r < bruteCount; ++r) {
+    math::real32 closest = std::numeric_limits<math::real32>::max();
+    bool hit = false;
+    for (size_t t = 0; t < triangleCount; ++t) {
+      math::real32 distance, u, v;
+      if (math::Intersect(rays[r], positions[indices[t * 3]], positions[indices[t * 3 + 1]],
+          positions[indices[t * 3 + 2]], distance, u, v, closest)) {
+        closest = distance;
+        hit = true;
+      }
+    }
+    hits += hit ? 1 : 0;
+    bruteDistances[r] = hit ? closest : -1.0f;
+  }
+  ReportNs("Raycast brute force", bruteCount, Seconds(start));
+
+  hits = 0;
+  std::vector<math::RayHit> rayHits(rayCount);
+  std::vector<bool> hitAny(rayCount);
+  start = Clock::now();
+  for (math::uint32 r = 0; r < rayCount; ++r) {
+    hitAny[r] = bvh.Raycast(rays[r], span, indices.data(), rayHits[r]);
+    hits += hitAny[r] ? 1 : 0;
+  }
+  ReportNs("Raycast Bvh", rayCount, Seconds(start));
+  std::cout << "  hits " << hits << "\n";
+  for (math::uint32 r = 0; r < bruteCount; ++r) {
+    math::real32 distance = hitAny[r] ? rayHits[r].distance : -1.0f;
+    if (math::Abs(distance - bruteDistances[r]) > 1.0e-4f) {
+      Mismatch("brute force", r);
+    }
+  }
+
+  hits = 0;
+  std::vector<math::RayHit> packetHits(rayCount);
+  std::vector<math::int32> packetBits(rayCount / math::FloatN::Width);
+  start = Clock::now();
+  for (math::uint32 r = 0; r < rayCount; r += math::FloatN::Width) {
+    math::int32 bits = bvh.Raycast(math::WideRay<math::FloatN>::Load(&rays[r]), span,
+      indices.data(), &packetHits[r]);
+    packetBits[r / math::FloatN::Width] = bits;
+    for (; bits != 0; bits &= bits - 1) {
+      ++hits;
+    }
+  }
+  ReportNs("Raycast Bvh packet", rayCount, Seconds(start));
+  std::cout << "  hits " << hits << "\n";
+  for (math::uint32 r = 0; r < rayCount; ++r) {
+    bool hit = ((packetBits[r / math::FloatN::Width] >> (r % math::FloatN::Width)) & 1) != 0;
+    if (hit != hitAny[r] || (hit && math::Abs(packetHits[r].distance - rayHits[r].distance) > 1.0e-4f)) {
+      Mismatch("single rays", r);
+    }
+  }
+}
+
+
+static void CountPair(void *userData, math::uint32, math::uint32)
+{
+  ++*static_cast<size_t *>(userData);
+}
+
+
+// Boxes drifting around a cube a frame at a time, kept up to date by sweep
+// and prune, next to one frame of testing every pair.
+static void BenchSweepAndPrune()
+{
+  const math::uint32 count = 50000;
+  const math::uint32 frames = 60;
+  const math::real32 world = 400.0f;
+  std::vector<math::AABB> boxes(count);
+  std::vector<math::Vec3> velocities(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Vec3 center((Random() + 1.0f) * world * 0.5f, (Random() + 1.0f) * world * 0.5f,
+      (Random() + 1.0f) * world * 0.5f);
+    math::Vec3 extent(Random() + 1.5f, Random() + 1.5f, Random() + 1.5f);
+    boxes[i] = math::AABB::FromCenterExtent(center, extent);
+    velocities[i] = math::Vec3(Random(), Random(), Random()) * 0.2f;
+  }
+
+  std::cout << "Sweep and prune (" << count << " boxes x " << frames << " frames)\n";
+  size_t added = 0;
+  math::SweepAndPrune sap;
+  sap.SetCallbacks(CountPair, nullptr, &added);
+  Clock::time_point start = Clock::now();
+  sap.Build(boxes.data(), count);
+  ReportNs("Build", count, Seconds(start));
+  std::cout << "  pairs " << sap.PairCount() << "\n";
+
+  added = 0;
+  start = Clock::now();
+  for (math::uint32 f = 0; f < frames; ++f) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      math::AABB &box = boxes[i];
+      math::Vec3 &velocity = velocities[i];
+      if (box.min.x < 0.0f || box.max.x > world) velocity.x = -velocity.x;
+      if (box.min.y < 0.0f || box.max.y > world) velocity.y = -velocity.y;
+      if (box.min.z < 0.0f || box.max.z > world) velocity.z = -velocity.z;
+      box = math::AABB(box.min + velocity, box.max + velocity);
+      sap.Move(i, box);
+    }
+  }
+  ReportNs("Move", double(count) * frames, Seconds(start));
+  std::cout << "  pairs " << sap.PairCount() << ", " << added << " added over "
+            << frames << " frames\n";
+
+  std::vector<math::uint32> pairs;
+  start = Clock::now();
+  for (math::uint32 a = 0; a < count; ++a) {
+    for (math::uint32 b = a + 1; b < count; ++b) {
+      if (boxes[a].Intersects(boxes[b])) {
+        pairs.push_back(a);
+        pairs.push_back(b);
+      }
+    }
+  }
+  ReportNs("Brute force, one frame", count, Seconds(start));
+  std::cout << "  pairs " << pairs.size() / 2 << "\n";
+  // The same pairs, and no others.
+  for (size_t p = 0; p < pairs.size(); p += 2) {
+    if (!sap.Overlapping(pairs[p], pairs[p + 1])) {
+      Mismatch("brute force", p / 2);
+    }
+  }
+  if (sap.PairCount() != pairs.size() / 2) {
+    Mismatch("brute force", pairs.size() / 2);
+  }
+}
+
+
+// The count indices in visible must be those of the volumes that
+// Frustum::Intersects keeps, in order.
+template<typename Array>
+static void CheckCull(const math::Frustum &frustum, const Array &volumes, const math::uint32 *visible,
+  size_t count, std::vector<math::uint32> &reference)
+{
+  size_t expected = 0;
+  for (size_t i = 0; i < volumes.Size(); ++i) {
+    if (frustum.Intersects(volumes.Get(i))) {
+      reference[expected++] = static_cast<math::uint32>(i);
+    }
+  }
+  CheckList("the scalar Intersects", visible, count, reference, expected);
+}
+
+
+// Long thin objects at random orientations, pipes and poles, each fitted
+// from its vertices with every kind of volume, then culled with each. The
+// visible counts are the draws each volume would submit.
+static void BenchTightVolumes()
+{
+  const math::uint32 count = 1 << 18;
+  const math::uint32 passes = 8;
+  const math::uint32 segments = 8;
+  math::AABBArray boxes(count);
+  math::SphereArray spheres(count);
+  math::OBBArray orientedBoxes(count);
+  math::CapsuleArray capsules(count);
+  math::CylinderArray cylinders(count);
+  std::vector<math::Vec3> vertices(segments * 2);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Vec3 base(Random() * 500.0f, Random() * 100.0f, Random() * 500.0f);
+    math::Vec3 direction = math::Normalize(math::Vec3(Random(), Random(), Random()));
+    math::Vec3 side = math::Normalize(math::Cross(direction,
+      std::fabs(direction.y) < 0.9f ? math::Vec3(0.0f, 1.0f, 0.0f) : math::Vec3(1.0f, 0.0f, 0.0f)));
+    math::Vec3 up = math::Cross(direction, side);
+    math::real32 length = 10.0f + (Random() + 1.0f) * 10.0f;
+    math::real32 radius = 0.25f + (Random() + 1.0f) * 0.25f;
+    for (math::uint32 s = 0; s < segments; ++s) {
+      math::real32 angle = s * 6.2831853f / segments;
+      math::Vec3 ring = (side * std::cos(angle) + up * std::sin(angle)) * radius;
+      vertices[s] = base + ring;
+      vertices[segments + s] = base + direction * length + ring;
+    }
+    math::StridedSpan<const math::Vec3> span(vertices.data(), vertices.size());
+    math::AABB box;
+    for (size_t v = 0; v < vertices.size(); ++v) {
+      box.Merge(vertices[v]);
+    }
+    boxes.Set(i, box);
+    math::Sphere sphere = math::FitSphere(span);
+    math::OBB orientedBox = math::FitOrientedBox(span);
+    math::Capsule capsule = math::FitCapsule(span);
+    math::Cylinder cylinder = math::FitCylinder(span);
+    spheres.Set(i, sphere);
+    orientedBoxes.Set(i, orientedBox);
+    capsules.Set(i, capsule);
+    cylinders.Set(i, cylinder);
+    // Every fit must hold the vertices it was fitted to.
+    for (size_t v = 0; v < vertices.size(); ++v) {
+      if (!sphere.Contains(vertices[v]) || !orientedBox.Contains(vertices[v]) ||
+          !capsule.Contains(vertices[v]) || !cylinder.Contains(vertices[v])) {
+        Mismatch("the fitted vertices", i);
+      }
+    }
+  }
+  math::Mat4 view = math::LookAtRH(math::Vec3(0.0f, 0.0f, 0.0f), math::Vec3(0.0f, 0.0f, -1.0f),
+    math::Vec3(0.0f, 1.0f, 0.0f));
+  math::Mat4 projection = math::PerspectiveRH(math::ToRadians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+  math::Frustum frustum(view * projection);
+  std::vector<math::uint32> visible(count), reference(count);
+
+  std::cout << "Tight volumes (" << count << " pipes x " << passes << ")\n";
+  size_t boxVisible = 0;
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    boxVisible = math::CullBatch(frustum, boxes, visible.data());
+  }
+  ReportNs("AABB", double(count) * passes, Seconds(start));
+  std::cout << "  visible " << boxVisible << "\n";
+  CheckCull(frustum, boxes, visible.data(), boxVisible, reference);
+
+  size_t written = 0;
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::CullBatch(frustum, spheres, visible.data());
+  }
+  ReportNs("Sphere", double(count) * passes, Seconds(start));
+  std::cout << "  visible " << written << "\n";
+  CheckCull(frustum, spheres, visible.data(), written, reference);
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::CullBatch(frustum, orientedBoxes, visible.data());
+  }
+  ReportNs("OBB", double(count) * passes, Seconds(start));
+  std::cout << "  visible " << written << ", " << boxVisible - written << " fewer draws than AABB\n";
+  CheckCull(frustum, orientedBoxes, visible.data(), written, reference);
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::CullBatch(frustum, capsules, visible.data());
+  }
+  ReportNs("Capsule", double(count) * passes, Seconds(start));
+  std::cout << "  visible " << written << ", " << boxVisible - written << " fewer draws than AABB\n";
+  CheckCull(frustum, capsules, visible.data(), written, reference);
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::CullBatch(frustum, cylinders, visible.data());
+  }
+  ReportNs("Cylinder", double(count) * passes, Seconds(start));
+  std::cout << "  visible " << written << ", " << boxVisible - written << " fewer draws than AABB\n";
+  CheckCull(frustum, cylinders, visible.data(), written, reference);
+}
+
+
+// A query's results, in no particular order, must be the handles of every
+// object in index whose box passes test.
+template<typename Test>
+static void CheckQuery(const char *what, const math::SpatialIndex &index,
+  std::vector<math::uint32> &results, const Test &test)
+{
+  std::vector<math::uint32> reference;
+  for (math::uint32 i = 0; i < index.Size(); ++i) {
+    if (test(index.Bounds(i))) {
+      reference.push_back(i);
+    }
+  }
+  std::sort(results.begin(), results.end());
+  CheckList(what, results.data(), results.size(), reference, reference.size());
+}
+
+
+// One frame of a scene of moving objects in a spatial index: every object
+// moves, then the camera, a few hundred box queries, as for explosions and
+// triggers, and a few hundred rays, as for line of sight, look through it.
+static void BenchSpatialIndexCase(const char *name, math::SpatialIndex &index,
+  std::vector<math::AABB> &boxes, const std::vector<math::Vec3> &velocities,
+  const math::Frustum &frustum, const std::vector<math::AABB> &queries,
+  const std::vector<math::Ray3> &rays, math::real32 world, math::uint32 frames)
+{
+  const math::uint32 count = static_cast<math::uint32>(boxes.size());
+  std::vector<math::uint32> results;
+  results.reserve(count);
+  std::cout << "  " << name << "\n";
+
+  index.Clear();
+  Clock::time_point start = Clock::now();
+  for (math::uint32 i = 0; i < count; ++i) {
+    index.Insert(boxes[i]);
+  }
+  ReportNs("Insert", count, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 f = 0; f < frames; ++f) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      math::Vec3 center = boxes[i].Center() + velocities[i] * static_cast<math::real32>(f % 2 ? -1 : 1);
+      math::Vec3 extent = boxes[i].Extent();
+      center.x = center.x < 0.0f ? center.x + world : (center.x > world ? center.x - world : center.x);
+      boxes[i] = math::AABB::FromCenterExtent(center, extent);
+      index.Move(i, boxes[i]);
+    }
+  }
+  ReportNs("Move", double(count) * frames, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 f = 0; f < frames; ++f) {
+    results.clear();
+    index.QueryFrustum(frustum, results);
+  }
+  ReportNs("Frustum query", double(count) * frames, Seconds(start));
+  std::cout << "  visible " << results.size() << "\n";
+  CheckQuery("a linear frustum test", index, results, [&] (const math::AABB &box) {
+    return frustum.Intersects(box);
+  });
+
+  size_t found = 0;
+  start = Clock::now();
+  for (const math::AABB &query : queries) {
+    results.clear();
+    index.QueryBox(query, results);
+    found += results.size();
+  }
+  ReportNs("Box query, per query", double(queries.size()), Seconds(start));
+  std::cout << "  found " << found << "\n";
+  for (const math::AABB &query : queries) {
+    results.clear();
+    index.QueryBox(query, results);
+    CheckQuery("a linear box test", index, results, [&] (const math::AABB &box) {
+      return box.Intersects(query);
+    });
+  }
+
+  found = 0;
+  start = Clock::now();
+  for (const math::Ray3 &ray : rays) {
+    results.clear();
+    index.QueryRay(ray, world * 0.25f, results);
+    found += results.size();
+  }
+  ReportNs("Ray query, per ray", double(rays.size()), Seconds(start));
+  std::cout << "  hit " << found << "\n";
+  for (const math::Ray3 &ray : rays) {
+    results.clear();
+    index.QueryRay(ray, world * 0.25f, results);
+    CheckQuery("a linear ray test", index, results, [&] (const math::AABB &box) {
+      math::real32 distance;
+      return math::Intersect(ray, box, distance, world * 0.25f);
+    });
+  }
+}
+
+
+static void BenchSpatialIndex()
+{
+  const math::uint32 count = 100000;
+  const math::uint32 frames = 16;
+  const math::uint32 queryCount = 256;
+  const math::real32 world = 1000.0f;
+  std::vector<math::AABB> boxes(count);
+  std::vector<math::Vec3> velocities(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Vec3 center((Random() + 1.0f) * world * 0.5f, (Random() + 1.0f) * 20.0f,
+      (Random() + 1.0f) * world * 0.5f);
+    math::Vec3 extent(Random() + 1.5f, Random() + 1.5f, Random() + 1.5f);
+    boxes[i] = math::AABB::FromCenterExtent(center, extent);
+    velocities[i] = math::Vec3(Random(), 0.0f, Random()) * 0.5f;
+  }
+  std::vector<math::AABB> queries(queryCount);
+  std::vector<math::Ray3> rays(queryCount);
+  for (math::uint32 i = 0; i < queryCount; ++i) {
+    math::Vec3 center((Random() + 1.0f) * world * 0.5f, 20.0f, (Random() + 1.0f) * world * 0.5f);
+    queries[i] = math::AABB::FromCenterExtent(center, math::Vec3(10.0f, 10.0f, 10.0f));
+    rays[i] = math::Ray3(center, math::Vec3(Random(), Random() * 0.1f, Random()));
+  }
+  math::Mat4 view = math::LookAtRH(math::Vec3(world * 0.5f, 40.0f, world * 0.5f),
+    math::Vec3(world * 0.5f, 20.0f, 0.0f), math::Vec3(0.0f, 1.0f, 0.0f));
+  math::Mat4 projection = math::PerspectiveRH(math::ToRadians(60.0f), 16.0f / 9.0f, 0.1f, 300.0f);
+  math::Frustum frustum(view * projection);
+
+  std::cout << "Spatial index (" << count << " moving boxes, " << queryCount << " queries)\n";
+  math::LooseOctree octree(math::AABB(math::Vec3(0.0f, 0.0f, 0.0f),
+    math::Vec3(world, world, world)), 8);
+  BenchSpatialIndexCase("Loose octree", octree, boxes, velocities, frustum, queries, rays,
+    world, frames);
+  math::HashGrid grid(8.0f);
+  BenchSpatialIndexCase("Hashed grid", grid, boxes, velocities, frustum, queries, rays,
+    world, frames);
+
+  // The same queries as a linear pass over every box.
+  std::cout << "  Linear\n";
+  math::AABBArray array(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    array.Set(i, boxes[i]);
+  }
+  std::vector<math::uint32> results(count);
+  size_t written = 0;
+  Clock::time_point start = Clock::now();
+  for (math::uint32 f = 0; f < frames; ++f) {
+    written = math::CullBatch(frustum, array, results.data());
+  }
+  ReportNs("Frustum CullBatch", double(count) * frames, Seconds(start));
+  std::cout << "  visible " << written << "\n";
+  std::vector<math::uint32> reference(count);
+  CheckCull(frustum, array, results.data(), written, reference);
+
+  size_t found = 0;
+  start = Clock::now();
+  for (const math::AABB &query : queries) {
+    for (math::uint32 i = 0; i < count; ++i) {
+      found += boxes[i].Intersects(query) ? 1 : 0;
+    }
+  }
+  ReportNs("Box query, per query", double(queryCount), Seconds(start));
+  std::cout << "  found " << found << "\n";
+
+  found = 0;
+  start = Clock::now();
+  for (const math::Ray3 &ray : rays) {
+    found += math::IntersectBatch(ray, array, results.data(), world * 0.25f);
+  }
+  ReportNs("Ray IntersectBatch, per ray", double(queryCount), Seconds(start));
+  std::cout << "  hit " << found << "\n";
+}
+
+
+// A city block seen from the street: a grid of buildings, box shells of 12
+// triangles each, hiding a crowd of props behind them. Frustum culling runs
+// first, then the occlusion culler filters its survivors.
+static void BenchOcclusion()
+{
+  const math::uint32 count = 1 << 18;
+  const math::uint32 passes = 16;
+  const math::uint32 buildings = 24;
+  std::vector<math::Vec3> corners;
+  for (math::uint32 c = 0; c < 8; ++c) {
+    corners.push_back(math::Vec3((c & 1) ? 1.0f : -1.0f, (c & 2) ? 1.0f : -1.0f, (c & 4) ? 1.0f : -1.0f));
+  }
+  // Counter clockwise seen from outside.
+  const math::uint32 shell[36] = {
+    0, 3, 1, 0, 2, 3, 4, 7, 6, 4, 5, 7, 0, 5, 4, 0, 1, 5,
+    2, 7, 3, 2, 6, 7, 0, 6, 2, 0, 4, 6, 1, 7, 5, 1, 3, 7
+  };
+  std::vector<math::Mat4> worlds;
+  for (math::uint32 x = 0; x < buildings; ++x) {
+    for (math::uint32 z = 0; z < buildings; ++z) {
+      math::real32 height = (Random() + 1.5f) * 15.0f;
+      worlds.push_back(math::Mat4(8.0f, 0.0f, 0.0f, 0.0f, 0.0f, height, 0.0f, 0.0f,
+        0.0f, 0.0f, 8.0f, 0.0f,
+        (static_cast<math::real32>(x) - buildings * 0.5f) * 20.0f, height,
+        -static_cast<math::real32>(z) * 20.0f - 10.0f, 1.0f));
+    }
+  }
+  math::AABBArray boxes(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Vec3 center(Random() * 240.0f, (Random() + 1.0f) * 2.0f, (Random() - 1.0f) * 240.0f);
+    math::Vec3 extent(Random() + 1.5f, Random() + 1.5f, Random() + 1.5f);
+    boxes.Set(i, math::AABB::FromCenterExtent(center, extent));
+  }
+  math::Mat4 view = math::LookAtRH(math::Vec3(0.0f, 2.0f, 5.0f), math::Vec3(0.0f, 2.0f, -100.0f),
+    math::Vec3(0.0f, 1.0f, 0.0f));
+  math::Mat4 projection = math::PerspectiveRH(math::ToRadians(70.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+  math::Mat4 viewProjection = view * projection;
+  math::Frustum frustum(viewProjection);
+  math::OcclusionCuller culler(256, 128);
+  math::AABB unit(math::Vec3(-1.0f, -1.0f, -1.0f), math::Vec3(1.0f, 1.0f, 1.0f));
+  math::StridedSpan<const math::Vec3> positions(corners.data(), corners.size());
+
+  std::cout << "Occlusion culling (" << worlds.size() << " occluders, " << count << " boxes x "
+            << passes << ")\n";
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    culler.Begin(viewProjection);
+    for (const math::Mat4 &world : worlds) {
+      culler.AddOccluder(world, unit, positions, shell, 12);
+    }
+    culler.Rasterize();
+  }
+  ReportNs("Raster, per frame", passes, Seconds(start));
+  std::cout << "  triangles " << culler.TriangleCount() << "\n";
+  std::vector<math::uint32> serial(count);
+  size_t serialCount = culler.CullBatch(boxes, serial.data());
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    culler.Begin(viewProjection);
+    for (const math::Mat4 &world : worlds) {
+      culler.AddOccluder(world, unit, positions, shell, 12);
+    }
+    culler.Rasterize(true);
+  }
+  ReportNs("Raster parallel, per frame", passes, Seconds(start));
+  std::vector<math::uint32> reference(count);
+  size_t expected = 0;
+  for (math::uint32 i = 0; i < count; ++i) {
+    if (culler.IsVisible(boxes.Get(i))) {
+      reference[expected++] = i;
+    }
+  }
+  CheckList("the serial raster", reference.data(), expected, serial, serialCount);
+
+  std::vector<math::uint32> visible(count);
+  size_t inFrustum = math::CullBatch(frustum, boxes, visible.data());
+  std::vector<math::uint32> survivors(count);
+  size_t written = 0;
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = culler.CullBatch(boxes, visible.data(), inFrustum,
+      survivors.data());
+  }
+  ReportNs("Test frustum survivors", double(inFrustum) * passes, Seconds(start));
+  std::cout << "  in frustum " << inFrustum << ", visible " << written << "\n";
+  std::vector<math::uint32> listed;
+  for (size_t i = 0; i < inFrustum; ++i) {
+    if (culler.IsVisible(boxes.Get(visible[i]))) {
+      listed.push_back(visible[i]);
+    }
+  }
+  CheckList("IsVisible on the frustum survivors", survivors.data(), written, listed, listed.size());
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = culler.CullBatch(boxes, survivors.data());
+  }
+  ReportNs("Test all", double(count) * passes, Seconds(start));
+  CheckList("IsVisible", survivors.data(), written, reference, expected);
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = culler.CullBatch(boxes, survivors.data(), true);
+  }
+  ReportNs("Test all parallel", double(count) * passes, Seconds(start));
+  std::cout << "  visible " << written << "\n";
+  CheckList("the serial CullBatch", survivors.data(), written, reference, expected);
+}
+
+
+// Clutter scattered over a large terrain, mostly small and far away, put
+// through the screen size pass with four levels of detail at 1080p.
+static void BenchLod()
+{
+  const math::uint32 count = 1 << 20;
+  const math::uint32 passes = 16;
+  math::SphereArray spheres(count);
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::Vec3 center(Random() * 2000.0f, (Random() + 1.0f) * 5.0f, Random() * 2000.0f);
+    spheres.Set(i, math::Sphere(center, (Random() + 1.1f) * 0.5f));
+  }
+  math::Mat4 view = math::LookAtRH(math::Vec3(0.0f, 10.0f, 0.0f), math::Vec3(0.0f, 10.0f, -1.0f),
+    math::Vec3(0.0f, 1.0f, 0.0f));
+  math::Mat4 projection = math::PerspectiveRH(math::ToRadians(60.0f), 16.0f / 9.0f, 0.1f, 5000.0f);
+  math::LodView lodView(view, projection, 1080.0f);
+  math::LodSettings settings;
+  settings.levelCount = 4;
+  settings.thresholds[0] = 64.0f;
+  settings.thresholds[1] = 16.0f;
+  settings.thresholds[2] = 4.0f;
+  std::vector<math::uint8> levels(count, 0);
+  std::vector<math::uint32> visible(count);
+  std::vector<math::uint8> visibleLevels(count);
+  std::vector<math::real32> pixelRadii(count);
+
+  std::cout << "Screen size and LOD (" << count << " x " << passes << ")\n";
+  size_t written = 0;
+  Clock::time_point start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = 0;
+    for (math::uint32 i = 0; i < count; ++i) {
+      math::real32 pixels = math::ProjectedRadius(lodView, spheres.Get(i));
+      if (pixels >= settings.minPixelRadius) {
+        visible[written++] = i;
+      }
+    }
+  }
+  ReportNs("ProjectedRadius scalar", double(count) * passes, Seconds(start));
+  std::cout << "  visible " << written << "\n";
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::SelectLodBatch(lodView, spheres, settings, levels.data(), visible.data(),
+      visibleLevels.data(), pixelRadii.data());
+  }
+  ReportNs("SelectLodBatch", double(count) * passes, Seconds(start));
+
+  start = Clock::now();
+  for (math::uint32 p = 0; p < passes; ++p) {
+    written = math::SelectLodBatch(lodView, spheres, settings, levels.data(), visible.data(),
+      visibleLevels.data(), pixelRadii.data(), true);
+  }
+  ReportNs("SelectLodBatch parallel", double(count) * passes, Seconds(start));
+
+  // One more frame each way from the same levels, against the scalar
+  // ProjectedRadius and level choice, then the serial pass against the
+  // parallel one. The wide radii agree with the scalar ones within rounding,
+  // which differs where the compiler fuses multiplies and adds, so spheres
+  // right at minPixelRadius may go either way, and the levels are checked
+  // from the radii the batch wrote.
+  std::vector<math::uint8> previous(levels);
+  written = math::SelectLodBatch(lodView, spheres, settings, levels.data(), visible.data(),
+    visibleLevels.data(), pixelRadii.data());
+  const math::real32 tolerance = 1e-5f;
+  size_t next = 0;
+  for (math::uint32 i = 0; i < count; ++i) {
+    math::real32 pixels = math::ProjectedRadius(lodView, spheres.Get(i));
+    bool listed = next < written && visible[next] == i;
+    if (!listed) {
+      if (pixels >= settings.minPixelRadius * (1.0f + tolerance)) {
+        Mismatch("the scalar ProjectedRadius", i);
+      }
+      continue;
+    }
+    if (std::abs(pixelRadii[next] - pixels) > tolerance * pixels ||
+        pixels < settings.minPixelRadius * (1.0f - tolerance)) {
+      Mismatch("the scalar ProjectedRadius", i);
+    }
+    if (visibleLevels[next] != levels[i] ||
+        visibleLevels[next] != math::detail::LodLevel(settings, pixelRadii[next], previous[i])) {
+      Mismatch("the scalar LodLevel", next);
+    }
+    ++next;
+  }
+  if (next != written) {
+    Mismatch("the scalar ProjectedRadius", next);
+  }
+  std::vector<math::uint32> serial(visible.begin(), visible.begin() + written);
+  std::vector<math::uint8> serialLevels(levels);
+  levels = previous;
+  written = math::SelectLodBatch(lodView, spheres, settings, levels.data(), visible.data(),
+    visibleLevels.data(), pixelRadii.data(), true);
+  CheckList("the serial SelectLodBatch", visible.data(), written, serial, serial.size());
+  for (math::uint32 i = 0; i < count; ++i) {
+    if (levels[i] != serialLevels[i]) {
+      Mismatch("the serial SelectLodBatch levels", i);
+    }
+  }
+  size_t perLevel[math::LodSettings::MaxLevels] = { };
+  for (size_t i = 0; i < written; ++i) {
+    ++perLevel[visibleLevels[i]];
+  }
+  std::cout << "  visible " << written << ", dropped " << count - written << ", per level";
+  for (math::uint32 l = 0; l < settings.levelCount; ++l) {
+    std::cout << " " << perLevel[l];
+  }
+  std::cout << "\n";
+}
+
+
+int main()
+{
+  std::srand(1234);
+  BenchMat4Mul();
+  BenchMat4Inverse();
+  BenchNormalize();
+  BenchTrig();
+  BenchQuatBatch();
+  BenchSkinning();
+  BenchBoundBox();
+  BenchBoundSphere();
+  BenchFrustumCull();
+  BenchTightVolumes();
+  BenchRay();
+  BenchBvh();
+  BenchSweepAndPrune();
+  BenchSpatialIndex();
+  BenchOcclusion();
+  BenchLod();
+  return 0;
+}
@@ -0,0 +1,109 @@
+// Compile time checks for the math library. Everything here is evaluated by
+// the compiler, so if this file builds, the tests have passed. The executable
+// only prints a confirmation.
+#include <iostream>
+#include "vector.hpp"
+#include "vector_math.hpp"
+#include "matrix.hpp"
+#include "matrix_math.hpp"
+#include "quaternion.hpp"
+#include "quaternion_math.hpp"
+
+
+using namespace math;
+
+
+constexpr bool Near(real32 a, real32 b, real32 epsilon = 1e-5f)
+{
+  return Abs(a - b) <= epsilon;
+}
+
+
+constexpr bool Near(const Mat4 &a, const Mat4 &b, real32 epsilon = 1e-5f)
+{
+  for (uint32 row = 0; row < 4; ++row) {
+    for (uint32 col = 0; col < 4; ++col) {
+      if (!Near(a.data[row][col], b.data[row][col], epsilon)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+constexpr Mat4 Sample()
+{
+  return Mat4(
+    2.0f, 0.0f, 1.0f, 0.0f,
+    1.0f, 3.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 4.0f, 0.0f,
+    5.0f, -2.0f, 7.0f, 1.0f
+  );
+}
+
+
+// Vectors.
+static_assert(Vec3(1.0f, 2.0f, 3.0f).x == 1.0f, "vector construction");
+static_assert((Vec3(1.0f, 2.0f, 3.0f) + Vec3(1.0f, 1.0f, 1.0f)).z == 4.0f, "vector add");
+static_assert(Dot(Vec3(1.0f, 2.0f, 3.0f), Vec3(4.0f, 5.0f, 6.0f)) == 32.0f, "dot");
+static_assert(Cross(Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f)).z == 1.0f, "cross");
+static_assert(Near(Vec3(3.0f, 4.0f, 0.0f).Length(), 5.0f), "length");
+static_assert(Near(Normalize(Vec3(0.0f, 3.0f, 4.0f)).z, 0.8f), "normalize");
+static_assert(Near(Lerp(Vec3(0.0f), Vec3(2.0f, 2.0f, 2.0f), 0.25f).y, 0.5f), "lerp");
+
+// Scalar fallbacks.
+static_assert(Near(static_cast<real32>(Sqrt(2.0)), 1.4142135f), "sqrt");
+static_assert(Sqrt(16) == 4.0, "integer sqrt");
+static_assert(Vector3<int32>(3, 4, 0).Length() == 5, "integer vector length");
+static_assert(Near(Sinf(static_cast<real32>(J_PI) / 6.0f), 0.5f), "sin");
+static_assert(Near(Cosf(static_cast<real32>(J_PI) / 3.0f), 0.5f), "cos");
+static_assert(Near(Tanf(static_cast<real32>(J_PI) / 4.0f), 1.0f), "tan");
+static_assert(Near(Sinf(100.0f), -0.50636564f), "sin range reduction");
+static_assert(Near(Sin(0.5f), 0.47942554f), "float sin");
+static_assert(Near(Cos(-2.0f), -0.41614684f), "float cos");
+static_assert(Near(Tan(1.0f), 1.5574077f), "float tan");
+static_assert(Near(Atan2(-1.0f, -1.0f), -2.3561945f), "atan2");
+static_assert(Near(Acos(-0.6f), 2.2142975f), "acos");
+
+// Matrices.
+static_assert(Mat4::Identity().data[2][2] == 1.0f, "identity");
+static_assert(Near(Sample() * Mat4::Identity(), Sample()), "multiply by identity");
+static_assert(Near(Sample() * Sample().Inverse(), Mat4::Identity()), "inverse");
+static_assert(Near(Sample().InverseAffine(), Sample().Inverse()), "affine inverse");
+static_assert(Near(Sample().Determinant(), 25.0f), "determinant");
+static_assert(Sample().Transpose().data[0][3] == 5.0f, "transpose");
+static_assert(Translate(Mat4(), Vec3(1.0f, 2.0f, 3.0f)).data[3][1] == 2.0f, "translate");
+static_assert(Near(Rotate(Mat4(), static_cast<real32>(J_PI) * 0.5f, Vec3(0.0f, 0.0f, 1.0f)).data[0][1], 1.0f),
+  "rotate");
+static_assert(Near(PerspectiveLH(ToRadians(90.0f), 1.0f, 0.1f, 100.0f).data[0][0], 1.0f), "perspective");
+static_assert(Near(LookAtLH(Vec3(0.0f, 0.0f, -5.0f), Vec3(0.0f), Vec3(0.0f, 1.0f, 0.0f)).data[3][2], 5.0f),
+  "look at");
+
+// Quaternions.
+static_assert((Quat(1.0f, 0.0f, 0.0f, 0.0f) * Quat(1.0f, 0.0f, 0.0f, 0.0f)).w == 1.0f, "quaternion multiply");
+static_assert(Near(Normalize(Quat(2.0f, 0.0f, 0.0f, 0.0f)).w, 1.0f), "quaternion normalize");
+static_assert(Near(AngleAxis(static_cast<real32>(J_PI), Vec3(0.0f, 1.0f, 0.0f)).y, 1.0f), "angle axis");
+static_assert(Near(ToQuaternion(Vec3(0.0f, 0.0f, 0.5f)).z, AngleAxis(0.5f, Vec3(0.0f, 0.0f, 1.0f)).z), 
+  "euler to quaternion");
+
+// A constant table built entirely at compile time.
+constexpr Mat4 ViewProjection = 
+  LookAtLH(Vec3(0.0f, 2.0f, -5.0f), Vec3(0.0f), Vec3(0.0f, 1.0f, 0.0f)) *
+  PerspectiveLH(ToRadians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+
+
+int main()
+{
+  std::cout << "Math constexpr tests passed at compile time.\n";
+  std::cout << "ViewProjection[3][3] = " << ViewProjection.data[3][3] << "\n";
+  // The runtime paths (simd specializations) must agree with the compile
+  // time ones.
+  Mat4 runtime = LookAtLH(Vec3(0.0f, 2.0f, -5.0f), Vec3(0.0f), Vec3(0.0f, 1.0f, 0.0f)) *
+    PerspectiveLH(ToRadians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+  if (!Near(runtime, ViewProjection, 1e-4f)) {
+    std::cout << "Runtime and compile time results differ!\n";
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,165 @@
+// Behavior tests for the memory tracker: tag totals follow what is
+// allocated and freed under each tag, across threads, and going over a
+// budget is reported once per crossing.
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "memory/memory_tracker.hpp"
+#include "memory/handle_pool.hpp"
+
+
+using namespace qengine;
+
+
+static int failures = 0;
+
+
+static void Check(bool passed, const char *what)
+{
+  if (!passed) {
+    std::cout << "FAILED: " << what << "\n";
+    ++failures;
+  }
+}
+
+
+static const MemoryTagStats &Stats(const MemorySnapshot &snapshot, MemoryTag tag)
+{
+  return snapshot.tags[static_cast<uint32_t>(tag)];
+}
+
+
+#if defined(Q_MEMORY_TRACKING)
+
+struct Overrun {
+  uint32_t calls;
+  MemoryTag tag;
+  size_t bytes;
+  size_t budget;
+};
+
+
+static void OnOverBudget(void *userData, MemoryTag tag, size_t bytes, size_t budget)
+{
+  Overrun *overrun = static_cast<Overrun *>(userData);
+  ++overrun->calls;
+  overrun->tag = tag;
+  overrun->bytes = bytes;
+  overrun->budget = budget;
+}
+
+
+static void TestTotals()
+{
+  MemorySnapshot before = TakeMemorySnapshot();
+  void *a = TrackedAllocate(1000, MemoryTag::Math);
+  void *b = TrackedAllocate(24, MemoryTag::Math);
+  TrackAllocation(MemoryTag::Texture, 4096);
+  MemorySnapshot during = TakeMemorySnapshot();
+  Check(Stats(during, MemoryTag::Math).bytes == Stats(before, MemoryTag::Math).bytes + 1024,
+    "bytes add up per tag");
+  Check(Stats(during, MemoryTag::Math).allocations ==
+    Stats(before, MemoryTag::Math).allocations + 2, "allocations add up per tag");
+  Check(Stats(during, MemoryTag::Texture).bytes == Stats(before, MemoryTag::Texture).bytes + 4096,
+    "memory allocated elsewhere is counted");
+  Check(during.bytes == before.bytes + 1024 + 4096, "the total covers every tag");
+
+  TrackedFree(a, 1000, MemoryTag::Math);
+  TrackedFree(b, 24, MemoryTag::Math);
+  TrackFree(MemoryTag::Texture, 4096);
+  MemorySnapshot after = TakeMemorySnapshot();
+  Check(Stats(after, MemoryTag::Math).bytes == Stats(before, MemoryTag::Math).bytes &&
+    Stats(after, MemoryTag::Texture).bytes == Stats(before, MemoryTag::Texture).bytes,
+    "frees take the bytes back off");
+  Check(Stats(after, MemoryTag::Math).peakBytes >= Stats(before, MemoryTag::Math).bytes + 1024,
+    "peaks stay after frees");
+  Check(Stats(after, MemoryTag::Math).totalAllocations ==
+    Stats(before, MemoryTag::Math).totalAllocations + 2, "totalAllocations keeps counting");
+  ResetMemoryPeaks();
+  Check(Stats(TakeMemorySnapshot(), MemoryTag::Math).peakBytes ==
+    Stats(after, MemoryTag::Math).bytes, "ResetMemoryPeaks starts from the bytes held");
+
+  // Containers and pools count under their tags, from any thread.
+  before = TakeMemorySnapshot();
+  {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.push_back(std::thread([] {
+        for (int i = 0; i < 1000; ++i) {
+          std::vector<float, TrackedAllocator<float, MemoryTag::Math>> values(16);
+        }
+      }));
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    HandlePool<int, MemoryTag::Mesh> pool;
+    for (int i = 0; i < 100; ++i) {
+      pool.Add(i);
+    }
+    Check(Stats(TakeMemorySnapshot(), MemoryTag::Mesh).bytes > Stats(before, MemoryTag::Mesh).bytes,
+      "handle pools count under their tag");
+  }
+  after = TakeMemorySnapshot();
+  Check(Stats(after, MemoryTag::Math).bytes == Stats(before, MemoryTag::Math).bytes,
+    "threads freeing what they allocate balance out");
+  Check(Stats(after, MemoryTag::Math).totalAllocations ==
+    Stats(before, MemoryTag::Math).totalAllocations + 4000, "no allocation is lost across threads");
+  Check(Stats(after, MemoryTag::Mesh).bytes == Stats(before, MemoryTag::Mesh).bytes,
+    "a destroyed pool gives its bytes back");
+}
+
+
+static void TestBudget()
+{
+  Overrun overrun = { 0, MemoryTag::General, 0, 0 };
+  SetOverBudgetCallback(OnOverBudget, &overrun);
+  size_t held = TakeMemorySnapshot().tags[static_cast<uint32_t>(MemoryTag::Renderer)].bytes;
+  SetMemoryBudget(MemoryTag::Renderer, held + 1000);
+  Check(Stats(TakeMemorySnapshot(), MemoryTag::Renderer).budget == held + 1000,
+    "snapshots show the budget");
+
+  TrackAllocation(MemoryTag::Renderer, 600);
+  Check(overrun.calls == 0, "nothing reported under budget");
+  TrackAllocation(MemoryTag::Renderer, 600);
+  Check(overrun.calls == 1 && overrun.tag == MemoryTag::Renderer &&
+    overrun.bytes == held + 1200 && overrun.budget == held + 1000,
+    "going over budget is reported with the tag, bytes and budget");
+  TrackAllocation(MemoryTag::Renderer, 600);
+  Check(overrun.calls == 1, "staying over budget is not reported again");
+
+  TrackFree(MemoryTag::Renderer, 600);
+  TrackFree(MemoryTag::Renderer, 600);
+  TrackAllocation(MemoryTag::Renderer, 600);
+  Check(overrun.calls == 2, "going over again after dropping under is reported again");
+
+  TrackFree(MemoryTag::Renderer, 600);
+  TrackFree(MemoryTag::Renderer, 600);
+  SetMemoryBudget(MemoryTag::Renderer, 0);
+  TrackAllocation(MemoryTag::Renderer, 1 << 20);
+  TrackFree(MemoryTag::Renderer, 1 << 20);
+  Check(overrun.calls == 2, "no budget, no reports");
+  SetOverBudgetCallback(nullptr, nullptr);
+}
+
+#endif
+
+
+int main()
+{
+#if defined(Q_MEMORY_TRACKING)
+  TestTotals();
+  TestBudget();
+  if (failures) {
+    return 1;
+  }
+  std::cout << "Memory tracker tests passed.\n";
+#else
+  Check(Stats(TakeMemorySnapshot(), MemoryTag::General).bytes == 0, "nothing tracked");
+  if (failures) {
+    return 1;
+  }
+  std::cout << "Memory tracking is compiled out, nothing to test.\n";
+#endif
+  return 0;
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <iomanip>
+#include <cstring>
 #include "renderer/renderer.hpp"
 #include "matrix.hpp"
 #include "matrix_math.hpp"
@@ -15,8 +16,23 @@ int main(int c, char *argv[])
     }
     std::cout << "\n";
   }
+  // --headless and --null run a fixed number of frames without a display,
+  // for build machines.
+  qengine::EngineConfig config;
+  for (int i = 1; i < c; ++i) {
+    if (std::strcmp(argv[i], "--headless") == 0) {
+      config.mode = qengine::DisplayMode::Headless;
+    } else if (std::strcmp(argv[i], "--null") == 0) {
+      config.mode = qengine::DisplayMode::Null;
+    }
+  }
+  if (config.mode == qengine::DisplayMode::Headless || config.mode == qengine::DisplayMode::Null) {
+    config.frameLimit = 1000;
+  }
   qengine::Engine engine;
-  engine.Init();
+  if (!engine.Init(config)) {
+    return 1;
+  }
 
   while (engine.WindowIsRunning()) {
     engine.SwapBuffers();